@@ -0,0 +1,147 @@
+#pragma once
+
+#include "binary_report.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace video_analyzer {
+
+/**
+ * @brief Version of the cached analysis results
+ *
+ * Bump whenever decoding or analysis changes what ends up in FrameInfo,
+ * GOPInfo, BitrateStatistics or StreamInfo; entries written by another
+ * version are ignored.
+ */
+constexpr int kAnalysisCacheVersion = 2;
+
+/**
+ * @brief Identity of a video file for cache lookups
+ */
+struct CacheKey {
+    std::string path;         // Canonical absolute path
+    uint64_t size = 0;        // File size in bytes
+    int64_t mtime = 0;        // Last write time (filesystem clock ticks)
+    uint64_t contentHash = 0; // FNV-1a hash of the first and last 64 KiB
+    int version = kAnalysisCacheVersion;
+    
+    /**
+     * @brief Compute the key of a file
+     *
+     * @param videoPath Path to the video file
+     * @throws std::runtime_error if the file does not exist
+     */
+    static CacheKey fromFile(const std::string& videoPath);
+    
+    nlohmann::json toJson() const;
+};
+
+/**
+ * @brief On-disk cache of analysis results
+ *
+ * Each analyzed video has one entry: a binary columnar report (.vsa) named
+ * after a hash of the video's path, with the CacheKey stored in its
+ * metadata. An entry is only used when size, mtime, partial content hash
+ * and cache version all still match, so modified files are re-analyzed and
+ * their entry overwritten.
+ *
+ * Cache failures never fail an analysis: lookups return nullptr and
+ * commits that cannot be written are discarded.
+ */
+class AnalysisCache {
+public:
+    /**
+     * @brief Pending cache entry being filled during an analysis
+     *
+     * Frames are written through writer() as they are decoded. The entry
+     * becomes visible only after commit(); otherwise it is discarded.
+     */
+    class Entry {
+    public:
+        Entry(const CacheKey& key, const std::string& finalPath);
+        ~Entry();
+        
+        // Disable copy
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+        
+        /**
+         * @brief Sink receiving the analyzed frames
+         */
+        BinaryReportWriter& writer() { return *writer_; }
+        
+        /**
+         * @brief Write the entry and atomically replace any previous one
+         *
+         * @param summary Summary fields stored in the metadata (e.g. frameStatistics)
+         * @return true if the entry was written
+         */
+        bool commit(const nlohmann::json& summary = nlohmann::json::object());
+    
+    private:
+        CacheKey key_;
+        std::string finalPath_;
+        std::string tempPath_;
+        std::unique_ptr<BinaryReportWriter> writer_;
+        bool committed_ = false;
+    };
+    
+    /**
+     * @brief Construct a cache
+     *
+     * @param directory Cache directory (created on first write)
+     */
+    explicit AnalysisCache(const std::string& directory = defaultDirectory());
+    
+    /**
+     * @brief Default cache directory
+     *
+     * $AISTREAMEYE_CACHE_DIR if set, otherwise $XDG_CACHE_HOME/aistreameye,
+     * ~/.cache/aistreameye, or %LOCALAPPDATA%\aistreameye on Windows.
+     */
+    static std::string defaultDirectory();
+    
+    /**
+     * @brief Look up a valid entry for a video
+     *
+     * @param videoPath Path to the video file
+     * @return std::unique_ptr<BinaryReport> Mapped entry, or nullptr on a miss or stale entry
+     */
+    std::unique_ptr<BinaryReport> lookup(const std::string& videoPath) const;
+    
+    /**
+     * @brief Start a new entry for a video
+     *
+     * @param videoPath Path to the video file
+     * @return std::unique_ptr<Entry> Pending entry, or nullptr if the video cannot be keyed
+     */
+    std::unique_ptr<Entry> createEntry(const std::string& videoPath) const;
+    
+    /**
+     * @brief Store complete analysis results for a video
+     *
+     * @return true if the entry was written
+     */
+    bool store(const std::string& videoPath, const StreamInfo& streamInfo,
+               const std::vector<FrameInfo>& frames, const std::vector<GOPInfo>& gops,
+               const FrameStatistics& frameStats, const BitrateStatistics& bitrateStats) const;
+    
+    /**
+     * @brief Remove all entries
+     */
+    void clear() const;
+    
+    /**
+     * @brief Get the cache directory
+     */
+    const std::string& getDirectory() const { return directory_; }
+
+private:
+    std::string entryPath(const CacheKey& key) const;
+    
+    std::string directory_;
+};
+
+} // namespace video_analyzer
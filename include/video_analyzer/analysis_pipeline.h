@@ -0,0 +1,153 @@
+#pragma once
+
+#include "video_decoder.h"
+#include "data_models.h"
+#include <atomic>
+#include <vector>
+#include <functional>
+
+namespace video_analyzer {
+
+/**
+ * @brief Consumer of decoded frames in an AnalysisPipeline
+ *
+ * Sinks receive every frame of a single decode pass. Sinks that need pixel
+ * data or motion vectors can query the decoder passed to consume(), which
+ * still holds the frame that produced the FrameInfo.
+ */
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+    
+    /**
+     * @brief Called once before the first frame
+     *
+     * @param info Stream information of the decoded stream
+     */
+    virtual void begin(const StreamInfo& /*info*/) {}
+    
+    /**
+     * @brief Called for every decoded frame, in presentation order
+     *
+     * @param frame Frame information
+     * @param decoder Decoder that produced the frame (last decoded frame is still available)
+     */
+    virtual void consume(const FrameInfo& frame, const VideoDecoder& decoder) = 0;
+    
+    /**
+     * @brief Called once after the last frame
+     */
+    virtual void end() {}
+    
+    /**
+     * @brief Whether the sink reads motion vectors from the decoder
+     *
+     * Motion vector export is only enabled on the decoder when a registered
+     * sink returns true, so other analyses do not pay for it.
+     */
+    virtual bool needsMotionVectors() const { return false; }
+};
+
+/**
+ * @brief Sink that keeps every FrameInfo in memory
+ */
+class FrameCollector : public FrameSink {
+public:
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    
+    /**
+     * @brief Get the collected frames
+     */
+    const std::vector<FrameInfo>& getFrames() const { return frames_; }
+    
+    /**
+     * @brief Move the collected frames out of the collector
+     */
+    std::vector<FrameInfo> takeFrames();
+
+private:
+    std::vector<FrameInfo> frames_;
+};
+
+/**
+ * @brief Single-pass analysis pipeline
+ *
+ * Decodes the stream once and fans each frame out to all registered sinks,
+ * so GOP, bitrate, scene, motion and statistics analysis share one decode.
+ */
+class AnalysisPipeline {
+public:
+    using ProgressCallback = std::function<void(size_t framesDecoded)>;
+    
+    /**
+     * @brief Construct a pipeline over a decoder
+     *
+     * run() continues from the decoder's current position, unless it has
+     * to enable motion vector export, which restarts the decoder from the
+     * beginning of the stream.
+     *
+     * @param decoder Decoder to read frames from
+     */
+    explicit AnalysisPipeline(VideoDecoder& decoder);
+    
+    /**
+     * @brief Register a sink (not owned, must outlive run())
+     *
+     * @param sink Sink to receive frames
+     */
+    void addSink(FrameSink& sink);
+    
+    /**
+     * @brief Set a callback invoked after each decoded frame
+     *
+     * @param callback Progress callback
+     */
+    void setProgressCallback(ProgressCallback callback);
+    
+    /**
+     * @brief Decode the stream and feed all sinks
+     *
+     * If a sink needs motion vectors and the decoder does not export them
+     * yet, export is enabled first, which restarts the decoder from the
+     * beginning of the stream.
+     *
+     * @param maxFrames Maximum frames to decode (-1 = all)
+     * @return size_t Number of frames decoded
+     */
+    size_t run(int maxFrames = -1);
+    
+    /**
+     * @brief Feed already decoded frames to all sinks
+     * 
+     * Used with frames produced elsewhere (e.g. SegmentedDecoder). The
+     * pipeline's decoder is passed to the sinks but holds no decoded picture.
+     * 
+     * @param frames Frames in presentation order
+     * @param maxFrames Maximum frames to feed (-1 = all)
+     * @return size_t Number of frames fed
+     */
+    size_t replay(const std::vector<FrameInfo>& frames, int maxFrames = -1);
+    
+    /**
+     * @brief Stop run() or replay() after the current frame
+     *
+     * Safe to call from any thread, including from a sink or the progress
+     * callback. Sinks still receive end(). Only the current pass is
+     * cancelled: the next run() or replay() clears the flag.
+     */
+    void cancel();
+    
+    /**
+     * @brief Check whether the last run() or replay() was cancelled
+     */
+    bool isCancelled() const { return cancelled_.load(); }
+
+private:
+    VideoDecoder& decoder_;
+    std::vector<FrameSink*> sinks_;
+    ProgressCallback progressCallback_;
+    std::atomic<bool> cancelled_{false};
+};
+
+} // namespace video_analyzer
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "data_models.h"
+#include <vector>
+
+namespace video_analyzer {
+
+/**
+ * @brief Per-stream anomaly detection on consecutive frames
+ *
+ * Detects frame drops (timestamp gaps), bitrate spikes (frame size jumps)
+ * and quality drops (high QP). Keeps only what the rules need from the
+ * previous frame, so one detector per monitored stream stays small.
+ */
+class AnomalyDetector {
+public:
+    /**
+     * @brief Inspect the next frame of the stream
+     *
+     * @param frame Frame in presentation order, as the decoder outputs it;
+     *              the timestamp-gap rule relies on it
+     * @param anomalies Receives the detected anomalies (appended)
+     * @return size_t Number of anomalies detected
+     */
+    size_t inspect(const FrameInfo& frame, std::vector<Anomaly>& anomalies);
+    
+    /**
+     * @brief Forget the previous frame
+     */
+    void reset();
+
+private:
+    bool hasPrevious_ = false;
+    double previousTimestamp_ = 0.0;
+    int previousSize_ = 0;
+};
+
+} // namespace video_analyzer
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "video_decoder.h"
+#include "frame_statistics.h"
+#include "data_models.h"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace video_analyzer {
+
+/**
+ * @brief Options for batch analysis
+ */
+struct BatchOptions {
+    size_t jobs = 0;                 // Files analyzed concurrently (0 = hardware threads)
+    DecoderOptions decoderOptions;   // Per-file decoder options (threadCount 0 = balanced against jobs)
+    std::string outputDir = "batch_reports";  // Directory for per-file reports and the summary
+    std::string format = "json";     // Per-file report format (json|csv|binary)
+    int maxFrames = -1;              // Maximum frames per file (-1 = all)
+};
+
+/**
+ * @brief Result of analyzing one file in a batch
+ */
+struct BatchFileResult {
+    std::string path;                // Input file path
+    std::string reportPath;          // Per-file report path (empty on failure)
+    bool success = false;            // Whether analysis succeeded
+    std::string error;               // Error message on failure
+    StreamInfo streamInfo;           // Stream information
+    FrameStatistics frameStats;      // Frame statistics
+    size_t gopCount = 0;             // Number of GOPs
+    double averageGOPLength = 0.0;   // Average GOP length in frames
+    double elapsedSeconds = 0.0;     // Wall time spent on this file
+    
+    nlohmann::json toJson() const;
+};
+
+/**
+ * @brief Aggregate result of a batch run
+ */
+struct BatchSummary {
+    std::vector<BatchFileResult> files;  // Per-file results, in input order
+    size_t succeeded = 0;                // Number of files analyzed successfully
+    size_t failed = 0;                   // Number of files that failed
+    int64_t totalFrames = 0;             // Frames analyzed across all files
+    double elapsedSeconds = 0.0;         // Wall time of the whole batch
+    double filesPerHour = 0.0;           // Aggregate throughput
+    
+    nlohmann::json toJson() const;
+};
+
+/**
+ * @brief Analyzes many files concurrently on a shared ThreadPool
+ * 
+ * File-level parallelism is bounded by the job count; each file's decoder
+ * gets an equal share of the remaining hardware threads so the machine is
+ * neither idle nor oversubscribed.
+ */
+class BatchAnalyzer {
+public:
+    using ProgressCallback = std::function<void(const BatchFileResult& result, size_t completed, size_t total)>;
+    
+    /**
+     * @brief Construct a BatchAnalyzer
+     * 
+     * @param options Batch options
+     */
+    explicit BatchAnalyzer(const BatchOptions& options = BatchOptions{});
+    
+    /**
+     * @brief Collect input files from a directory or a file list
+     * 
+     * A directory is searched recursively for video files. Any other path is
+     * read as a text file with one input path per line ('#' starts a comment).
+     * 
+     * @param source Directory or list file
+     * @return std::vector<std::string> Input files, sorted for directories
+     * @throws std::runtime_error if the source cannot be read
+     */
+    static std::vector<std::string> collectInputs(const std::string& source);
+    
+    /**
+     * @brief Set a callback invoked as each file completes
+     * 
+     * Called from worker threads, one call at a time.
+     * 
+     * @param callback Progress callback
+     */
+    void setProgressCallback(ProgressCallback callback);
+    
+    /**
+     * @brief Analyze all files and write per-file reports plus batch_summary.json
+     * 
+     * @param files Input files
+     * @return BatchSummary Aggregate result
+     */
+    BatchSummary run(const std::vector<std::string>& files);
+    
+    /**
+     * @brief Get the decoder thread count used for each file
+     */
+    int getDecoderThreadsPerFile() const;
+    
+    /**
+     * @brief Get the number of files analyzed concurrently
+     */
+    size_t getJobCount() const;
+    
+private:
+    BatchOptions options_;
+    ProgressCallback progressCallback_;
+    
+    BatchFileResult analyzeFile(const std::string& path, const std::string& reportPath) const;
+};
+
+} // namespace video_analyzer
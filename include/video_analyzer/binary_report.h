@@ -0,0 +1,250 @@
+#pragma once
+
+#include "analysis_pipeline.h"
+#include "data_models.h"
+#include "frame_statistics.h"
+#include "motion_field.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace video_analyzer {
+
+/**
+ * @brief Binary columnar analysis report (.vsa)
+ *
+ * Layout (all integers little-endian):
+ *
+ *   [header 64 B][column directory][columns, each 64-byte aligned][metadata JSON]
+ *
+ * The header holds the magic "VSAREP01", the format version, the column
+ * count and the offsets of the directory and the metadata. Each directory
+ * entry names a column ("frames.pts", "gops.totalSize", ...), gives its
+ * numpy dtype string ("<i8", "|u1", ...), its byte offset and its element
+ * count. Columns can therefore be mapped directly as arrays, e.g. with
+ * numpy.frombuffer() or BinaryReport::column<T>().
+ *
+ * Column groups: "frames.*", "gops.*", "bitrate.*" and "motion.*" (per-frame
+ * motion vector summaries, only for frames decoded with motion vector
+ * export). Stream information and summary statistics are stored in the
+ * metadata JSON.
+ */
+constexpr char kBinaryReportMagic[8] = {'V', 'S', 'A', 'R', 'E', 'P', '0', '1'};
+constexpr uint32_t kBinaryReportVersion = 1;
+constexpr size_t kBinaryReportAlignment = 64;
+
+// Per-frame flag bits of the "frames.flags" column
+constexpr uint8_t kFrameFlagKeyFrame = 0x01;
+constexpr uint8_t kFrameFlagDuplicate = 0x02;
+
+/**
+ * @brief numpy dtype string of a column element type
+ */
+template <typename T>
+constexpr const char* binaryColumnDtype() {
+    if constexpr (std::is_same_v<T, int64_t>) return "<i8";
+    else if constexpr (std::is_same_v<T, int32_t>) return "<i4";
+    else if constexpr (std::is_same_v<T, int16_t>) return "<i2";
+    else if constexpr (std::is_same_v<T, uint8_t>) return "|u1";
+    else if constexpr (std::is_same_v<T, double>) return "<f8";
+    else if constexpr (std::is_same_v<T, float>) return "<f4";
+    else static_assert(sizeof(T) == 0, "Unsupported column type");
+}
+
+/**
+ * @brief Read-only view of a mapped column
+ */
+template <typename T>
+struct ColumnView {
+    const T* data = nullptr;
+    size_t size = 0;
+    
+    const T& operator[](size_t index) const { return data[index]; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
+/**
+ * @brief Sink that writes a binary columnar report
+ *
+ * Frames are appended to compact per-column buffers as they are decoded
+ * (about 40 bytes per frame) and written out by finish(). With motion
+ * export enabled, the writer also summarizes each decoded frame's motion
+ * field into the motion columns.
+ */
+class BinaryReportWriter : public FrameSink {
+public:
+    /**
+     * @brief Construct a writer
+     *
+     * @param path Output file path (opened by finish())
+     */
+    explicit BinaryReportWriter(const std::string& path);
+    
+    ~BinaryReportWriter() override;
+    
+    // Disable copy
+    BinaryReportWriter(const BinaryReportWriter&) = delete;
+    BinaryReportWriter& operator=(const BinaryReportWriter&) = delete;
+    
+    // FrameSink interface
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    bool needsMotionVectors() const override;
+    
+    /**
+     * @brief Summarize motion vectors of the frames consumed from a pipeline
+     *
+     * Makes the pipeline enable motion vector export, which slows decoding.
+     * Replayed frames carry no motion vectors and add no motion rows.
+     *
+     * @param enable true to fill the motion columns while decoding
+     */
+    void setMotionExport(bool enable);
+    
+    /**
+     * @brief Append a single frame
+     *
+     * @param frame Frame information
+     */
+    void writeFrame(const FrameInfo& frame);
+    
+    /**
+     * @brief Set the GOP columns
+     */
+    void setGOPs(const std::vector<GOPInfo>& gops);
+    
+    /**
+     * @brief Set the bitrate time series (summary values go to the metadata)
+     */
+    void setBitrateStatistics(const BitrateStatistics& stats);
+    
+    /**
+     * @brief Append the motion summary of a single frame
+     *
+     * @param pts Presentation timestamp of the frame
+     * @param summary Summary of the frame's motion field
+     */
+    void writeMotion(int64_t pts, const MotionAccumulator& summary);
+    
+    /**
+     * @brief Set per-frame motion summaries from motion fields
+     */
+    void setMotionVectorData(const std::vector<MotionField>& fields);
+    
+    /**
+     * @brief Write the report file
+     *
+     * @param summary JSON object merged into the metadata (e.g. frameStatistics)
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void finish(const nlohmann::json& summary = nlohmann::json::object());
+    
+    /**
+     * @brief Drop all buffered data without writing the file
+     */
+    void discard();
+    
+    /**
+     * @brief Get the number of frames written
+     */
+    size_t getFramesWritten() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+/**
+ * @brief Memory-mapped binary columnar report
+ *
+ * Opening a report maps the file and reads the directory and metadata;
+ * columns are accessed in place without parsing.
+ */
+class BinaryReport {
+public:
+    /**
+     * @brief Map a report file
+     *
+     * @param path Path to a .vsa file
+     * @throws std::runtime_error if the file cannot be mapped or is not a valid report
+     */
+    explicit BinaryReport(const std::string& path);
+    
+    ~BinaryReport();
+    
+    // Disable copy
+    BinaryReport(const BinaryReport&) = delete;
+    BinaryReport& operator=(const BinaryReport&) = delete;
+    
+    /**
+     * @brief Check whether a file starts with the report magic
+     */
+    static bool isBinaryReport(const std::string& path);
+    
+    /**
+     * @brief Check whether a column exists
+     */
+    bool hasColumn(const std::string& name) const;
+    
+    /**
+     * @brief Get a typed view of a column
+     *
+     * @param name Column name
+     * @return ColumnView<T> View into the mapped file (valid while the report is open)
+     * @throws std::runtime_error if the column is missing or has a different dtype
+     */
+    template <typename T>
+    ColumnView<T> column(const std::string& name) const {
+        ColumnView<T> view;
+        view.data = static_cast<const T*>(columnData(name, binaryColumnDtype<T>(), view.size));
+        return view;
+    }
+    
+    /**
+     * @brief Get the metadata JSON (streamInfo, summary statistics, source path)
+     */
+    const nlohmann::json& getMetadata() const;
+    
+    /**
+     * @brief Get the number of frames
+     */
+    size_t getFrameCount() const;
+    
+    /**
+     * @brief Stream information stored in the metadata
+     */
+    StreamInfo getStreamInfo() const;
+    
+    /**
+     * @brief Frame statistics stored in the metadata
+     */
+    FrameStatistics getFrameStatistics() const;
+    
+    /**
+     * @brief Materialize all frames
+     */
+    std::vector<FrameInfo> readFrames() const;
+    
+    /**
+     * @brief Materialize all GOPs
+     */
+    std::vector<GOPInfo> readGOPs() const;
+    
+    /**
+     * @brief Bitrate time series and the summary stored in the metadata
+     */
+    BitrateStatistics readBitrateStatistics() const;
+
+private:
+    const void* columnData(const std::string& name, const char* dtype, size_t& count) const;
+    
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace video_analyzer
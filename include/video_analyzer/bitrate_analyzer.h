@@ -1,6 +1,7 @@
 #pragma once
 
 #include "video_decoder.h"
+#include "analysis_pipeline.h"
 #include "data_models.h"
 #include <vector>
 
@@ -8,8 +9,11 @@ namespace video_analyzer {
 
 /**
  * @brief Analyzer for video bitrate
+ *
+ * Can be used standalone via analyze() or registered as a sink in an
+ * AnalysisPipeline; time windows are closed as frames stream in.
  */
-class BitrateAnalyzer {
+class BitrateAnalyzer : public FrameSink {
 public:
     /**
      * @brief Construct a BitrateAnalyzer
@@ -22,10 +26,22 @@ public:
     /**
      * @brief Analyze bitrate
      * 
+     * Decodes the whole stream from the beginning.
+     * 
      * @return BitrateStatistics Bitrate statistics
      */
     BitrateStatistics analyze();
     
+    // FrameSink interface
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    void end() override;
+    
+    /**
+     * @brief Get statistics computed by the last analysis
+     */
+    const BitrateStatistics& getStatistics() const { return stats_; }
+    
     /**
      * @brief Set the time window size
      * 
@@ -36,12 +52,23 @@ public:
 private:
     VideoDecoder& decoder_;
     double windowSize_;
+    BitrateStatistics stats_;
+    
+    // Running totals
+    int64_t totalSize_ = 0;
+    size_t frameCount_ = 0;
+    double firstTimestamp_ = 0.0;
+    double lastTimestamp_ = 0.0;
+    
+    // Current time window
+    double windowStart_ = 0.0;
+    double windowEnd_ = 0.0;
+    double windowLastTimestamp_ = 0.0;
+    int64_t windowBytes_ = 0;
+    size_t windowFrames_ = 0;
+    std::vector<double> bitrateValues_;
     
-    double calculateInstantaneousBitrate(
-        const std::vector<FrameInfo>& frames,
-        size_t startIdx,
-        size_t endIdx
-    ) const;
+    void closeWindow();
 };
 
 } // namespace video_analyzer
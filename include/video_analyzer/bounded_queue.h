@@ -0,0 +1,204 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+namespace video_analyzer {
+
+/**
+ * @brief What a BoundedQueue does when a push finds it full
+ */
+enum class OverflowPolicy {
+    BLOCK,        // Wait until the consumer makes room (backpressure)
+    DROP_OLDEST,  // Evict the oldest queued item to make room
+    DROP_NEWEST   // Reject the pushed item
+};
+
+/**
+ * @brief Result of BoundedQueue::push
+ */
+enum class PushResult {
+    PUSHED,          // Item queued, nothing dropped
+    EVICTED_OLDEST,  // Item queued, the oldest item (and its dependents) was dropped
+    REJECTED,        // Item dropped (queue full with DROP_NEWEST, or a dependent of an evicted item)
+    CLOSED           // Queue closed, item dropped
+};
+
+/**
+ * @brief Bounded FIFO connecting two pipeline stages
+ *
+ * The overflow policy decides whether a full queue applies backpressure to
+ * the producer or drops items, so a stalled consumer cannot stall a
+ * producer that must keep up with a live source. Consumers block in pop()
+ * until an item arrives or the queue is closed.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * @brief Construct a queue
+     *
+     * @param capacity Maximum number of queued items (at least 1)
+     * @param policy Behavior when full
+     */
+    BoundedQueue(size_t capacity, OverflowPolicy policy)
+        : capacity_(capacity > 0 ? capacity : 1), policy_(policy) {}
+    
+    // Disable copy
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+    
+    /**
+     * @brief Make DROP_OLDEST evict whole dependency runs
+     *
+     * Items that depend on their predecessors (e.g. non-key packets) are
+     * useless once the oldest item is evicted. With a boundary predicate
+     * set, an eviction also drops the following items up to the next one
+     * for which isBoundary returns true; if that consumes the pushed item
+     * too, push() returns REJECTED.
+     *
+     * @param isBoundary Whether an item starts a new independent run
+     */
+    void setEvictionBoundary(std::function<bool(const T&)> isBoundary) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isBoundary_ = std::move(isBoundary);
+    }
+    
+    /**
+     * @brief Push an item, applying the overflow policy when full
+     */
+    PushResult push(T item) {
+        PushResult result = PushResult::PUSHED;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (policy_ == OverflowPolicy::BLOCK) {
+                notFull_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+            }
+            if (closed_) {
+                return PushResult::CLOSED;
+            }
+            
+            if (items_.size() >= capacity_) {
+                dropped_++;
+                if (policy_ == OverflowPolicy::DROP_NEWEST) {
+                    return PushResult::REJECTED;
+                }
+                items_.pop_front();
+                result = PushResult::EVICTED_OLDEST;
+                items_.push_back(std::move(item));
+                
+                // Dependents of the evicted item, possibly including the new one
+                while (isBoundary_ && !items_.empty() && !isBoundary_(items_.front())) {
+                    items_.pop_front();
+                    dropped_++;
+                }
+                if (items_.empty()) {
+                    return PushResult::REJECTED;
+                }
+            } else {
+                items_.push_back(std::move(item));
+            }
+        }
+        notEmpty_.notify_one();
+        return result;
+    }
+    
+    /**
+     * @brief Pop the oldest item, waiting until one is available
+     *
+     * @return std::optional<T> Item, or nullopt once the queue is closed and drained
+     */
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        return takeFront(lock);
+    }
+    
+    /**
+     * @brief Pop the oldest item, waiting at most timeout
+     *
+     * @return std::optional<T> Item, or nullopt on timeout or when closed and drained
+     */
+    template <typename Rep, typename Period>
+    std::optional<T> popFor(const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait_for(lock, timeout, [this] { return closed_ || !items_.empty(); });
+        return takeFront(lock);
+    }
+    
+    /**
+     * @brief Close the queue
+     *
+     * Pending and future pushes fail; consumers drain the remaining items
+     * and then receive nullopt.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+    
+    /**
+     * @brief Drop all queued items
+     */
+    void clear() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            items_.clear();
+        }
+        notFull_.notify_all();
+    }
+    
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+    
+    /**
+     * @brief Number of items dropped by the overflow policy
+     */
+    uint64_t droppedCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+    
+    bool isClosed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+    
+    size_t capacity() const { return capacity_; }
+
+private:
+    std::optional<T> takeFront(std::unique_lock<std::mutex>& lock) {
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        std::optional<T> item(std::move(items_.front()));
+        items_.pop_front();
+        lock.unlock();
+        notFull_.notify_one();
+        return item;
+    }
+    
+    const size_t capacity_;
+    const OverflowPolicy policy_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<T> items_;
+    std::function<bool(const T&)> isBoundary_;
+    uint64_t dropped_ = 0;
+    bool closed_ = false;
+};
+
+} // namespace video_analyzer
@@ -30,6 +30,9 @@ struct FrameInfo {
     double timestamp;      // Timestamp in seconds
     bool isDuplicate;      // Whether this frame is a duplicate of the previous frame
     int duplicateGroupId;  // ID of the duplicate group (-1 if not duplicate)
+    int64_t pos = -1;      // Byte position of the frame's packet in the input (-1 if unknown)
+    int qpMin = 0;         // Minimum block QP (equals qp when no per-block data)
+    int qpMax = 0;         // Maximum block QP (equals qp when no per-block data)
     
     nlohmann::json toJson() const;
     std::string toCsv() const;
@@ -176,6 +179,9 @@ struct Anomaly {
 // Helper function to convert FrameType to string
 std::string frameTypeToString(FrameType type);
 
+// Name of a FrameType as a static string (no allocation)
+const char* frameTypeName(FrameType type);
+
 // Helper function to convert AnomalyType to string
 std::string anomalyTypeToString(AnomalyType type);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <cstdint>
 
 // Forward declarations for FFmpeg types
 struct AVFormatContext;
@@ -111,4 +112,33 @@ private:
     AVFrame* frame_;
 };
 
+/**
+ * @brief Packet metadata carried through the decoder to the frame it produces
+ * 
+ * Attached to AVPacket::opaque_ref before sending. With AV_CODEC_FLAG_COPY_OPAQUE
+ * set on the codec context, the decoder moves it to AVFrame::opaque_ref of the
+ * output frame, so it stays correct under frame threading and B-frame reordering.
+ */
+struct PacketMetadata {
+    int size = 0;            // Packet size in bytes
+    int64_t pos = -1;        // Byte position in the input (-1 if unknown)
+    int64_t attachedAt = 0;  // steady_clock time of attachment in ns
+};
+
+/**
+ * @brief Attach PacketMetadata describing the packet to its opaque_ref
+ * 
+ * @param packet Packet about to be sent to a decoder
+ * @throws FFmpegError if allocation fails
+ */
+void attachPacketMetadata(AVPacket* packet);
+
+/**
+ * @brief Get the PacketMetadata propagated to a decoded frame
+ * 
+ * @param frame Decoded frame
+ * @return const PacketMetadata* Metadata, or nullptr if the frame carries none
+ */
+const PacketMetadata* getPacketMetadata(const AVFrame* frame);
+
 } // namespace video_analyzer
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "ffmpeg_context.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace video_analyzer {
+
+/**
+ * @brief LRU cache of decoded frames bounded by a memory budget
+ *
+ * Frames are stored as new references to the decoder's buffers (no pixel
+ * copy) and keyed by display-order frame number. When the total size of
+ * the cached buffers exceeds the budget, the least recently used frames
+ * are released; the most recently stored frame is always kept.
+ */
+class FrameCache {
+public:
+    static constexpr size_t kDefaultBudget = 256 * 1024 * 1024;
+
+    /**
+     * @brief Construct a cache
+     *
+     * @param budgetBytes Maximum total size of cached frame buffers
+     */
+    explicit FrameCache(size_t budgetBytes = kDefaultBudget);
+
+    // Disable copy
+    FrameCache(const FrameCache&) = delete;
+    FrameCache& operator=(const FrameCache&) = delete;
+
+    /**
+     * @brief Store a frame, replacing a cached frame with the same number
+     *
+     * @param frameNumber Display-order frame number
+     * @param frame Decoded frame (referenced, not copied)
+     * @return true if stored; false if the frame could not be referenced
+     */
+    bool put(int64_t frameNumber, const AVFrame* frame);
+
+    /**
+     * @brief Look up a frame and mark it as most recently used
+     *
+     * @param frameNumber Display-order frame number
+     * @return AVFrame* Cached frame (owned by the cache, valid until evicted), or nullptr
+     */
+    AVFrame* get(int64_t frameNumber);
+
+    /**
+     * @brief Check whether a frame is cached without touching its LRU position
+     */
+    bool contains(int64_t frameNumber) const;
+
+    /**
+     * @brief Release all frames
+     */
+    void clear();
+
+    /**
+     * @brief Change the memory budget, evicting frames as needed
+     */
+    void setBudget(size_t budgetBytes);
+
+    size_t getBudget() const { return budget_; }
+
+    /**
+     * @brief Number of cached frames
+     */
+    size_t size() const { return entries_.size(); }
+
+    /**
+     * @brief Total size of the cached frame buffers in bytes
+     */
+    size_t getMemoryUsage() const { return memoryUsage_; }
+
+    uint64_t getHitCount() const { return hits_; }
+    uint64_t getMissCount() const { return misses_; }
+
+    /**
+     * @brief Size of the buffers referenced by a frame in bytes
+     */
+    static size_t frameBytes(const AVFrame* frame);
+
+private:
+    struct Entry {
+        int64_t frameNumber;
+        FramePtr frame;
+        size_t bytes;
+    };
+
+    void evict();
+
+    // Most recently used first
+    std::list<Entry> entries_;
+    std::unordered_map<int64_t, std::list<Entry>::iterator> lookup_;
+    size_t budget_;
+    size_t memoryUsage_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+} // namespace video_analyzer
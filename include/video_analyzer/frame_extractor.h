@@ -1,7 +1,11 @@
 #pragma once
 
+#include "video_analyzer/frame_cache.h"
+#include "video_analyzer/keyframe_index.h"
+#include <atomic>
 #include <string>
 #include <memory>
+#include <future>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -11,17 +15,30 @@ extern "C" {
 namespace video_analyzer {
 
 /**
- * @brief Simple frame extractor for GUI display
+ * @brief Frame extractor for GUI display
+ * 
+ * Random access starts decoding at the keyframe preceding the requested
+ * frame, found in a KeyframeIndex that is built in the background while
+ * the first frames are decoded sequentially. Every decoded frame goes into
+ * an LRU FrameCache, so stepping backwards decodes each GOP once and then
+ * serves the remaining frames from the cache.
  */
 class FrameExtractor {
 public:
-    explicit FrameExtractor(const std::string& filepath);
+    /**
+     * @brief Open a video for frame extraction
+     * 
+     * @param filepath Path to video file
+     * @param cache_budget Memory budget of the decoded frame cache in bytes
+     */
+    explicit FrameExtractor(const std::string& filepath,
+                            size_t cache_budget = FrameCache::kDefaultBudget);
     ~FrameExtractor();
     
     /**
      * @brief Seek to specific frame number
      * 
-     * @param frame_number Frame number (0-based)
+     * @param frame_number Frame number (0-based, display order)
      * @return AVFrame* Frame data (owned by extractor, valid until next call)
      */
     AVFrame* getFrame(int frame_number);
@@ -30,6 +47,13 @@ public:
     int getHeight() const { return height_; }
     int getFrameCount() const { return frame_count_; }
     
+    /**
+     * @brief Check whether the keyframe index is available yet
+     */
+    bool hasKeyframeIndex() const { return index_ != nullptr; }
+    
+    const FrameCache& getCache() const { return cache_; }
+
 private:
     AVFormatContext* format_ctx_ = nullptr;
     AVCodecContext* codec_ctx_ = nullptr;
@@ -40,9 +64,24 @@ private:
     int width_ = 0;
     int height_ = 0;
     int frame_count_ = 0;
-    int current_frame_ = -1;
+    int decoded_frame_ = -1;  // Last frame produced by the decoder since the last seek
+    
+    // Keyframe index, built on a background thread; the destructor sets
+    // index_cancelled_ so it does not wait for a full scan
+    std::atomic<bool> index_cancelled_{false};
+    std::future<KeyframeIndex> index_future_;
+    std::unique_ptr<KeyframeIndex> index_;
+    
+    FrameCache cache_;
     
+    // Take over the keyframe index once it is built
+    void acquireIndex();
+    
+    void seekToKeyframe(int keyframe, int64_t timestamp);
     bool decodeToFrame(int target_frame);
+    
+    // Receive the next decoded frame into frame_, reading packets as needed
+    bool receiveFrame();
 };
 
 } // namespace video_analyzer
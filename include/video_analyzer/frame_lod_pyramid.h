@@ -0,0 +1,119 @@
+#pragma once
+
+#include "data_models.h"
+#include <cstdint>
+#include <vector>
+
+namespace video_analyzer {
+
+class ThreadPool;
+
+/**
+ * @brief Min/max/sum summary of a run of consecutive frames
+ */
+struct FrameLodBucket {
+    uint32_t count = 0;        // Frames summarized
+    int minSize = 0;           // Smallest frame size in bytes
+    int maxSize = 0;           // Largest frame size in bytes
+    int64_t sumSize = 0;       // Total size in bytes
+    int minQP = 0;             // Lowest frame QP
+    int maxQP = 0;             // Highest frame QP
+    int64_t sumQP = 0;         // Sum of frame QPs
+    uint32_t iFrames = 0;      // Frames per type
+    uint32_t pFrames = 0;
+    uint32_t bFrames = 0;
+    bool hasKeyFrame = false;  // Whether any frame is a keyframe
+    
+    /**
+     * @brief Summary of a single frame
+     */
+    static FrameLodBucket fromFrame(const FrameInfo& frame);
+    
+    /**
+     * @brief Extend this summary by another one
+     */
+    void merge(const FrameLodBucket& other);
+    
+    double averageSize() const;
+    double averageQP() const;
+    
+    /**
+     * @brief Type that represents the bucket when drawn as one element
+     *
+     * I-frames win whenever present so GOP starts stay visible when zoomed
+     * out; otherwise the more frequent of P and B.
+     */
+    FrameType dominantType() const;
+};
+
+/**
+ * @brief Level-of-detail pyramid over per-frame size, type and QP
+ *
+ * Level 0 summarizes single frames; each level above halves the node
+ * count, so any frame range is covered by O(log n) nodes. Charts over
+ * millions of frames query one bucket per pixel column instead of
+ * touching every frame on every UI frame.
+ *
+ * update() only summarizes frames appended since the last call and the
+ * O(log n) ancestors they change, so it can be called every UI frame while
+ * analysis is still producing frames.
+ */
+class FrameLodPyramid {
+public:
+    /**
+     * @brief Bring the pyramid in sync with a frame sequence
+     *
+     * Frames beyond the previously seen count are appended; a shorter
+     * sequence triggers a full rebuild. Call clear() when switching to
+     * another video.
+     *
+     * @param frames All frames analyzed so far
+     * @param pool Optional pool used for large batches of new frames
+     */
+    void update(const std::vector<FrameInfo>& frames, ThreadPool* pool = nullptr);
+    
+    /**
+     * @brief Remove all frames
+     */
+    void clear();
+    
+    /**
+     * @brief Number of frames summarized
+     */
+    size_t size() const { return frameCount_; }
+    
+    bool empty() const { return frameCount_ == 0; }
+    
+    /**
+     * @brief Number of levels (0 when empty)
+     */
+    size_t levelCount() const { return levels_.size(); }
+    
+    /**
+     * @brief Summarize frames [begin, end)
+     *
+     * The range is clamped to the summarized frames.
+     */
+    FrameLodBucket aggregate(size_t begin, size_t end) const;
+    
+    /**
+     * @brief Summarize frames [begin, end) as evenly sized columns
+     *
+     * Column c covers frames [begin + c * n / k, begin + (c + 1) * n / k)
+     * with n = end - begin and k the number of columns returned, which is
+     * min(columns, n) so that no column is empty.
+     *
+     * @param begin First frame
+     * @param end One past the last frame
+     * @param columns Maximum number of columns (typically the pixel width)
+     * @return std::vector<FrameLodBucket> One bucket per column
+     */
+    std::vector<FrameLodBucket> query(size_t begin, size_t end, size_t columns) const;
+
+private:
+    // levels_[k][j] summarizes frames [j * 2^k, (j + 1) * 2^k)
+    std::vector<std::vector<FrameLodBucket>> levels_;
+    size_t frameCount_ = 0;
+};
+
+} // namespace video_analyzer
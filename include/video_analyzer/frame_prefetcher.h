@@ -0,0 +1,135 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace video_analyzer {
+
+class FrameExtractor;
+class FrameRenderer;
+struct YUVColorInfo;
+
+/**
+ * @brief Background decoder that keeps frames ready ahead of playback
+ *
+ * A worker thread decodes the frames cursor, cursor + step,
+ * cursor + 2 * step, ... (or backwards, following the direction in which
+ * the cursor last moved) into a fixed ring of planar YUV 4:2:0 buffers
+ * (see FrameRenderer::convertFrameToYUV). The render
+ * thread only picks up finished buffers, so slow decoding delays playback
+ * instead of blocking the UI.
+ *
+ * The extractor and renderer are used exclusively by the worker thread.
+ * Buffers can be swapped out with take(), which lets the worker decode
+ * straight into memory supplied by the caller, such as mapped pixel
+ * buffer objects.
+ */
+class FramePrefetcher {
+public:
+    static constexpr size_t kDefaultBudget = 256 * 1024 * 1024;
+    static constexpr size_t kMinSlots = 3;
+    static constexpr size_t kMaxSlots = 16;
+    
+    /**
+     * @brief Open a video and start the decode thread
+     *
+     * @param filepath Path to video file
+     * @param width Output width
+     * @param height Output height
+     * @param memory_budget Total size of the frame buffers in bytes; the ring
+     *                      holds between kMinSlots and kMaxSlots frames
+     */
+    FramePrefetcher(const std::string& filepath, int width, int height,
+                    size_t memory_budget = kDefaultBudget);
+    ~FramePrefetcher();
+    
+    // Disable copy
+    FramePrefetcher(const FramePrefetcher&) = delete;
+    FramePrefetcher& operator=(const FramePrefetcher&) = delete;
+    
+    /**
+     * @brief Move the cursor to a frame and return it if it is ready
+     *
+     * @param frame_number Frame to display
+     * @param step Distance between prefetched frames (> 1 when playback
+     *             skips frames)
+     * @param color Receives the color parameters of the frame if ready
+     * @return const uint8_t* Planar YUV data (getBufferSize() bytes), valid
+     *         until the cursor moves again; nullptr while the frame is pending
+     */
+    const uint8_t* acquire(int frame_number, int step = 1, YUVColorInfo* color = nullptr);
+    
+    /**
+     * @brief Move the cursor to a frame and block until it is decoded
+     *
+     * @return const uint8_t* YUV data as for acquire(), or nullptr if the
+     *         frame could not be decoded
+     */
+    const uint8_t* wait(int frame_number, int step = 1, YUVColorInfo* color = nullptr);
+    
+    /**
+     * @brief Take a ready frame's buffer, giving the slot another one
+     *
+     * The slot keeps its frame number so the frame is not decoded again
+     * while it stays in the window; wait() on it decodes it anew.
+     *
+     * @param frame_number Ready frame, typically the one just acquired
+     * @param replacement Buffer of getBufferSize() bytes for the slot; it
+     *                    must stay valid while the prefetcher exists
+     * @return uint8_t* The frame's data, now owned by the caller (buffers
+     *         allocated by the prefetcher stay valid while it exists), or
+     *         nullptr if the frame is not ready
+     */
+    uint8_t* take(int frame_number, uint8_t* replacement);
+    
+    /**
+     * @brief Check whether a frame in the window failed to decode
+     */
+    bool isFailed(int frame_number) const;
+    
+    size_t getSlotCount() const { return slots_.size(); }
+    size_t getBufferSize() const { return buffer_size_; }
+
+private:
+    enum class SlotState { Empty, Decoding, Ready, Failed, Taken };
+    
+    struct Slot {
+        int frame_number = -1;
+        SlotState state = SlotState::Empty;
+        uint8_t* data = nullptr;
+        bool full_range = false;
+        bool bt709 = false;
+    };
+    
+    void run();
+    
+    // Requires mutex_
+    void moveCursor(int frame_number, int step);
+    bool inWindow(int frame_number) const;
+    Slot* findSlot(int frame_number);
+    const Slot* findSlot(int frame_number) const;
+    const uint8_t* readySlotData(const Slot* slot, YUVColorInfo* color) const;
+    
+    std::unique_ptr<FrameExtractor> extractor_;
+    std::unique_ptr<FrameRenderer> renderer_;
+    size_t buffer_size_ = 0;
+    std::vector<std::vector<uint8_t>> storage_;  // Initial slot buffers
+    
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;   // Cursor moved or stopping
+    std::condition_variable ready_cv_;  // A slot finished decoding
+    std::vector<Slot> slots_;
+    int cursor_ = 0;
+    int stride_ = 1;                    // Signed step between window frames
+    int frame_count_ = 0;
+    bool stop_ = false;
+    
+    std::thread worker_;
+};
+
+} // namespace video_analyzer
@@ -13,7 +13,15 @@ extern "C" {
 namespace video_analyzer {
 
 /**
- * @brief Helper class to render video frames to RGB buffer
+ * @brief How the display shader maps YUV samples to RGB
+ */
+struct YUVColorInfo {
+    bool full_range = false;  // 0-255 luma (JPEG) instead of 16-235
+    bool bt709 = false;       // BT.709 matrix instead of BT.601
+};
+
+/**
+ * @brief Helper class to render video frames to RGB or planar YUV buffers
  */
 class FrameRenderer {
 public:
@@ -29,15 +37,41 @@ public:
      */
     bool convertFrameToRGB(AVFrame* frame, uint8_t* rgb_buffer);
     
+    /**
+     * @brief Copy a frame into a planar YUV 4:2:0 buffer for GPU conversion
+     * 
+     * The Y plane (width * height) is followed by the U and V planes
+     * (getChromaWidth() * getChromaHeight() each), all tightly packed.
+     * 8-bit 4:2:0 frames are copied plane by plane; other formats are
+     * converted with swscale first.
+     * 
+     * @param frame AVFrame to convert
+     * @param yuv_buffer Output buffer (must be getYUVBufferSize() bytes)
+     * @param color Receives the range and matrix of the output samples
+     * @return true if successful
+     */
+    bool convertFrameToYUV(AVFrame* frame, uint8_t* yuv_buffer, YUVColorInfo* color);
+    
     /**
      * @brief Get RGB buffer size
      */
     size_t getRGBBufferSize() const { return width_ * height_ * 3; }
     
+    /**
+     * @brief Get planar YUV 4:2:0 buffer size
+     */
+    size_t getYUVBufferSize() const {
+        return static_cast<size_t>(width_) * height_ + 2 * static_cast<size_t>(getChromaWidth()) * getChromaHeight();
+    }
+    
+    int getChromaWidth() const { return (width_ + 1) / 2; }
+    int getChromaHeight() const { return (height_ + 1) / 2; }
+
 private:
     int width_;
     int height_;
     SwsContext* sws_context_ = nullptr;
+    SwsContext* yuv_sws_context_ = nullptr;  // For frames that are not 8-bit 4:2:0
     AVFrame* rgb_frame_ = nullptr;
 };
 
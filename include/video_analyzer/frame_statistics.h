@@ -1,6 +1,7 @@
 #pragma once
 
 #include "data_models.h"
+#include "analysis_pipeline.h"
 #include <vector>
 
 namespace video_analyzer {
@@ -26,4 +27,34 @@ struct FrameStatistics {
     static FrameStatistics compute(const std::vector<FrameInfo>& frames);
 };
 
+/**
+ * @brief Incremental FrameStatistics computation, usable as a pipeline sink
+ */
+class FrameStatisticsAccumulator : public FrameSink {
+public:
+    /**
+     * @brief Add a single frame to the statistics
+     */
+    void add(const FrameInfo& frame);
+    
+    /**
+     * @brief Reset all accumulated values
+     */
+    void clear();
+    
+    /**
+     * @brief Get statistics of all frames added so far
+     */
+    FrameStatistics getStatistics() const;
+    
+    // FrameSink interface
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    
+private:
+    FrameStatistics stats_;
+    int64_t totalSize_ = 0;
+    int64_t totalQP_ = 0;
+};
+
 } // namespace video_analyzer
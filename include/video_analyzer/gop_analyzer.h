@@ -1,6 +1,7 @@
 #pragma once
 
 #include "video_decoder.h"
+#include "analysis_pipeline.h"
 #include "data_models.h"
 #include <vector>
 
@@ -8,8 +9,11 @@ namespace video_analyzer {
 
 /**
  * @brief Analyzer for GOP (Group of Pictures) structure
+ *
+ * Can be used standalone via analyze() or registered as a sink in an
+ * AnalysisPipeline, in which case GOP boundaries are detected incrementally.
  */
-class GOPAnalyzer {
+class GOPAnalyzer : public FrameSink {
 public:
     /**
      * @brief Construct a GOPAnalyzer
@@ -21,10 +25,22 @@ public:
     /**
      * @brief Analyze GOP structure
      * 
+     * Decodes the whole stream from the beginning.
+     * 
      * @return std::vector<GOPInfo> List of GOP information
      */
     std::vector<GOPInfo> analyze();
     
+    // FrameSink interface
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    void end() override;
+    
+    /**
+     * @brief Get GOPs detected by the last analysis
+     */
+    const std::vector<GOPInfo>& getGOPs() const { return gops_; }
+    
     /**
      * @brief Get average GOP length
      */
@@ -43,8 +59,11 @@ public:
 private:
     VideoDecoder& decoder_;
     std::vector<GOPInfo> gops_;
+    GOPInfo currentGop_;
+    bool hasCurrentGop_ = false;
     
-    void detectGOPBoundaries(const std::vector<FrameInfo>& frames);
+    void startGOP(const FrameInfo& frame);
+    void closeGOP();
 };
 
 } // namespace video_analyzer
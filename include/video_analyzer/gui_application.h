@@ -9,9 +9,14 @@
 #endif
 
 #include <GLFW/glfw3.h>
+#include <atomic>
+#include <future>
 #include <memory>
 #include <string>
 #include "video_analyzer/video_analyzer.h"
+#include "video_analyzer/analysis_cache.h"
+#include "video_analyzer/frame_lod_pyramid.h"
+#include "video_analyzer/motion_heatmap.h"
 
 namespace video_analyzer {
 
@@ -44,14 +49,38 @@ private:
     void renderCharts();
     void renderControls();
     
+    // Merge background analysis results; sets up the video output once the
+    // stream is open
+    void pollAnalysis();
+    void setupVideoOutput();
+    
+    // Bring the chart pyramid up to date with the analyzed frames
+    void updateFrameLod();
+    
+    // Motion heatmap overlay: a background decode builds the heatmap of
+    // every GOP, the overlay shows the one of the current frame's GOP
+    void startMotionAnalysis();
+    void cancelMotionAnalysis();
+    void pollMotionAnalysis();
+    void updateMotionHeatmap();
+    void renderMotionHeatmap(float origin_x, float origin_y, float display_w, float display_h,
+                             bool mirror_x, bool mirror_y);
+    void exportMotionHeatmaps(const std::string& path);
+    
     // Video frame rendering
     void updateVideoTexture();
+    bool presentFrame(int frame_number);
+    void uploadFrame(int frame_number, const uint8_t* yuv, const struct YUVColorInfo& color);
+    uint8_t* acquireFrameBuffer();
+    void releaseFrameBuffer(uint8_t* buffer);
+    int playbackStep() const;
     void createVideoTexture();
     void deleteVideoTexture();
 
     GLFWwindow* window_ = nullptr;
     std::unique_ptr<VideoAnalyzer> analyzer_;
     std::string current_video_path_;
+    AnalysisCache analysis_cache_;  // Reopening an unchanged video skips decoding
     
     // Playback state
     bool is_playing_ = false;
@@ -60,14 +89,31 @@ private:
     double last_frame_time_ = 0.0;
     
     // Video texture
-    GLuint video_texture_ = 0;
+    std::unique_ptr<class VideoTexture> video_texture_;
     int video_width_ = 0;
     int video_height_ = 0;
     
-    // Video frame extraction and rendering
-    std::unique_ptr<class FrameExtractor> frame_extractor_;
-    std::unique_ptr<class FrameRenderer> frame_renderer_;
-    std::vector<uint8_t> rgb_buffer_;
+    // Client-memory replacements for FramePrefetcher::take() when no pixel
+    // buffer can be mapped; slots may hold them, so they outlive the prefetcher
+    std::vector<std::unique_ptr<uint8_t[]>> frame_buffers_;
+    std::vector<uint8_t*> free_frame_buffers_;
+    
+    // Video frames decoded and converted ahead of playback
+    std::unique_ptr<class FramePrefetcher> frame_prefetcher_;
+    bool video_output_ready_ = false;
+    
+    // Per-pixel-column chart data for long videos
+    FrameLodPyramid frame_lod_;
+    std::unique_ptr<ThreadPool> lod_pool_;  // Created for large batches of frames
+    
+    // Motion heatmap state
+    std::unique_ptr<ThreadPool> motion_pool_;  // Fills partial grids; outlives the jobs below
+    std::future<std::vector<MotionHeatmap>> motion_future_;
+    std::shared_ptr<std::atomic<bool>> motion_cancel_;  // Stops motion_future_'s decode
+    std::vector<std::future<std::vector<MotionHeatmap>>> cancelled_motion_jobs_;  // Finishing their current frame
+    std::vector<MotionHeatmap> motion_heatmaps_;  // One per GOP, ordered by startPts
+    int motion_heatmap_gop_ = -1;           // Index of the heatmap shown
+    bool show_motion_heatmap_ = false;
     
     // Zoom and scroll state
     float zoom_level_ = 1.0f;        // 1.0 = show all frames, 2.0 = show half, etc.
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+namespace video_analyzer {
+
+/**
+ * @brief A keyframe (random access point) of the video stream
+ */
+struct KeyframeEntry {
+    int64_t pts;           // Presentation timestamp
+    int64_t dts;           // Decode timestamp (PTS if the container has none)
+    int64_t pos;           // Byte position in the input (-1 if unknown)
+    size_t frameNumber;    // Display-order frame number
+};
+
+/**
+ * @brief Index of keyframes and frame timestamps of a video file
+ * 
+ * Built from a single demux pass (no decoding). Maps between display-order
+ * frame numbers and PTS, and finds the keyframe to start decoding from.
+ */
+class KeyframeIndex {
+public:
+    /**
+     * @brief Build the index by scanning all packets of the first video stream
+     * 
+     * @param filePath Path to the video file
+     * @param cancel Optional flag; setting it aborts the scan (also while
+     *               the demuxer is blocked on I/O)
+     * @return KeyframeIndex Index of the file
+     * @throws FFmpegError if the file cannot be opened or read, or the scan was cancelled
+     */
+    static KeyframeIndex build(const std::string& filePath, const std::atomic<bool>* cancel = nullptr);
+    
+    /**
+     * @brief Get keyframes in presentation order
+     */
+    const std::vector<KeyframeEntry>& getKeyframes() const { return keyframes_; }
+    
+    /**
+     * @brief Get PTS of all frames in presentation order
+     */
+    const std::vector<int64_t>& getFramePts() const { return framePts_; }
+    
+    /**
+     * @brief Get total number of frames
+     */
+    size_t getFrameCount() const { return framePts_.size(); }
+    
+    /**
+     * @brief Get the stream time base in seconds per PTS tick
+     */
+    double getTimeBase() const { return timeBase_; }
+    
+    /**
+     * @brief Find the display-order frame number of a PTS
+     * 
+     * @param pts Presentation timestamp
+     * @return std::optional<size_t> Frame number, or nullopt if no frame has this PTS
+     */
+    std::optional<size_t> findFrameNumber(int64_t pts) const;
+    
+    /**
+     * @brief Find the last keyframe at or before a frame
+     * 
+     * @param frameNumber Display-order frame number
+     * @return const KeyframeEntry* Keyframe to start decoding from, or nullptr if none precedes the frame
+     */
+    const KeyframeEntry* findKeyframeForFrame(size_t frameNumber) const;
+
+private:
+    std::vector<KeyframeEntry> keyframes_;
+    std::vector<int64_t> framePts_;
+    double timeBase_ = 0.0;
+};
+
+} // namespace video_analyzer
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace video_analyzer {
+
+/**
+ * @brief Lock-free histogram of latencies with power-of-two buckets
+ *
+ * Bucket 0 counts latencies below 1 us; bucket i counts [2^(i-1), 2^i) us.
+ * One thread records while others read; readers may observe a sample in
+ * count() slightly before it shows up in the buckets.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t kBucketCount = 32;
+    
+    LatencyHistogram() = default;
+    
+    // Disable copy
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    
+    /**
+     * @brief Record one latency sample (negative values count as zero)
+     */
+    void record(std::chrono::nanoseconds latency);
+    
+    /**
+     * @brief Remove all samples
+     */
+    void reset();
+    
+    uint64_t count() const;
+    
+    /**
+     * @brief Mean latency in microseconds
+     */
+    double mean() const;
+    
+    /**
+     * @brief Maximum latency in microseconds
+     */
+    double max() const;
+    
+    /**
+     * @brief Approximate percentile latency in microseconds
+     *
+     * @param percentile Percentile in [0, 100]
+     * @return double Upper bound of the bucket holding the percentile (0 if empty)
+     */
+    double percentile(double percentile) const;
+    
+    /**
+     * @brief Number of samples in a bucket
+     */
+    uint64_t bucketCount(size_t bucket) const;
+    
+    /**
+     * @brief Upper bound of a bucket in microseconds
+     */
+    static double bucketUpperBound(size_t bucket);
+    
+    /**
+     * @brief Summary (count, mean, p50/p90/p99, max) and non-empty buckets
+     */
+    nlohmann::json toJson() const;
+
+private:
+    static size_t bucketIndex(uint64_t micros);
+    
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> totalNanos_{0};
+    std::atomic<uint64_t> maxNanos_{0};
+};
+
+} // namespace video_analyzer
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Forward declarations for FFmpeg types
+struct AVFrame;
+
+namespace video_analyzer {
+
+/**
+ * @brief Block-averaged copy of a luma plane
+ *
+ * Each pixel is the rounded mean of an 8x8 block of the source plane;
+ * partial blocks at the right and bottom edges are dropped.
+ */
+struct LumaThumbnail {
+    static constexpr int kBlockSize = 8;
+    
+    int width = 0;                 // Blocks per row
+    int height = 0;                // Block rows
+    std::vector<uint8_t> pixels;   // Row-major block means (width * height)
+    
+    bool empty() const { return pixels.empty(); }
+};
+
+/**
+ * @brief Number of bins of a luma histogram (4 luma levels per bin)
+ */
+constexpr int kLumaHistogramBins = 64;
+
+/**
+ * @brief Downscale an 8-bit luma plane by 8x8 block averaging
+ *
+ * Block sums use SAD-against-zero instructions (AVX2 when the CPU supports
+ * it, otherwise SSE2, or NEON on ARM), so a 4K plane is reduced at memory
+ * bandwidth.
+ *
+ * @param plane First row of the plane
+ * @param linesize Bytes between rows
+ * @param width Plane width in pixels
+ * @param height Plane height in pixels
+ * @param thumbnail Receives the block means (storage is reused)
+ */
+void downscaleLuma(const uint8_t* plane, int linesize, int width, int height,
+                   LumaThumbnail& thumbnail);
+
+/**
+ * @brief Downscale the luma plane of a decoded frame
+ *
+ * @param frame Decoded frame
+ * @param thumbnail Receives the block means
+ * @return true if the frame has an 8-bit luma plane of at least one block;
+ *         false for other pixel formats (thumbnail is cleared)
+ */
+bool downscaleLuma(const AVFrame* frame, LumaThumbnail& thumbnail);
+
+/**
+ * @brief Sum of absolute differences of two byte arrays
+ */
+uint64_t sumAbsoluteDifferences(const uint8_t* a, const uint8_t* b, size_t count);
+
+/**
+ * @brief Histogram of luma values into kLumaHistogramBins bins
+ *
+ * Counting uses four interleaved sub-histograms so consecutive equal
+ * values do not serialize on the same counter.
+ *
+ * @param pixels Luma values
+ * @param count Number of values
+ * @param bins Output, kLumaHistogramBins counters (overwritten)
+ */
+void lumaHistogram(const uint8_t* pixels, size_t count, uint32_t* bins);
+
+/**
+ * @brief Chi-square distance of two histograms
+ *
+ * Both histograms are normalized to unit mass first, which bounds the
+ * result to [0, 1]: 0 for identical distributions, 1 for disjoint ones.
+ *
+ * @param a First histogram
+ * @param b Second histogram
+ * @param binCount Number of bins
+ * @return double Distance in [0, 1]
+ */
+double chiSquareDistance(const uint32_t* a, const uint32_t* b, int binCount);
+
+/**
+ * @brief Name of the instruction set used by the kernels
+ *
+ * @return const char* "avx2", "sse2", "neon" or "scalar"
+ */
+const char* lumaKernelName();
+
+} // namespace video_analyzer
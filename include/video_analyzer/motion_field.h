@@ -0,0 +1,145 @@
+#pragma once
+
+#include "data_models.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Forward declarations for FFmpeg types
+struct AVFrame;
+
+namespace video_analyzer {
+
+/**
+ * @brief Motion vectors of a frame in structure-of-arrays layout
+ *
+ * Each vector takes 10 bytes instead of the 32 of a MotionVector, and the
+ * component arrays can be processed in SIMD batches. Positions are kept
+ * explicitly because codecs mix partition sizes within a frame (and
+ * B-frames carry two vectors per block), so blocks don't form a regular
+ * grid. Components are clamped to +-32767.
+ */
+struct MotionField {
+    int64_t pts = 0;                // Presentation timestamp
+    int motionScale = 1;            // Motion units per pixel (4 = quarter-pel)
+    std::vector<int16_t> x;         // Block center in the current frame (pixels)
+    std::vector<int16_t> y;
+    std::vector<int16_t> dx;        // Motion in 1/motionScale pixels
+    std::vector<int16_t> dy;
+    std::vector<uint8_t> width;     // Block size in pixels
+    std::vector<uint8_t> height;
+    
+    size_t size() const { return dx.size(); }
+    bool empty() const { return dx.empty(); }
+    
+    /**
+     * @brief Bytes used by the vector arrays
+     */
+    size_t memoryUsage() const;
+};
+
+/**
+ * @brief Direction octants, counter-clockwise from +x with +y as north
+ */
+enum class MotionOctant : uint8_t {
+    E, NE, N, NW, W, SW, S, SE
+};
+
+constexpr int kMotionOctantCount = 8;
+
+/**
+ * @brief Short name of an octant ("E", "NE", ...)
+ */
+const char* motionOctantName(MotionOctant octant);
+
+/**
+ * @brief Mergeable summary of motion vector magnitudes and directions
+ *
+ * Accumulators are built per frame (independently, so frames can be
+ * summarized in parallel) and merged into GOP or whole-file statistics
+ * without revisiting any vector. Vectors below kStaticThreshold count as
+ * static and have no direction; vectors above kHighMotionThreshold count
+ * as high motion.
+ */
+struct MotionAccumulator {
+    static constexpr float kStaticThreshold = 1.0f;
+    static constexpr float kHighMotionThreshold = 10.0f;
+    
+    uint64_t count = 0;                         // Vectors summarized
+    double sumMagnitude = 0.0;                  // Sum of magnitudes
+    float minMagnitude = 0.0f;                  // Smallest magnitude
+    float maxMagnitude = 0.0f;                  // Largest magnitude
+    uint64_t staticCount = 0;                   // Vectors below kStaticThreshold
+    uint64_t highMotionCount = 0;               // Vectors above kHighMotionThreshold
+    uint64_t octants[kMotionOctantCount] = {};  // Non-static vectors per MotionOctant
+    
+    /**
+     * @brief Summary of a motion field (batched SIMD kernels)
+     */
+    static MotionAccumulator fromField(const MotionField& field);
+    
+    /**
+     * @brief Summary of per-vector records, using their magnitude and direction
+     */
+    static MotionAccumulator fromVectors(const std::vector<MotionVector>& vectors);
+    
+    /**
+     * @brief Extend this summary by another one
+     */
+    void merge(const MotionAccumulator& other);
+    
+    double averageMagnitude() const;
+    
+    /**
+     * @brief Convert to MotionStatistics (direction names as keys)
+     */
+    MotionStatistics toStatistics() const;
+};
+
+/**
+ * @brief Compute vector magnitudes in batches
+ *
+ * Uses SSE2 on x86-64 and NEON on AArch64; results are identical to
+ * sqrtf(dx * dx + dy * dy) for components within +-32767.
+ *
+ * @param dx Horizontal components
+ * @param dy Vertical components
+ * @param count Number of vectors
+ * @param magnitudes Output, count values
+ */
+void motionMagnitudes(const int16_t* dx, const int16_t* dy, size_t count, float* magnitudes);
+
+/**
+ * @brief Classify vector directions into octants without atan2
+ *
+ * The octant boundaries at 22.5 degrees are tested as
+ * |minor| <= tan(22.5) * |major| with tan(22.5) approximated by 408/985
+ * (error 4e-7) in integer arithmetic, so all code paths agree exactly.
+ * Zero vectors are classified as E.
+ *
+ * @param dx Horizontal components (within +-32767)
+ * @param dy Vertical components (within +-32767)
+ * @param count Number of vectors
+ * @param octants Output, count MotionOctant values
+ */
+void motionOctants(const int16_t* dx, const int16_t* dy, size_t count, uint8_t* octants);
+
+/**
+ * @brief Extract the motion vectors of a frame's AV_FRAME_DATA_MOTION_VECTORS side data
+ *
+ * Requires the decoder to be opened with AV_CODEC_EXPORT_DATA_MVS.
+ *
+ * @param frame Decoded frame
+ * @return MotionField Vectors of the frame (empty if it carries none, e.g. I-frames)
+ */
+MotionField extractMotionField(const AVFrame* frame);
+
+/**
+ * @brief Convert a motion field to per-vector MotionVector records
+ *
+ * @param field Motion field
+ * @return MotionVectorData Vectors with magnitude and direction filled in
+ */
+MotionVectorData toMotionVectorData(const MotionField& field);
+
+} // namespace video_analyzer
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "analysis_pipeline.h"
+#include "motion_field.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace video_analyzer {
+
+class ThreadPool;
+
+/**
+ * @brief Mean motion magnitude per block over a run of frames
+ *
+ * The frame is divided into a grid of blockSize x blockSize cells. Each
+ * vector adds its magnitude (in pixels) weighted by the area its partition
+ * covers in a cell, so partitions larger or smaller than a cell and
+ * B-frames' second vectors are accounted for. Memory depends only on the
+ * grid size; heatmaps of the same grid can be merged.
+ */
+struct MotionHeatmap {
+    static constexpr int kDefaultBlockSize = 16;
+    
+    int blockSize = kDefaultBlockSize;  // Cell size in pixels
+    int columns = 0;                    // Cells per row
+    int rows = 0;                       // Cell rows
+    int frameCount = 0;                 // Frames accumulated
+    int64_t startPts = 0;               // PTS of the first frame covered
+    int64_t endPts = 0;                 // PTS of the last frame covered
+    std::vector<double> weightedSum;    // Sum of magnitude x covered area per cell
+    std::vector<uint64_t> coverage;     // Covered area in pixels per cell
+    
+    /**
+     * @brief Empty heatmap covering a frame
+     *
+     * @param width Frame width in pixels
+     * @param height Frame height in pixels
+     * @param blockSize Cell size in pixels
+     */
+    static MotionHeatmap forFrame(int width, int height, int blockSize = kDefaultBlockSize);
+    
+    bool empty() const { return frameCount == 0; }
+    
+    /**
+     * @brief Add the vectors of a frame
+     */
+    void accumulate(const MotionField& field);
+    
+    /**
+     * @brief Add another heatmap of the same grid
+     *
+     * @throws std::runtime_error if the grids differ
+     */
+    void merge(const MotionHeatmap& other);
+    
+    /**
+     * @brief Mean magnitude in pixels of a cell (0 where no vector landed)
+     */
+    float mean(int column, int row) const;
+    
+    /**
+     * @brief Mean magnitudes of all cells, row by row
+     */
+    std::vector<float> means() const;
+    
+    /**
+     * @brief Largest cell mean, for normalizing colors
+     */
+    float maxMean() const;
+    
+    nlohmann::json toJson() const;
+};
+
+/**
+ * @brief Sink that builds one motion heatmap per GOP during a decode
+ *
+ * GOPs start at every I-frame keyframe, as in GOPAnalyzer. Each motion
+ * field is accumulated and dropped; fields are never kept beyond the
+ * current batch. With a pool, fields are collected into batches that the
+ * workers accumulate into their own partial grids (no cell is shared
+ * between tasks); the partial grids are merged into the GOP's heatmap at
+ * each GOP boundary and cleared. Memory is bounded by the thread count
+ * times the grid size plus one batch of fields, however long the video.
+ */
+class MotionHeatmapSink : public FrameSink {
+public:
+    /**
+     * @brief Construct a sink
+     *
+     * @param pool Pool whose workers fill partial grids (not owned, nullptr = serial)
+     * @param blockSize Cell size in pixels
+     */
+    explicit MotionHeatmapSink(ThreadPool* pool = nullptr,
+                               int blockSize = MotionHeatmap::kDefaultBlockSize);
+    
+    // FrameSink interface
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    void end() override;
+    bool needsMotionVectors() const override { return true; }
+    
+    /**
+     * @brief Add a frame and its motion field (what consume() does with the
+     *        decoder's field)
+     *
+     * @param frame Frame information, in presentation order
+     * @param field Motion field of the frame, if it has vectors
+     */
+    void addFrame(const FrameInfo& frame, std::optional<MotionField> field);
+    
+    /**
+     * @brief Heatmaps of the completed GOPs, ordered by startPts
+     */
+    const std::vector<MotionHeatmap>& getHeatmaps() const { return heatmaps_; }
+    
+    /**
+     * @brief Move the heatmaps out of the sink
+     */
+    std::vector<MotionHeatmap> takeHeatmaps();
+
+private:
+    // Accumulate the pending batch into the partial grids
+    void flushBatch();
+    // Merge the partial grids into the current GOP's heatmap and store it
+    void closeGOP();
+    
+    ThreadPool* pool_;
+    int blockSize_;
+    MotionHeatmap emptyGrid_;               // Cleared grid of the stream's size
+    MotionHeatmap current_;                 // GOP being decoded
+    bool hasCurrentGop_ = false;
+    std::vector<MotionHeatmap> partials_;   // One grid per worker (empty when serial)
+    std::vector<MotionField> batch_;        // Fields not yet accumulated
+    std::vector<MotionHeatmap> heatmaps_;   // Completed GOPs
+};
+
+} // namespace video_analyzer
@@ -1,20 +1,32 @@
 #pragma once
 
 #include "video_decoder.h"
+#include "analysis_pipeline.h"
 #include "data_models.h"
 #include "gop_analyzer.h"
+#include "motion_field.h"
 #include <vector>
 #include <memory>
 
 namespace video_analyzer {
 
+class ThreadPool;
+
 /**
  * @brief Motion vector analyzer
  * 
  * Analyzes motion vectors from video frames to compute statistics
- * and identify motion patterns.
+ * and identify motion patterns. Can be registered as a sink in an
+ * AnalysisPipeline to collect motion vectors during a shared decode.
+ * 
+ * Vectors are collected as MotionFields; the MotionVectorData overloads
+ * are kept for callers that need per-vector records.
+ * 
+ * Statistics are built as one MotionAccumulator per frame, optionally in
+ * parallel, and merged per GOP or for the whole file; no vectors are
+ * copied or visited twice.
  */
-class MotionVectorAnalyzer {
+class MotionVectorAnalyzer : public FrameSink {
 public:
     /**
      * @brief Construct a MotionVectorAnalyzer
@@ -23,6 +35,13 @@ public:
      */
     explicit MotionVectorAnalyzer(VideoDecoder& decoder);
     
+    /**
+     * @brief Summarize frames in parallel on a pool
+     * 
+     * @param pool Pool used for large inputs (not owned, nullptr = serial)
+     */
+    void setThreadPool(ThreadPool* pool) { pool_ = pool; }
+    
     /**
      * @brief Extract motion vectors from all frames
      * 
@@ -30,6 +49,25 @@ public:
      */
     std::vector<MotionVectorData> extractMotionVectors();
     
+    // FrameSink interface
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    bool needsMotionVectors() const override { return true; }
+    
+    /**
+     * @brief Get motion fields collected by the last analysis
+     * 
+     * @return const std::vector<MotionField>& Motion field of every frame
+     */
+    const std::vector<MotionField>& getMotionFields() const { return fields_; }
+    
+    /**
+     * @brief Get motion vectors collected by the last analysis as per-vector records
+     * 
+     * @return std::vector<MotionVectorData> Motion vector data for all frames
+     */
+    std::vector<MotionVectorData> getMotionVectorData() const;
+    
     /**
      * @brief Compute statistics from motion vector data
      * 
@@ -58,34 +96,49 @@ public:
         const std::vector<GOPInfo>& gops
     );
     
-private:
-    VideoDecoder& decoder_;
+    /**
+     * @brief Compute statistics from motion fields
+     * 
+     * Magnitudes and direction octants are computed in SIMD batches
+     * (see motionMagnitudes() and motionOctants()).
+     * 
+     * @param fields Motion fields
+     * @return MotionStatistics Computed statistics
+     */
+    MotionStatistics computeStatistics(const std::vector<MotionField>& fields);
     
     /**
-     * @brief Check if a motion vector represents a static region
+     * @brief Summarize each motion field
      * 
-     * @param mv Motion vector
-     * @param threshold Magnitude threshold (default 1.0)
-     * @return true if static
+     * @param fields Motion fields
+     * @return std::vector<MotionAccumulator> One mergeable summary per field
      */
-    bool isStaticRegion(const MotionVector& mv, double threshold = 1.0) const;
+    std::vector<MotionAccumulator> accumulateByFrame(const std::vector<MotionField>& fields) const;
     
     /**
-     * @brief Check if a motion vector represents a high motion region
+     * @brief Aggregate motion fields by frame
      * 
-     * @param mv Motion vector
-     * @param threshold Magnitude threshold (default 10.0)
-     * @return true if high motion
+     * @param fields Motion fields
+     * @return std::vector<MotionStatistics> Statistics for each frame
      */
-    bool isHighMotionRegion(const MotionVector& mv, double threshold = 10.0) const;
+    std::vector<MotionStatistics> aggregateByFrame(const std::vector<MotionField>& fields);
     
     /**
-     * @brief Compute statistics for a single set of motion vectors
+     * @brief Aggregate motion fields by GOP
      * 
-     * @param vectors Motion vectors
-     * @return MotionStatistics Computed statistics
+     * @param fields Motion fields
+     * @param gops GOP information
+     * @return std::vector<MotionStatistics> Statistics for each GOP
      */
-    MotionStatistics computeStatisticsForVectors(const std::vector<MotionVector>& vectors);
+    std::vector<MotionStatistics> aggregateByGOP(
+        const std::vector<MotionField>& fields,
+        const std::vector<GOPInfo>& gops
+    );
+
+private:
+    VideoDecoder& decoder_;
+    std::vector<MotionField> fields_;
+    ThreadPool* pool_ = nullptr;
 };
 
 } // namespace video_analyzer
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "stream_decoder.h"
+#include "data_models.h"
+#include "frame_statistics.h"
+#include "thread_pool.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace video_analyzer {
+
+/**
+ * @brief Options for MultiStreamMonitor
+ */
+struct MonitorOptions {
+    size_t workerThreads = 0;        // Shared decode/analysis workers (0 = hardware threads)
+    size_t demuxThreads = 1;         // Threads multiplexing packet reads across all streams
+    size_t windowFrames = 120;       // Per-stream sliding window of recent frames
+    size_t maxAnomalies = 32;        // Per-stream anomaly history
+    size_t maxQueuedPackets = 64;    // Per-stream packets awaiting decode; more are dropped
+    std::string exportDirectory;     // Per-stream JSON Lines export (empty = disabled)
+};
+
+/**
+ * @brief Snapshot of one monitored stream
+ */
+struct MonitoredStreamStatus {
+    int id = -1;                     // Stream ID returned by addStream()
+    std::string url;                 // Stream URL
+    bool active = false;             // Whether the stream is still being read
+    uint64_t packetsRead = 0;        // Video packets demuxed
+    uint64_t packetsDropped = 0;     // Packets dropped because decoding fell behind
+    uint64_t framesAnalyzed = 0;     // Frames decoded and analyzed
+    uint64_t anomaliesDetected = 0;  // Anomalies detected since the stream was added
+    double lastTimestamp = 0.0;      // Timestamp of the last analyzed frame in seconds
+    bool failed = false;             // Decoding or a callback threw; the stream was stopped
+    std::string error;               // Message of that exception
+    
+    nlohmann::json toJson() const;
+};
+
+/**
+ * @brief Monitors many live streams in one process
+ *
+ * Thread usage does not grow with the number of streams: a few demux
+ * threads read packets from all streams round-robin in non-blocking mode,
+ * and one shared ThreadPool decodes and analyzes them. Each stream's
+ * packets are processed in order by at most one worker at a time, and
+ * each decoder is single-threaded.
+ *
+ * Per-stream state is a fixed-size window, a bounded anomaly history and
+ * an optional export file. When a stream's decoding falls behind, new
+ * packets are dropped up to the next keyframe so demuxing never waits.
+ */
+class MultiStreamMonitor {
+public:
+    using FrameCallback = std::function<void(int streamId, const FrameInfo& frame)>;
+    using AnomalyCallback = std::function<void(int streamId, const Anomaly& anomaly)>;
+    
+    /**
+     * @brief Construct a monitor
+     *
+     * @param options Monitor options
+     */
+    explicit MultiStreamMonitor(const MonitorOptions& options = MonitorOptions{});
+    
+    /**
+     * @brief Destructor - stops monitoring
+     */
+    ~MultiStreamMonitor();
+    
+    // Disable copy
+    MultiStreamMonitor(const MultiStreamMonitor&) = delete;
+    MultiStreamMonitor& operator=(const MultiStreamMonitor&) = delete;
+    
+    /**
+     * @brief Open a stream and add it to the monitor
+     *
+     * May be called while monitoring is running.
+     *
+     * @param url Stream URL (rtmp://, srt://, udp://, file path, ...)
+     * @return int Stream ID
+     * @throws FFmpegError if the stream cannot be opened
+     */
+    int addStream(const std::string& url);
+    
+    /**
+     * @brief Stop monitoring a stream and release it
+     *
+     * @param streamId Stream ID
+     * @return true if the stream existed
+     */
+    bool removeStream(int streamId);
+    
+    /**
+     * @brief Start monitoring all added streams
+     */
+    void start();
+    
+    /**
+     * @brief Stop monitoring
+     */
+    void stop();
+    
+    /**
+     * @brief Wait until every stream has ended and all its frames were analyzed
+     *
+     * Live streams normally never end; this is meant for finite inputs.
+     *
+     * @param timeout Maximum time to wait
+     * @return true if all streams completed
+     */
+    bool waitForCompletion(std::chrono::milliseconds timeout);
+    
+    /**
+     * @brief Get the number of monitored streams
+     */
+    size_t getStreamCount() const;
+    
+    /**
+     * @brief Get the status of all streams, ordered by ID
+     */
+    std::vector<MonitoredStreamStatus> getStatus() const;
+    
+    /**
+     * @brief Get frame statistics of a stream (sliding window)
+     *
+     * @param streamId Stream ID
+     * @param windowSize Window size in seconds
+     * @return FrameStatistics Statistics (empty for unknown streams)
+     */
+    FrameStatistics getFrameStats(int streamId, double windowSize = 5.0) const;
+    
+    /**
+     * @brief Get the recent anomalies of a stream
+     *
+     * @param streamId Stream ID
+     * @return std::vector<Anomaly> Anomalies, oldest first
+     */
+    std::vector<Anomaly> getAnomalies(int streamId) const;
+    
+    /**
+     * @brief Set frame callback (called on worker threads)
+     */
+    void setFrameCallback(FrameCallback callback);
+    
+    /**
+     * @brief Set anomaly callback (called on worker threads)
+     */
+    void setAnomalyCallback(AnomalyCallback callback);
+    
+    /**
+     * @brief Get the number of threads used, independent of the stream count
+     */
+    size_t getThreadCount() const;
+
+private:
+    struct Stream;
+    
+    std::shared_ptr<Stream> findStream(int streamId) const;
+    std::vector<std::shared_ptr<Stream>> snapshotStreams() const;
+    
+    // Demux thread: reads the streams with id % demuxThreads == index
+    void demuxLoop(size_t index);
+    
+    // Queue a packet (or the end of the stream) and schedule processing
+    void enqueue(const std::shared_ptr<Stream>& stream, PacketPtr packet);
+    void requestEnd(const std::shared_ptr<Stream>& stream);
+    void schedule(const std::shared_ptr<Stream>& stream);
+    
+    // Worker task: decode and analyze the stream's queued packets in order.
+    // processPackets() returns true when it yielded with packets left
+    void process(const std::shared_ptr<Stream>& stream);
+    bool processPackets(const std::shared_ptr<Stream>& stream);
+    void analyze(Stream& stream, const FrameInfo& frame);
+    void markCompleted(Stream& stream);
+    void markFailed(Stream& stream, const std::string& error);
+    void notifyCompletion();
+    
+    MonitorOptions options_;
+    std::unique_ptr<ThreadPool> workers_;
+    std::vector<std::thread> demuxThreads_;
+    std::atomic<bool> running_{false};
+    
+    mutable std::mutex streamsMutex_;
+    std::vector<std::shared_ptr<Stream>> streams_;
+    int nextStreamId_ = 0;
+    
+    // Signaled when a stream completes
+    std::mutex completionMutex_;
+    std::condition_variable completionCondition_;
+    
+    FrameCallback frameCallback_;
+    AnomalyCallback anomalyCallback_;
+};
+
+} // namespace video_analyzer
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+// Forward declarations for FFmpeg types
+struct AVFrame;
+
+namespace video_analyzer {
+
+/**
+ * @brief Per-frame quantization parameter summary
+ */
+struct QPStatistics {
+    int average = 0;      // Average QP over all coded blocks
+    int min = 0;          // Minimum block QP
+    int max = 0;          // Maximum block QP
+    int blockCount = 0;   // Number of coded blocks (0 = only frame-level QP available)
+};
+
+/**
+ * @brief Per-block QP map of a frame
+ * 
+ * The map is a regular grid whose cell size is the smallest block size
+ * reported by the decoder (16x16 macroblocks for H.264). Larger blocks
+ * cover several cells.
+ */
+struct QPMap {
+    int cellWidth = 0;              // Cell width in pixels
+    int cellHeight = 0;             // Cell height in pixels
+    int columns = 0;                // Number of cells per row
+    int rows = 0;                   // Number of cell rows
+    std::vector<int16_t> values;    // Row-major QP values (rows * columns)
+};
+
+/**
+ * @brief Reduce block QP deltas to average/min/max
+ * 
+ * The reduction is written as independent min/max/sum lanes so it
+ * auto-vectorizes; sums are flushed to 64 bits every few thousand
+ * elements so the 32-bit lanes never overflow.
+ * 
+ * @param deltas Per-block QP deltas relative to baseQP
+ * @param count Number of blocks
+ * @param baseQP Frame-level QP
+ * @return QPStatistics Reduced statistics (blockCount = count)
+ */
+QPStatistics reduceBlockQP(const int32_t* deltas, size_t count, int baseQP);
+
+/**
+ * @brief Extract QP statistics from a frame's AV_FRAME_DATA_VIDEO_ENC_PARAMS side data
+ * 
+ * Requires the decoder to be opened with AV_CODEC_EXPORT_DATA_VIDEO_ENC_PARAMS.
+ * 
+ * @param frame Decoded frame
+ * @return std::optional<QPStatistics> Statistics, or nullopt if the frame carries no encoding parameters
+ */
+std::optional<QPStatistics> extractQPStatistics(const AVFrame* frame);
+
+/**
+ * @brief Extract the per-block QP map of a frame
+ * 
+ * @param frame Decoded frame
+ * @return std::optional<QPMap> QP map, or nullopt if the frame carries no per-block parameters
+ */
+std::optional<QPMap> extractQPMap(const AVFrame* frame);
+
+} // namespace video_analyzer
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "analysis_pipeline.h"
+#include "data_models.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace video_analyzer {
+
+/**
+ * @brief Output format of a ReportWriter
+ */
+enum class ReportFormat {
+    JSON,   // Report object with streamInfo, frames and trailing summary fields
+    CSV     // One line per frame
+};
+
+/**
+ * @brief Streaming JSON/CSV report writer
+ * 
+ * Writes each frame as soon as it is decoded, formatting numbers with
+ * std::to_chars into a fixed-size buffer that is flushed to the file when
+ * nearly full. Memory use is independent of the number of frames.
+ * 
+ * JSON reports have the same fields as FrameInfo::toJson(); summary fields
+ * that are only known after the last frame (statistics, GOPs) are appended
+ * after the frame array by finish().
+ */
+class ReportWriter : public FrameSink {
+public:
+    /**
+     * @brief Open a report file
+     * 
+     * @param path Output file path
+     * @param format Report format
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    ReportWriter(const std::string& path, ReportFormat format);
+    
+    /**
+     * @brief Destructor - finishes the report if finish() was not called
+     */
+    ~ReportWriter() override;
+    
+    // Disable copy
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+    
+    // FrameSink interface
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    void end() override;
+    
+    /**
+     * @brief Write a single frame
+     * 
+     * @param frame Frame information
+     */
+    void writeFrame(const FrameInfo& frame);
+    
+    /**
+     * @brief Append summary fields and close the report
+     * 
+     * @param summary JSON object whose fields are added after "frames" (ignored for CSV)
+     * @throws std::runtime_error if writing fails
+     */
+    void finish(const nlohmann::json& summary = nlohmann::json::object());
+    
+    /**
+     * @brief Get the number of frames written
+     */
+    size_t getFramesWritten() const { return framesWritten_; }
+    
+private:
+    std::ofstream file_;
+    std::string path_;
+    ReportFormat format_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    size_t framesWritten_ = 0;
+    bool begun_ = false;
+    bool framesClosed_ = false;
+    bool finished_ = false;
+    
+    void ensureCapacity(size_t bytes);
+    void flush();
+    void append(const char* text, size_t length);
+    void append(const char* text);
+    void append(const std::string& text);
+    void appendInt(int64_t value);
+    void appendDouble(double value);
+    void appendFixed(double value, int precision);
+    void appendFrameJson(const FrameInfo& frame);
+    void appendFrameCsv(const FrameInfo& frame);
+};
+
+} // namespace video_analyzer
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "video_decoder.h"
+#include "analysis_pipeline.h"
 #include "data_models.h"
 #include <vector>
 #include <memory>
@@ -19,7 +20,7 @@ struct SceneInfo {
     double startTimestamp;       // Start timestamp in seconds
     double endTimestamp;         // End timestamp in seconds
     int frameCount;              // Number of frames in scene
-    double averageBrightness;    // Average brightness of scene
+    double averageBrightness;    // Average luma (0-255) of scene; average frame size without pixel data
     
     nlohmann::json toJson() const;
 };
@@ -27,9 +28,16 @@ struct SceneInfo {
 /**
  * @brief Scene detection analyzer
  * 
- * Detects scene boundaries using frame difference metrics
+ * Detects scene boundaries using frame difference metrics. Can be used
+ * standalone via analyze() or registered as a sink in an AnalysisPipeline.
+ * 
+ * Each decoded luma plane is reduced to an 8x8 block thumbnail (see
+ * luma_kernels.h); a cut is reported when the average of the thumbnails'
+ * scaled mean absolute difference and their histogram chi-square distance
+ * to the previous frame exceeds the threshold. Decoders in HEADER_SCAN mode
+ * provide no pixels, in which case frame size changes are used instead.
  */
-class SceneDetector {
+class SceneDetector : public FrameSink {
 public:
     /**
      * @brief Construct a SceneDetector
@@ -59,6 +67,18 @@ public:
      */
     std::vector<SceneInfo> analyze();
     
+    // FrameSink interface
+    void begin(const StreamInfo& info) override;
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override;
+    void end() override;
+    
+    /**
+     * @brief Get scenes detected by the last analysis
+     * 
+     * @return const std::vector<SceneInfo>& Detected scenes
+     */
+    const std::vector<SceneInfo>& getScenes() const;
+    
     /**
      * @brief Set scene detection threshold
      * 
@@ -94,6 +114,9 @@ private:
     /**
      * @brief Calculate frame difference using pixel difference
      * 
+     * Mean absolute difference of the frames' luma thumbnails, scaled so that
+     * a change of a quarter of the luma range gives 1.0.
+     * 
      * @param frame1 First frame
      * @param frame2 Second frame
      * @return double Difference metric (0.0-1.0)
@@ -103,6 +126,9 @@ private:
     /**
      * @brief Calculate frame difference using histogram difference
      * 
+     * Chi-square distance of the 64-bin histograms of the frames' luma
+     * thumbnails.
+     * 
      * @param frame1 First frame
      * @param frame2 Second frame
      * @return double Difference metric (0.0-1.0)
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "video_decoder.h"
+#include "keyframe_index.h"
+#include "thread_pool.h"
+#include "data_models.h"
+#include <string>
+#include <vector>
+
+namespace video_analyzer {
+
+/**
+ * @brief A keyframe-aligned range of frames decoded by one decoder instance
+ */
+struct DecodeSegment {
+    int64_t startPts;      // First PTS of the segment (inclusive)
+    int64_t endPts;        // End PTS of the segment (exclusive)
+    int64_t seekTimestamp; // Timestamp to seek to before decoding (stream time base)
+    size_t firstFrame;     // Display-order frame number of the first frame
+    size_t frameCount;     // Number of frames in the segment
+};
+
+/**
+ * @brief Parallel decoder for a single file
+ * 
+ * Builds a keyframe index, splits the file into GOP-aligned segments and
+ * decodes each segment on its own VideoDecoder across a ThreadPool. Each
+ * segment keeps only frames whose PTS falls in its range, so the per-segment
+ * results concatenate into the same presentation-order sequence a
+ * sequential decode produces.
+ */
+class SegmentedDecoder {
+public:
+    /**
+     * @brief Construct a SegmentedDecoder and index the file
+     * 
+     * @param filePath Path to the video file
+     * @param pool Thread pool to decode segments on
+     * @param options Options for each per-segment decoder (single-threaded by default)
+     * @throws FFmpegError if the file cannot be opened or indexed
+     */
+    SegmentedDecoder(const std::string& filePath, ThreadPool& pool,
+                     const DecoderOptions& options = DecoderOptions{1, DecodeMode::FULL_DECODE});
+    
+    /**
+     * @brief Set the number of segments (0 = four per pool thread)
+     * 
+     * @param count Segment count
+     */
+    void setSegmentCount(size_t count);
+    
+    /**
+     * @brief Split the file into GOP-aligned segments of similar frame count
+     * 
+     * @return std::vector<DecodeSegment> Segments in presentation order
+     */
+    std::vector<DecodeSegment> planSegments() const;
+    
+    /**
+     * @brief Decode all segments in parallel
+     * 
+     * @return std::vector<FrameInfo> All frames in presentation order
+     * @throws FFmpegError if any segment fails to decode
+     */
+    std::vector<FrameInfo> decodeAll();
+    
+    /**
+     * @brief Get the keyframe index of the file
+     */
+    const KeyframeIndex& getKeyframeIndex() const { return index_; }
+
+private:
+    std::string filePath_;
+    ThreadPool& pool_;
+    DecoderOptions options_;
+    KeyframeIndex index_;
+    size_t segmentCount_ = 0;
+    
+    std::vector<FrameInfo> decodeSegment(const DecodeSegment& segment) const;
+};
+
+} // namespace video_analyzer
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace video_analyzer {
+
+/**
+ * @brief Fixed-capacity single-writer ring with seqlock snapshots
+ *
+ * Keeps the most recent capacity() values. One thread pushes; any number
+ * of threads take consistent copies of the contents without locking. The
+ * writer never waits for readers: it bumps a sequence counter around each
+ * write, and a reader that observes a concurrent write discards its copy
+ * and retries.
+ *
+ * T must be trivially copyable since readers may copy a slot while it is
+ * being overwritten (such torn copies are detected and discarded).
+ */
+template <typename T>
+class SnapshotRing {
+    static_assert(std::is_trivially_copyable_v<T>, "SnapshotRing requires a trivially copyable type");
+
+public:
+    /**
+     * @brief Construct a ring
+     *
+     * @param capacity Number of most recent values kept (at least 1)
+     */
+    explicit SnapshotRing(size_t capacity)
+        : capacity_(std::max<size_t>(capacity, 1)),
+          slots_(std::make_unique<T[]>(capacity_)) {}
+    
+    // Disable copy
+    SnapshotRing(const SnapshotRing&) = delete;
+    SnapshotRing& operator=(const SnapshotRing&) = delete;
+    
+    /**
+     * @brief Append a value, overwriting the oldest when full (writer thread only)
+     */
+    void push(const T& value) {
+        uint64_t written = written_.load(std::memory_order_relaxed);
+        beginWrite();
+        std::memcpy(static_cast<void*>(&slots_[written % capacity_]), &value, sizeof(T));
+        written_.store(written + 1, std::memory_order_relaxed);
+        endWrite();
+    }
+    
+    /**
+     * @brief Remove all values (writer thread only)
+     */
+    void clear() {
+        beginWrite();
+        written_.store(0, std::memory_order_relaxed);
+        endWrite();
+    }
+    
+    /**
+     * @brief Copy the most recent values, oldest first
+     *
+     * @param out Destination (resized to the number of values copied)
+     * @param maxItems Maximum number of values to copy
+     * @return size_t Number of values copied
+     */
+    size_t snapshot(std::vector<T>& out, size_t maxItems = std::numeric_limits<size_t>::max()) const {
+        for (unsigned attempt = 0;; ++attempt) {
+            uint64_t sequence = sequence_.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                backoff(attempt);
+                continue;
+            }
+            
+            uint64_t written = written_.load(std::memory_order_relaxed);
+            size_t count = static_cast<size_t>(std::min<uint64_t>(written, capacity_));
+            count = std::min(count, maxItems);
+            out.resize(count);
+            
+            // Copy in at most two contiguous runs
+            size_t first = static_cast<size_t>((written - count) % capacity_);
+            size_t headRun = std::min(count, capacity_ - first);
+            std::memcpy(static_cast<void*>(out.data()), &slots_[first], headRun * sizeof(T));
+            std::memcpy(static_cast<void*>(out.data() + headRun), &slots_[0], (count - headRun) * sizeof(T));
+            
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == sequence) {
+                return count;
+            }
+            backoff(attempt);
+        }
+    }
+    
+    /**
+     * @brief Copy all values, oldest first
+     */
+    std::vector<T> snapshot() const {
+        std::vector<T> values;
+        snapshot(values);
+        return values;
+    }
+    
+    /**
+     * @brief Number of values currently held
+     */
+    size_t size() const {
+        return static_cast<size_t>(std::min<uint64_t>(written_.load(std::memory_order_acquire), capacity_));
+    }
+    
+    /**
+     * @brief Total number of values pushed since construction or clear()
+     */
+    uint64_t totalPushed() const {
+        return written_.load(std::memory_order_acquire);
+    }
+    
+    size_t capacity() const { return capacity_; }
+
+private:
+    void beginWrite() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    
+    void endWrite() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    static void backoff(unsigned attempt) {
+        if (attempt >= 16) {
+            std::this_thread::yield();
+        }
+    }
+    
+    const size_t capacity_;
+    std::unique_ptr<T[]> slots_;
+    
+    // Sequence is odd while a write is in progress
+    alignas(64) std::atomic<uint64_t> sequence_{0};
+    std::atomic<uint64_t> written_{0};
+};
+
+} // namespace video_analyzer
@@ -3,22 +3,63 @@
 #include "stream_decoder.h"
 #include "data_models.h"
 #include "frame_statistics.h"
-#include "thread_pool.h"
+#include "snapshot_ring.h"
+#include "bounded_queue.h"
+#include "latency_histogram.h"
+#include "anomaly_detector.h"
 #include <string>
 #include <vector>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <atomic>
 #include <functional>
 #include <fstream>
+#include <cstdint>
 
 namespace video_analyzer {
 
+/**
+ * @brief Queue sizes and overflow policies between the stream analysis stages
+ */
+struct StreamQueueOptions {
+    // Demuxed packets waiting for the decoder. Dropping new packets keeps
+    // the reader draining the network; after a drop the reader skips to the
+    // next keyframe so the decoder never sees a broken reference chain.
+    // DROP_OLDEST evicts the oldest packet together with the queued packets
+    // that depend on it, up to the next keyframe.
+    size_t packetCapacity = 512;
+    OverflowPolicy packetPolicy = OverflowPolicy::DROP_NEWEST;
+    
+    // Decoded frames waiting for analysis. Dropping the oldest keeps the
+    // analysis close to live when callbacks or export fall behind.
+    size_t frameCapacity = 256;
+    OverflowPolicy framePolicy = OverflowPolicy::DROP_OLDEST;
+};
+
+/**
+ * @brief Counters of the stream analysis pipeline
+ */
+struct StreamPipelineStats {
+    uint64_t packetsRead = 0;       // Video packets demuxed
+    uint64_t packetsDropped = 0;    // Packets dropped before decoding
+    uint64_t framesDecoded = 0;     // Frames produced by the decoder
+    uint64_t framesDropped = 0;     // Decoded frames dropped before analysis
+    size_t packetQueueDepth = 0;    // Packets currently queued
+    size_t frameQueueDepth = 0;     // Frames currently queued
+};
+
 /**
  * @brief Real-time stream analyzer
  * 
- * Analyzes streaming video in real-time with anomaly detection
+ * Analyzes streaming video in real-time with anomaly detection.
+ * 
+ * Runs three threads connected by bounded queues: a reader that only
+ * demuxes packets, a decoder, and an analysis stage that runs anomaly
+ * detection, callbacks and export. A slow callback or disk stall fills the
+ * queues and drops data according to StreamQueueOptions instead of
+ * stalling the reader on a live source.
  */
 class StreamAnalyzer {
 public:
@@ -96,16 +137,54 @@ public:
      */
     void enableStreamingExport(const std::string& outputPath);
     
+    /**
+     * @brief Set queue sizes and overflow policies (before start())
+     * 
+     * @param options Queue options
+     */
+    void setQueueOptions(const StreamQueueOptions& options);
+    
+    /**
+     * @brief Get pipeline counters
+     * 
+     * @return StreamPipelineStats Packets and frames read, decoded and dropped
+     */
+    StreamPipelineStats getPipelineStats() const;
+    
+    /**
+     * @brief Get the latency from packet receipt to the end of frame analysis
+     * 
+     * Covers decoding, queueing, anomaly detection, callbacks and export.
+     * 
+     * @return const LatencyHistogram& Histogram updated live by the analysis thread
+     */
+    const LatencyHistogram& getLatencyHistogram() const { return latency_; }
+    
 private:
     std::unique_ptr<StreamDecoder> decoder_;
-    std::unique_ptr<ThreadPool> threadPool_;
     std::atomic<bool> running_{false};
+    std::thread readerThread_;
+    std::thread decodeThread_;
     std::thread analysisThread_;
     
-    // Sliding window data
-    std::deque<FrameInfo> frameWindow_;
+    // Queues between the stages
+    std::unique_ptr<BoundedQueue<PacketPtr>> packetQueue_;
+    std::unique_ptr<BoundedQueue<DecodedFrame>> frameQueue_;
+    
+    // Pipeline counters
+    std::atomic<uint64_t> packetsRead_{0};
+    std::atomic<uint64_t> packetsSkipped_{0};  // Non-keyframes skipped after a drop
+    std::atomic<uint64_t> framesDecoded_{0};
+    LatencyHistogram latency_;
+    
+    // Sliding window of recent frames: written only by the analysis thread,
+    // snapshotted lock-free by the statistics queries
+    static constexpr size_t kMaxWindowFrames = 300;
+    SnapshotRing<FrameInfo> frameWindow_{kMaxWindowFrames};
+    
+    // Recent anomalies (rare writes)
     std::deque<Anomaly> anomalies_;
-    mutable std::mutex dataMutex_;
+    mutable std::mutex anomalyMutex_;
     
     // Callbacks
     FrameCallback frameCallback_;
@@ -115,15 +194,18 @@ private:
     std::ofstream streamingOutput_;
     bool exportEnabled_ = false;
     
-    // Analysis loop
+    // Pipeline stages
+    void readerLoop();
+    void decodeLoop();
     void analysisLoop();
     
-    // Anomaly detection
-    void detectAnomalies(const FrameInfo& frame);
+    // Frames of the last windowSize seconds, oldest first
+    std::vector<FrameInfo> snapshotWindow(double windowSize) const;
     
-    // Previous frame for comparison
-    std::optional<FrameInfo> previousFrame_;
-    double averageBitrate_ = 0.0;
+    // Anomaly detection (analysis thread)
+    void detectAnomalies(const FrameInfo& frame);
+    AnomalyDetector anomalyDetector_;
+    std::vector<Anomaly> detectedAnomalies_;
 };
 
 } // namespace video_analyzer
@@ -6,13 +6,37 @@
 #include <optional>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <vector>
 
 namespace video_analyzer {
 
+/**
+ * @brief Outcome of StreamDecoder::readPacket
+ */
+enum class PacketReadResult {
+    VIDEO_PACKET,  // A video packet was read
+    SKIPPED,       // A packet of another stream was read and discarded
+    WOULD_BLOCK,   // Non-blocking mode: no data available yet
+    ENDED          // Stream ended, failed or was stopped
+};
+
+/**
+ * @brief Frame decoded from a stream, with the receipt time of its packet
+ */
+struct DecodedFrame {
+    FrameInfo info;
+    std::chrono::steady_clock::time_point receivedAt;  // When the packet was demuxed
+};
+
 /**
  * @brief Real-time stream decoder
  * 
  * Supports network streaming protocols (RTMP, HLS, RTSP)
+ * 
+ * Demuxing and decoding can run on separate threads: one thread calls
+ * readPacket() while another calls decodePacket(). readNextFrame() does
+ * both on the calling thread.
  */
 class StreamDecoder {
 public:
@@ -21,9 +45,14 @@ public:
      * 
      * @param streamUrl URL of the stream (rtmp://, http://, rtsp://)
      * @param threadCount Number of threads for decoding (0 = auto-detect)
+     * @param nonBlocking Make readPacket() return WOULD_BLOCK instead of
+     *                    waiting when the demuxer has no data ready. The
+     *                    protocol is opened with AVIO_FLAG_NONBLOCK; inputs
+     *                    whose demuxer does its own networking (RTSP) only
+     *                    get AVFMT_FLAG_NONBLOCK
      * @throws FFmpegError if stream cannot be opened
      */
-    explicit StreamDecoder(const std::string& streamUrl, int threadCount = 0);
+    explicit StreamDecoder(const std::string& streamUrl, int threadCount = 0, bool nonBlocking = false);
     
     /**
      * @brief Destructor
@@ -46,12 +75,44 @@ public:
     StreamInfo getStreamInfo() const;
     
     /**
-     * @brief Read the next frame (non-blocking)
+     * @brief Read the next frame
      * 
-     * @return std::optional<FrameInfo> Frame information, or nullopt if no frame available
+     * Blocks until a frame is decoded, the stream ends or stop() is called.
+     * 
+     * @return std::optional<FrameInfo> Frame information, or nullopt once the stream is inactive
      */
     std::optional<FrameInfo> readNextFrame();
     
+    /**
+     * @brief Read the next video packet (demux only)
+     * 
+     * Blocks in the demuxer until a packet arrives, the read times out or
+     * stop() is called, unless the decoder is non-blocking.
+     * 
+     * @param packet Receives the packet, with PacketMetadata attached
+     * @return PacketReadResult VIDEO_PACKET if packet holds a video packet
+     */
+    PacketReadResult readPacket(PacketPtr& packet);
+    
+    /**
+     * @brief Decode a packet returned by readPacket()
+     * 
+     * Packets with invalid data (e.g. after packets were dropped) are
+     * skipped; any other decoder error ends the stream.
+     * 
+     * @param packet Packet to decode
+     * @param frames Receives the decoded frames (appended)
+     * @return true if decoding can continue
+     */
+    bool decodePacket(const PacketPtr& packet, std::vector<DecodedFrame>& frames);
+    
+    /**
+     * @brief Drain the frames still buffered in the decoder at end of stream
+     * 
+     * @param frames Receives the decoded frames (appended)
+     */
+    void flush(std::vector<DecodedFrame>& frames);
+    
     /**
      * @brief Check if stream is still active
      * 
@@ -75,8 +136,10 @@ private:
     struct Impl;
     std::unique_ptr<Impl> pImpl_;
     
+    FrameInfo buildFrameInfo(const struct AVFrame* frame) const;
+    bool sendPacket(const struct AVPacket* packet, std::vector<DecodedFrame>& frames);
+    bool receiveFrames(std::vector<DecodedFrame>& frames);
     FrameType detectFrameType(const struct AVFrame* frame) const;
-    int extractQP(const struct AVFrame* frame) const;
 };
 
 } // namespace video_analyzer
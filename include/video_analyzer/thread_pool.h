@@ -1,23 +1,128 @@
 #pragma once
 
+#include "work_stealing_deque.h"
+#include <algorithm>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
 
 namespace video_analyzer {
 
 /**
- * @brief Thread pool for parallel task execution
- * 
- * Manages a pool of worker threads that execute submitted tasks.
- * Automatically detects system core count if numThreads is 0.
- * Uses RAII to ensure proper thread cleanup.
+ * @brief Counter that releases waiters once it reaches zero
+ *
+ * Lighter than one std::future per task when the caller only needs to
+ * join a group of tasks. The first exception thrown by a task counted
+ * against the latch is rethrown by wait().
+ */
+class CompletionLatch {
+public:
+    explicit CompletionLatch(size_t count = 0) : count_(count) {}
+    
+    // Disable copy
+    CompletionLatch(const CompletionLatch&) = delete;
+    CompletionLatch& operator=(const CompletionLatch&) = delete;
+    
+    /**
+     * @brief Add to the count (before the matching tasks are submitted)
+     */
+    void add(size_t count) {
+        count_.fetch_add(count, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Decrement the count, releasing waiters when it reaches zero
+     */
+    void countDown(size_t count = 1) {
+        // Under the lock: a waiter can only return, and destroy the latch,
+        // after the final countDown() has released it
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            condition_.notify_all();
+        }
+    }
+    
+    /**
+     * @brief Whether the count has reached zero
+     */
+    bool isReady() const {
+        return count_.load(std::memory_order_acquire) == 0;
+    }
+    
+    /**
+     * @brief Block until the count reaches zero
+     *
+     * Inside a ThreadPool task use ThreadPool::wait() instead, which keeps
+     * the worker running other tasks.
+     *
+     * @throws The first exception recorded by setException()
+     */
+    void wait() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return isReady(); });
+        }
+        rethrowIfFailed();
+    }
+    
+    /**
+     * @brief Block until the count reaches zero or the timeout expires
+     *
+     * @return true if the count reached zero
+     */
+    template<typename Rep, typename Period>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return condition_.wait_for(lock, timeout, [this] { return isReady(); });
+    }
+    
+    /**
+     * @brief Record a task failure (only the first one is kept)
+     */
+    void setException(std::exception_ptr exception) {
+        std::lock_guard<std::mutex> lock(exceptionMutex_);
+        if (!exception_) {
+            exception_ = exception;
+        }
+    }
+    
+    void rethrowIfFailed() {
+        std::lock_guard<std::mutex> lock(exceptionMutex_);
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+    std::atomic<size_t> count_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::mutex exceptionMutex_;
+    std::exception_ptr exception_;
+};
+
+/**
+ * @brief Work-stealing thread pool for parallel task execution
+ *
+ * Each worker owns a lock-free deque: tasks submitted from a worker go to
+ * its own deque and run LIFO, idle workers steal the oldest tasks of
+ * others. Tasks submitted from outside the pool go through a shared
+ * injection queue. Automatically detects system core count if numThreads
+ * is 0. Uses RAII to ensure proper thread cleanup.
+ *
+ * submit() returns a std::future; for fine-grained work use execute()
+ * with a CompletionLatch, submitBulk() or parallelFor(), which avoid the
+ * future and std::function overhead.
  */
 class ThreadPool {
 public:
@@ -52,33 +157,120 @@ public:
     auto submit(F&& f, Args&&... args) -> std::future<decltype(f(args...))> {
         using return_type = decltype(f(args...));
         
-        // Create a packaged task
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
+        std::packaged_task<return_type()> task(
             std::bind(std::forward<F>(f), std::forward<Args>(args)...)
         );
+        std::future<return_type> result = task.get_future();
         
-        std::future<return_type> result = task->get_future();
+        execute(std::move(task));
+        return result;
+    }
+    
+    /**
+     * @brief Run a callable on the pool without creating a future
+     *
+     * @param f Callable taking no arguments
+     * @param latch Optional latch counted down when f returns or throws;
+     *              the caller must have counted this task into it
+     */
+    template<typename F>
+    void execute(F&& f, CompletionLatch* latch = nullptr) {
+        using Callable = std::decay_t<F>;
+        checkAccepting();
+        auto* job = new CallableJob<Callable>(std::forward<F>(f));
+        job->latch = latch;
+        enqueue(job);
+    }
+    
+    /**
+     * @brief Run body(i) for i in [0, count) as separate tasks
+     *
+     * All tasks are allocated at once and counted into latch, which the
+     * caller waits on (preferably with wait()). body must stay alive
+     * until the latch is released.
+     *
+     * @param count Number of tasks
+     * @param body Callable taking the task index
+     * @param latch Latch counted up by count here and down per finished task
+     */
+    template<typename F>
+    void submitBulk(size_t count, F& body, CompletionLatch& latch) {
+        if (count == 0) {
+            return;
+        }
+        checkAccepting();
         
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            
-            // Don't allow enqueueing after stopping the pool
-            if (stop_) {
-                throw std::runtime_error("Cannot submit task to stopped ThreadPool");
+        auto batch = std::make_shared<std::vector<IndexJob<F>>>(count);
+        latch.add(count);
+        std::vector<Job*> jobs(count);
+        for (size_t i = 0; i < count; ++i) {
+            IndexJob<F>& job = (*batch)[i];
+            job.body = &body;
+            job.index = i;
+            job.latch = &latch;
+            job.batch = batch;
+            jobs[i] = &job;
+        }
+        batch.reset();  // The jobs own their batch now
+        enqueueBulk(jobs);
+    }
+    
+    /**
+     * @brief Run body(i) for every i in [begin, end) and wait
+     *
+     * The range is split into chunks of grainSize indices (0 = about four
+     * chunks per worker). The calling thread runs chunks too, so
+     * parallelFor may be nested inside pool tasks.
+     *
+     * @throws The first exception thrown by body
+     */
+    template<typename F>
+    void parallelFor(size_t begin, size_t end, F&& body, size_t grainSize = 0) {
+        if (end <= begin) {
+            return;
+        }
+        
+        size_t total = end - begin;
+        if (grainSize == 0) {
+            grainSize = std::max<size_t>(1, total / (getThreadCount() * 4));
+        }
+        size_t chunks = (total + grainSize - 1) / grainSize;
+        
+        auto chunk = [&](size_t index) {
+            size_t first = begin + index * grainSize;
+            size_t last = std::min(end, first + grainSize);
+            for (size_t i = first; i < last; ++i) {
+                body(i);
             }
-            
-            tasks_.emplace([task]() { (*task)(); });
+        };
+        
+        if (chunks == 1) {
+            chunk(0);
+            return;
         }
         
-        condition_.notify_one();
-        return result;
+        CompletionLatch latch;
+        submitBulk(chunks, chunk, latch);
+        wait(latch);
     }
     
+    /**
+     * @brief Wait for a latch, helping with queued tasks meanwhile
+     *
+     * A worker runs any pool task while it waits, so nested waits cannot
+     * deadlock. Any other thread only runs tasks counted against this
+     * latch that no worker has picked up yet, then blocks; it never runs
+     * unrelated tasks.
+     *
+     * @throws The first exception recorded in the latch
+     */
+    void wait(CompletionLatch& latch);
+    
     /**
      * @brief Wait for all currently queued tasks to complete
-     * 
+     *
      * Note: This does not prevent new tasks from being submitted.
-     * It only waits for tasks that were queued at the time of the call.
+     * It waits until no task is queued or running.
      */
     void waitAll();
     
@@ -87,33 +279,122 @@ public:
      * @return Number of threads in the pool
      */
     size_t getThreadCount() const;
-    
+
 private:
-    // Worker threads
-    std::vector<std::thread> workers_;
+    // Type-erased task; derived jobs delete themselves after running
+    struct Job {
+        void (*run)(Job* job) = nullptr;
+        CompletionLatch* latch = nullptr;
+    };
     
-    // Task queue
-    std::queue<std::function<void()>> tasks_;
+    template<typename F>
+    struct CallableJob : Job {
+        explicit CallableJob(F&& callable) : fn(std::move(callable)) {
+            this->run = &CallableJob::invoke;
+        }
+        explicit CallableJob(const F& callable) : fn(callable) {
+            this->run = &CallableJob::invoke;
+        }
+        
+        static void invoke(Job* job) {
+            std::unique_ptr<CallableJob> self(static_cast<CallableJob*>(job));
+            self->fn();
+        }
+        
+        F fn;
+    };
     
-    // Synchronization
-    std::mutex queueMutex_;
-    std::condition_variable condition_;
-    std::atomic<bool> stop_;
+    template<typename F>
+    struct IndexJob : Job {
+        IndexJob() {
+            this->run = &IndexJob::invoke;
+        }
+        
+        static void invoke(Job* job) {
+            auto* self = static_cast<IndexJob*>(job);
+            std::shared_ptr<std::vector<IndexJob>> batch = std::move(self->batch);
+            (*self->body)(self->index);
+        }
+        
+        F* body = nullptr;
+        size_t index = 0;
+        std::shared_ptr<std::vector<IndexJob>> batch;  // Keeps the batch alive
+    };
     
-    // Track active tasks for waitAll()
-    std::atomic<size_t> activeTasks_;
-    std::condition_variable allTasksComplete_;
+    struct Worker {
+        explicit Worker(size_t capacity) : deque(capacity) {}
+        
+        WorkStealingDeque<Job> deque;
+        std::thread thread;
+    };
+    
+    void checkAccepting() const;
+    void enqueue(Job* job);
+    void enqueueBulk(const std::vector<Job*>& jobs);
+    
+    // Run a job, count it down and record its exception
+    void runJob(Job* job);
+    
+    // Find work: own deque, then the injection queue, then other workers
+    Job* findJob(size_t workerIndex);
+    Job* stealJob(size_t thiefIndex);
+    
+    // Remove a job counted against latch from the injection queue
+    Job* takeInjectedJob(const CompletionLatch& latch);
+    
+    // Wake sleeping workers after new work was queued
+    void notifyWork(size_t jobs);
     
     /**
      * @brief Worker thread function
      */
-    void workerThread();
+    void workerThread(size_t index);
     
     /**
      * @brief Detect number of hardware threads
      * @return Number of hardware threads, or 1 if detection fails
      */
     static size_t detectHardwareThreads();
+    
+    // Worker threads and their deques
+    std::vector<std::unique_ptr<Worker>> workers_;
+    
+    // Tasks submitted from outside the pool
+    std::deque<Job*> injected_;
+    std::mutex injectionMutex_;
+    
+    // Sleeping workers wait for the epoch to change
+    std::mutex sleepMutex_;
+    std::condition_variable wakeCondition_;
+    std::atomic<uint64_t> workEpoch_{0};
+    std::atomic<size_t> sleepers_{0};
+    std::atomic<bool> stop_{false};
+    
+    // Queued or running tasks, for waitAll()
+    std::atomic<size_t> pendingJobs_{0};
+    std::mutex idleMutex_;
+    std::condition_variable allTasksComplete_;
 };
 
+/**
+ * @brief Run body(i) for every i in [begin, end), in parallel when worthwhile
+ *
+ * Small ranges run serially on the calling thread, where scheduling the
+ * tasks would cost more than it saves; callers pick minParallel for the
+ * cost of one body call.
+ *
+ * @param pool Pool to use, or nullptr to always run serially
+ * @param minParallel Smallest range size handed to ThreadPool::parallelFor
+ */
+template<typename F>
+void parallelForIfLarge(ThreadPool* pool, size_t begin, size_t end, size_t minParallel, F&& body) {
+    if (pool && end > begin && end - begin >= minParallel) {
+        pool->parallelFor(begin, end, body);
+        return;
+    }
+    for (size_t i = begin; i < end; ++i) {
+        body(i);
+    }
+}
+
 } // namespace video_analyzer
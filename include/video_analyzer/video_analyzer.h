@@ -1,8 +1,10 @@
 #pragma once
 
 #include "video_analyzer/video_decoder.h"
+#include "video_analyzer/analysis_pipeline.h"
 #include "video_analyzer/gop_analyzer.h"
 #include "video_analyzer/frame_statistics.h"
+#include "video_analyzer/analysis_cache.h"
 #include "video_analyzer/data_models.h"
 #include <string>
 #include <vector>
@@ -10,6 +12,18 @@
 
 namespace video_analyzer {
 
+/**
+ * @brief Progress of a background analysis started with VideoAnalyzer::startAnalysis()
+ */
+struct AnalysisProgress {
+    bool running = false;           // Results are still being produced or merged
+    bool cancelled = false;         // Stopped by cancelAnalysis()
+    size_t framesDecoded = 0;       // Frames analyzed by the background thread
+    double fraction = 0.0;          // Estimated completion (0.0 - 1.0) from timestamps
+    double framesPerSecond = 0.0;   // Analysis throughput
+    double elapsedSeconds = 0.0;    // Time since the analysis started
+};
+
 /**
  * @brief High-level video analyzer for GUI
  * 
@@ -17,15 +31,94 @@ namespace video_analyzer {
  */
 class VideoAnalyzer {
 public:
-    VideoAnalyzer() = default;
-    ~VideoAnalyzer() = default;
+    VideoAnalyzer();
+    
+    /**
+     * @brief Destructor - cancels a running background analysis
+     */
+    ~VideoAnalyzer();
     
     /**
      * @brief Analyze a video file
      * 
+     * With a cache, results of an unchanged file are loaded from the cache
+     * without decoding; fresh results are stored in it.
+     * 
+     * @param filepath Path to video file
+     * @param cache Optional analysis cache
+     */
+    void analyze(const std::string& filepath, const AnalysisCache* cache = nullptr);
+    
+    /**
+     * @brief Check whether the last analyze() was served from the cache
+     */
+    bool isFromCache() const { return from_cache_; }
+    
+    /**
+     * @brief Analyze a video file on a background thread
+     * 
+     * Returns immediately. Stream information, frames, GOPs and statistics
+     * are published in batches as decoding proceeds and become visible
+     * through the getters once poll() merged them, so the getters stay
+     * safe to use from the calling thread without locking.
+     * 
      * @param filepath Path to video file
+     * @param cache Optional analysis cache (must outlive the analysis)
+     */
+    void startAnalysis(const std::string& filepath, const AnalysisCache* cache = nullptr);
+    
+    /**
+     * @brief Merge results published by the background analysis
+     * 
+     * Call regularly (e.g. once per UI frame) from the thread that uses the
+     * getters. When the final batch is merged, duplicates are detected as
+     * in analyze().
+     * 
+     * @return true if frames, GOPs or stream information changed
+     * @throws The exception that ended the background analysis
      */
-    void analyze(const std::string& filepath);
+    bool poll();
+    
+    /**
+     * @brief Check whether a background analysis is still running or unmerged
+     */
+    bool isAnalyzing() const;
+    
+    /**
+     * @brief Check whether stream information is available
+     * 
+     * During a background analysis this is false until the video was opened.
+     */
+    bool hasStreamInfo() const { return has_stream_info_; }
+    
+    /**
+     * @brief Get the progress of the last background analysis
+     */
+    AnalysisProgress getProgress() const;
+    
+    /**
+     * @brief Stop the background analysis
+     * 
+     * Frames analyzed so far remain available after the next poll().
+     */
+    void cancelAnalysis();
+    
+    /**
+     * @brief Load a binary analysis report (.vsa) instead of decoding
+     * 
+     * The report is memory-mapped and its columns copied into the frame
+     * and GOP lists without parsing.
+     * 
+     * @param filepath Path to report file
+     */
+    void loadReport(const std::string& filepath);
+    
+    /**
+     * @brief Get the path of the analyzed video
+     * 
+     * @return const std::string& Video path (for reports: the recorded source, empty if unknown)
+     */
+    const std::string& getSourcePath() const { return source_path_; }
     
     /**
      * @brief Get stream information
@@ -69,10 +162,20 @@ public:
                                bool require_same_type = true);
 
 private:
+    struct BackgroundAnalysis;
+    
+    // Background thread body
+    static void runBackground(BackgroundAnalysis& state, std::string filepath,
+                              const AnalysisCache* cache);
+    
+    std::string source_path_;
+    bool from_cache_ = false;
+    bool has_stream_info_ = false;
     StreamInfo stream_info_;
     std::vector<FrameInfo> frames_;
     std::vector<GOPInfo> gops_;
     FrameStatistics frame_stats_;
+    std::unique_ptr<BackgroundAnalysis> background_;
 };
 
 } // namespace video_analyzer
@@ -2,12 +2,32 @@
 
 #include "ffmpeg_context.h"
 #include "data_models.h"
+#include "qp_extractor.h"
+#include "motion_field.h"
 #include <string>
 #include <optional>
 #include <memory>
 
 namespace video_analyzer {
 
+/**
+ * @brief How the decoder produces FrameInfo
+ */
+enum class DecodeMode {
+    FULL_DECODE,   // Decode every frame (pixels, QP and motion vectors available)
+    HEADER_SCAN    // Demux and parse headers only (no pixel decoding, QP is 0)
+};
+
+/**
+ * @brief Options for opening a VideoDecoder
+ */
+struct DecoderOptions {
+    int threadCount = 0;                       // Decoding threads (0 = auto-detect)
+    DecodeMode mode = DecodeMode::FULL_DECODE; // Decode mode
+    bool exportMotionVectors = false;          // Export motion vectors as frame side data (FULL_DECODE only)
+    bool exportEncodeParams = true;            // Export per-block QP as frame side data (FULL_DECODE only)
+};
+
 /**
  * @brief Core video decoder class
  * 
@@ -24,6 +44,19 @@ public:
      */
     explicit VideoDecoder(const std::string& filePath, int threadCount = 0);
     
+    /**
+     * @brief Construct a VideoDecoder with explicit options
+     * 
+     * In HEADER_SCAN mode frames are produced from packet flags, sizes, timestamps
+     * and the codec parser's picture type, without reconstructing pixels. Frames are
+     * still returned in presentation order.
+     * 
+     * @param filePath Path to the video file
+     * @param options Decoder options
+     * @throws FFmpegError if file cannot be opened or decoded
+     */
+    VideoDecoder(const std::string& filePath, const DecoderOptions& options);
+    
     /**
      * @brief Destructor
      */
@@ -58,6 +91,13 @@ public:
      */
     void seekToTime(double seconds);
     
+    /**
+     * @brief Seek to the keyframe at or before a timestamp
+     * 
+     * @param timestamp Timestamp in stream time base units
+     */
+    void seekToTimestamp(int64_t timestamp);
+    
     /**
      * @brief Reset to the beginning of the stream
      */
@@ -70,20 +110,79 @@ public:
      */
     bool hasMoreFrames() const;
     
+    /**
+     * @brief Get the decode mode
+     * 
+     * @return DecodeMode Mode the decoder was opened with
+     */
+    DecodeMode getDecodeMode() const;
+    
+    /**
+     * @brief Enable or disable motion vector export
+     * 
+     * Exporting motion vectors slows decoding down, so it is off unless
+     * requested here or through DecoderOptions::exportMotionVectors.
+     * AnalysisPipeline enables it when a sink needs motion vectors.
+     * Changing the setting reopens the codec and resets the decoder to the
+     * beginning of the stream. Has no effect in HEADER_SCAN mode.
+     * 
+     * @param enable true to export motion vectors
+     * @throws FFmpegError if the codec cannot be reopened
+     */
+    void setMotionVectorExport(bool enable);
+    
+    /**
+     * @brief Check whether motion vectors are exported
+     * 
+     * @return true if decoded frames carry motion vectors
+     */
+    bool isMotionVectorExportEnabled() const;
+    
     /**
      * @brief Get motion vectors from the last decoded frame (if available)
      * 
+     * Vectors are empty unless motion vector export is enabled.
+     * 
      * @return std::optional<MotionVectorData> Motion vector data, or nullopt if not available
      */
     std::optional<MotionVectorData> getMotionVectors() const;
     
+    /**
+     * @brief Get motion vectors of the last decoded frame in compact form
+     * 
+     * Cheaper than getMotionVectors(): no per-vector records, magnitudes or
+     * directions are computed.
+     * 
+     * @return std::optional<MotionField> Motion field, or nullopt if no frame was decoded
+     */
+    std::optional<MotionField> getMotionField() const;
+    
+    /**
+     * @brief Get the per-block QP map of the last decoded frame (if available)
+     * 
+     * The map is only built when requested, so callers that don't need it pay nothing.
+     * 
+     * @return std::optional<QPMap> QP map, or nullopt if the codec exports no per-block QP
+     */
+    std::optional<QPMap> getQPMap() const;
+    
+    /**
+     * @brief Get the last decoded frame
+     * 
+     * The frame stays valid until the next call to readNextFrame(), seekToTime() or reset().
+     * 
+     * @return const AVFrame* Last decoded frame, or nullptr if none
+     */
+    const struct AVFrame* getLastDecodedFrame() const;
+    
 private:
     struct Impl;
     std::unique_ptr<Impl> pImpl_;
     
+    std::optional<FrameInfo> scanNextFrame();
+    void resetParser();
+    FrameInfo buildFrameInfo(const struct AVFrame* frame) const;
     FrameType detectFrameType(const struct AVFrame* frame) const;
-    int extractQP(const struct AVFrame* frame) const;
-    MotionVectorData extractMotionVectors(const struct AVFrame* frame) const;
 };
 
 } // namespace video_analyzer
@@ -0,0 +1,136 @@
+#pragma once
+
+// GLEW must be included before any OpenGL headers
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl3.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace video_analyzer {
+
+struct YUVColorInfo;
+
+/**
+ * @brief RGB texture of the current video frame, converted on the GPU
+ *
+ * The Y, U and V planes are uploaded as single-channel textures and a
+ * fragment shader converts them into an RGB texture through a
+ * framebuffer. The CPU only copies planes; rotation and flipping are
+ * left to the texture coordinates used when drawing the texture.
+ *
+ * Callers can decode directly into a mapped pixel buffer from
+ * mapUploadBuffer() and pass it to updateFromUploadBuffer(), which the
+ * driver transfers asynchronously without any further copy. Buffers are
+ * mapped with invalidation, letting the driver orphan one that a previous
+ * transfer still reads instead of stalling.
+ */
+class VideoTexture {
+public:
+    VideoTexture() = default;
+    ~VideoTexture();
+    
+    // Disable copy
+    VideoTexture(const VideoTexture&) = delete;
+    VideoTexture& operator=(const VideoTexture&) = delete;
+    
+    /**
+     * @brief Create the textures, framebuffer and shader
+     *
+     * Requires a current OpenGL 3.3 context.
+     *
+     * @param width Frame width
+     * @param height Frame height
+     * @return true if successful
+     */
+    bool create(int width, int height);
+    
+    /**
+     * @brief Release all OpenGL objects
+     */
+    void destroy();
+    
+    /**
+     * @brief Upload a frame from client memory and convert it to RGB
+     *
+     * The planes are read before the call returns. Buffers from
+     * mapUploadBuffer() are mapped write-only and cannot be read; they are
+     * ignored here and must be passed to updateFromUploadBuffer() instead.
+     *
+     * @param yuv Planar YUV 4:2:0 data as written by FrameRenderer::convertFrameToYUV
+     * @param color Range and matrix of the samples
+     */
+    void update(const uint8_t* yuv, const YUVColorInfo& color);
+    
+    /**
+     * @brief Upload a frame decoded into a buffer from mapUploadBuffer()
+     *
+     * Takes the buffer back: it is unmapped and transferred without a
+     * copy, and must not be written afterwards. Other memory is uploaded
+     * like update().
+     *
+     * @param buffer Mapped buffer holding the frame
+     * @param color Range and matrix of the samples
+     */
+    void updateFromUploadBuffer(uint8_t* buffer, const YUVColorInfo& color);
+    
+    /**
+     * @brief Map a pixel buffer for the next frame
+     *
+     * The memory may be written from any thread until it is passed to
+     * updateFromUploadBuffer() or discardUploadBuffer() on the OpenGL thread. All mapped
+     * buffers become invalid when the texture is destroyed.
+     *
+     * @return uint8_t* Mapped memory of getUploadBufferSize() bytes, or
+     *         nullptr on failure
+     */
+    uint8_t* mapUploadBuffer();
+    
+    /**
+     * @brief Unmap a buffer from mapUploadBuffer() without uploading it
+     */
+    void discardUploadBuffer(uint8_t* buffer);
+    
+    size_t getUploadBufferSize() const { return upload_size_; }
+    
+    /**
+     * @brief RGB texture for display (0 before create())
+     */
+    GLuint getTexture() const { return rgb_texture_; }
+
+private:
+    struct UploadBuffer {
+        GLuint pbo = 0;
+        uint8_t* mapped = nullptr;  // Set while handed out
+    };
+    
+    bool createProgram();
+    
+    // Upload from the handed-out buffer at index, or from yuv when index is -1
+    void upload(const uint8_t* yuv, int index, const YUVColorInfo& color);
+    
+    // Index of the pixel buffer mapped at the given address, or -1
+    int findUploadBuffer(const uint8_t* mapped) const;
+    // Bind an unmapped pixel buffer, creating one if needed; returns its index
+    int bindFreeUploadBuffer();
+    
+    int width_ = 0;
+    int height_ = 0;
+    GLuint plane_textures_[3] = { 0, 0, 0 };  // Y, U, V
+    GLuint rgb_texture_ = 0;
+    GLuint framebuffer_ = 0;
+    GLuint vertex_array_ = 0;
+    GLuint program_ = 0;
+    GLint yuv_matrix_location_ = -1;
+    GLint yuv_offset_location_ = -1;
+    
+    size_t upload_size_ = 0;
+    std::vector<UploadBuffer> upload_buffers_;
+};
+
+} // namespace video_analyzer
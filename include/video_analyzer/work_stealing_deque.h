@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace video_analyzer {
+
+/**
+ * @brief Fixed-capacity lock-free work-stealing deque (Chase-Lev)
+ *
+ * The owning thread pushes and pops at the bottom (LIFO, cache-warm work
+ * first); any other thread steals from the top (FIFO, the oldest and
+ * usually largest work). Only the last remaining item is contended, and
+ * then resolved with a single compare-and-swap.
+ *
+ * Holds raw pointers; ownership stays with the caller. push() fails when
+ * full so the caller can fall back to a shared queue instead of growing.
+ */
+template <typename T>
+class WorkStealingDeque {
+public:
+    /**
+     * @brief Construct a deque
+     *
+     * @param capacity Maximum number of items (rounded up to a power of two)
+     */
+    explicit WorkStealingDeque(size_t capacity = 1024)
+        : capacity_(roundUpToPowerOfTwo(std::max<size_t>(capacity, 2))),
+          mask_(capacity_ - 1),
+          slots_(std::make_unique<std::atomic<T*>[]>(capacity_)) {}
+    
+    // Disable copy
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    
+    /**
+     * @brief Push an item at the bottom (owner thread only)
+     *
+     * @return false if the deque is full
+     */
+    bool push(T* item) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        if (bottom - top >= static_cast<int64_t>(capacity_)) {
+            return false;
+        }
+        
+        slots_[bottom & mask_].store(item, std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Pop the most recently pushed item (owner thread only)
+     *
+     * @return T* Item, or nullptr if empty or the last item was stolen
+     */
+    T* pop() {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(bottom, std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_seq_cst);
+        
+        if (top > bottom) {
+            // Empty
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        
+        T* item = slots_[bottom & mask_].load(std::memory_order_acquire);
+        if (top == bottom) {
+            // Last item: race thieves for it
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+    
+    /**
+     * @brief Steal the oldest item (any thread)
+     *
+     * @return T* Item, or nullptr if empty or another thread won the race
+     */
+    T* steal() {
+        int64_t top = top_.load(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        
+        T* item = slots_[top & mask_].load(std::memory_order_acquire);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+    
+    /**
+     * @brief Approximate number of items
+     */
+    size_t size() const {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+    
+    bool empty() const { return size() == 0; }
+    
+    size_t capacity() const { return capacity_; }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t power = 1;
+        while (power < value) {
+            power <<= 1;
+        }
+        return power;
+    }
+    
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<std::atomic<T*>[]> slots_;
+    
+    // Thieves contend on top, the owner works at bottom: keep them apart
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+};
+
+} // namespace video_analyzer
@@ -0,0 +1,216 @@
+#include "video_analyzer/analysis_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace video_analyzer {
+
+namespace {
+
+// Bytes hashed at each end of the file
+constexpr size_t kHashedBytes = 64 * 1024;
+
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+uint64_t fnv1a(const char* data, size_t length, uint64_t hash = kFnvOffsetBasis) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+std::string toHex(uint64_t value) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+    return text;
+}
+
+// Hash the first and last kHashedBytes of a file together with its size
+uint64_t partialContentHash(const std::string& path, uint64_t size) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file for hashing: " + path);
+    }
+    
+    std::vector<char> buffer(kHashedBytes);
+    uint64_t hash = fnv1a(reinterpret_cast<const char*>(&size), sizeof(size));
+    
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    hash = fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+    
+    // Tail of the file, without re-reading bytes already hashed
+    if (size > kHashedBytes) {
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(size - std::min<uint64_t>(size - kHashedBytes, kHashedBytes)));
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash = fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+    }
+    
+    return hash;
+}
+
+} // namespace
+
+// CacheKey implementation
+CacheKey CacheKey::fromFile(const std::string& videoPath) {
+    std::error_code ec;
+    fs::path canonical = fs::canonical(videoPath, ec);
+    if (ec || !fs::is_regular_file(canonical, ec)) {
+        throw std::runtime_error("Cannot key missing file: " + videoPath);
+    }
+    
+    CacheKey key;
+    key.path = canonical.string();
+    key.size = static_cast<uint64_t>(fs::file_size(canonical));
+    key.mtime = static_cast<int64_t>(fs::last_write_time(canonical).time_since_epoch().count());
+    key.contentHash = partialContentHash(key.path, key.size);
+    return key;
+}
+
+nlohmann::json CacheKey::toJson() const {
+    return nlohmann::json{
+        {"path", path},
+        {"size", size},
+        {"mtime", mtime},
+        {"contentHash", toHex(contentHash)},
+        {"version", version}
+    };
+}
+
+// AnalysisCache::Entry implementation
+AnalysisCache::Entry::Entry(const CacheKey& key, const std::string& finalPath)
+    : key_(key), finalPath_(finalPath) {
+    // Unique temporary name so concurrent analyses never share a file
+    static std::atomic<uint64_t> counter{0};
+    uint64_t ticks = static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+    tempPath_ = finalPath_ + ".tmp" + toHex(ticks ^ (counter++ << 48));
+    writer_ = std::make_unique<BinaryReportWriter>(tempPath_);
+}
+
+AnalysisCache::Entry::~Entry() {
+    if (!committed_) {
+        writer_->discard();
+    }
+}
+
+bool AnalysisCache::Entry::commit(const nlohmann::json& summary) {
+    if (committed_) {
+        return true;
+    }
+    committed_ = true;
+    
+    std::error_code ec;
+    try {
+        fs::create_directories(fs::path(finalPath_).parent_path());
+        
+        nlohmann::json metadata = summary;
+        metadata["cacheKey"] = key_.toJson();
+        metadata["source"] = key_.path;
+        writer_->finish(metadata);
+        
+        // Rename is atomic, readers never see a partially written entry
+        fs::rename(tempPath_, finalPath_);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Analysis cache: failed to store entry: " << e.what() << std::endl;
+        fs::remove(tempPath_, ec);
+        return false;
+    }
+}
+
+// AnalysisCache implementation
+AnalysisCache::AnalysisCache(const std::string& directory)
+    : directory_(directory) {}
+
+std::string AnalysisCache::defaultDirectory() {
+    if (const char* dir = std::getenv("AISTREAMEYE_CACHE_DIR")) {
+        return dir;
+    }
+#ifdef _WIN32
+    if (const char* localAppData = std::getenv("LOCALAPPDATA")) {
+        return (fs::path(localAppData) / "aistreameye").string();
+    }
+#else
+    if (const char* xdgCache = std::getenv("XDG_CACHE_HOME")) {
+        return (fs::path(xdgCache) / "aistreameye").string();
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return (fs::path(home) / ".cache" / "aistreameye").string();
+    }
+#endif
+    return (fs::temp_directory_path() / "aistreameye").string();
+}
+
+std::string AnalysisCache::entryPath(const CacheKey& key) const {
+    return (fs::path(directory_) / (toHex(fnv1a(key.path.data(), key.path.size())) + ".vsa")).string();
+}
+
+std::unique_ptr<BinaryReport> AnalysisCache::lookup(const std::string& videoPath) const {
+    try {
+        CacheKey key = CacheKey::fromFile(videoPath);
+        std::string path = entryPath(key);
+        if (!fs::exists(path)) {
+            return nullptr;
+        }
+        
+        auto report = std::make_unique<BinaryReport>(path);
+        if (report->getMetadata().value("cacheKey", nlohmann::json()) != key.toJson()) {
+            return nullptr;  // Stale: file changed or written by another version
+        }
+        return report;
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+std::unique_ptr<AnalysisCache::Entry> AnalysisCache::createEntry(const std::string& videoPath) const {
+    try {
+        CacheKey key = CacheKey::fromFile(videoPath);
+        return std::make_unique<Entry>(key, entryPath(key));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+bool AnalysisCache::store(const std::string& videoPath, const StreamInfo& streamInfo,
+                          const std::vector<FrameInfo>& frames, const std::vector<GOPInfo>& gops,
+                          const FrameStatistics& frameStats, const BitrateStatistics& bitrateStats) const {
+    auto entry = createEntry(videoPath);
+    if (!entry) {
+        return false;
+    }
+    
+    BinaryReportWriter& writer = entry->writer();
+    writer.begin(streamInfo);
+    for (const auto& frame : frames) {
+        writer.writeFrame(frame);
+    }
+    writer.setGOPs(gops);
+    writer.setBitrateStatistics(bitrateStats);
+    return entry->commit({{"frameStatistics", frameStats.toJson()}});
+}
+
+void AnalysisCache::clear() const {
+    std::error_code ec;
+    for (fs::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (it->path().extension() == ".vsa" || name.find(".vsa.tmp") != std::string::npos) {
+            std::error_code removeError;
+            fs::remove(it->path(), removeError);
+        }
+    }
+}
+
+} // namespace video_analyzer
@@ -0,0 +1,112 @@
+#include "video_analyzer/analysis_pipeline.h"
+#include <algorithm>
+
+namespace video_analyzer {
+
+// FrameCollector implementation
+void FrameCollector::begin(const StreamInfo& /*info*/) {
+    frames_.clear();
+}
+
+void FrameCollector::consume(const FrameInfo& frame, const VideoDecoder& /*decoder*/) {
+    frames_.push_back(frame);
+}
+
+std::vector<FrameInfo> FrameCollector::takeFrames() {
+    std::vector<FrameInfo> frames;
+    frames.swap(frames_);
+    return frames;
+}
+
+// AnalysisPipeline implementation
+AnalysisPipeline::AnalysisPipeline(VideoDecoder& decoder)
+    : decoder_(decoder) {}
+
+void AnalysisPipeline::addSink(FrameSink& sink) {
+    sinks_.push_back(&sink);
+}
+
+void AnalysisPipeline::setProgressCallback(ProgressCallback callback) {
+    progressCallback_ = std::move(callback);
+}
+
+size_t AnalysisPipeline::run(int maxFrames) {
+    cancelled_ = false;
+    
+    bool needsMotionVectors = std::any_of(sinks_.begin(), sinks_.end(),
+                                          [](const FrameSink* sink) { return sink->needsMotionVectors(); });
+    if (needsMotionVectors) {
+        decoder_.setMotionVectorExport(true);
+    }
+    
+    StreamInfo info = decoder_.getStreamInfo();
+    for (FrameSink* sink : sinks_) {
+        sink->begin(info);
+    }
+    
+    size_t frameCount = 0;
+    while (auto frame = decoder_.readNextFrame()) {
+        for (FrameSink* sink : sinks_) {
+            sink->consume(*frame, decoder_);
+        }
+        frameCount++;
+        
+        if (progressCallback_) {
+            progressCallback_(frameCount);
+        }
+        
+        if (maxFrames > 0 && frameCount >= static_cast<size_t>(maxFrames)) {
+            break;
+        }
+        if (cancelled_) {
+            break;
+        }
+    }
+    
+    for (FrameSink* sink : sinks_) {
+        sink->end();
+    }
+    
+    return frameCount;
+}
+
+size_t AnalysisPipeline::replay(const std::vector<FrameInfo>& frames, int maxFrames) {
+    cancelled_ = false;
+    
+    StreamInfo info = decoder_.getStreamInfo();
+    for (FrameSink* sink : sinks_) {
+        sink->begin(info);
+    }
+    
+    size_t frameCount = frames.size();
+    if (maxFrames > 0) {
+        frameCount = std::min(frameCount, static_cast<size_t>(maxFrames));
+    }
+    
+    for (size_t i = 0; i < frameCount; ++i) {
+        for (FrameSink* sink : sinks_) {
+            sink->consume(frames[i], decoder_);
+        }
+        
+        if (progressCallback_) {
+            progressCallback_(i + 1);
+        }
+        
+        if (cancelled_) {
+            frameCount = i + 1;
+            break;
+        }
+    }
+    
+    for (FrameSink* sink : sinks_) {
+        sink->end();
+    }
+    
+    return frameCount;
+}
+
+void AnalysisPipeline::cancel() {
+    cancelled_ = true;
+}
+
+} // namespace video_analyzer
@@ -0,0 +1,46 @@
+#include "video_analyzer/anomaly_detector.h"
+#include <string>
+
+namespace video_analyzer {
+
+size_t AnomalyDetector::inspect(const FrameInfo& frame, std::vector<Anomaly>& anomalies) {
+    size_t before = anomalies.size();
+    
+    if (hasPrevious_) {
+        // Frame drop detection
+        double timeDiff = frame.timestamp - previousTimestamp_;
+        double expectedDiff = 1.0 / 30.0;  // Assume 30fps
+        
+        if (timeDiff > expectedDiff * 2.0) {
+            anomalies.push_back({AnomalyType::FRAME_DROP, frame.timestamp,
+                                 "Frame drop detected: " + std::to_string(timeDiff) + "s gap"});
+        }
+        
+        // Bitrate spike detection
+        double currentBitrate = frame.size * 8.0;  // Simplified
+        double previousBitrate = previousSize_ * 8.0;
+        
+        if (currentBitrate > previousBitrate * 3.0) {
+            anomalies.push_back({AnomalyType::BITRATE_SPIKE, frame.timestamp, "Bitrate spike detected"});
+        }
+    }
+    
+    // Quality drop detection (simplified - based on QP)
+    if (frame.qp > 40) {  // High QP indicates low quality
+        anomalies.push_back({AnomalyType::QUALITY_DROP, frame.timestamp,
+                             "Quality drop detected: QP=" + std::to_string(frame.qp)});
+    }
+    
+    hasPrevious_ = true;
+    previousTimestamp_ = frame.timestamp;
+    previousSize_ = frame.size;
+    return anomalies.size() - before;
+}
+
+void AnomalyDetector::reset() {
+    hasPrevious_ = false;
+    previousTimestamp_ = 0.0;
+    previousSize_ = 0;
+}
+
+} // namespace video_analyzer
@@ -0,0 +1,276 @@
+#include "video_analyzer/batch_analyzer.h"
+#include "video_analyzer/analysis_pipeline.h"
+#include "video_analyzer/bitrate_analyzer.h"
+#include "video_analyzer/gop_analyzer.h"
+#include "video_analyzer/report_writer.h"
+#include "video_analyzer/binary_report.h"
+#include "video_analyzer/thread_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace video_analyzer {
+
+namespace {
+
+size_t hardwareThreads() {
+    size_t threads = std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+bool isVideoFile(const fs::path& path) {
+    static const std::set<std::string> extensions = {
+        ".mp4", ".m4v", ".mov", ".mkv", ".webm", ".avi", ".flv",
+        ".ts", ".m2ts", ".mts", ".ivf", ".obu", ".h264", ".264",
+        ".h265", ".265", ".hevc", ".y4m"
+    };
+    
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extensions.count(ext) > 0;
+}
+
+} // namespace
+
+// BatchFileResult implementation
+nlohmann::json BatchFileResult::toJson() const {
+    nlohmann::json j{
+        {"path", path},
+        {"success", success},
+        {"elapsedSeconds", elapsedSeconds}
+    };
+    
+    if (success) {
+        j["reportPath"] = reportPath;
+        j["streamInfo"] = streamInfo.toJson();
+        j["frameStatistics"] = frameStats.toJson();
+        j["gopCount"] = gopCount;
+        j["averageGOPLength"] = averageGOPLength;
+    } else {
+        j["error"] = error;
+    }
+    
+    return j;
+}
+
+// BatchSummary implementation
+nlohmann::json BatchSummary::toJson() const {
+    nlohmann::json filesJson = nlohmann::json::array();
+    for (const auto& file : files) {
+        filesJson.push_back(file.toJson());
+    }
+    
+    return nlohmann::json{
+        {"totalFiles", files.size()},
+        {"succeeded", succeeded},
+        {"failed", failed},
+        {"totalFrames", totalFrames},
+        {"elapsedSeconds", elapsedSeconds},
+        {"filesPerHour", filesPerHour},
+        {"files", filesJson}
+    };
+}
+
+// BatchAnalyzer implementation
+BatchAnalyzer::BatchAnalyzer(const BatchOptions& options)
+    : options_(options) {
+}
+
+std::vector<std::string> BatchAnalyzer::collectInputs(const std::string& source) {
+    std::vector<std::string> files;
+    
+    if (fs::is_directory(source)) {
+        for (const auto& entry : fs::recursive_directory_iterator(source)) {
+            if (entry.is_regular_file() && isVideoFile(entry.path())) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+    
+    std::ifstream list(source);
+    if (!list) {
+        throw std::runtime_error("Cannot read batch input: " + source);
+    }
+    
+    std::string line;
+    while (std::getline(list, line)) {
+        // Trim whitespace and skip blank lines and comments
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        size_t end = line.find_last_not_of(" \t\r");
+        files.push_back(line.substr(begin, end - begin + 1));
+    }
+    
+    return files;
+}
+
+void BatchAnalyzer::setProgressCallback(ProgressCallback callback) {
+    progressCallback_ = std::move(callback);
+}
+
+size_t BatchAnalyzer::getJobCount() const {
+    size_t jobs = options_.jobs > 0 ? options_.jobs : hardwareThreads();
+    return std::min(jobs, hardwareThreads());
+}
+
+int BatchAnalyzer::getDecoderThreadsPerFile() const {
+    if (options_.decoderOptions.threadCount > 0) {
+        return options_.decoderOptions.threadCount;
+    }
+    
+    // Share the hardware threads evenly between concurrently analyzed files
+    return static_cast<int>(std::max<size_t>(1, hardwareThreads() / getJobCount()));
+}
+
+BatchSummary BatchAnalyzer::run(const std::vector<std::string>& files) {
+    auto startTime = std::chrono::steady_clock::now();
+    
+    fs::create_directories(options_.outputDir);
+    
+    // Assign unique report names up front so the output is deterministic
+    std::vector<std::string> reportPaths;
+    std::set<std::string> usedNames;
+    std::string extension = options_.format == "csv" ? ".csv"
+                          : options_.format == "binary" ? ".vsa" : ".json";
+    for (const auto& file : files) {
+        std::string stem = fs::path(file).stem().string();
+        std::string name = stem + extension;
+        for (int suffix = 1; usedNames.count(name) > 0; ++suffix) {
+            name = stem + "_" + std::to_string(suffix) + extension;
+        }
+        usedNames.insert(name);
+        reportPaths.push_back((fs::path(options_.outputDir) / name).string());
+    }
+    
+    BatchSummary summary;
+    summary.files.resize(files.size());
+    
+    {
+        ThreadPool pool(getJobCount());
+        std::mutex progressMutex;
+        size_t completed = 0;
+        
+        std::vector<std::future<void>> results;
+        results.reserve(files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            results.push_back(pool.submit([&, i]() {
+                summary.files[i] = analyzeFile(files[i], reportPaths[i]);
+                
+                std::lock_guard<std::mutex> lock(progressMutex);
+                completed++;
+                if (progressCallback_) {
+                    progressCallback_(summary.files[i], completed, files.size());
+                }
+            }));
+        }
+        
+        for (auto& result : results) {
+            result.get();
+        }
+    }
+    
+    for (const auto& result : summary.files) {
+        if (result.success) {
+            summary.succeeded++;
+            summary.totalFrames += result.frameStats.totalFrames;
+        } else {
+            summary.failed++;
+        }
+    }
+    
+    summary.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    if (summary.elapsedSeconds > 0.0) {
+        summary.filesPerHour = files.size() * 3600.0 / summary.elapsedSeconds;
+    }
+    
+    std::ofstream summaryFile(fs::path(options_.outputDir) / "batch_summary.json");
+    summaryFile << summary.toJson().dump(2);
+    
+    return summary;
+}
+
+BatchFileResult BatchAnalyzer::analyzeFile(const std::string& path, const std::string& reportPath) const {
+    auto startTime = std::chrono::steady_clock::now();
+    
+    BatchFileResult result;
+    result.path = path;
+    
+    try {
+        DecoderOptions decoderOptions = options_.decoderOptions;
+        decoderOptions.threadCount = getDecoderThreadsPerFile();
+        VideoDecoder decoder(path, decoderOptions);
+        result.streamInfo = decoder.getStreamInfo();
+        
+        FrameStatisticsAccumulator statsAccumulator;
+        GOPAnalyzer gopAnalyzer(decoder);
+        BitrateAnalyzer bitrateAnalyzer(decoder);
+        std::unique_ptr<ReportWriter> reportWriter;
+        std::unique_ptr<BinaryReportWriter> binaryWriter;
+        
+        AnalysisPipeline pipeline(decoder);
+        if (options_.format == "binary") {
+            binaryWriter = std::make_unique<BinaryReportWriter>(reportPath);
+            binaryWriter->setMotionExport(decoderOptions.exportMotionVectors);
+            pipeline.addSink(*binaryWriter);
+        } else {
+            reportWriter = std::make_unique<ReportWriter>(
+                reportPath, options_.format == "csv" ? ReportFormat::CSV : ReportFormat::JSON);
+            pipeline.addSink(*reportWriter);
+        }
+        pipeline.addSink(statsAccumulator);
+        pipeline.addSink(gopAnalyzer);
+        pipeline.addSink(bitrateAnalyzer);
+        pipeline.run(options_.maxFrames);
+        
+        result.frameStats = statsAccumulator.getStatistics();
+        result.gopCount = gopAnalyzer.getGOPs().size();
+        result.averageGOPLength = gopAnalyzer.getAverageGOPLength();
+        
+        if (binaryWriter) {
+            binaryWriter->setGOPs(gopAnalyzer.getGOPs());
+            binaryWriter->setBitrateStatistics(bitrateAnalyzer.getStatistics());
+            binaryWriter->finish({
+                {"frameStatistics", result.frameStats.toJson()},
+                {"source", path}
+            });
+        } else {
+            nlohmann::json gopsJson = nlohmann::json::array();
+            for (const auto& gop : gopAnalyzer.getGOPs()) {
+                gopsJson.push_back(gop.toJson());
+            }
+            reportWriter->finish({
+                {"frameStatistics", result.frameStats.toJson()},
+                {"bitrateStatistics", bitrateAnalyzer.getStatistics().toJson()},
+                {"gops", gopsJson}
+            });
+        }
+        
+        result.reportPath = reportPath;
+        result.success = true;
+    } catch (const std::exception& e) {
+        result.success = false;
+        result.error = e.what();
+    }
+    
+    result.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+} // namespace video_analyzer
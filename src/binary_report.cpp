@@ -0,0 +1,677 @@
+#include "video_analyzer/binary_report.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Columns are written and mapped in host byte order, so the host must be
+// little-endian to match the format (Windows targets always are)
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "Binary reports require a little-endian host");
+#elif !defined(_WIN32)
+#error "Cannot determine the byte order; binary reports require a little-endian host"
+#endif
+
+namespace video_analyzer {
+
+namespace {
+
+// On-disk structures; every field is naturally aligned so there is no padding.
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t columnCount;
+    uint64_t directoryOffset;
+    uint64_t metadataOffset;
+    uint64_t metadataSize;
+    uint64_t fileSize;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader must be 64 bytes");
+
+struct DirectoryEntry {
+    char name[40];
+    char dtype[8];
+    uint64_t offset;
+    uint64_t count;
+};
+static_assert(sizeof(DirectoryEntry) == 64, "DirectoryEntry must be 64 bytes");
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kBinaryReportAlignment - 1) / kBinaryReportAlignment * kBinaryReportAlignment;
+}
+
+// Element size encoded in a numpy dtype string ("<i8" -> 8)
+size_t dtypeSize(const char* dtype) {
+    return static_cast<size_t>(dtype[2] - '0');
+}
+
+// Whether count elements of elementSize bytes at offset lie within the
+// file, without the overflow of computing offset + count * elementSize
+bool fitsInFile(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize) {
+    return offset <= fileSize && elementSize != 0 && count <= (fileSize - offset) / elementSize;
+}
+
+// Column to be written: points into the writer's buffers
+struct ColumnSource {
+    const char* name;
+    const char* dtype;
+    const void* data;
+    size_t count;
+};
+
+template <typename T>
+ColumnSource makeColumn(const char* name, const std::vector<T>& values) {
+    return ColumnSource{name, binaryColumnDtype<T>(), values.data(), values.size()};
+}
+
+} // namespace
+
+// BinaryReportWriter implementation
+class BinaryReportWriter::Impl {
+public:
+    std::string path;
+    StreamInfo streamInfo{};
+    bool finished = false;
+    bool exportMotion = false;
+    
+    // Frame columns
+    std::vector<int64_t> pts;
+    std::vector<int64_t> dts;
+    std::vector<int64_t> pos;
+    std::vector<double> timestamp;
+    std::vector<int32_t> size;
+    std::vector<int32_t> duplicateGroupId;
+    std::vector<int16_t> qp;
+    std::vector<int16_t> qpMin;
+    std::vector<int16_t> qpMax;
+    std::vector<uint8_t> type;
+    std::vector<uint8_t> flags;
+    
+    // GOP columns
+    std::vector<int32_t> gopIndex;
+    std::vector<int64_t> gopStartPts;
+    std::vector<int64_t> gopEndPts;
+    std::vector<int32_t> gopFrameCount;
+    std::vector<int32_t> gopIFrameCount;
+    std::vector<int32_t> gopPFrameCount;
+    std::vector<int32_t> gopBFrameCount;
+    std::vector<int64_t> gopTotalSize;
+    std::vector<uint8_t> gopIsOpen;
+    
+    // Bitrate columns and summary
+    std::vector<double> bitrateTimestamp;
+    std::vector<double> bitrateValue;
+    nlohmann::json bitrateSummary;
+    
+    // Motion columns
+    std::vector<int64_t> motionPts;
+    std::vector<int32_t> motionVectorCount;
+    std::vector<float> motionAverageMagnitude;
+    std::vector<float> motionMaxMagnitude;
+    
+    void write(const nlohmann::json& summary);
+};
+
+void BinaryReportWriter::Impl::write(const nlohmann::json& summary) {
+    std::vector<ColumnSource> columns = {
+        makeColumn("frames.pts", pts),
+        makeColumn("frames.dts", dts),
+        makeColumn("frames.pos", pos),
+        makeColumn("frames.timestamp", timestamp),
+        makeColumn("frames.size", size),
+        makeColumn("frames.duplicateGroupId", duplicateGroupId),
+        makeColumn("frames.qp", qp),
+        makeColumn("frames.qpMin", qpMin),
+        makeColumn("frames.qpMax", qpMax),
+        makeColumn("frames.type", type),
+        makeColumn("frames.flags", flags),
+        makeColumn("gops.gopIndex", gopIndex),
+        makeColumn("gops.startPts", gopStartPts),
+        makeColumn("gops.endPts", gopEndPts),
+        makeColumn("gops.frameCount", gopFrameCount),
+        makeColumn("gops.iFrameCount", gopIFrameCount),
+        makeColumn("gops.pFrameCount", gopPFrameCount),
+        makeColumn("gops.bFrameCount", gopBFrameCount),
+        makeColumn("gops.totalSize", gopTotalSize),
+        makeColumn("gops.isOpenGOP", gopIsOpen),
+        makeColumn("bitrate.timestamp", bitrateTimestamp),
+        makeColumn("bitrate.bitrate", bitrateValue),
+        makeColumn("motion.pts", motionPts),
+        makeColumn("motion.vectorCount", motionVectorCount),
+        makeColumn("motion.averageMagnitude", motionAverageMagnitude),
+        makeColumn("motion.maxMagnitude", motionMaxMagnitude)
+    };
+    
+    nlohmann::json metadata = {
+        {"streamInfo", streamInfo.toJson()},
+        {"frameTypes", {"I", "P", "B", "UNKNOWN"}},
+        {"frameFlags", {{"keyFrame", kFrameFlagKeyFrame}, {"duplicate", kFrameFlagDuplicate}}}
+    };
+    if (!bitrateSummary.is_null()) {
+        metadata["bitrateStatistics"] = bitrateSummary;
+    }
+    for (const auto& item : summary.items()) {
+        metadata[item.key()] = item.value();
+    }
+    std::string metadataText = metadata.dump();
+    
+    // Lay out the directory, the aligned columns and the metadata
+    std::vector<DirectoryEntry> directory(columns.size());
+    uint64_t offset = alignUp(sizeof(FileHeader) + directory.size() * sizeof(DirectoryEntry));
+    for (size_t i = 0; i < columns.size(); ++i) {
+        DirectoryEntry& entry = directory[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::strncpy(entry.name, columns[i].name, sizeof(entry.name) - 1);
+        std::strncpy(entry.dtype, columns[i].dtype, sizeof(entry.dtype) - 1);
+        entry.offset = offset;
+        entry.count = columns[i].count;
+        offset = alignUp(offset + columns[i].count * dtypeSize(columns[i].dtype));
+    }
+    
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kBinaryReportMagic, sizeof(header.magic));
+    header.version = kBinaryReportVersion;
+    header.columnCount = static_cast<uint32_t>(columns.size());
+    header.directoryOffset = sizeof(FileHeader);
+    header.metadataOffset = offset;
+    header.metadataSize = metadataText.size();
+    header.fileSize = offset + metadataText.size();
+    
+    std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open report file: " + path);
+    }
+    
+    static const char padding[kBinaryReportAlignment] = {};
+    uint64_t written = 0;
+    auto writeBytes = [&](const void* data, uint64_t bytes) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written += bytes;
+    };
+    auto padTo = [&](uint64_t target) {
+        writeBytes(padding, target - written);
+    };
+    
+    writeBytes(&header, sizeof(header));
+    writeBytes(directory.data(), directory.size() * sizeof(DirectoryEntry));
+    for (size_t i = 0; i < columns.size(); ++i) {
+        padTo(directory[i].offset);
+        writeBytes(columns[i].data, columns[i].count * dtypeSize(columns[i].dtype));
+    }
+    padTo(header.metadataOffset);
+    writeBytes(metadataText.data(), metadataText.size());
+    
+    file.close();
+    if (file.fail()) {
+        throw std::runtime_error("Failed to write report file: " + path);
+    }
+}
+
+BinaryReportWriter::BinaryReportWriter(const std::string& path)
+    : pImpl(std::make_unique<Impl>()) {
+    pImpl->path = path;
+}
+
+BinaryReportWriter::~BinaryReportWriter() {
+    if (!pImpl->finished) {
+        try {
+            finish();
+        } catch (...) {
+            // Destructors must not throw
+        }
+    }
+}
+
+void BinaryReportWriter::begin(const StreamInfo& info) {
+    pImpl->streamInfo = info;
+}
+
+void BinaryReportWriter::consume(const FrameInfo& frame, const VideoDecoder& decoder) {
+    writeFrame(frame);
+    
+    // Replayed frames have no decoded picture to take vectors from
+    if (pImpl->exportMotion && decoder.getLastDecodedFrame()) {
+        if (auto field = decoder.getMotionField()) {
+            writeMotion(frame.pts, MotionAccumulator::fromField(*field));
+        }
+    }
+}
+
+bool BinaryReportWriter::needsMotionVectors() const {
+    return pImpl->exportMotion;
+}
+
+void BinaryReportWriter::setMotionExport(bool enable) {
+    pImpl->exportMotion = enable;
+}
+
+void BinaryReportWriter::writeFrame(const FrameInfo& frame) {
+    Impl& d = *pImpl;
+    d.pts.push_back(frame.pts);
+    d.dts.push_back(frame.dts);
+    d.pos.push_back(frame.pos);
+    d.timestamp.push_back(frame.timestamp);
+    d.size.push_back(frame.size);
+    d.duplicateGroupId.push_back(frame.duplicateGroupId);
+    d.qp.push_back(static_cast<int16_t>(frame.qp));
+    d.qpMin.push_back(static_cast<int16_t>(frame.qpMin));
+    d.qpMax.push_back(static_cast<int16_t>(frame.qpMax));
+    d.type.push_back(static_cast<uint8_t>(frame.type));
+    d.flags.push_back(static_cast<uint8_t>((frame.isKeyFrame ? kFrameFlagKeyFrame : 0) |
+                                           (frame.isDuplicate ? kFrameFlagDuplicate : 0)));
+}
+
+void BinaryReportWriter::setGOPs(const std::vector<GOPInfo>& gops) {
+    Impl& d = *pImpl;
+    d.gopIndex.clear();
+    d.gopStartPts.clear();
+    d.gopEndPts.clear();
+    d.gopFrameCount.clear();
+    d.gopIFrameCount.clear();
+    d.gopPFrameCount.clear();
+    d.gopBFrameCount.clear();
+    d.gopTotalSize.clear();
+    d.gopIsOpen.clear();
+    
+    for (const auto& gop : gops) {
+        d.gopIndex.push_back(gop.gopIndex);
+        d.gopStartPts.push_back(gop.startPts);
+        d.gopEndPts.push_back(gop.endPts);
+        d.gopFrameCount.push_back(gop.frameCount);
+        d.gopIFrameCount.push_back(gop.iFrameCount);
+        d.gopPFrameCount.push_back(gop.pFrameCount);
+        d.gopBFrameCount.push_back(gop.bFrameCount);
+        d.gopTotalSize.push_back(gop.totalSize);
+        d.gopIsOpen.push_back(gop.isOpenGOP ? 1 : 0);
+    }
+}
+
+void BinaryReportWriter::setBitrateStatistics(const BitrateStatistics& stats) {
+    Impl& d = *pImpl;
+    d.bitrateTimestamp.clear();
+    d.bitrateValue.clear();
+    for (const auto& point : stats.timeSeriesData) {
+        d.bitrateTimestamp.push_back(point.timestamp);
+        d.bitrateValue.push_back(point.bitrate);
+    }
+    
+    d.bitrateSummary = {
+        {"averageBitrate", stats.averageBitrate},
+        {"maxBitrate", stats.maxBitrate},
+        {"minBitrate", stats.minBitrate},
+        {"stdDeviation", stats.stdDeviation}
+    };
+}
+
+void BinaryReportWriter::writeMotion(int64_t pts, const MotionAccumulator& summary) {
+    Impl& d = *pImpl;
+    d.motionPts.push_back(pts);
+    d.motionVectorCount.push_back(static_cast<int32_t>(summary.count));
+    d.motionAverageMagnitude.push_back(static_cast<float>(summary.averageMagnitude()));
+    d.motionMaxMagnitude.push_back(summary.maxMagnitude);
+}
+
+void BinaryReportWriter::setMotionVectorData(const std::vector<MotionField>& fields) {
+    Impl& d = *pImpl;
+    d.motionPts.clear();
+    d.motionVectorCount.clear();
+    d.motionAverageMagnitude.clear();
+    d.motionMaxMagnitude.clear();
+    
+    for (const auto& field : fields) {
+        writeMotion(field.pts, MotionAccumulator::fromField(field));
+    }
+}
+
+void BinaryReportWriter::finish(const nlohmann::json& summary) {
+    if (pImpl->finished) {
+        return;
+    }
+    pImpl->finished = true;
+    pImpl->write(summary);
+}
+
+void BinaryReportWriter::discard() {
+    pImpl->finished = true;
+}
+
+size_t BinaryReportWriter::getFramesWritten() const {
+    return pImpl->pts.size();
+}
+
+// BinaryReport implementation
+class BinaryReport::Impl {
+public:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    struct Column {
+        std::string dtype;
+        uint64_t offset;
+        uint64_t count;
+    };
+    std::unordered_map<std::string, Column> columns;
+    nlohmann::json metadata;
+    
+    void map(const std::string& path);
+    void unmap();
+    void parseDirectory(const std::string& path);
+};
+
+void BinaryReport::Impl::map(const std::string& path) {
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open report: " + path);
+    }
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        throw std::runtime_error("Failed to stat report: " + path);
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) {
+        throw std::runtime_error("Empty report file: " + path);
+    }
+    
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        throw std::runtime_error("Failed to map report: " + path);
+    }
+    data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        throw std::runtime_error("Failed to map report: " + path);
+    }
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open report: " + path);
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        throw std::runtime_error("Failed to stat report: " + path);
+    }
+    size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        throw std::runtime_error("Empty report file: " + path);
+    }
+    
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Failed to map report: " + path);
+    }
+    data = static_cast<const uint8_t*>(mapped);
+#endif
+}
+
+void BinaryReport::Impl::unmap() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    fd = -1;
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+void BinaryReport::Impl::parseDirectory(const std::string& path) {
+    FileHeader header;
+    if (size < sizeof(header)) {
+        throw std::runtime_error("Not a binary analysis report: " + path);
+    }
+    std::memcpy(&header, data, sizeof(header));
+    
+    if (std::memcmp(header.magic, kBinaryReportMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a binary analysis report: " + path);
+    }
+    if (header.version != kBinaryReportVersion) {
+        throw std::runtime_error("Unsupported binary report version " +
+                                 std::to_string(header.version) + ": " + path);
+    }
+    
+    if (!fitsInFile(header.directoryOffset, header.columnCount, sizeof(DirectoryEntry), size) ||
+        !fitsInFile(header.metadataOffset, header.metadataSize, 1, size)) {
+        throw std::runtime_error("Truncated binary report: " + path);
+    }
+    
+    for (uint32_t i = 0; i < header.columnCount; ++i) {
+        DirectoryEntry entry;
+        std::memcpy(&entry, data + header.directoryOffset + i * sizeof(DirectoryEntry), sizeof(entry));
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        entry.dtype[sizeof(entry.dtype) - 1] = '\0';
+        
+        Column column{entry.dtype, entry.offset, entry.count};
+        if (column.dtype.size() != 3 || entry.offset % kBinaryReportAlignment != 0 ||
+            !fitsInFile(entry.offset, entry.count, dtypeSize(entry.dtype), size)) {
+            throw std::runtime_error("Corrupt column '" + std::string(entry.name) +
+                                     "' in binary report: " + path);
+        }
+        columns[entry.name] = column;
+    }
+    
+    const char* metadataText = reinterpret_cast<const char*>(data + header.metadataOffset);
+    metadata = nlohmann::json::parse(metadataText, metadataText + header.metadataSize);
+}
+
+BinaryReport::BinaryReport(const std::string& path)
+    : pImpl(std::make_unique<Impl>()) {
+    try {
+        pImpl->map(path);
+        pImpl->parseDirectory(path);
+    } catch (...) {
+        pImpl->unmap();
+        throw;
+    }
+}
+
+BinaryReport::~BinaryReport() {
+    pImpl->unmap();
+}
+
+bool BinaryReport::isBinaryReport(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kBinaryReportMagic)] = {};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, kBinaryReportMagic, sizeof(magic)) == 0;
+}
+
+bool BinaryReport::hasColumn(const std::string& name) const {
+    return pImpl->columns.count(name) > 0;
+}
+
+const void* BinaryReport::columnData(const std::string& name, const char* dtype, size_t& count) const {
+    auto it = pImpl->columns.find(name);
+    if (it == pImpl->columns.end()) {
+        throw std::runtime_error("Missing column in binary report: " + name);
+    }
+    if (it->second.dtype != dtype) {
+        throw std::runtime_error("Column '" + name + "' has dtype " + it->second.dtype +
+                                 ", expected " + dtype);
+    }
+    
+    count = static_cast<size_t>(it->second.count);
+    return pImpl->data + it->second.offset;
+}
+
+const nlohmann::json& BinaryReport::getMetadata() const {
+    return pImpl->metadata;
+}
+
+size_t BinaryReport::getFrameCount() const {
+    auto it = pImpl->columns.find("frames.pts");
+    return it != pImpl->columns.end() ? static_cast<size_t>(it->second.count) : 0;
+}
+
+StreamInfo BinaryReport::getStreamInfo() const {
+    StreamInfo info{};
+    const nlohmann::json j = pImpl->metadata.value("streamInfo", nlohmann::json::object());
+    info.codecName = j.value("codecName", "");
+    info.width = j.value("width", 0);
+    info.height = j.value("height", 0);
+    info.frameRate = j.value("frameRate", 0.0);
+    info.duration = j.value("duration", 0.0);
+    info.bitrate = j.value("bitrate", int64_t{0});
+    info.pixelFormat = j.value("pixelFormat", "");
+    info.streamIndex = j.value("streamIndex", 0);
+    
+    if (j.contains("av1TileInfo")) {
+        AV1TileInfo tileInfo;
+        tileInfo.tileColumns = j["av1TileInfo"].value("tileColumns", 0);
+        tileInfo.tileRows = j["av1TileInfo"].value("tileRows", 0);
+        info.av1TileInfo = tileInfo;
+    }
+    
+    return info;
+}
+
+FrameStatistics BinaryReport::getFrameStatistics() const {
+    FrameStatistics stats;
+    const nlohmann::json j = pImpl->metadata.value("frameStatistics", nlohmann::json::object());
+    stats.totalFrames = j.value("totalFrames", 0);
+    stats.iFrames = j.value("iFrames", 0);
+    stats.pFrames = j.value("pFrames", 0);
+    stats.bFrames = j.value("bFrames", 0);
+    stats.averageFrameSize = j.value("averageFrameSize", 0.0);
+    stats.maxFrameSize = j.value("maxFrameSize", 0);
+    stats.minFrameSize = j.value("minFrameSize", 0);
+    stats.averageQP = j.value("averageQP", 0.0);
+    return stats;
+}
+
+std::vector<FrameInfo> BinaryReport::readFrames() const {
+    auto pts = column<int64_t>("frames.pts");
+    auto dts = column<int64_t>("frames.dts");
+    auto pos = column<int64_t>("frames.pos");
+    auto timestamp = column<double>("frames.timestamp");
+    auto size = column<int32_t>("frames.size");
+    auto duplicateGroupId = column<int32_t>("frames.duplicateGroupId");
+    auto qp = column<int16_t>("frames.qp");
+    auto qpMin = column<int16_t>("frames.qpMin");
+    auto qpMax = column<int16_t>("frames.qpMax");
+    auto type = column<uint8_t>("frames.type");
+    auto flags = column<uint8_t>("frames.flags");
+    
+    for (size_t count : {dts.size, pos.size, timestamp.size, size.size, duplicateGroupId.size,
+                         qp.size, qpMin.size, qpMax.size, type.size, flags.size}) {
+        if (count != pts.size) {
+            throw std::runtime_error("Frame columns have different lengths");
+        }
+    }
+    
+    std::vector<FrameInfo> frames(pts.size);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        FrameInfo& frame = frames[i];
+        frame.pts = pts[i];
+        frame.dts = dts[i];
+        frame.pos = pos[i];
+        frame.timestamp = timestamp[i];
+        frame.size = size[i];
+        frame.duplicateGroupId = duplicateGroupId[i];
+        frame.qp = qp[i];
+        frame.qpMin = qpMin[i];
+        frame.qpMax = qpMax[i];
+        frame.type = type[i] <= static_cast<uint8_t>(FrameType::UNKNOWN)
+                     ? static_cast<FrameType>(type[i]) : FrameType::UNKNOWN;
+        frame.isKeyFrame = (flags[i] & kFrameFlagKeyFrame) != 0;
+        frame.isDuplicate = (flags[i] & kFrameFlagDuplicate) != 0;
+    }
+    
+    return frames;
+}
+
+std::vector<GOPInfo> BinaryReport::readGOPs() const {
+    auto gopIndex = column<int32_t>("gops.gopIndex");
+    auto startPts = column<int64_t>("gops.startPts");
+    auto endPts = column<int64_t>("gops.endPts");
+    auto frameCount = column<int32_t>("gops.frameCount");
+    auto iFrameCount = column<int32_t>("gops.iFrameCount");
+    auto pFrameCount = column<int32_t>("gops.pFrameCount");
+    auto bFrameCount = column<int32_t>("gops.bFrameCount");
+    auto totalSize = column<int64_t>("gops.totalSize");
+    auto isOpenGOP = column<uint8_t>("gops.isOpenGOP");
+    
+    for (size_t count : {startPts.size, endPts.size, frameCount.size, iFrameCount.size,
+                         pFrameCount.size, bFrameCount.size, totalSize.size, isOpenGOP.size}) {
+        if (count != gopIndex.size) {
+            throw std::runtime_error("GOP columns have different lengths");
+        }
+    }
+    
+    std::vector<GOPInfo> gops(gopIndex.size);
+    for (size_t i = 0; i < gops.size(); ++i) {
+        GOPInfo& gop = gops[i];
+        gop.gopIndex = gopIndex[i];
+        gop.startPts = startPts[i];
+        gop.endPts = endPts[i];
+        gop.frameCount = frameCount[i];
+        gop.iFrameCount = iFrameCount[i];
+        gop.pFrameCount = pFrameCount[i];
+        gop.bFrameCount = bFrameCount[i];
+        gop.totalSize = totalSize[i];
+        gop.isOpenGOP = isOpenGOP[i] != 0;
+    }
+    
+    return gops;
+}
+
+BitrateStatistics BinaryReport::readBitrateStatistics() const {
+    BitrateStatistics stats{};
+    const nlohmann::json j = pImpl->metadata.value("bitrateStatistics", nlohmann::json::object());
+    stats.averageBitrate = j.value("averageBitrate", 0.0);
+    stats.maxBitrate = j.value("maxBitrate", 0.0);
+    stats.minBitrate = j.value("minBitrate", 0.0);
+    stats.stdDeviation = j.value("stdDeviation", 0.0);
+    
+    auto timestamp = column<double>("bitrate.timestamp");
+    auto bitrate = column<double>("bitrate.bitrate");
+    if (timestamp.size != bitrate.size) {
+        throw std::runtime_error("Bitrate columns have different lengths");
+    }
+    
+    stats.timeSeriesData.reserve(timestamp.size);
+    for (size_t i = 0; i < timestamp.size; ++i) {
+        stats.timeSeriesData.push_back({timestamp[i], bitrate[i]});
+    }
+    
+    return stats;
+}
+
+} // namespace video_analyzer
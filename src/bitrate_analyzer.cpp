@@ -9,109 +9,107 @@ BitrateAnalyzer::BitrateAnalyzer(VideoDecoder& decoder, double windowSize)
     : decoder_(decoder), windowSize_(windowSize) {}
 
 BitrateStatistics BitrateAnalyzer::analyze() {
-    BitrateStatistics stats;
-    
-    // Collect all frames
-    std::vector<FrameInfo> frames;
     decoder_.reset();
     
-    while (auto frame = decoder_.readNextFrame()) {
-        frames.push_back(*frame);
+    AnalysisPipeline pipeline(decoder_);
+    pipeline.addSink(*this);
+    pipeline.run();
+    
+    return stats_;
+}
+
+void BitrateAnalyzer::begin(const StreamInfo& /*info*/) {
+    stats_ = BitrateStatistics{};
+    totalSize_ = 0;
+    frameCount_ = 0;
+    windowBytes_ = 0;
+    windowFrames_ = 0;
+    bitrateValues_.clear();
+}
+
+void BitrateAnalyzer::consume(const FrameInfo& frame, const VideoDecoder& /*decoder*/) {
+    if (frameCount_ == 0) {
+        firstTimestamp_ = frame.timestamp;
     }
+    lastTimestamp_ = frame.timestamp;
+    totalSize_ += frame.size;
+    frameCount_++;
     
-    if (frames.empty()) {
-        return stats;
+    // Close the current window once a frame falls outside of it
+    if (windowFrames_ > 0 && !(frame.timestamp < windowEnd_)) {
+        closeWindow();
     }
     
-    // Calculate total size and duration
-    int64_t totalSize = 0;
-    for (const auto& frame : frames) {
-        totalSize += frame.size;
+    if (windowFrames_ == 0) {
+        windowStart_ = frame.timestamp;
+        windowEnd_ = windowStart_ + windowSize_;
     }
     
-    double duration = frames.back().timestamp - frames.front().timestamp;
-    if (duration <= 0) {
-        duration = frames.size() / 30.0; // Assume 30fps if timestamps are invalid
+    if (frame.timestamp < windowEnd_) {
+        windowBytes_ += frame.size;
+        windowLastTimestamp_ = frame.timestamp;
+        windowFrames_++;
+    }
+}
+
+void BitrateAnalyzer::end() {
+    if (windowFrames_ > 0) {
+        closeWindow();
     }
     
-    // Calculate average bitrate
-    stats.averageBitrate = (totalSize * 8.0) / duration; // bits per second
+    if (frameCount_ == 0) {
+        return;
+    }
     
-    // Calculate instantaneous bitrate using time windows
-    stats.minBitrate = stats.averageBitrate;
-    stats.maxBitrate = stats.averageBitrate;
+    double duration = lastTimestamp_ - firstTimestamp_;
+    if (duration <= 0) {
+        duration = frameCount_ / 30.0; // Assume 30fps if timestamps are invalid
+    }
     
-    std::vector<double> bitrateValues;
+    // Calculate average bitrate
+    stats_.averageBitrate = (totalSize_ * 8.0) / duration; // bits per second
     
-    for (size_t i = 0; i < frames.size(); ) {
-        double windowStart = frames[i].timestamp;
-        double windowEnd = windowStart + windowSize_;
-        
-        // Find frames in this window
-        size_t windowEndIdx = i;
-        while (windowEndIdx < frames.size() && 
-               frames[windowEndIdx].timestamp < windowEnd) {
-            windowEndIdx++;
-        }
-        
-        if (windowEndIdx > i) {
-            double bitrate = calculateInstantaneousBitrate(frames, i, windowEndIdx);
-            bitrateValues.push_back(bitrate);
-            
-            stats.timeSeriesData.push_back({
-                windowStart,
-                bitrate
-            });
-            
-            stats.minBitrate = std::min(stats.minBitrate, bitrate);
-            stats.maxBitrate = std::max(stats.maxBitrate, bitrate);
-        }
-        
-        // Move to next window
-        i = windowEndIdx > i ? windowEndIdx : i + 1;
+    stats_.minBitrate = stats_.averageBitrate;
+    stats_.maxBitrate = stats_.averageBitrate;
+    for (double bitrate : bitrateValues_) {
+        stats_.minBitrate = std::min(stats_.minBitrate, bitrate);
+        stats_.maxBitrate = std::max(stats_.maxBitrate, bitrate);
     }
     
     // Calculate standard deviation
-    if (!bitrateValues.empty()) {
-        double mean = stats.averageBitrate;
+    if (!bitrateValues_.empty()) {
+        double mean = stats_.averageBitrate;
         double variance = 0.0;
         
-        for (double bitrate : bitrateValues) {
+        for (double bitrate : bitrateValues_) {
             double diff = bitrate - mean;
             variance += diff * diff;
         }
         
-        variance /= bitrateValues.size();
-        stats.stdDeviation = std::sqrt(variance);
+        variance /= bitrateValues_.size();
+        stats_.stdDeviation = std::sqrt(variance);
     }
-    
-    return stats;
 }
 
 void BitrateAnalyzer::setWindowSize(double seconds) {
     windowSize_ = seconds;
 }
 
-double BitrateAnalyzer::calculateInstantaneousBitrate(
-    const std::vector<FrameInfo>& frames,
-    size_t startIdx,
-    size_t endIdx
-) const {
-    if (startIdx >= endIdx || endIdx > frames.size()) {
-        return 0.0;
-    }
-    
-    int64_t totalSize = 0;
-    for (size_t i = startIdx; i < endIdx; ++i) {
-        totalSize += frames[i].size;
-    }
-    
-    double duration = frames[endIdx - 1].timestamp - frames[startIdx].timestamp;
+void BitrateAnalyzer::closeWindow() {
+    double duration = windowLastTimestamp_ - windowStart_;
     if (duration <= 0) {
-        duration = (endIdx - startIdx) / 30.0; // Assume 30fps
+        duration = windowFrames_ / 30.0; // Assume 30fps
     }
     
-    return (totalSize * 8.0) / duration; // bits per second
+    double bitrate = (windowBytes_ * 8.0) / duration; // bits per second
+    bitrateValues_.push_back(bitrate);
+    stats_.timeSeriesData.push_back({
+        windowStart_,
+        bitrate
+    });
+    
+    windowBytes_ = 0;
+    windowFrames_ = 0;
 }
 
 } // namespace video_analyzer
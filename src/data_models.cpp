@@ -6,7 +6,7 @@
 namespace video_analyzer {
 
 // Helper functions
-std::string frameTypeToString(FrameType type) {
+const char* frameTypeName(FrameType type) {
     switch (type) {
         case FrameType::I_FRAME: return "I";
         case FrameType::P_FRAME: return "P";
@@ -16,6 +16,10 @@ std::string frameTypeToString(FrameType type) {
     }
 }
 
+std::string frameTypeToString(FrameType type) {
+    return frameTypeName(type);
+}
+
 FrameType stringToFrameType(const std::string& str) {
     if (str == "I") return FrameType::I_FRAME;
     if (str == "P") return FrameType::P_FRAME;
@@ -31,10 +35,13 @@ nlohmann::json FrameInfo::toJson() const {
         {"type", frameTypeToString(type)},
         {"size", size},
         {"qp", qp},
+        {"qpMin", qpMin},
+        {"qpMax", qpMax},
         {"isKeyFrame", isKeyFrame},
         {"timestamp", timestamp},
         {"isDuplicate", isDuplicate},
-        {"duplicateGroupId", duplicateGroupId}
+        {"duplicateGroupId", duplicateGroupId},
+        {"pos", pos}
     };
 }
 
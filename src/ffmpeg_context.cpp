@@ -5,8 +5,11 @@ extern "C" {
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
 #include <libavutil/error.h>
+#include <libavutil/buffer.h>
 }
 
+#include <chrono>
+
 namespace video_analyzer {
 
 // FFmpegError implementation
@@ -146,4 +149,28 @@ AVFrame* FramePtr::operator->() const {
     return frame_;
 }
 
+// Packet metadata helpers
+void attachPacketMetadata(AVPacket* packet) {
+    av_buffer_unref(&packet->opaque_ref);
+    packet->opaque_ref = av_buffer_allocz(sizeof(PacketMetadata));
+    if (!packet->opaque_ref) {
+        throw FFmpegError(AVERROR(ENOMEM), "Failed to allocate packet metadata");
+    }
+    
+    auto* meta = reinterpret_cast<PacketMetadata*>(packet->opaque_ref->data);
+    meta->size = packet->size;
+    meta->pos = packet->pos;
+    meta->attachedAt = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const PacketMetadata* getPacketMetadata(const AVFrame* frame) {
+    if (!frame || !frame->opaque_ref ||
+        static_cast<size_t>(frame->opaque_ref->size) < sizeof(PacketMetadata)) {
+        return nullptr;
+    }
+    
+    return reinterpret_cast<const PacketMetadata*>(frame->opaque_ref->data);
+}
+
 } // namespace video_analyzer
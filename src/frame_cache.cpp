@@ -0,0 +1,80 @@
+#include "video_analyzer/frame_cache.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+namespace video_analyzer {
+
+FrameCache::FrameCache(size_t budgetBytes)
+    : budget_(budgetBytes) {}
+
+bool FrameCache::put(int64_t frameNumber, const AVFrame* frame) {
+    FramePtr copy;
+    if (av_frame_ref(copy.get(), frame) < 0) {
+        return false;
+    }
+
+    auto it = lookup_.find(frameNumber);
+    if (it != lookup_.end()) {
+        memoryUsage_ -= it->second->bytes;
+        entries_.erase(it->second);
+        lookup_.erase(it);
+    }
+
+    size_t bytes = frameBytes(copy.get());
+    entries_.push_front(Entry{frameNumber, std::move(copy), bytes});
+    lookup_[frameNumber] = entries_.begin();
+    memoryUsage_ += bytes;
+
+    evict();
+    return true;
+}
+
+AVFrame* FrameCache::get(int64_t frameNumber) {
+    auto it = lookup_.find(frameNumber);
+    if (it == lookup_.end()) {
+        misses_++;
+        return nullptr;
+    }
+
+    hits_++;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->frame.get();
+}
+
+bool FrameCache::contains(int64_t frameNumber) const {
+    return lookup_.count(frameNumber) > 0;
+}
+
+void FrameCache::clear() {
+    entries_.clear();
+    lookup_.clear();
+    memoryUsage_ = 0;
+}
+
+void FrameCache::setBudget(size_t budgetBytes) {
+    budget_ = budgetBytes;
+    evict();
+}
+
+size_t FrameCache::frameBytes(const AVFrame* frame) {
+    size_t bytes = 0;
+    for (int i = 0; i < AV_NUM_DATA_POINTERS; ++i) {
+        if (frame->buf[i]) {
+            bytes += frame->buf[i]->size;
+        }
+    }
+    return bytes;
+}
+
+void FrameCache::evict() {
+    while (memoryUsage_ > budget_ && entries_.size() > 1) {
+        Entry& oldest = entries_.back();
+        memoryUsage_ -= oldest.bytes;
+        lookup_.erase(oldest.frameNumber);
+        entries_.pop_back();
+    }
+}
+
+} // namespace video_analyzer
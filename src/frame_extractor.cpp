@@ -1,10 +1,12 @@
 #include "video_analyzer/frame_extractor.h"
 #include <stdexcept>
 #include <iostream>
+#include <chrono>
 
 namespace video_analyzer {
 
-FrameExtractor::FrameExtractor(const std::string& filepath) {
+FrameExtractor::FrameExtractor(const std::string& filepath, size_t cache_budget)
+    : cache_(cache_budget) {
     // Open video file
     if (avformat_open_input(&format_ctx_, filepath.c_str(), nullptr, nullptr) < 0) {
         throw std::runtime_error("Failed to open video file");
@@ -29,6 +31,13 @@ FrameExtractor::FrameExtractor(const std::string& filepath) {
         throw std::runtime_error("No video stream found");
     }
     
+    // Only the video stream is needed
+    for (unsigned i = 0; i < format_ctx_->nb_streams; ++i) {
+        if (static_cast<int>(i) != video_stream_index_) {
+            format_ctx_->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+    
     // Get codec parameters
     AVCodecParameters* codec_params = format_ctx_->streams[video_stream_index_]->codecpar;
     
@@ -53,6 +62,9 @@ FrameExtractor::FrameExtractor(const std::string& filepath) {
         throw std::runtime_error("Failed to copy codec parameters");
     }
     
+    // Decode on all cores; playback of high-resolution video needs it
+    codec_ctx_->thread_count = 0;
+    
     // Open codec
     if (avcodec_open2(codec_ctx_, codec, nullptr) < 0) {
         avcodec_free_context(&codec_ctx_);
@@ -86,9 +98,22 @@ FrameExtractor::FrameExtractor(const std::string& filepath) {
         double fps = av_q2d(stream->avg_frame_rate);
         frame_count_ = static_cast<int>(duration * fps);
     }
+    
+    // Index keyframes on a separate demuxer; until it is ready frames are
+    // decoded sequentially from the start
+    index_future_ = std::async(std::launch::async, [this, filepath] {
+        return KeyframeIndex::build(filepath, &index_cancelled_);
+    });
 }
 
 FrameExtractor::~FrameExtractor() {
+    // Abort the index build and wait for its thread; it uses its own demuxer
+    index_cancelled_ = true;
+    if (index_future_.valid()) {
+        index_future_.wait();
+    }
+    
+    cache_.clear();
     if (frame_) av_frame_free(&frame_);
     if (packet_) av_packet_free(&packet_);
     if (codec_ctx_) avcodec_free_context(&codec_ctx_);
@@ -100,50 +125,108 @@ AVFrame* FrameExtractor::getFrame(int frame_number) {
         return nullptr;
     }
     
-    // If we need to seek backwards or jump far forward, reset
-    if (frame_number < current_frame_ || frame_number > current_frame_ + 100) {
-        // Seek to keyframe before target
-        AVStream* stream = format_ctx_->streams[video_stream_index_];
-        int64_t timestamp = frame_number * stream->time_base.den / 
-                           (stream->time_base.num * av_q2d(stream->avg_frame_rate));
-        
-        int seek_ret = av_seek_frame(format_ctx_, video_stream_index_, timestamp, AVSEEK_FLAG_BACKWARD);
-        if (seek_ret < 0) {
-            std::cerr << "Seek failed for frame " << frame_number << ", trying from beginning" << std::endl;
-            // Try seeking to beginning
-            av_seek_frame(format_ctx_, video_stream_index_, 0, AVSEEK_FLAG_BACKWARD);
+    if (AVFrame* cached = cache_.get(frame_number)) {
+        return cached;
+    }
+    
+    acquireIndex();
+    
+    // Start of the GOP containing the frame (the whole file without index)
+    int keyframe = 0;
+    int64_t timestamp = 0;
+    if (index_) {
+        if (const KeyframeEntry* entry = index_->findKeyframeForFrame(frame_number)) {
+            keyframe = static_cast<int>(entry->frameNumber);
+            timestamp = entry->dts;
         }
-        avcodec_flush_buffers(codec_ctx_);
-        current_frame_ = -1;
     }
     
-    // Decode until we reach target frame
-    bool success = decodeToFrame(frame_number);
+    // Keep decoding forward when the frame lies ahead in the current GOP;
+    // otherwise restart at its keyframe
+    if (frame_number <= decoded_frame_ || keyframe > decoded_frame_ + 1) {
+        seekToKeyframe(keyframe, timestamp);
+    }
+    
+    if (!decodeToFrame(frame_number)) {
+        std::cerr << "Failed to decode frame " << frame_number << std::endl;
+        return nullptr;
+    }
+    
+    return cache_.get(frame_number);
+}
+
+void FrameExtractor::acquireIndex() {
+    if (index_ || !index_future_.valid()) {
+        return;
+    }
+    if (index_future_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
     
-    // If failed and we haven't tried from beginning, try once more
-    if (!success && current_frame_ != -1) {
-        std::cout << "⚠️  First attempt failed for frame " << frame_number << ", retrying from beginning..." << std::endl;
-        av_seek_frame(format_ctx_, video_stream_index_, 0, AVSEEK_FLAG_BACKWARD);
-        avcodec_flush_buffers(codec_ctx_);
-        current_frame_ = -1;
-        success = decodeToFrame(frame_number);
+    try {
+        index_ = std::make_unique<KeyframeIndex>(index_future_.get());
+        if (index_->getFrameCount() > 0) {
+            frame_count_ = static_cast<int>(index_->getFrameCount());
+        }
+    } catch (const std::exception& e) {
+        // Keep decoding sequentially
+        std::cerr << "Keyframe index unavailable: " << e.what() << std::endl;
+    }
+}
+
+void FrameExtractor::seekToKeyframe(int keyframe, int64_t timestamp) {
+    if (av_seek_frame(format_ctx_, video_stream_index_, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+        std::cerr << "Seek failed for keyframe " << keyframe << std::endl;
+    }
+    avcodec_flush_buffers(codec_ctx_);
+    decoded_frame_ = keyframe - 1;
+}
+
+bool FrameExtractor::decodeToFrame(int target_frame) {
+    while (decoded_frame_ < target_frame) {
+        if (!receiveFrame()) {
+            return false;
+        }
+        
+        // Display-order number from the PTS; count frames without index
+        int frame_number = decoded_frame_ + 1;
+        if (index_) {
+            int64_t pts = frame_->best_effort_timestamp != AV_NOPTS_VALUE ?
+                          frame_->best_effort_timestamp : frame_->pts;
+            if (auto number = index_->findFrameNumber(pts)) {
+                frame_number = static_cast<int>(*number);
+            }
+        }
         
-        if (success) {
-            std::cout << "✅ Retry successful for frame " << frame_number << std::endl;
-        } else {
-            std::cerr << "❌ Failed to decode frame " << frame_number << " even after retry" << std::endl;
+        // Leading pictures of an open GOP belong before the keyframe
+        if (frame_number > decoded_frame_) {
+            decoded_frame_ = frame_number;
+            cache_.put(frame_number, frame_);
         }
+        av_frame_unref(frame_);
     }
     
-    return success ? frame_ : nullptr;
+    return decoded_frame_ == target_frame;
 }
 
-bool FrameExtractor::decodeToFrame(int target_frame) {
-    while (current_frame_ < target_frame) {
-        // Read packet
-        int ret = av_read_frame(format_ctx_, packet_);
+bool FrameExtractor::receiveFrame() {
+    while (true) {
+        int ret = avcodec_receive_frame(codec_ctx_, frame_);
+        if (ret >= 0) {
+            return true;
+        }
+        if (ret != AVERROR(EAGAIN)) {
+            return false; // Drained or error
+        }
+        
+        // The decoder needs more input
+        ret = av_read_frame(format_ctx_, packet_);
         if (ret < 0) {
-            return false; // End of file or error
+            // End of file: drain the frames still buffered in the decoder
+            if (avcodec_send_packet(codec_ctx_, nullptr) < 0) {
+                return false;
+            }
+            continue;
         }
         
         // Skip non-video packets
@@ -152,37 +235,14 @@ bool FrameExtractor::decodeToFrame(int target_frame) {
             continue;
         }
         
-        // Send packet to decoder
         ret = avcodec_send_packet(codec_ctx_, packet_);
         av_packet_unref(packet_);
         
-        if (ret < 0) {
+        // Skip corrupt packets instead of giving up
+        if (ret < 0 && ret != AVERROR_INVALIDDATA) {
             return false;
         }
-        
-        // Receive frame from decoder
-        while (ret >= 0) {
-            ret = avcodec_receive_frame(codec_ctx_, frame_);
-            
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-                break;
-            } else if (ret < 0) {
-                return false;
-            }
-            
-            // We got a frame
-            current_frame_++;
-            
-            if (current_frame_ == target_frame) {
-                return true;
-            }
-            
-            // Not the target frame yet, continue
-            av_frame_unref(frame_);
-        }
     }
-    
-    return current_frame_ == target_frame;
 }
 
 } // namespace video_analyzer
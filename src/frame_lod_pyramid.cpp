@@ -0,0 +1,159 @@
+#include "video_analyzer/frame_lod_pyramid.h"
+#include "video_analyzer/thread_pool.h"
+#include <algorithm>
+
+namespace video_analyzer {
+
+namespace {
+
+// Levels with fewer nodes are built serially
+constexpr size_t kMinParallelNodes = 1 << 16;
+
+} // namespace
+
+FrameLodBucket FrameLodBucket::fromFrame(const FrameInfo& frame) {
+    FrameLodBucket bucket;
+    bucket.count = 1;
+    bucket.minSize = frame.size;
+    bucket.maxSize = frame.size;
+    bucket.sumSize = frame.size;
+    bucket.minQP = frame.qp;
+    bucket.maxQP = frame.qp;
+    bucket.sumQP = frame.qp;
+    bucket.iFrames = frame.type == FrameType::I_FRAME ? 1 : 0;
+    bucket.pFrames = frame.type == FrameType::P_FRAME ? 1 : 0;
+    bucket.bFrames = frame.type == FrameType::B_FRAME ? 1 : 0;
+    bucket.hasKeyFrame = frame.isKeyFrame;
+    return bucket;
+}
+
+void FrameLodBucket::merge(const FrameLodBucket& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    
+    count += other.count;
+    minSize = std::min(minSize, other.minSize);
+    maxSize = std::max(maxSize, other.maxSize);
+    sumSize += other.sumSize;
+    minQP = std::min(minQP, other.minQP);
+    maxQP = std::max(maxQP, other.maxQP);
+    sumQP += other.sumQP;
+    iFrames += other.iFrames;
+    pFrames += other.pFrames;
+    bFrames += other.bFrames;
+    hasKeyFrame = hasKeyFrame || other.hasKeyFrame;
+}
+
+double FrameLodBucket::averageSize() const {
+    return count > 0 ? static_cast<double>(sumSize) / count : 0.0;
+}
+
+double FrameLodBucket::averageQP() const {
+    return count > 0 ? static_cast<double>(sumQP) / count : 0.0;
+}
+
+FrameType FrameLodBucket::dominantType() const {
+    if (iFrames > 0) {
+        return FrameType::I_FRAME;
+    }
+    if (pFrames == 0 && bFrames == 0) {
+        return FrameType::UNKNOWN;
+    }
+    return pFrames >= bFrames ? FrameType::P_FRAME : FrameType::B_FRAME;
+}
+
+void FrameLodPyramid::update(const std::vector<FrameInfo>& frames, ThreadPool* pool) {
+    if (frames.size() < frameCount_) {
+        clear();
+    }
+    if (frames.size() == frameCount_) {
+        return;
+    }
+    
+    size_t first = frameCount_;
+    if (levels_.empty()) {
+        levels_.emplace_back();
+    }
+    std::vector<FrameLodBucket>& base = levels_[0];
+    base.resize(frames.size());
+    parallelForIfLarge(pool, first, frames.size(), kMinParallelNodes, [&](size_t i) {
+        base[i] = FrameLodBucket::fromFrame(frames[i]);
+    });
+    frameCount_ = frames.size();
+    
+    // Recompute the ancestors of the new frames, including the previously
+    // partial last node of each level
+    size_t dirty = first;
+    for (size_t level = 1; levels_[level - 1].size() > 1; ++level) {
+        if (levels_.size() == level) {
+            levels_.emplace_back();
+        }
+        const std::vector<FrameLodBucket>& children = levels_[level - 1];
+        std::vector<FrameLodBucket>& nodes = levels_[level];
+        
+        dirty >>= 1;
+        nodes.resize((children.size() + 1) / 2);
+        parallelForIfLarge(pool, dirty, nodes.size(), kMinParallelNodes, [&](size_t j) {
+            FrameLodBucket node = children[2 * j];
+            if (2 * j + 1 < children.size()) {
+                node.merge(children[2 * j + 1]);
+            }
+            nodes[j] = node;
+        });
+    }
+}
+
+void FrameLodPyramid::clear() {
+    levels_.clear();
+    frameCount_ = 0;
+}
+
+FrameLodBucket FrameLodPyramid::aggregate(size_t begin, size_t end) const {
+    FrameLodBucket result;
+    end = std::min(end, frameCount_);
+    
+    // Walk up while the range allows larger aligned nodes, then back down
+    // for the tail; begin stays aligned to the current node span
+    size_t level = 0;
+    while (begin < end) {
+        size_t span = size_t(1) << level;
+        if (level + 1 < levels_.size() && (begin & (2 * span - 1)) == 0 &&
+            begin + 2 * span <= end) {
+            ++level;
+            continue;
+        }
+        if (begin + span > end) {
+            --level;
+            continue;
+        }
+        result.merge(levels_[level][begin >> level]);
+        begin += span;
+    }
+    return result;
+}
+
+std::vector<FrameLodBucket> FrameLodPyramid::query(size_t begin, size_t end,
+                                                   size_t columns) const {
+    end = std::min(end, frameCount_);
+    if (begin >= end || columns == 0) {
+        return {};
+    }
+    
+    size_t frames = end - begin;
+    columns = std::min(columns, frames);
+    
+    std::vector<FrameLodBucket> result(columns);
+    for (size_t c = 0; c < columns; ++c) {
+        size_t first = begin + c * frames / columns;
+        size_t last = begin + (c + 1) * frames / columns;
+        result[c] = aggregate(first, last);
+    }
+    return result;
+}
+
+} // namespace video_analyzer
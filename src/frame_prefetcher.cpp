@@ -0,0 +1,197 @@
+#include "video_analyzer/frame_prefetcher.h"
+#include "video_analyzer/frame_extractor.h"
+#include "video_analyzer/frame_renderer.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace video_analyzer {
+
+FramePrefetcher::FramePrefetcher(const std::string& filepath, int width, int height,
+                                 size_t memory_budget)
+    : extractor_(std::make_unique<FrameExtractor>(filepath)),
+      renderer_(std::make_unique<FrameRenderer>(width, height)),
+      buffer_size_(renderer_->getYUVBufferSize()) {
+    
+    size_t slot_count = buffer_size_ > 0 ? memory_budget / buffer_size_ : kMaxSlots;
+    slot_count = std::clamp(slot_count, kMinSlots, kMaxSlots);
+    
+    slots_.resize(slot_count);
+    storage_.resize(slot_count);
+    for (size_t i = 0; i < slot_count; ++i) {
+        storage_[i].resize(buffer_size_);
+        slots_[i].data = storage_[i].data();
+    }
+    frame_count_ = extractor_->getFrameCount();
+    
+    worker_ = std::thread(&FramePrefetcher::run, this);
+}
+
+FramePrefetcher::~FramePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+const uint8_t* FramePrefetcher::acquire(int frame_number, int step, YUVColorInfo* color) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    moveCursor(frame_number, step);
+    
+    return readySlotData(findSlot(frame_number), color);
+}
+
+const uint8_t* FramePrefetcher::wait(int frame_number, int step, YUVColorInfo* color) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    moveCursor(frame_number, step);
+    
+    // A taken frame has to be decoded again
+    if (Slot* taken = findSlot(frame_number)) {
+        if (taken->state == SlotState::Taken) {
+            taken->state = SlotState::Empty;
+            work_cv_.notify_one();
+        }
+    }
+    
+    const Slot* slot = nullptr;
+    ready_cv_.wait(lock, [&] {
+        // Frames outside the video are never decoded
+        if (frame_number < 0 || frame_number >= frame_count_) {
+            return true;
+        }
+        slot = findSlot(frame_number);
+        return slot && (slot->state == SlotState::Ready || slot->state == SlotState::Failed);
+    });
+    
+    return readySlotData(slot, color);
+}
+
+uint8_t* FramePrefetcher::take(int frame_number, uint8_t* replacement) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    Slot* slot = findSlot(frame_number);
+    if (!replacement || !slot || slot->state != SlotState::Ready) {
+        return nullptr;
+    }
+    
+    uint8_t* data = slot->data;
+    slot->data = replacement;
+    slot->state = SlotState::Taken;
+    return data;
+}
+
+bool FramePrefetcher::isFailed(int frame_number) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Slot* slot = findSlot(frame_number);
+    return slot && slot->state == SlotState::Failed;
+}
+
+void FramePrefetcher::moveCursor(int frame_number, int step) {
+    step = std::max(1, step);
+    
+    // Keep the previous direction when the cursor stays put
+    int direction = stride_ < 0 ? -1 : 1;
+    if (frame_number > cursor_) {
+        direction = 1;
+    } else if (frame_number < cursor_) {
+        direction = -1;
+    }
+    
+    if (frame_number != cursor_ || step * direction != stride_) {
+        cursor_ = frame_number;
+        stride_ = step * direction;
+        work_cv_.notify_one();
+    }
+}
+
+bool FramePrefetcher::inWindow(int frame_number) const {
+    int offset = (frame_number - cursor_) * (stride_ < 0 ? -1 : 1);
+    int step = std::abs(stride_);
+    return offset >= 0 && offset % step == 0 &&
+           static_cast<size_t>(offset / step) < slots_.size();
+}
+
+FramePrefetcher::Slot* FramePrefetcher::findSlot(int frame_number) {
+    for (auto& slot : slots_) {
+        if (slot.state != SlotState::Empty && slot.frame_number == frame_number) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+const FramePrefetcher::Slot* FramePrefetcher::findSlot(int frame_number) const {
+    return const_cast<FramePrefetcher*>(this)->findSlot(frame_number);
+}
+
+const uint8_t* FramePrefetcher::readySlotData(const Slot* slot, YUVColorInfo* color) const {
+    if (!slot || slot->state != SlotState::Ready) {
+        return nullptr;
+    }
+    if (color) {
+        color->full_range = slot->full_range;
+        color->bt709 = slot->bt709;
+    }
+    return slot->data;
+}
+
+void FramePrefetcher::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    while (!stop_) {
+        // Nearest frame of the window that is not decoded yet
+        int target = -1;
+        for (size_t k = 0; k < slots_.size(); ++k) {
+            int frame_number = cursor_ + static_cast<int>(k) * stride_;
+            if (frame_number < 0 || frame_number >= frame_count_) {
+                break;
+            }
+            if (!findSlot(frame_number)) {
+                target = frame_number;
+                break;
+            }
+        }
+        
+        // Reuse a slot that fell out of the window
+        Slot* slot = nullptr;
+        if (target >= 0) {
+            for (auto& candidate : slots_) {
+                if (candidate.state == SlotState::Empty) {
+                    slot = &candidate;
+                    break;
+                }
+                if (!inWindow(candidate.frame_number)) {
+                    slot = &candidate;
+                }
+            }
+        }
+        
+        if (!slot) {
+            work_cv_.wait(lock);
+            continue;
+        }
+        
+        slot->frame_number = target;
+        slot->state = SlotState::Decoding;
+        uint8_t* buffer = slot->data;
+        lock.unlock();
+        
+        AVFrame* frame = extractor_->getFrame(target);
+        YUVColorInfo color;
+        bool converted = frame && renderer_->convertFrameToYUV(frame, buffer, &color);
+        // The count is refined once the extractor's keyframe index is ready
+        int frame_count = extractor_->getFrameCount();
+        
+        lock.lock();
+        slot->state = converted ? SlotState::Ready : SlotState::Failed;
+        slot->full_range = color.full_range;
+        slot->bt709 = color.bt709;
+        frame_count_ = frame_count;
+        ready_cv_.notify_all();
+    }
+}
+
+} // namespace video_analyzer
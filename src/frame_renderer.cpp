@@ -1,5 +1,6 @@
 #include "video_analyzer/frame_renderer.h"
 #include <stdexcept>
+#include <cstring>
 
 extern "C" {
 #include <libavutil/imgutils.h>
@@ -31,6 +32,9 @@ FrameRenderer::~FrameRenderer() {
     if (sws_context_) {
         sws_freeContext(sws_context_);
     }
+    if (yuv_sws_context_) {
+        sws_freeContext(yuv_sws_context_);
+    }
     if (rgb_frame_) {
         av_frame_free(&rgb_frame_);
     }
@@ -65,4 +69,74 @@ bool FrameRenderer::convertFrameToRGB(AVFrame* frame, uint8_t* rgb_buffer) {
     return true;
 }
 
+bool FrameRenderer::convertFrameToYUV(AVFrame* frame, uint8_t* yuv_buffer, YUVColorInfo* color) {
+    if (!frame || !yuv_buffer) {
+        return false;
+    }
+    
+    int chroma_width = getChromaWidth();
+    int chroma_height = getChromaHeight();
+    uint8_t* dest[3] = {
+        yuv_buffer,
+        yuv_buffer + static_cast<size_t>(width_) * height_,
+        yuv_buffer + static_cast<size_t>(width_) * height_ + static_cast<size_t>(chroma_width) * chroma_height
+    };
+    int dest_linesize[3] = { width_, chroma_width, chroma_width };
+    
+    bool jpeg_format = frame->format == AV_PIX_FMT_YUVJ420P;
+    bool full_range = frame->color_range == AVCOL_RANGE_JPEG || jpeg_format;
+    
+    if ((frame->format == AV_PIX_FMT_YUV420P || jpeg_format) &&
+        frame->width == width_ && frame->height == height_) {
+        // Already in the texture layout: copy the rows of each plane
+        for (int plane = 0; plane < 3; ++plane) {
+            int plane_width = plane == 0 ? width_ : chroma_width;
+            int plane_height = plane == 0 ? height_ : chroma_height;
+            for (int y = 0; y < plane_height; ++y) {
+                memcpy(dest[plane] + static_cast<size_t>(y) * plane_width,
+                       frame->data[plane] + static_cast<ptrdiff_t>(y) * frame->linesize[plane],
+                       plane_width);
+            }
+        }
+    } else {
+        yuv_sws_context_ = sws_getCachedContext(
+            yuv_sws_context_,
+            frame->width, frame->height, (AVPixelFormat)frame->format,
+            width_, height_, AV_PIX_FMT_YUV420P,
+            SWS_BILINEAR, nullptr, nullptr, nullptr
+        );
+        
+        if (!yuv_sws_context_) {
+            return false;
+        }
+        
+        // Keep the input's range in the output; by default swscale derives
+        // the range from the pixel format, not from color_range. The same
+        // coefficients on both sides leave the matrix unchanged
+        const int* coefficients = sws_getCoefficients(SWS_CS_DEFAULT);
+        int range = full_range ? 1 : 0;
+        if (sws_setColorspaceDetails(yuv_sws_context_, coefficients, range, coefficients, range,
+                                     0, 1 << 16, 1 << 16) < 0) {
+            // Left to swscale: only J formats are read as full range, and
+            // they come out limited
+            if (jpeg_format) {
+                full_range = false;
+            }
+        }
+        
+        sws_scale(yuv_sws_context_,
+                  frame->data, frame->linesize, 0, frame->height,
+                  dest, dest_linesize);
+    }
+    
+    if (color) {
+        color->full_range = full_range;
+        // Untagged HD content is BT.709 in practice
+        color->bt709 = frame->colorspace == AVCOL_SPC_BT709 ||
+                       (frame->colorspace == AVCOL_SPC_UNSPECIFIED && height_ >= 720);
+    }
+    
+    return true;
+}
+
 } // namespace video_analyzer
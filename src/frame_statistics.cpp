@@ -18,48 +18,70 @@ nlohmann::json FrameStatistics::toJson() const {
 }
 
 FrameStatistics FrameStatistics::compute(const std::vector<FrameInfo>& frames) {
-    FrameStatistics stats;
+    FrameStatisticsAccumulator accumulator;
     
-    if (frames.empty()) {
-        return stats;
+    for (const auto& frame : frames) {
+        accumulator.add(frame);
     }
     
-    stats.totalFrames = static_cast<int>(frames.size());
-    
-    int64_t totalSize = 0;
-    int totalQP = 0;
-    stats.minFrameSize = frames[0].size;
-    stats.maxFrameSize = frames[0].size;
+    return accumulator.getStatistics();
+}
+
+// FrameStatisticsAccumulator implementation
+void FrameStatisticsAccumulator::add(const FrameInfo& frame) {
+    if (stats_.totalFrames == 0) {
+        stats_.minFrameSize = frame.size;
+        stats_.maxFrameSize = frame.size;
+    }
+    stats_.totalFrames++;
     
-    for (const auto& frame : frames) {
-        // Count frame types
-        switch (frame.type) {
-            case FrameType::I_FRAME:
-                stats.iFrames++;
-                break;
-            case FrameType::P_FRAME:
-                stats.pFrames++;
-                break;
-            case FrameType::B_FRAME:
-                stats.bFrames++;
-                break;
-            default:
-                break;
-        }
-        
-        // Accumulate sizes
-        totalSize += frame.size;
-        stats.minFrameSize = std::min(stats.minFrameSize, frame.size);
-        stats.maxFrameSize = std::max(stats.maxFrameSize, frame.size);
-        
-        // Accumulate QP
-        totalQP += frame.qp;
+    // Count frame types
+    switch (frame.type) {
+        case FrameType::I_FRAME:
+            stats_.iFrames++;
+            break;
+        case FrameType::P_FRAME:
+            stats_.pFrames++;
+            break;
+        case FrameType::B_FRAME:
+            stats_.bFrames++;
+            break;
+        default:
+            break;
     }
     
-    stats.averageFrameSize = static_cast<double>(totalSize) / frames.size();
-    stats.averageQP = static_cast<double>(totalQP) / frames.size();
+    // Accumulate sizes
+    totalSize_ += frame.size;
+    stats_.minFrameSize = std::min(stats_.minFrameSize, frame.size);
+    stats_.maxFrameSize = std::max(stats_.maxFrameSize, frame.size);
+    
+    // Accumulate QP
+    totalQP_ += frame.qp;
+}
+
+void FrameStatisticsAccumulator::clear() {
+    stats_ = FrameStatistics{};
+    totalSize_ = 0;
+    totalQP_ = 0;
+}
+
+FrameStatistics FrameStatisticsAccumulator::getStatistics() const {
+    FrameStatistics stats = stats_;
+    
+    if (stats.totalFrames > 0) {
+        stats.averageFrameSize = static_cast<double>(totalSize_) / stats.totalFrames;
+        stats.averageQP = static_cast<double>(totalQP_) / stats.totalFrames;
+    }
     
     return stats;
 }
 
+void FrameStatisticsAccumulator::begin(const StreamInfo& /*info*/) {
+    clear();
+}
+
+void FrameStatisticsAccumulator::consume(const FrameInfo& frame, const VideoDecoder& /*decoder*/) {
+    add(frame);
+}
+
 } // namespace video_analyzer
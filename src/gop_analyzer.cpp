@@ -6,104 +6,74 @@ namespace video_analyzer {
 GOPAnalyzer::GOPAnalyzer(VideoDecoder& decoder) : decoder_(decoder) {}
 
 std::vector<GOPInfo> GOPAnalyzer::analyze() {
-    gops_.clear();
-    
-    // Collect all frames
-    std::vector<FrameInfo> frames;
     decoder_.reset();
     
-    while (auto frame = decoder_.readNextFrame()) {
-        frames.push_back(*frame);
-    }
-    
-    if (frames.empty()) {
-        return gops_;
-    }
-    
-    // Detect GOP boundaries
-    detectGOPBoundaries(frames);
+    AnalysisPipeline pipeline(decoder_);
+    pipeline.addSink(*this);
+    pipeline.run();
     
     return gops_;
 }
 
-void GOPAnalyzer::detectGOPBoundaries(const std::vector<FrameInfo>& frames) {
-    if (frames.empty()) return;
-    
-    int gopIndex = 0;
-    size_t gopStart = 0;
-    
-    for (size_t i = 1; i < frames.size(); ++i) {
+void GOPAnalyzer::begin(const StreamInfo& /*info*/) {
+    gops_.clear();
+    hasCurrentGop_ = false;
+}
+
+void GOPAnalyzer::consume(const FrameInfo& frame, const VideoDecoder& /*decoder*/) {
+    if (!hasCurrentGop_) {
+        startGOP(frame);
+    } else if (frame.type == FrameType::I_FRAME && frame.isKeyFrame) {
         // New GOP starts at I-frame
-        if (frames[i].type == FrameType::I_FRAME && frames[i].isKeyFrame) {
-            // Process previous GOP
-            GOPInfo gop;
-            gop.gopIndex = gopIndex++;
-            gop.startPts = frames[gopStart].pts;
-            gop.endPts = frames[i - 1].pts;
-            gop.frameCount = static_cast<int>(i - gopStart);
-            gop.iFrameCount = 0;
-            gop.pFrameCount = 0;
-            gop.bFrameCount = 0;
-            gop.totalSize = 0;
-            gop.isOpenGOP = false;
-            
-            // Count frame types and sizes
-            for (size_t j = gopStart; j < i; ++j) {
-                switch (frames[j].type) {
-                    case FrameType::I_FRAME:
-                        gop.iFrameCount++;
-                        break;
-                    case FrameType::P_FRAME:
-                        gop.pFrameCount++;
-                        break;
-                    case FrameType::B_FRAME:
-                        gop.bFrameCount++;
-                        break;
-                    default:
-                        break;
-                }
-                gop.totalSize += frames[j].size;
-            }
-            
-            gops_.push_back(gop);
-            gopStart = i;
-        }
+        closeGOP();
+        startGOP(frame);
     }
     
+    // Count frame types and sizes
+    switch (frame.type) {
+        case FrameType::I_FRAME:
+            currentGop_.iFrameCount++;
+            break;
+        case FrameType::P_FRAME:
+            currentGop_.pFrameCount++;
+            break;
+        case FrameType::B_FRAME:
+            currentGop_.bFrameCount++;
+            break;
+        default:
+            break;
+    }
+    currentGop_.endPts = frame.pts;
+    currentGop_.frameCount++;
+    currentGop_.totalSize += frame.size;
+}
+
+void GOPAnalyzer::end() {
     // Process last GOP
-    if (gopStart < frames.size()) {
-        GOPInfo gop;
-        gop.gopIndex = gopIndex;
-        gop.startPts = frames[gopStart].pts;
-        gop.endPts = frames.back().pts;
-        gop.frameCount = static_cast<int>(frames.size() - gopStart);
-        gop.iFrameCount = 0;
-        gop.pFrameCount = 0;
-        gop.bFrameCount = 0;
-        gop.totalSize = 0;
-        gop.isOpenGOP = false;
-        
-        for (size_t j = gopStart; j < frames.size(); ++j) {
-            switch (frames[j].type) {
-                case FrameType::I_FRAME:
-                    gop.iFrameCount++;
-                    break;
-                case FrameType::P_FRAME:
-                    gop.pFrameCount++;
-                    break;
-                case FrameType::B_FRAME:
-                    gop.bFrameCount++;
-                    break;
-                default:
-                    break;
-            }
-            gop.totalSize += frames[j].size;
-        }
-        
-        gops_.push_back(gop);
+    if (hasCurrentGop_) {
+        closeGOP();
     }
 }
 
+void GOPAnalyzer::startGOP(const FrameInfo& frame) {
+    currentGop_ = GOPInfo{};
+    currentGop_.gopIndex = static_cast<int>(gops_.size());
+    currentGop_.startPts = frame.pts;
+    currentGop_.endPts = frame.pts;
+    currentGop_.frameCount = 0;
+    currentGop_.iFrameCount = 0;
+    currentGop_.pFrameCount = 0;
+    currentGop_.bFrameCount = 0;
+    currentGop_.totalSize = 0;
+    currentGop_.isOpenGOP = false;
+    hasCurrentGop_ = true;
+}
+
+void GOPAnalyzer::closeGOP() {
+    gops_.push_back(currentGop_);
+    hasCurrentGop_ = false;
+}
+
 double GOPAnalyzer::getAverageGOPLength() const {
     if (gops_.empty()) return 0.0;
     
@@ -1,12 +1,18 @@
 #include "video_analyzer/gui_application.h"
-#include "video_analyzer/frame_extractor.h"
+#include "video_analyzer/frame_prefetcher.h"
 #include "video_analyzer/frame_renderer.h"
+#include "video_analyzer/video_texture.h"
+#include "video_analyzer/binary_report.h"
+#include "video_analyzer/thread_pool.h"
+#include "video_analyzer/analysis_pipeline.h"
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <iostream>
 #include <cmath>
 #include <fstream>
+#include <filesystem>
+#include <algorithm>
 
 // STB Image for loading icon
 #define STB_IMAGE_IMPLEMENTATION
@@ -18,6 +24,20 @@ static void glfw_error_callback(int error, const char* description) {
     std::cerr << "GLFW Error " << error << ": " << description << std::endl;
 }
 
+// Timeline and chart color of a frame type
+static ImU32 frameTypeColor(FrameType type) {
+    switch (type) {
+        case FrameType::I_FRAME:
+            return IM_COL32(255, 100, 100, 255);
+        case FrameType::P_FRAME:
+            return IM_COL32(100, 255, 100, 255);
+        case FrameType::B_FRAME:
+            return IM_COL32(100, 100, 255, 255);
+        default:
+            return IM_COL32(150, 150, 150, 255);
+    }
+}
+
 void GUIApplication::dropCallback(GLFWwindow* window, int count, const char** paths) {
     if (count > 0) {
         // Get the GUIApplication instance from the window user pointer
@@ -167,6 +187,11 @@ void GUIApplication::cleanupImGui() {
 }
 
 void GUIApplication::shutdown() {
+    // Let a background motion decode stop while the window closes
+    cancelMotionAnalysis();
+    
+    // The prefetcher may be decoding into mapped pixel buffers of the texture
+    frame_prefetcher_.reset();
     deleteVideoTexture();
     cleanupImGui();
     
@@ -176,166 +201,166 @@ void GUIApplication::shutdown() {
     }
     
     glfwTerminate();
+    
+    // Cancelled jobs stop after their current frame
+    cancelled_motion_jobs_.clear();
 }
 
 void GUIApplication::createVideoTexture() {
-    if (video_texture_) {
-        deleteVideoTexture();
+    // YUV planes are converted to RGB on the GPU
+    video_texture_ = std::make_unique<VideoTexture>();
+    if (!video_texture_->create(video_width_, video_height_)) {
+        std::cerr << "Failed to create video texture" << std::endl;
+        video_texture_.reset();
     }
-    
-    glGenTextures(1, &video_texture_);
-    glBindTexture(GL_TEXTURE_2D, video_texture_);
-    
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    
-    // Allocate texture memory
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, video_width_, video_height_, 
-                 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void GUIApplication::deleteVideoTexture() {
-    if (video_texture_) {
-        glDeleteTextures(1, &video_texture_);
-        video_texture_ = 0;
-    }
+    video_texture_.reset();
 }
 
 void GUIApplication::updateVideoTexture() {
-    if (!frame_extractor_ || !frame_renderer_ || !video_texture_) {
+    if (!frame_prefetcher_ || !video_texture_) {
         std::cerr << "updateVideoTexture: Missing components - "
-                  << "extractor:" << (frame_extractor_ ? "OK" : "NULL") << " "
-                  << "renderer:" << (frame_renderer_ ? "OK" : "NULL") << " "
-                  << "texture:" << video_texture_ << std::endl;
+                  << "prefetcher:" << (frame_prefetcher_ ? "OK" : "NULL") << " "
+                  << "texture:" << (video_texture_ ? "OK" : "NULL") << std::endl;
         return;
     }
     
     std::cout << "📹 Extracting frame " << current_frame_ << "..." << std::endl;
     
-    // Get frame from extractor
-    AVFrame* frame = frame_extractor_->getFrame(current_frame_);
-    if (!frame) {
+    // Wait for the frame; a prefetched frame returns immediately
+    YUVColorInfo color;
+    int shown_frame = current_frame_;
+    const uint8_t* yuv = frame_prefetcher_->wait(current_frame_, playbackStep(), &color);
+    if (!yuv) {
         std::cerr << "❌ Failed to extract frame " << current_frame_ << std::endl;
         
         // Try adjacent frames as fallback
         if (current_frame_ > 0) {
             std::cout << "🔄 Trying previous frame " << (current_frame_ - 1) << " as fallback..." << std::endl;
-            frame = frame_extractor_->getFrame(current_frame_ - 1);
-            if (frame) {
+            yuv = frame_prefetcher_->wait(current_frame_ - 1, 1, &color);
+            if (yuv) {
+                shown_frame = current_frame_ - 1;
                 std::cout << "✅ Using frame " << (current_frame_ - 1) << " instead" << std::endl;
             }
         }
         
-        if (!frame && analyzer_) {
+        if (!yuv && analyzer_) {
             const auto& frames = analyzer_->getFrames();
             if (current_frame_ + 1 < frames.size()) {
                 std::cout << "🔄 Trying next frame " << (current_frame_ + 1) << " as fallback..." << std::endl;
-                frame = frame_extractor_->getFrame(current_frame_ + 1);
-                if (frame) {
+                yuv = frame_prefetcher_->wait(current_frame_ + 1, 1, &color);
+                if (yuv) {
+                    shown_frame = current_frame_ + 1;
                     std::cout << "✅ Using frame " << (current_frame_ + 1) << " instead" << std::endl;
                 }
             }
         }
         
         // If still no frame, just keep the current texture
-        if (!frame) {
+        if (!yuv) {
             std::cerr << "❌ Could not extract any nearby frame, keeping current display" << std::endl;
             return;
         }
     }
     
-    // Convert to RGB
-    if (!frame_renderer_->convertFrameToRGB(frame, rgb_buffer_.data())) {
-        std::cerr << "❌ Failed to convert frame to RGB" << std::endl;
-        return;
+    uploadFrame(shown_frame, yuv, color);
+    
+    std::cout << "✅ Frame " << current_frame_ << " displayed successfully!" << std::endl;
+}
+
+bool GUIApplication::presentFrame(int frame_number) {
+    // Reports without a source video show statistics only
+    if (!frame_prefetcher_ || !video_texture_) {
+        return true;
     }
     
-    // Apply video transformations if needed
-    if (rotate_180_ || flip_horizontal_ || flip_vertical_) {
-        std::vector<uint8_t> transformed_buffer(rgb_buffer_.size());
-        
-        for (int y = 0; y < video_height_; y++) {
-            for (int x = 0; x < video_width_; x++) {
-                int src_x = x;
-                int src_y = y;
-                
-                // Apply transformations
-                if (flip_horizontal_) {
-                    src_x = video_width_ - 1 - x;
-                }
-                if (flip_vertical_) {
-                    src_y = video_height_ - 1 - y;
-                }
-                if (rotate_180_) {
-                    src_x = video_width_ - 1 - src_x;
-                    src_y = video_height_ - 1 - src_y;
-                }
-                
-                // Copy pixel (RGB)
-                int dst_idx = (y * video_width_ + x) * 3;
-                int src_idx = (src_y * video_width_ + src_x) * 3;
-                
-                transformed_buffer[dst_idx + 0] = rgb_buffer_[src_idx + 0];
-                transformed_buffer[dst_idx + 1] = rgb_buffer_[src_idx + 1];
-                transformed_buffer[dst_idx + 2] = rgb_buffer_[src_idx + 2];
-            }
-        }
-        
-        // Upload transformed buffer
-        glBindTexture(GL_TEXTURE_2D, video_texture_);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, video_width_, video_height_,
-                        GL_RGB, GL_UNSIGNED_BYTE, transformed_buffer.data());
-        glBindTexture(GL_TEXTURE_2D, 0);
+    YUVColorInfo color;
+    const uint8_t* yuv = frame_prefetcher_->acquire(frame_number, playbackStep(), &color);
+    if (!yuv) {
+        // Skip undecodable frames instead of stalling on them
+        return frame_prefetcher_->isFailed(frame_number);
+    }
+    
+    uploadFrame(frame_number, yuv, color);
+    return true;
+}
+
+void GUIApplication::uploadFrame(int frame_number, const uint8_t* yuv, const YUVColorInfo& color) {
+    // Give the prefetcher a mapped pixel buffer in exchange for the one the
+    // frame was decoded into; once the ring consists of pixel buffers,
+    // frames reach the GPU without another copy. When no buffer can be
+    // mapped, exchange it for client memory instead: the slot's buffer may
+    // be a write-only mapping, which has to be taken back to be uploaded
+    uint8_t* mapped = video_texture_->mapUploadBuffer();
+    uint8_t* replacement = mapped ? mapped : acquireFrameBuffer();
+    if (uint8_t* taken = frame_prefetcher_->take(frame_number, replacement)) {
+        video_texture_->updateFromUploadBuffer(taken, color);
+        releaseFrameBuffer(taken);
+        return;
+    }
+    if (mapped) {
+        video_texture_->discardUploadBuffer(mapped);
     } else {
-        // Upload original buffer
-        glBindTexture(GL_TEXTURE_2D, video_texture_);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, video_width_, video_height_,
-                        GL_RGB, GL_UNSIGNED_BYTE, rgb_buffer_.data());
-        glBindTexture(GL_TEXTURE_2D, 0);
+        releaseFrameBuffer(replacement);
     }
     
-    std::cout << "✅ Frame " << current_frame_ << " displayed successfully!" << std::endl;
+    // The slot keeps its buffer; update() skips it if it is mapped
+    video_texture_->update(yuv, color);
+}
+
+uint8_t* GUIApplication::acquireFrameBuffer() {
+    if (free_frame_buffers_.empty()) {
+        frame_buffers_.push_back(std::make_unique<uint8_t[]>(frame_prefetcher_->getBufferSize()));
+        free_frame_buffers_.push_back(frame_buffers_.back().get());
+    }
+    uint8_t* buffer = free_frame_buffers_.back();
+    free_frame_buffers_.pop_back();
+    return buffer;
+}
+
+void GUIApplication::releaseFrameBuffer(uint8_t* buffer) {
+    // Pixel buffers and the prefetcher's own buffers are not ours to reuse
+    for (const auto& owned : frame_buffers_) {
+        if (owned.get() == buffer) {
+            free_frame_buffers_.push_back(buffer);
+            return;
+        }
+    }
+}
+
+int GUIApplication::playbackStep() const {
+    // Above 1x show every n-th frame at the normal rate rather than more
+    // frames than the display can present
+    return is_playing_ ? std::max(1, static_cast<int>(playback_speed_)) : 1;
 }
 
 bool GUIApplication::loadVideo(const std::string& filepath) {
     try {
-        // Analyze video
         analyzer_ = std::make_unique<VideoAnalyzer>();
-        analyzer_->analyze(filepath);
-        
-        // Re-detect duplicates with configured parameters
-        analyzer_->detectDuplicateFrames(duplicate_size_tolerance_,
-                                        duplicate_require_same_qp_,
-                                        duplicate_require_same_type_);
-        
+        frame_lod_.clear();
+        cancelMotionAnalysis();
+        motion_heatmaps_.clear();
+        motion_heatmap_gop_ = -1;
+        video_output_ready_ = false;
         current_video_path_ = filepath;
         current_frame_ = 0;
         is_playing_ = false;
         
-        // Get video dimensions
-        const auto& stream_info = analyzer_->getStreamInfo();
-        video_width_ = stream_info.width;
-        video_height_ = stream_info.height;
-        
-        // Create frame extractor and renderer
-        frame_extractor_ = std::make_unique<FrameExtractor>(filepath);
-        frame_renderer_ = std::make_unique<FrameRenderer>(video_width_, video_height_);
-        
-        // Allocate RGB buffer
-        rgb_buffer_.resize(video_width_ * video_height_ * 3);
-        
-        // Create OpenGL texture
-        createVideoTexture();
-        
-        // Load first frame
-        updateVideoTexture();
-        
-        std::cout << "Video loaded: " << video_width_ << "x" << video_height_ << std::endl;
+        // Binary reports load at once; videos are analyzed in the background
+        // while the timeline and charts fill in
+        if (BinaryReport::isBinaryReport(filepath)) {
+            analyzer_->loadReport(filepath);
+            
+            // Re-detect duplicates with configured parameters
+            analyzer_->detectDuplicateFrames(duplicate_size_tolerance_,
+                                            duplicate_require_same_qp_,
+                                            duplicate_require_same_type_);
+            setupVideoOutput();
+        } else {
+            analyzer_->startAnalysis(filepath, &analysis_cache_);
+        }
         
         // Update window title with filename
         size_t last_slash = filepath.find_last_of("/\\");
@@ -347,15 +372,74 @@ bool GUIApplication::loadVideo(const std::string& filepath) {
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Failed to load video: " << e.what() << std::endl;
+        analyzer_.reset();
         return false;
     }
 }
 
+void GUIApplication::setupVideoOutput() {
+    // Get video dimensions
+    const auto& stream_info = analyzer_->getStreamInfo();
+    video_width_ = stream_info.width;
+    video_height_ = stream_info.height;
+    
+    // Start decoding frames (reports without an accessible source video
+    // show statistics only)
+    const std::string& source_path = analyzer_->getSourcePath();
+    frame_prefetcher_.reset();
+    frame_buffers_.clear();
+    free_frame_buffers_.clear();
+    if (!source_path.empty() && std::filesystem::exists(source_path)) {
+        frame_prefetcher_ = std::make_unique<FramePrefetcher>(source_path, video_width_, video_height_);
+    } else {
+        frame_prefetcher_.reset();
+    }
+    
+    // Create OpenGL texture
+    createVideoTexture();
+    
+    // Load first frame
+    updateVideoTexture();
+    video_output_ready_ = true;
+    
+    std::cout << "Video loaded: " << video_width_ << "x" << video_height_ << std::endl;
+}
+
+void GUIApplication::pollAnalysis() {
+    if (!analyzer_ || !analyzer_->isAnalyzing()) {
+        return;
+    }
+    
+    try {
+        analyzer_->poll();
+        
+        // Show the first frame as soon as the stream is open
+        if (!video_output_ready_ && analyzer_->hasStreamInfo()) {
+            setupVideoOutput();
+        }
+        
+        if (!analyzer_->isAnalyzing()) {
+            // Re-detect duplicates with configured parameters
+            analyzer_->detectDuplicateFrames(duplicate_size_tolerance_,
+                                            duplicate_require_same_qp_,
+                                            duplicate_require_same_type_);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load video: " << e.what() << std::endl;
+        analyzer_.reset();
+        frame_prefetcher_.reset();
+        video_output_ready_ = false;
+        glfwSetWindowTitle(window_, "StreamEye - Video Stream Analyzer");
+    }
+}
+
 void GUIApplication::run() {
     last_frame_time_ = glfwGetTime();
     
     while (!glfwWindowShouldClose(window_)) {
         glfwPollEvents();
+        pollAnalysis();
+        pollMotionAnalysis();
         
         // Handle playback
         if (is_playing_ && analyzer_) {
@@ -363,13 +447,17 @@ void GUIApplication::run() {
             double elapsed = current_time - last_frame_time_;
             
             const auto& stream_info = analyzer_->getStreamInfo();
-            double frame_duration = 1.0 / (stream_info.frameRate * playback_speed_);
+            int step = playbackStep();
+            double frame_duration = step / (stream_info.frameRate * playback_speed_);
             
             if (elapsed >= frame_duration) {
                 const auto& frames = analyzer_->getFrames();
-                if (current_frame_ < frames.size() - 1) {
-                    current_frame_++;
-                    updateVideoTexture();
+                int next_frame = std::min(current_frame_ + step, (int)frames.size() - 1);
+                if (next_frame <= current_frame_) {
+                    is_playing_ = false;
+                    last_frame_time_ = current_time;
+                } else if (presentFrame(next_frame)) {
+                    current_frame_ = next_frame;
                     
                     // Auto-scroll timeline to keep current frame visible (smooth scrolling)
                     if (zoom_level_ > 1.0f) {
@@ -393,10 +481,10 @@ void GUIApplication::run() {
                             scroll_offset_ = scroll_offset_ * 0.7f + target_offset * 0.3f;
                         }
                     }
-                } else {
-                    is_playing_ = false;
+                    last_frame_time_ = current_time;
                 }
-                last_frame_time_ = current_time;
+                // Otherwise the frame is still decoding; keep the UI responsive
+                // and show it on a later iteration
             }
         }
         
@@ -490,29 +578,15 @@ void GUIApplication::renderMenuBar() {
             
             // Video transformations
             if (ImGui::BeginMenu("Video Transform")) {
-                if (ImGui::MenuItem("Rotate 180°", nullptr, &rotate_180_)) {
-                    if (analyzer_) {
-                        updateVideoTexture();
-                    }
-                }
-                if (ImGui::MenuItem("Flip Horizontal", nullptr, &flip_horizontal_)) {
-                    if (analyzer_) {
-                        updateVideoTexture();
-                    }
-                }
-                if (ImGui::MenuItem("Flip Vertical", nullptr, &flip_vertical_)) {
-                    if (analyzer_) {
-                        updateVideoTexture();
-                    }
-                }
+                // Applied through texture coordinates when drawing the frame
+                ImGui::MenuItem("Rotate 180°", nullptr, &rotate_180_);
+                ImGui::MenuItem("Flip Horizontal", nullptr, &flip_horizontal_);
+                ImGui::MenuItem("Flip Vertical", nullptr, &flip_vertical_);
                 ImGui::Separator();
                 if (ImGui::MenuItem("Reset All")) {
                     rotate_180_ = false;
                     flip_horizontal_ = false;
                     flip_vertical_ = false;
-                    if (analyzer_) {
-                        updateVideoTexture();
-                    }
                 }
                 ImGui::EndMenu();
             }
@@ -533,10 +607,17 @@ void GUIApplication::renderMenuBar() {
                     std::cout << "Scene detection not yet implemented" << std::endl;
                 }
             }
-            if (ImGui::MenuItem("Analyze Motion Vectors")) {
-                if (analyzer_) {
-                    std::cout << "Motion vector analysis not yet implemented" << std::endl;
-                }
+            bool can_analyze_motion = analyzer_ && !analyzer_->isAnalyzing() &&
+                                      !motion_future_.valid() &&
+                                      std::filesystem::exists(analyzer_->getSourcePath());
+            if (ImGui::MenuItem("Analyze Motion Vectors", nullptr, false, can_analyze_motion)) {
+                startMotionAnalysis();
+            }
+            ImGui::MenuItem("Show Motion Heatmap", nullptr, &show_motion_heatmap_, !motion_heatmaps_.empty());
+            if (ImGui::MenuItem("Export Motion Heatmaps", nullptr, false, !motion_heatmaps_.empty())) {
+                // Next to the analysis export
+                std::filesystem::path path(export_path_buffer_);
+                exportMotionHeatmaps(path.replace_filename("motion_heatmaps.json").string());
             }
             ImGui::EndMenu();
         }
@@ -798,11 +879,9 @@ void GUIApplication::renderMenuBar() {
         
         // Video transformation settings
         if (ImGui::CollapsingHeader("Video Transform", ImGuiTreeNodeFlags_DefaultOpen)) {
-            bool transform_changed = false;
-            
-            transform_changed |= ImGui::Checkbox("Rotate 180°", &rotate_180_);
-            transform_changed |= ImGui::Checkbox("Flip Horizontal", &flip_horizontal_);
-            transform_changed |= ImGui::Checkbox("Flip Vertical", &flip_vertical_);
+            ImGui::Checkbox("Rotate 180°", &rotate_180_);
+            ImGui::Checkbox("Flip Horizontal", &flip_horizontal_);
+            ImGui::Checkbox("Flip Vertical", &flip_vertical_);
             
             ImGui::Spacing();
             
@@ -810,11 +889,6 @@ void GUIApplication::renderMenuBar() {
                 rotate_180_ = false;
                 flip_horizontal_ = false;
                 flip_vertical_ = false;
-                transform_changed = true;
-            }
-            
-            if (transform_changed && analyzer_) {
-                updateVideoTexture();
             }
         }
         
@@ -914,7 +988,7 @@ void GUIApplication::renderToolBar() {
         if (ImGui::Button("⏭ Next")) {
             if (has_video) {
                 const auto& frames = analyzer_->getFrames();
-                if (current_frame_ < frames.size() - 1) {
+                if (current_frame_ + 1 < (int)frames.size()) {
                     current_frame_++;
                     updateVideoTexture();
                 }
@@ -971,6 +1045,28 @@ void GUIApplication::renderToolBar() {
             ImGui::Text("No video loaded");
         }
         
+        // Background analysis progress
+        if (has_video && analyzer_->isAnalyzing()) {
+            AnalysisProgress progress = analyzer_->getProgress();
+            
+            ImGui::SameLine();
+            ImGui::TextDisabled("|");
+            ImGui::SameLine();
+            
+            char overlay[32];
+            snprintf(overlay, sizeof(overlay), "Analyzing %.0f%%", progress.fraction * 100.0);
+            ImGui::ProgressBar((float)progress.fraction, ImVec2(160, 0), overlay);
+            ImGui::SameLine();
+            ImGui::Text("%zu frames @ %.0f fps", progress.framesDecoded, progress.framesPerSecond);
+            ImGui::SameLine();
+            if (ImGui::Button("✖ Cancel")) {
+                analyzer_->cancelAnalysis();
+            }
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("Stop analysis and keep the frames analyzed so far");
+            }
+        }
+        
         if (!has_video) {
             ImGui::EndDisabled();
         }
@@ -1036,9 +1132,19 @@ void GUIApplication::renderVideoPlayer() {
                                    ImGui::GetCursorPosY() + offset_y));
         
         if (video_texture_) {
-            // Display video texture (normal orientation)
-            ImGui::Image((void*)(intptr_t)video_texture_, ImVec2(display_w, display_h),
-                        ImVec2(0, 0), ImVec2(1, 1));
+            // Rotate/flip by mirroring the texture coordinates
+            bool mirror_x = flip_horizontal_ != rotate_180_;
+            bool mirror_y = flip_vertical_ != rotate_180_;
+            ImVec2 uv0(mirror_x ? 1.0f : 0.0f, mirror_y ? 1.0f : 0.0f);
+            ImVec2 uv1(mirror_x ? 0.0f : 1.0f, mirror_y ? 0.0f : 1.0f);
+            ImGui::Image((void*)(intptr_t)video_texture_->getTexture(), ImVec2(display_w, display_h),
+                        uv0, uv1);
+            
+            if (show_motion_heatmap_ && !motion_heatmaps_.empty()) {
+                updateMotionHeatmap();
+                ImVec2 origin = ImGui::GetItemRectMin();
+                renderMotionHeatmap(origin.x, origin.y, display_w, display_h, mirror_x, mirror_y);
+            }
         } else {
             // Placeholder
             ImGui::GetWindowDrawList()->AddRectFilled(
@@ -1069,6 +1175,11 @@ void GUIApplication::renderVideoPlayer() {
             ImGui::Text("Type: %c  Size: %.1f KB  QP: %d", 
                        type_char, frame.size / 1024.0, frame.qp);
             ImGui::Text("PTS: %lld  DTS: %lld", frame.pts, frame.dts);
+            if (show_motion_heatmap_ && motion_heatmap_gop_ >= 0 &&
+                !motion_heatmaps_[motion_heatmap_gop_].empty()) {
+                ImGui::Text("Motion: GOP %d, max %.1f px/frame", motion_heatmap_gop_,
+                           motion_heatmaps_[motion_heatmap_gop_].maxMean());
+            }
         }
         ImGui::EndChild();
     }
@@ -1076,6 +1187,164 @@ void GUIApplication::renderVideoPlayer() {
     ImGui::End();
 }
 
+void GUIApplication::updateFrameLod() {
+    const auto& frames = analyzer_->getFrames();
+    
+    // Spread large batches (a freshly loaded long video) over a pool
+    if (!lod_pool_ && frames.size() - std::min(frames.size(), frame_lod_.size()) > (1 << 16)) {
+        lod_pool_ = std::make_unique<ThreadPool>();
+    }
+    frame_lod_.update(frames, lod_pool_.get());
+}
+
+void GUIApplication::startMotionAnalysis() {
+    std::string source_path = analyzer_->getSourcePath();
+    std::cout << "Analyzing motion vectors: " << source_path << std::endl;
+    
+    if (!motion_pool_) {
+        motion_pool_ = std::make_unique<ThreadPool>();
+    }
+    
+    // Decode on a separate decoder so playback is not disturbed; fields are
+    // folded into the heatmaps as they are decoded and never kept
+    ThreadPool* pool = motion_pool_.get();
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    motion_cancel_ = cancel;
+    motion_future_ = std::async(std::launch::async, [source_path, pool, cancel] {
+        VideoDecoder decoder(source_path);
+        MotionHeatmapSink heatmap_sink(pool);
+        AnalysisPipeline pipeline(decoder);
+        pipeline.addSink(heatmap_sink);
+        pipeline.setProgressCallback([&pipeline, cancel](size_t) {
+            if (cancel->load()) {
+                pipeline.cancel();
+            }
+        });
+        pipeline.run();
+        return heatmap_sink.takeHeatmaps();
+    });
+}
+
+void GUIApplication::cancelMotionAnalysis() {
+    if (!motion_future_.valid()) {
+        return;
+    }
+    
+    // Releasing a running std::async future would block until the decode
+    // finishes; keep it until pollMotionAnalysis() sees it complete
+    motion_cancel_->store(true);
+    cancelled_motion_jobs_.push_back(std::move(motion_future_));
+    motion_cancel_.reset();
+}
+
+void GUIApplication::pollMotionAnalysis() {
+    // Drop cancelled jobs once done; their results are discarded
+    cancelled_motion_jobs_.erase(
+        std::remove_if(cancelled_motion_jobs_.begin(), cancelled_motion_jobs_.end(),
+                       [](const std::future<std::vector<MotionHeatmap>>& job) {
+                           return job.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                       }),
+        cancelled_motion_jobs_.end());
+    
+    if (!motion_future_.valid() ||
+        motion_future_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    
+    try {
+        motion_heatmaps_ = motion_future_.get();
+        motion_heatmap_gop_ = -1;
+        show_motion_heatmap_ = true;
+        std::cout << "Motion vectors analyzed: " << motion_heatmaps_.size() << " GOPs" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Motion vector analysis failed: " << e.what() << std::endl;
+    }
+}
+
+void GUIApplication::updateMotionHeatmap() {
+    const auto& frames = analyzer_->getFrames();
+    if (current_frame_ >= (int)frames.size()) {
+        return;
+    }
+    
+    // Heatmap of the GOP containing the current frame
+    int64_t pts = frames[current_frame_].pts;
+    auto it = std::upper_bound(motion_heatmaps_.begin(), motion_heatmaps_.end(), pts,
+                               [](int64_t p, const MotionHeatmap& heatmap) { return p < heatmap.startPts; });
+    motion_heatmap_gop_ = (int)(it - motion_heatmaps_.begin()) - 1;
+}
+
+void GUIApplication::renderMotionHeatmap(float origin_x, float origin_y, float display_w, float display_h,
+                                         bool mirror_x, bool mirror_y) {
+    if (motion_heatmap_gop_ < 0) {
+        return;
+    }
+    
+    const MotionHeatmap& heatmap = motion_heatmaps_[motion_heatmap_gop_];
+    float max_mean = heatmap.maxMean();
+    if (max_mean <= 0.0f || video_width_ <= 0 || video_height_ <= 0) {
+        return;
+    }
+    
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    float scale_x = display_w / video_width_;
+    float scale_y = display_h / video_height_;
+    int block = heatmap.blockSize;
+    
+    for (int row = 0; row < heatmap.rows; ++row) {
+        for (int column = 0; column < heatmap.columns; ++column) {
+            float mean = heatmap.mean(column, row);
+            if (mean <= 0.0f) {
+                continue;
+            }
+            
+            // Cell in video pixels, mirrored like the texture coordinates
+            float x0 = (float)(column * block);
+            float x1 = (float)std::min((column + 1) * block, video_width_);
+            float y0 = (float)(row * block);
+            float y1 = (float)std::min((row + 1) * block, video_height_);
+            if (mirror_x) {
+                std::swap(x0, x1);
+                x0 = video_width_ - x0;
+                x1 = video_width_ - x1;
+            }
+            if (mirror_y) {
+                std::swap(y0, y1);
+                y0 = video_height_ - y0;
+                y1 = video_height_ - y1;
+            }
+            
+            // Yellow (little motion) to red (most motion in the GOP)
+            float t = mean / max_mean;
+            draw_list->AddRectFilled(
+                ImVec2(origin_x + x0 * scale_x, origin_y + y0 * scale_y),
+                ImVec2(origin_x + x1 * scale_x, origin_y + y1 * scale_y),
+                IM_COL32(255, (int)(255 * (1.0f - t)), 0, (int)(40 + 120 * t))
+            );
+        }
+    }
+}
+
+void GUIApplication::exportMotionHeatmaps(const std::string& path) {
+    nlohmann::json j;
+    j["width"] = video_width_;
+    j["height"] = video_height_;
+    j["gops"] = nlohmann::json::array();
+    for (size_t i = 0; i < motion_heatmaps_.size(); ++i) {
+        nlohmann::json entry = motion_heatmaps_[i].toJson();
+        entry["gopIndex"] = (int)i;
+        j["gops"].push_back(std::move(entry));
+    }
+    
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to write motion heatmaps: " << path << std::endl;
+        return;
+    }
+    file << j.dump(2);
+    std::cout << "Motion heatmaps exported to: " << path << std::endl;
+}
+
 void GUIApplication::renderTimeline() {
     // Set default position and size
     int window_width, window_height;
@@ -1105,6 +1374,7 @@ void GUIApplication::renderTimeline() {
         ImGui::End();
         return;
     }
+    updateFrameLod();
     
     // Zoom controls
     ImGui::Text("Frame Type Importance");
@@ -1168,32 +1438,29 @@ void GUIApplication::renderTimeline() {
         scroll_offset_ = (float)start_frame / total_frames;
     }
     
-    // Draw frames (only visible range)
+    // Draw frames (only visible range), one bar per pixel column at most;
+    // a column covering several frames shows the most important type
     float frame_width = canvas_size.x / visible_frames;
+    auto columns = frame_lod_.query(start_frame, end_frame, std::max(1, (int)canvas_size.x));
+    float column_width = canvas_size.x / std::max<size_t>(1, columns.size());
+    float bar_gap = column_width > 2.0f ? 1.0f : 0.0f;
     
-    for (int i = start_frame; i < end_frame; ++i) {
-        const auto& frame = frames[i];
-        float x = canvas_pos.x + (i - start_frame) * frame_width;
+    for (size_t c = 0; c < columns.size(); ++c) {
+        float x = canvas_pos.x + c * column_width;
+        FrameType type = columns[c].dominantType();
         
-        // Frame color based on type
-        ImU32 color;
         float height_ratio;
-        
-        switch (frame.type) {
+        switch (type) {
             case FrameType::I_FRAME:
-                color = IM_COL32(255, 100, 100, 255);
                 height_ratio = 1.0f;
                 break;
             case FrameType::P_FRAME:
-                color = IM_COL32(100, 255, 100, 255);
                 height_ratio = 0.6f;
                 break;
             case FrameType::B_FRAME:
-                color = IM_COL32(100, 100, 255, 255);
                 height_ratio = 0.4f;
                 break;
             default:
-                color = IM_COL32(150, 150, 150, 255);
                 height_ratio = 0.3f;
         }
         
@@ -1202,22 +1469,24 @@ void GUIApplication::renderTimeline() {
         
         draw_list->AddRectFilled(
             ImVec2(x, canvas_pos.y + y_offset),
-            ImVec2(x + frame_width - 1, canvas_pos.y + y_offset + bar_height),
-            color
+            ImVec2(x + column_width - bar_gap, canvas_pos.y + y_offset + bar_height),
+            frameTypeColor(type)
         );
-        
-        // Highlight current frame
-        if (i == current_frame_) {
-            draw_list->AddRect(
-                ImVec2(x - 1, canvas_pos.y + 2),
-                ImVec2(x + frame_width, canvas_pos.y + canvas_size.y - 2),
-                IM_COL32(255, 255, 0, 255), 0.0f, 0, 2.0f
-            );
-        }
     }
     
-    // Draw duplicate frame groups (boxes around duplicate frames)
-    if (show_duplicate_frames_) {
+    // Highlight current frame
+    if (current_frame_ >= start_frame && current_frame_ < end_frame) {
+        float x = canvas_pos.x + (current_frame_ - start_frame) * frame_width;
+        draw_list->AddRect(
+            ImVec2(x - 1, canvas_pos.y + 2),
+            ImVec2(x + std::max(frame_width, 1.0f), canvas_pos.y + canvas_size.y - 2),
+            IM_COL32(255, 255, 0, 255), 0.0f, 0, 2.0f
+        );
+    }
+    
+    // Draw duplicate frame groups (boxes around duplicate frames); skipped
+    // while frames are too narrow for the boxes to be told apart
+    if (show_duplicate_frames_ && frame_width >= 2.0f) {
         for (int i = start_frame; i < end_frame; ++i) {
             const auto& frame = frames[i];
             
@@ -1266,17 +1535,24 @@ void GUIApplication::renderTimeline() {
         }
     }
     
-    // GOP boundaries (only in visible range)
+    // GOP boundaries (only in visible range, at most one per pixel column)
     const auto& gops = analyzer_->getGOPs();
     int frame_idx = 0;
+    float last_boundary_x = -1.0f;
     for (const auto& gop : gops) {
-        if (frame_idx >= start_frame && frame_idx < end_frame) {
+        if (frame_idx >= end_frame) {
+            break;
+        }
+        if (frame_idx >= start_frame) {
             float x = canvas_pos.x + (frame_idx - start_frame) * frame_width;
-            draw_list->AddLine(
-                ImVec2(x, canvas_pos.y),
-                ImVec2(x, canvas_pos.y + canvas_size.y),
-                IM_COL32(255, 255, 255, 128), 2.0f
-            );
+            if (x - last_boundary_x >= 1.0f) {
+                draw_list->AddLine(
+                    ImVec2(x, canvas_pos.y),
+                    ImVec2(x, canvas_pos.y + canvas_size.y),
+                    IM_COL32(255, 255, 255, 128), 2.0f
+                );
+                last_boundary_x = x;
+            }
         }
         frame_idx += gop.frameCount;
     }
@@ -1481,6 +1757,7 @@ void GUIApplication::renderCharts() {
         ImGui::End();
         return;
     }
+    updateFrameLod();
     
     // Unified zoom controls for all charts
     ImGui::Text("Charts Zoom:");
@@ -1512,6 +1789,9 @@ void GUIApplication::renderCharts() {
         end_frame = total_frames;
     }
     
+    // Whole-video extremes for scaling, from the pyramid root
+    FrameLodBucket all_frames = frame_lod_.aggregate(0, total_frames);
+    
     // Bitrate chart (custom drawing with colors)
     if (ImGui::CollapsingHeader("Bitrate", ImGuiTreeNodeFlags_DefaultOpen)) {
         ImVec2 canvas_pos = ImGui::GetCursorScreenPos();
@@ -1530,12 +1810,8 @@ void GUIApplication::renderCharts() {
                                 ImVec2(canvas_pos.x + canvas_size.x, canvas_pos.y + canvas_size.y),
                                 IM_COL32(25, 25, 25, 255));
         
-        // Find max bitrate for scaling
-        float max_bitrate = 0.0f;
-        for (const auto& frame : frames) {
-            float bitrate = frame.size * 8.0f / 1000.0f; // Kbits
-            max_bitrate = std::max(max_bitrate, bitrate);
-        }
+        // Max bitrate for scaling
+        float max_bitrate = all_frames.maxSize * 8.0f / 1000.0f; // Kbits
         
         // Y-axis labels (Kbits)
         char label_max[32], label_mid[32], label_min[32];
@@ -1557,66 +1833,49 @@ void GUIApplication::renderCharts() {
         
         if (max_bitrate > 0 && visible_frames > 1) {
             float point_width = canvas_size.x / (visible_frames - 1);
+            size_t columns = std::max(1, (int)canvas_size.x);
             
-            // Draw lines between points (only visible range)
-            for (int i = start_frame; i < end_frame - 1; ++i) {
-                const auto& frame1 = frames[i];
-                const auto& frame2 = frames[i + 1];
-                
-                float bitrate1 = frame1.size * 8.0f / 1000.0f;
-                float bitrate2 = frame2.size * 8.0f / 1000.0f;
-                
-                float x1 = canvas_pos.x + (i - start_frame) * point_width;
-                float x2 = canvas_pos.x + (i + 1 - start_frame) * point_width;
-                float y1 = canvas_pos.y + canvas_size.y - 10 - (bitrate1 / max_bitrate) * (canvas_size.y - 20);
-                float y2 = canvas_pos.y + canvas_size.y - 10 - (bitrate2 / max_bitrate) * (canvas_size.y - 20);
-                
-                // Color based on frame type
-                ImU32 color;
-                switch (frame1.type) {
-                    case FrameType::I_FRAME:
-                        color = IM_COL32(255, 100, 100, 255);
-                        break;
-                    case FrameType::P_FRAME:
-                        color = IM_COL32(100, 255, 100, 255);
-                        break;
-                    case FrameType::B_FRAME:
-                        color = IM_COL32(100, 100, 255, 255);
-                        break;
-                    default:
-                        color = IM_COL32(150, 150, 150, 255);
-                        break;
+            if ((size_t)visible_frames <= columns) {
+                // Draw lines between points (only visible range)
+                for (int i = start_frame; i < end_frame - 1; ++i) {
+                    const auto& frame1 = frames[i];
+                    const auto& frame2 = frames[i + 1];
+                    
+                    float bitrate1 = frame1.size * 8.0f / 1000.0f;
+                    float bitrate2 = frame2.size * 8.0f / 1000.0f;
+                    
+                    float x1 = canvas_pos.x + (i - start_frame) * point_width;
+                    float x2 = canvas_pos.x + (i + 1 - start_frame) * point_width;
+                    float y1 = canvas_pos.y + canvas_size.y - 10 - (bitrate1 / max_bitrate) * (canvas_size.y - 20);
+                    float y2 = canvas_pos.y + canvas_size.y - 10 - (bitrate2 / max_bitrate) * (canvas_size.y - 20);
+                    
+                    // Color based on frame type
+                    ImU32 color = frameTypeColor(frame1.type);
+                    
+                    draw_list->AddLine(ImVec2(x1, y1), ImVec2(x2, y2), color, 2.0f);
+                    
+                    // Draw point
+                    draw_list->AddCircleFilled(ImVec2(x1, y1), 3.0f, color);
                 }
                 
-                draw_list->AddLine(ImVec2(x1, y1), ImVec2(x2, y2), color, 2.0f);
-                
-                // Draw point
-                draw_list->AddCircleFilled(ImVec2(x1, y1), 3.0f, color);
-            }
-            
-            // Draw last point in visible range
-            if (end_frame - 1 >= start_frame) {
+                // Draw last point in visible range
                 const auto& last_frame = frames[end_frame - 1];
                 float last_bitrate = last_frame.size * 8.0f / 1000.0f;
                 float last_x = canvas_pos.x + (end_frame - 1 - start_frame) * point_width;
                 float last_y = canvas_pos.y + canvas_size.y - 10 - (last_bitrate / max_bitrate) * (canvas_size.y - 20);
-                
-                ImU32 last_color;
-                switch (last_frame.type) {
-                    case FrameType::I_FRAME:
-                        last_color = IM_COL32(255, 100, 100, 255);
-                        break;
-                    case FrameType::P_FRAME:
-                        last_color = IM_COL32(100, 255, 100, 255);
-                        break;
-                    case FrameType::B_FRAME:
-                        last_color = IM_COL32(100, 100, 255, 255);
-                        break;
-                    default:
-                        last_color = IM_COL32(150, 150, 150, 255);
-                        break;
+                draw_list->AddCircleFilled(ImVec2(last_x, last_y), 3.0f, frameTypeColor(last_frame.type));
+            } else {
+                // More frames than pixels: one min-max line per column
+                auto buckets = frame_lod_.query(start_frame, end_frame, columns);
+                float column_width = canvas_size.x / buckets.size();
+                for (size_t c = 0; c < buckets.size(); ++c) {
+                    const auto& bucket = buckets[c];
+                    float x = canvas_pos.x + (c + 0.5f) * column_width;
+                    float y_top = canvas_pos.y + canvas_size.y - 10 - (bucket.maxSize * 8.0f / 1000.0f / max_bitrate) * (canvas_size.y - 20);
+                    float y_bottom = canvas_pos.y + canvas_size.y - 10 - (bucket.minSize * 8.0f / 1000.0f / max_bitrate) * (canvas_size.y - 20);
+                    draw_list->AddLine(ImVec2(x, std::max(y_bottom, y_top + 1.0f)), ImVec2(x, y_top),
+                                       frameTypeColor(bucket.dominantType()), column_width);
                 }
-                draw_list->AddCircleFilled(ImVec2(last_x, last_y), 3.0f, last_color);
             }
             
             // Highlight current frame (if in visible range)
@@ -1672,11 +1931,8 @@ void GUIApplication::renderCharts() {
                                 ImVec2(canvas_pos.x + canvas_size.x, canvas_pos.y + canvas_size.y),
                                 IM_COL32(25, 25, 25, 255));
         
-        // Find max frame size for scaling
-        float max_size = 0.0f;
-        for (const auto& frame : frames) {
-            max_size = std::max(max_size, frame.size / 1024.0f);
-        }
+        // Max frame size for scaling
+        float max_size = all_frames.maxSize / 1024.0f;
         
         // Y-axis labels (KB)
         char label_max[32], label_mid[32], label_min[32];
@@ -1699,46 +1955,35 @@ void GUIApplication::renderCharts() {
         if (max_size > 0) {
             float bar_width = canvas_size.x / visible_frames;
             
-            // Draw only visible frames
-            for (int i = start_frame; i < end_frame; ++i) {
-                const auto& frame = frames[i];
-                float x = canvas_pos.x + (i - start_frame) * bar_width;
-                
-                // Frame color based on type
-                ImU32 color;
-                switch (frame.type) {
-                    case FrameType::I_FRAME:
-                        color = IM_COL32(255, 100, 100, 255); // Red for I-frames
-                        break;
-                    case FrameType::P_FRAME:
-                        color = IM_COL32(100, 255, 100, 255); // Green for P-frames
-                        break;
-                    case FrameType::B_FRAME:
-                        color = IM_COL32(100, 100, 255, 255); // Blue for B-frames
-                        break;
-                    default:
-                        color = IM_COL32(150, 150, 150, 255);
-                        break;
-                }
+            // Draw only visible frames, one bar per pixel column at most;
+            // a column covering several frames shows their largest one
+            auto buckets = frame_lod_.query(start_frame, end_frame, std::max(1, (int)canvas_size.x));
+            float column_width = canvas_size.x / std::max<size_t>(1, buckets.size());
+            float bar_gap = column_width > 2.0f ? 1.0f : 0.0f;
+            
+            for (size_t c = 0; c < buckets.size(); ++c) {
+                const auto& bucket = buckets[c];
+                float x = canvas_pos.x + c * column_width;
                 
-                float size_kb = frame.size / 1024.0f;
+                float size_kb = bucket.maxSize / 1024.0f;
                 float bar_height = (size_kb / max_size) * (canvas_size.y - 20);
                 float y_offset = canvas_size.y - bar_height - 5;
                 
                 draw_list->AddRectFilled(
                     ImVec2(x, canvas_pos.y + y_offset),
-                    ImVec2(x + bar_width - 1, canvas_pos.y + canvas_size.y - 5),
-                    color
+                    ImVec2(x + column_width - bar_gap, canvas_pos.y + canvas_size.y - 5),
+                    frameTypeColor(bucket.dominantType())
+                );
+            }
+            
+            // Highlight current frame (if in visible range)
+            if (current_frame_ >= start_frame && current_frame_ < end_frame) {
+                float x = canvas_pos.x + (current_frame_ - start_frame) * bar_width;
+                draw_list->AddRect(
+                    ImVec2(x - 1, canvas_pos.y + 2),
+                    ImVec2(x + std::max(bar_width, 1.0f), canvas_pos.y + canvas_size.y - 2),
+                    IM_COL32(255, 255, 0, 255), 0.0f, 0, 2.0f
                 );
-                
-                // Highlight current frame (if in visible range)
-                if (i == current_frame_ && current_frame_ >= start_frame && current_frame_ < end_frame) {
-                    draw_list->AddRect(
-                        ImVec2(x - 1, canvas_pos.y + 2),
-                        ImVec2(x + bar_width, canvas_pos.y + canvas_size.y - 2),
-                        IM_COL32(255, 255, 0, 255), 0.0f, 0, 2.0f
-                    );
-                }
             }
         }
         
@@ -1797,60 +2042,43 @@ void GUIApplication::renderCharts() {
         if (visible_frames > 1) {
             float point_width = canvas_size.x / (visible_frames - 1);
             float max_qp = 51.0f; // QP range is 0-51
+            size_t columns = std::max(1, (int)canvas_size.x);
             
-            // Draw lines between points (only visible range)
-            for (int i = start_frame; i < end_frame - 1; ++i) {
-                const auto& frame1 = frames[i];
-                const auto& frame2 = frames[i + 1];
-                
-                float x1 = canvas_pos.x + (i - start_frame) * point_width;
-                float x2 = canvas_pos.x + (i + 1 - start_frame) * point_width;
-                float y1 = canvas_pos.y + canvas_size.y - 10 - (frame1.qp / max_qp) * (canvas_size.y - 20);
-                float y2 = canvas_pos.y + canvas_size.y - 10 - (frame2.qp / max_qp) * (canvas_size.y - 20);
-                
-                // Color based on frame type
-                ImU32 color;
-                switch (frame1.type) {
-                    case FrameType::I_FRAME:
-                        color = IM_COL32(255, 100, 100, 255);
-                        break;
-                    case FrameType::P_FRAME:
-                        color = IM_COL32(100, 255, 100, 255);
-                        break;
-                    case FrameType::B_FRAME:
-                        color = IM_COL32(100, 100, 255, 255);
-                        break;
-                    default:
-                        color = IM_COL32(150, 150, 150, 255);
-                        break;
+            if ((size_t)visible_frames <= columns) {
+                // Draw lines between points (only visible range)
+                for (int i = start_frame; i < end_frame - 1; ++i) {
+                    const auto& frame1 = frames[i];
+                    const auto& frame2 = frames[i + 1];
+                    
+                    float x1 = canvas_pos.x + (i - start_frame) * point_width;
+                    float x2 = canvas_pos.x + (i + 1 - start_frame) * point_width;
+                    float y1 = canvas_pos.y + canvas_size.y - 10 - (frame1.qp / max_qp) * (canvas_size.y - 20);
+                    float y2 = canvas_pos.y + canvas_size.y - 10 - (frame2.qp / max_qp) * (canvas_size.y - 20);
+                    
+                    // Color based on frame type
+                    ImU32 color = frameTypeColor(frame1.type);
+                    
+                    draw_list->AddLine(ImVec2(x1, y1), ImVec2(x2, y2), color, 2.0f);
+                    draw_list->AddCircleFilled(ImVec2(x1, y1), 3.0f, color);
                 }
                 
-                draw_list->AddLine(ImVec2(x1, y1), ImVec2(x2, y2), color, 2.0f);
-                draw_list->AddCircleFilled(ImVec2(x1, y1), 3.0f, color);
-            }
-            
-            // Draw last point in visible range
-            if (end_frame - 1 >= start_frame) {
+                // Draw last point in visible range
                 const auto& last_frame = frames[end_frame - 1];
                 float last_x = canvas_pos.x + (end_frame - 1 - start_frame) * point_width;
                 float last_y = canvas_pos.y + canvas_size.y - 10 - (last_frame.qp / max_qp) * (canvas_size.y - 20);
-                
-                ImU32 last_color;
-                switch (last_frame.type) {
-                    case FrameType::I_FRAME:
-                        last_color = IM_COL32(255, 100, 100, 255);
-                        break;
-                    case FrameType::P_FRAME:
-                        last_color = IM_COL32(100, 255, 100, 255);
-                        break;
-                    case FrameType::B_FRAME:
-                        last_color = IM_COL32(100, 100, 255, 255);
-                        break;
-                    default:
-                        last_color = IM_COL32(150, 150, 150, 255);
-                        break;
+                draw_list->AddCircleFilled(ImVec2(last_x, last_y), 3.0f, frameTypeColor(last_frame.type));
+            } else {
+                // More frames than pixels: one min-max line per column
+                auto buckets = frame_lod_.query(start_frame, end_frame, columns);
+                float column_width = canvas_size.x / buckets.size();
+                for (size_t c = 0; c < buckets.size(); ++c) {
+                    const auto& bucket = buckets[c];
+                    float x = canvas_pos.x + (c + 0.5f) * column_width;
+                    float y_top = canvas_pos.y + canvas_size.y - 10 - (bucket.maxQP / max_qp) * (canvas_size.y - 20);
+                    float y_bottom = canvas_pos.y + canvas_size.y - 10 - (bucket.minQP / max_qp) * (canvas_size.y - 20);
+                    draw_list->AddLine(ImVec2(x, std::max(y_bottom, y_top + 1.0f)), ImVec2(x, y_top),
+                                       frameTypeColor(bucket.dominantType()), column_width);
                 }
-                draw_list->AddCircleFilled(ImVec2(last_x, last_y), 3.0f, last_color);
             }
             
             // Highlight current frame (if in visible range)
@@ -1895,6 +2123,11 @@ void GUIApplication::renderControls() {
     }
     
     const auto& frames = analyzer_->getFrames();
+    if (frames.empty()) {
+        ImGui::TextDisabled("No frames analyzed");
+        ImGui::End();
+        return;
+    }
     
     // Play/Pause button
     if (is_playing_) {
@@ -1923,7 +2156,7 @@ void GUIApplication::renderControls() {
     
     ImGui::SameLine();
     if (ImGui::Button("⏭ Next")) {
-        if (current_frame_ < frames.size() - 1) {
+        if (current_frame_ + 1 < (int)frames.size()) {
             current_frame_++;
             updateVideoTexture();
         }
@@ -0,0 +1,123 @@
+#include "video_analyzer/keyframe_index.h"
+#include "video_analyzer/ffmpeg_context.h"
+#include "video_analyzer/ffmpeg_error.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/error.h>
+}
+
+#include <algorithm>
+
+namespace video_analyzer {
+
+KeyframeIndex KeyframeIndex::build(const std::string& filePath, const std::atomic<bool>* cancel) {
+    FFmpegContext context;
+    
+    AVFormatContext* fmtCtx = avformat_alloc_context();
+    if (!fmtCtx) {
+        throw FFmpegError(AVERROR(ENOMEM), "Failed to allocate format context");
+    }
+    
+    // Let the cancel flag abort a demuxer blocked on I/O
+    if (cancel) {
+        fmtCtx->interrupt_callback.callback = [](void* opaque) -> int {
+            return static_cast<const std::atomic<bool>*>(opaque)->load();
+        };
+        fmtCtx->interrupt_callback.opaque = const_cast<std::atomic<bool>*>(cancel);
+    }
+    
+    int ret = avformat_open_input(&fmtCtx, filePath.c_str(), nullptr, nullptr);
+    if (ret < 0) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        throw FFmpegError(ret, std::string("Failed to open file: ") + errbuf);
+    }
+    context.setFormatContext(fmtCtx);
+    
+    ret = avformat_find_stream_info(fmtCtx, nullptr);
+    if (ret < 0) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        throw FFmpegError(ret, std::string("Failed to find stream info: ") + errbuf);
+    }
+    
+    // Find the first video stream (same choice as VideoDecoder)
+    int videoStreamIndex = -1;
+    for (unsigned int i = 0; i < fmtCtx->nb_streams; i++) {
+        if (fmtCtx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+            videoStreamIndex = i;
+            break;
+        }
+    }
+    
+    if (videoStreamIndex == -1) {
+        throw FFmpegError(AVERROR_STREAM_NOT_FOUND, "No video stream found");
+    }
+    
+    KeyframeIndex index;
+    index.timeBase_ = av_q2d(fmtCtx->streams[videoStreamIndex]->time_base);
+    
+    // Only the video stream is needed
+    for (unsigned int i = 0; i < fmtCtx->nb_streams; i++) {
+        if (static_cast<int>(i) != videoStreamIndex) {
+            fmtCtx->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+    
+    PacketPtr packet;
+    while ((ret = av_read_frame(fmtCtx, packet.get())) >= 0) {
+        if (cancel && cancel->load()) {
+            throw FFmpegError(AVERROR_EXIT, "Keyframe indexing cancelled");
+        }
+        if (packet->stream_index == videoStreamIndex) {
+            int64_t pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            int64_t dts = packet->dts != AV_NOPTS_VALUE ? packet->dts : pts;
+            index.framePts_.push_back(pts);
+            
+            if (packet->flags & AV_PKT_FLAG_KEY) {
+                index.keyframes_.push_back({pts, dts, packet->pos, 0});
+            }
+        }
+        av_packet_unref(packet.get());
+    }
+    
+    if (ret != AVERROR_EOF) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        throw FFmpegError(ret, std::string("Error reading frame: ") + errbuf);
+    }
+    
+    // Packets arrive in decode order; sort into presentation order
+    std::sort(index.framePts_.begin(), index.framePts_.end());
+    std::sort(index.keyframes_.begin(), index.keyframes_.end(),
+              [](const KeyframeEntry& a, const KeyframeEntry& b) { return a.pts < b.pts; });
+    
+    for (auto& keyframe : index.keyframes_) {
+        keyframe.frameNumber = index.findFrameNumber(keyframe.pts).value_or(0);
+    }
+    
+    return index;
+}
+
+std::optional<size_t> KeyframeIndex::findFrameNumber(int64_t pts) const {
+    auto it = std::lower_bound(framePts_.begin(), framePts_.end(), pts);
+    if (it == framePts_.end() || *it != pts) {
+        return std::nullopt;
+    }
+    
+    return static_cast<size_t>(it - framePts_.begin());
+}
+
+const KeyframeEntry* KeyframeIndex::findKeyframeForFrame(size_t frameNumber) const {
+    auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), frameNumber,
+                               [](size_t n, const KeyframeEntry& k) { return n < k.frameNumber; });
+    if (it == keyframes_.begin()) {
+        return nullptr;
+    }
+    
+    return &*(it - 1);
+}
+
+} // namespace video_analyzer
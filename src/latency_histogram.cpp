@@ -0,0 +1,106 @@
+#include "video_analyzer/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace video_analyzer {
+
+size_t LatencyHistogram::bucketIndex(uint64_t micros) {
+    size_t index = 0;
+    while (micros > 0 && index < kBucketCount - 1) {
+        micros >>= 1;
+        index++;
+    }
+    return index;
+}
+
+double LatencyHistogram::bucketUpperBound(size_t bucket) {
+    return std::ldexp(1.0, static_cast<int>(bucket));
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    uint64_t nanos = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+    
+    buckets_[bucketIndex(nanos / 1000)].fetch_add(1, std::memory_order_relaxed);
+    totalNanos_.fetch_add(nanos, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    
+    uint64_t currentMax = maxNanos_.load(std::memory_order_relaxed);
+    while (nanos > currentMax &&
+           !maxNanos_.compare_exchange_weak(currentMax, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    totalNanos_.store(0, std::memory_order_relaxed);
+    maxNanos_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    return count_.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t samples = count();
+    if (samples == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(totalNanos_.load(std::memory_order_relaxed)) / samples / 1000.0;
+}
+
+double LatencyHistogram::max() const {
+    return static_cast<double>(maxNanos_.load(std::memory_order_relaxed)) / 1000.0;
+}
+
+double LatencyHistogram::percentile(double percentile) const {
+    // Count from the buckets themselves so the total matches what is summed
+    uint64_t total = 0;
+    std::array<uint64_t, kBucketCount> counts;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+    
+    double clamped = std::clamp(percentile, 0.0, 100.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), max());
+        }
+    }
+    return max();
+}
+
+uint64_t LatencyHistogram::bucketCount(size_t bucket) const {
+    return bucket < kBucketCount ? buckets_[bucket].load(std::memory_order_relaxed) : 0;
+}
+
+nlohmann::json LatencyHistogram::toJson() const {
+    nlohmann::json buckets = nlohmann::json::array();
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t samples = bucketCount(i);
+        if (samples > 0) {
+            buckets.push_back({{"upperBoundUs", bucketUpperBound(i)}, {"count", samples}});
+        }
+    }
+    
+    return nlohmann::json{
+        {"count", count()},
+        {"meanUs", mean()},
+        {"p50Us", percentile(50.0)},
+        {"p90Us", percentile(90.0)},
+        {"p99Us", percentile(99.0)},
+        {"maxUs", max()},
+        {"buckets", buckets}
+    };
+}
+
+} // namespace video_analyzer
@@ -0,0 +1,297 @@
+#include "video_analyzer/luma_kernels.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+#include <algorithm>
+#include <cstring>
+
+// x86-64 always has SSE2; AVX2 is selected at runtime where the compiler
+// can target it per function, or at build time with /arch:AVX2 on MSVC
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define LUMA_KERNELS_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define LUMA_KERNELS_AVX2 1
+#define LUMA_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define LUMA_KERNELS_AVX2 1
+#define LUMA_TARGET_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LUMA_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace video_analyzer {
+
+namespace {
+
+constexpr int kBlock = LumaThumbnail::kBlockSize;
+
+// Rounded mean of a block sum (64 pixels)
+inline uint8_t blockMean(uint32_t sum) {
+    return static_cast<uint8_t>((sum + kBlock * kBlock / 2) / (kBlock * kBlock));
+}
+
+// Means of `blocks` consecutive 8x8 blocks starting at `rows`
+using BlockRowKernel = void (*)(const uint8_t* rows, int linesize, int blocks, uint8_t* out);
+using SadKernel = uint64_t (*)(const uint8_t* a, const uint8_t* b, size_t count);
+
+void blockRowScalar(const uint8_t* rows, int linesize, int first, int blocks, uint8_t* out) {
+    for (int b = first; b < blocks; ++b) {
+        uint32_t sum = 0;
+        for (int r = 0; r < kBlock; ++r) {
+            const uint8_t* p = rows + static_cast<ptrdiff_t>(r) * linesize + b * kBlock;
+            for (int c = 0; c < kBlock; ++c) {
+                sum += p[c];
+            }
+        }
+        out[b] = blockMean(sum);
+    }
+}
+
+void blockRowScalar(const uint8_t* rows, int linesize, int blocks, uint8_t* out) {
+    blockRowScalar(rows, linesize, 0, blocks, out);
+}
+
+uint64_t sadScalar(const uint8_t* a, const uint8_t* b, size_t count) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+    }
+    return sum;
+}
+
+#if LUMA_KERNELS_SSE2
+// Two blocks per 16-byte load: PSADBW against zero sums each 8-byte half
+void blockRowSse2(const uint8_t* rows, int linesize, int blocks, uint8_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    int b = 0;
+    for (; b + 2 <= blocks; b += 2) {
+        __m128i acc = zero;
+        for (int r = 0; r < kBlock; ++r) {
+            const uint8_t* p = rows + static_cast<ptrdiff_t>(r) * linesize + b * kBlock;
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+        }
+        out[b] = blockMean(static_cast<uint32_t>(_mm_cvtsi128_si32(acc)));
+        out[b + 1] = blockMean(static_cast<uint32_t>(_mm_extract_epi16(acc, 4)));
+    }
+    blockRowScalar(rows, linesize, b, blocks, out);
+}
+
+uint64_t sadSse2(const uint8_t* a, const uint8_t* b, size_t count) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + sadScalar(a + i, b + i, count - i);
+}
+#endif
+
+#if LUMA_KERNELS_AVX2
+LUMA_TARGET_AVX2
+void blockRowAvx2(const uint8_t* rows, int linesize, int blocks, uint8_t* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    int b = 0;
+    for (; b + 4 <= blocks; b += 4) {
+        __m256i acc = zero;
+        for (int r = 0; r < kBlock; ++r) {
+            const uint8_t* p = rows + static_cast<ptrdiff_t>(r) * linesize + b * kBlock;
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, zero));
+        }
+        out[b] = blockMean(static_cast<uint32_t>(_mm256_extract_epi16(acc, 0)));
+        out[b + 1] = blockMean(static_cast<uint32_t>(_mm256_extract_epi16(acc, 4)));
+        out[b + 2] = blockMean(static_cast<uint32_t>(_mm256_extract_epi16(acc, 8)));
+        out[b + 3] = blockMean(static_cast<uint32_t>(_mm256_extract_epi16(acc, 12)));
+    }
+    blockRowScalar(rows, linesize, b, blocks, out);
+}
+
+LUMA_TARGET_AVX2
+uint64_t sadAvx2(const uint8_t* a, const uint8_t* b, size_t count) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sadScalar(a + i, b + i, count - i);
+}
+
+bool cpuHasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return true;  // Built with /arch:AVX2
+#endif
+}
+#endif
+
+#if LUMA_KERNELS_NEON
+// Two blocks per 16-byte load: pairwise widening adds down to 64-bit sums
+void blockRowNeon(const uint8_t* rows, int linesize, int blocks, uint8_t* out) {
+    int b = 0;
+    for (; b + 2 <= blocks; b += 2) {
+        uint16x8_t acc = vdupq_n_u16(0);
+        for (int r = 0; r < kBlock; ++r) {
+            const uint8_t* p = rows + static_cast<ptrdiff_t>(r) * linesize + b * kBlock;
+            acc = vpadalq_u8(acc, vld1q_u8(p));
+        }
+        uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(acc));
+        out[b] = blockMean(static_cast<uint32_t>(vgetq_lane_u64(sums, 0)));
+        out[b + 1] = blockMean(static_cast<uint32_t>(vgetq_lane_u64(sums, 1)));
+    }
+    blockRowScalar(rows, linesize, b, blocks, out);
+}
+
+uint64_t sadNeon(const uint8_t* a, const uint8_t* b, size_t count) {
+    uint64_t sum = 0;
+    size_t i = 0;
+    while (i + 16 <= count) {
+        // 16-bit lanes gain at most 2 * 255 per step; flush before overflow
+        uint16x8_t acc = vdupq_n_u16(0);
+        size_t end = std::min(count, i + 16 * 128);
+        for (; i + 16 <= end; i += 16) {
+            acc = vpadalq_u8(acc, vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+        }
+        uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(acc));
+        sum += vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1);
+    }
+    return sum + sadScalar(a + i, b + i, count - i);
+}
+#endif
+
+struct Kernels {
+    BlockRowKernel blockRow = blockRowScalar;
+    SadKernel sad = sadScalar;
+    const char* name = "scalar";
+};
+
+const Kernels& kernels() {
+    static const Kernels selected = [] {
+        Kernels k;
+#if LUMA_KERNELS_SSE2
+        k = Kernels{blockRowSse2, sadSse2, "sse2"};
+#endif
+#if LUMA_KERNELS_AVX2
+        if (cpuHasAvx2()) {
+            k = Kernels{blockRowAvx2, sadAvx2, "avx2"};
+        }
+#endif
+#if LUMA_KERNELS_NEON
+        k = Kernels{blockRowNeon, sadNeon, "neon"};
+#endif
+        return k;
+    }();
+    return selected;
+}
+
+// Formats whose first plane is 8-bit luma
+bool hasLumaPlane(int format) {
+    switch (format) {
+        case AV_PIX_FMT_YUV420P:
+        case AV_PIX_FMT_YUVJ420P:
+        case AV_PIX_FMT_YUV422P:
+        case AV_PIX_FMT_YUVJ422P:
+        case AV_PIX_FMT_YUV444P:
+        case AV_PIX_FMT_YUVJ444P:
+        case AV_PIX_FMT_NV12:
+        case AV_PIX_FMT_NV21:
+        case AV_PIX_FMT_GRAY8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+void downscaleLuma(const uint8_t* plane, int linesize, int width, int height,
+                   LumaThumbnail& thumbnail) {
+    thumbnail.width = width / kBlock;
+    thumbnail.height = height / kBlock;
+    thumbnail.pixels.resize(static_cast<size_t>(thumbnail.width) * thumbnail.height);
+    
+    BlockRowKernel blockRow = kernels().blockRow;
+    for (int y = 0; y < thumbnail.height; ++y) {
+        blockRow(plane + static_cast<ptrdiff_t>(y) * kBlock * linesize, linesize, thumbnail.width,
+                 thumbnail.pixels.data() + static_cast<size_t>(y) * thumbnail.width);
+    }
+}
+
+bool downscaleLuma(const AVFrame* frame, LumaThumbnail& thumbnail) {
+    if (!frame || !frame->data[0] || !hasLumaPlane(frame->format) ||
+        frame->width < kBlock || frame->height < kBlock) {
+        thumbnail = LumaThumbnail{};
+        return false;
+    }
+    
+    downscaleLuma(frame->data[0], frame->linesize[0], frame->width, frame->height, thumbnail);
+    return true;
+}
+
+uint64_t sumAbsoluteDifferences(const uint8_t* a, const uint8_t* b, size_t count) {
+    return kernels().sad(a, b, count);
+}
+
+void lumaHistogram(const uint8_t* pixels, size_t count, uint32_t* bins) {
+    constexpr int kShift = 2;  // 256 levels into 64 bins
+    uint32_t partial[4][kLumaHistogramBins] = {};
+    
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        partial[0][pixels[i] >> kShift]++;
+        partial[1][pixels[i + 1] >> kShift]++;
+        partial[2][pixels[i + 2] >> kShift]++;
+        partial[3][pixels[i + 3] >> kShift]++;
+    }
+    for (; i < count; ++i) {
+        partial[0][pixels[i] >> kShift]++;
+    }
+    
+    for (int bin = 0; bin < kLumaHistogramBins; ++bin) {
+        bins[bin] = partial[0][bin] + partial[1][bin] + partial[2][bin] + partial[3][bin];
+    }
+}
+
+double chiSquareDistance(const uint32_t* a, const uint32_t* b, int binCount) {
+    uint64_t totalA = 0;
+    uint64_t totalB = 0;
+    for (int i = 0; i < binCount; ++i) {
+        totalA += a[i];
+        totalB += b[i];
+    }
+    if (totalA == 0 || totalB == 0) {
+        return totalA == totalB ? 0.0 : 1.0;
+    }
+    
+    double distance = 0.0;
+    for (int i = 0; i < binCount; ++i) {
+        double pa = static_cast<double>(a[i]) / totalA;
+        double pb = static_cast<double>(b[i]) / totalB;
+        if (pa + pb > 0.0) {
+            distance += (pa - pb) * (pa - pb) / (pa + pb);
+        }
+    }
+    return std::min(1.0, 0.5 * distance);
+}
+
+const char* lumaKernelName() {
+    return kernels().name;
+}
+
+} // namespace video_analyzer
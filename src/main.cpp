@@ -1,24 +1,173 @@
 #include "video_analyzer/video_decoder.h"
+#include "video_analyzer/analysis_pipeline.h"
+#include "video_analyzer/segmented_decoder.h"
+#include "video_analyzer/batch_analyzer.h"
 #include "video_analyzer/gop_analyzer.h"
+#include "video_analyzer/bitrate_analyzer.h"
 #include "video_analyzer/frame_statistics.h"
+#include "video_analyzer/report_writer.h"
+#include "video_analyzer/binary_report.h"
+#include "video_analyzer/analysis_cache.h"
 #include "video_analyzer/ffmpeg_error.h"
+#include <chrono>
+#include <filesystem>
 #include <iostream>
-#include <fstream>
+#include <memory>
 #include <string>
 #include <iomanip>
 
 using namespace video_analyzer;
 
 void printUsage(const char* progName) {
-    std::cout << "Usage: " << progName << " <video_file> [options]\n"
+    std::cout << "Usage: " << progName << " <video_file|report.vsa> [options]\n"
+              << "       " << progName << " --batch <dir|list_file> [options]\n"
               << "\nOptions:\n"
               << "  --output <file>        Output file path (default: analysis_report.json)\n"
-              << "  --format <json|csv>    Output format (default: json)\n"
+              << "                         In batch mode: output directory (default: batch_reports)\n"
+              << "  --format <json|csv|binary>  Output format (default: json; binary = columnar .vsa)\n"
               << "  --max-frames <n>       Maximum frames to analyze (default: all)\n"
+              << "  --header-scan          Parse packet headers only, skip pixel decoding (fast, no QP)\n"
+              << "  --motion-vectors       Store per-frame motion summaries in binary reports (slower)\n"
+              << "  --parallel             Decode keyframe-aligned segments in parallel on all cores\n"
+              << "  --no-cache             Always decode, do not read or write the analysis cache\n"
+              << "  --batch <dir|list>     Analyze every video in a directory or listed in a file\n"
+              << "  --jobs <n>             Files analyzed concurrently in batch mode (default: all cores)\n"
+              << "  --benchmark            Measure decode speed with and without MV/QP side data export\n"
               << "  --help                 Show this help message\n"
               << std::endl;
 }
 
+int runBatch(const std::string& source, size_t jobs, const std::string& outputDir,
+             const std::string& format, int maxFrames, const DecoderOptions& decoderOptions) {
+    try {
+        std::vector<std::string> files = BatchAnalyzer::collectInputs(source);
+        if (files.empty()) {
+            std::cerr << "Error: No video files found in " << source << std::endl;
+            return 1;
+        }
+        
+        BatchOptions options;
+        options.jobs = jobs;
+        options.decoderOptions = decoderOptions;
+        options.outputDir = outputDir;
+        options.format = format;
+        options.maxFrames = maxFrames;
+        
+        BatchAnalyzer analyzer(options);
+        std::cout << "Batch: " << files.size() << " files, "
+                  << analyzer.getJobCount() << " concurrent jobs, "
+                  << analyzer.getDecoderThreadsPerFile() << " decoder threads per file\n" << std::endl;
+        
+        analyzer.setProgressCallback([](const BatchFileResult& result, size_t completed, size_t total) {
+            std::cout << "[" << completed << "/" << total << "] " << result.path;
+            if (result.success) {
+                std::cout << " (" << result.frameStats.totalFrames << " frames, "
+                          << std::fixed << std::setprecision(2) << result.elapsedSeconds << " s)";
+            } else {
+                std::cout << " FAILED: " << result.error;
+            }
+            std::cout << std::endl;
+        });
+        
+        BatchSummary summary = analyzer.run(files);
+        
+        std::cout << "\nBatch Summary:\n"
+                  << "  Files: " << summary.files.size() << "\n"
+                  << "  Succeeded: " << summary.succeeded << "\n"
+                  << "  Failed: " << summary.failed << "\n"
+                  << "  Total Frames: " << summary.totalFrames << "\n"
+                  << "  Elapsed: " << std::fixed << std::setprecision(2) << summary.elapsedSeconds << " seconds\n"
+                  << "  Throughput: " << std::fixed << std::setprecision(1) << summary.filesPerHour << " files/hour\n"
+                  << "\nReports saved to: " << outputDir << std::endl;
+        
+        return summary.failed == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+struct DecodeBenchmark {
+    size_t frames = 0;
+    size_t motionVectors = 0;
+    double decodeSeconds = 0.0;   // Excluding motion vector extraction
+    double extractSeconds = 0.0;
+};
+
+DecodeBenchmark benchmarkDecode(const std::string& videoPath, DecoderOptions options, int maxFrames) {
+    using Clock = std::chrono::steady_clock;
+    
+    VideoDecoder decoder(videoPath, options);
+    DecodeBenchmark result;
+    Clock::time_point start = Clock::now();
+    while (decoder.readNextFrame()) {
+        result.frames++;
+        if (options.exportMotionVectors) {
+            Clock::time_point extractStart = Clock::now();
+            if (auto mvData = decoder.getMotionVectors()) {
+                result.motionVectors += mvData->vectors.size();
+            }
+            result.extractSeconds += std::chrono::duration<double>(Clock::now() - extractStart).count();
+        }
+        if (maxFrames > 0 && result.frames >= static_cast<size_t>(maxFrames)) {
+            break;
+        }
+    }
+    result.decodeSeconds = std::chrono::duration<double>(Clock::now() - start).count() - result.extractSeconds;
+    return result;
+}
+
+int runBenchmark(const std::string& videoPath, const DecoderOptions& decoderOptions, int maxFrames) {
+    // Alternate the configurations and keep the fastest round of each, so
+    // file caching and clock ramp-up do not favor either one
+    constexpr int kRounds = 3;
+    
+    try {
+        DecoderOptions options = decoderOptions;
+        options.mode = DecodeMode::FULL_DECODE;
+        
+        // [0] plain decode, [1] with motion vector and encoding parameter
+        // (QP) side data export
+        DecodeBenchmark best[2];
+        for (int round = 0; round < kRounds; ++round) {
+            for (int exportData = 0; exportData < 2; ++exportData) {
+                options.exportMotionVectors = exportData != 0;
+                options.exportEncodeParams = exportData != 0;
+                DecodeBenchmark result = benchmarkDecode(videoPath, options, maxFrames);
+                if (round == 0 || result.decodeSeconds < best[exportData].decodeSeconds) {
+                    best[exportData] = result;
+                }
+            }
+        }
+        
+        // Rates of an empty decode are meaningless
+        for (const DecodeBenchmark& result : best) {
+            if (result.frames == 0 || result.decodeSeconds <= 0.0) {
+                std::cerr << "Error: No frames decoded, nothing to benchmark" << std::endl;
+                return 1;
+            }
+        }
+        
+        double baseFps = best[0].frames / best[0].decodeSeconds;
+        double exportFps = best[1].frames / best[1].decodeSeconds;
+        std::cout << "Decode Benchmark (best of " << kRounds << "):\n"
+                  << "  Frames: " << best[0].frames << "\n"
+                  << "  Without side data export: " << std::fixed << std::setprecision(1)
+                  << baseFps << " fps\n"
+                  << "  With MVS + VIDEO_ENC_PARAMS export: " << exportFps << " fps\n"
+                  << "  Export overhead: " << std::showpos
+                  << (best[1].decodeSeconds / best[0].decodeSeconds - 1.0) * 100.0
+                  << std::noshowpos << "% decode time\n"
+                  << "  Motion vectors: " << best[1].motionVectors << " (extraction "
+                  << std::setprecision(2) << best[1].extractSeconds * 1000.0 << " ms, not included)\n"
+                  << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "=== Video Stream Analyzer CLI ===\n" << std::endl;
     
@@ -28,9 +177,15 @@ int main(int argc, char* argv[]) {
     }
     
     std::string videoPath;
-    std::string outputPath = "analysis_report.json";
+    std::string batchSource;
+    size_t jobs = 0;
+    std::string outputPath;
     std::string format = "json";
     int maxFrames = -1;
+    DecoderOptions decoderOptions;
+    bool parallel = false;
+    bool useCache = true;
+    bool benchmark = false;
     
     // Parse arguments
     for (int i = 1; i < argc; ++i) {
@@ -45,25 +200,66 @@ int main(int argc, char* argv[]) {
             format = argv[++i];
         } else if (arg == "--max-frames" && i + 1 < argc) {
             maxFrames = std::stoi(argv[++i]);
+        } else if (arg == "--header-scan") {
+            decoderOptions.mode = DecodeMode::HEADER_SCAN;
+        } else if (arg == "--motion-vectors") {
+            decoderOptions.exportMotionVectors = true;
+        } else if (arg == "--parallel") {
+            parallel = true;
+        } else if (arg == "--no-cache") {
+            useCache = false;
+        } else if (arg == "--benchmark") {
+            benchmark = true;
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batchSource = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<size_t>(std::stoul(argv[++i]));
         } else if (arg[0] != '-') {
             videoPath = arg;
         }
     }
     
+    if (!batchSource.empty()) {
+        return runBatch(batchSource, jobs, outputPath.empty() ? "batch_reports" : outputPath,
+                        format, maxFrames, decoderOptions);
+    }
+    
+    if (outputPath.empty()) {
+        outputPath = format == "binary" ? "analysis_report.vsa" : "analysis_report.json";
+    }
+    
     if (videoPath.empty()) {
         std::cerr << "Error: No video file specified\n" << std::endl;
         printUsage(argv[0]);
         return 1;
     }
     
+    if (benchmark) {
+        return runBenchmark(videoPath, decoderOptions, maxFrames);
+    }
+    
     try {
-        std::cout << "Analyzing video: " << videoPath << "\n" << std::endl;
+        // A binary report is replayed instead of decoded; the sinks still
+        // need a decoder, which is opened on the report's source video
+        std::unique_ptr<BinaryReport> inputReport;
+        std::string sourcePath = videoPath;
+        if (BinaryReport::isBinaryReport(videoPath)) {
+            inputReport = std::make_unique<BinaryReport>(videoPath);
+            sourcePath = inputReport->getMetadata().value("source", "");
+            if (sourcePath.empty() || !std::filesystem::exists(sourcePath)) {
+                throw std::runtime_error("Source video of report not found: " +
+                                         (sourcePath.empty() ? videoPath : sourcePath));
+            }
+            std::cout << "Loading report: " << videoPath << "\n" << std::endl;
+        } else {
+            std::cout << "Analyzing video: " << videoPath << "\n" << std::endl;
+        }
         
         // Open video
-        VideoDecoder decoder(videoPath);
+        VideoDecoder decoder(sourcePath, decoderOptions);
         
         // Get stream info
-        auto streamInfo = decoder.getStreamInfo();
+        auto streamInfo = inputReport ? inputReport->getStreamInfo() : decoder.getStreamInfo();
         std::cout << "Stream Information:\n"
                   << "  Codec: " << streamInfo.codecName << "\n"
                   << "  Resolution: " << streamInfo.width << "x" << streamInfo.height << "\n"
@@ -73,27 +269,86 @@ int main(int argc, char* argv[]) {
                   << "  Pixel Format: " << streamInfo.pixelFormat << "\n"
                   << std::endl;
         
-        // Collect frames
-        std::cout << "Reading frames..." << std::flush;
-        std::vector<FrameInfo> frames;
-        int frameCount = 0;
+        // Decode once and run all analyzers on the same pass; frames are
+        // streamed to the report as they are decoded
+        FrameStatisticsAccumulator statsAccumulator;
+        GOPAnalyzer gopAnalyzer(decoder);
+        BitrateAnalyzer bitrateAnalyzer(decoder);
+        std::unique_ptr<ReportWriter> reportWriter;
+        std::unique_ptr<BinaryReportWriter> binaryWriter;
+        if (format == "json" || format == "csv") {
+            reportWriter = std::make_unique<ReportWriter>(
+                outputPath, format == "csv" ? ReportFormat::CSV : ReportFormat::JSON);
+        } else if (format == "binary") {
+            binaryWriter = std::make_unique<BinaryReportWriter>(outputPath);
+            binaryWriter->setMotionExport(decoderOptions.exportMotionVectors && !inputReport);
+        }
+        
+        AnalysisPipeline pipeline(decoder);
+        if (reportWriter) {
+            pipeline.addSink(*reportWriter);
+        }
+        if (binaryWriter) {
+            pipeline.addSink(*binaryWriter);
+        }
+        pipeline.addSink(statsAccumulator);
+        pipeline.addSink(gopAnalyzer);
+        pipeline.addSink(bitrateAnalyzer);
         
-        while (auto frame = decoder.readNextFrame()) {
-            frames.push_back(*frame);
-            frameCount++;
-            
+        // Header-scan results lack QP and are never cached, nor are runs
+        // that need motion vectors, which cache entries do not hold; partial
+        // analyses can be served from the cache but are not stored
+        std::unique_ptr<BinaryReport> cached;
+        std::unique_ptr<AnalysisCache::Entry> cacheEntry;
+        if (useCache && !inputReport && decoderOptions.mode == DecodeMode::FULL_DECODE &&
+            !decoderOptions.exportMotionVectors) {
+            AnalysisCache cache;
+            cached = cache.lookup(videoPath);
+            if (!cached && maxFrames <= 0) {
+                cacheEntry = cache.createEntry(videoPath);
+                if (cacheEntry) {
+                    pipeline.addSink(cacheEntry->writer());
+                }
+            }
+        }
+        
+        pipeline.setProgressCallback([](size_t frameCount) {
             if (frameCount % 100 == 0) {
                 std::cout << "\rReading frames... " << frameCount << std::flush;
             }
-            
-            if (maxFrames > 0 && frameCount >= maxFrames) {
-                break;
-            }
+        });
+        
+        std::cout << "Reading frames..." << std::flush;
+        size_t frameCount = 0;
+        if (inputReport) {
+            frameCount = pipeline.replay(inputReport->readFrames(), maxFrames);
+        } else if (cached) {
+            frameCount = pipeline.replay(cached->readFrames(), maxFrames);
+        } else if (parallel) {
+            // Each segment runs on its own single-threaded decoder
+            ThreadPool pool;
+            DecoderOptions segmentOptions = decoderOptions;
+            segmentOptions.threadCount = 1;
+            SegmentedDecoder segmentedDecoder(videoPath, pool, segmentOptions);
+            frameCount = pipeline.replay(segmentedDecoder.decodeAll(), maxFrames);
+        } else {
+            frameCount = pipeline.run(maxFrames);
         }
-        std::cout << "\rReading frames... " << frameCount << " (done)\n" << std::endl;
+        std::cout << "\rReading frames... " << frameCount
+                  << (inputReport ? " (from report)\n" : cached ? " (from cache)\n" : " (done)\n")
+                  << std::endl;
+        
+        const auto& gops = gopAnalyzer.getGOPs();
         
-        // Compute frame statistics
-        auto frameStats = FrameStatistics::compute(frames);
+        // Frame statistics
+        auto frameStats = statsAccumulator.getStatistics();
+        const auto& bitrateStats = bitrateAnalyzer.getStatistics();
+        
+        if (cacheEntry) {
+            cacheEntry->writer().setGOPs(gops);
+            cacheEntry->writer().setBitrateStatistics(bitrateStats);
+            cacheEntry->commit({{"frameStatistics", frameStats.toJson()}});
+        }
         std::cout << "Frame Statistics:\n"
                   << "  Total Frames: " << frameStats.totalFrames << "\n"
                   << "  I-Frames: " << frameStats.iFrames << "\n"
@@ -105,13 +360,6 @@ int main(int argc, char* argv[]) {
                   << "  Min Frame Size: " << (frameStats.minFrameSize / 1024.0) << " KB\n"
                   << std::endl;
         
-        // Analyze GOP structure
-        std::cout << "Analyzing GOP structure..." << std::flush;
-        decoder.reset();
-        GOPAnalyzer gopAnalyzer(decoder);
-        auto gops = gopAnalyzer.analyze();
-        std::cout << " done\n" << std::endl;
-        
         std::cout << "GOP Analysis:\n"
                   << "  Total GOPs: " << gops.size() << "\n"
                   << "  Average GOP Length: " << std::fixed << std::setprecision(2) 
@@ -120,38 +368,38 @@ int main(int argc, char* argv[]) {
                   << "  Min GOP Length: " << gopAnalyzer.getMinGOPLength() << " frames\n"
                   << std::endl;
         
-        // Export results
-        if (format == "json") {
-            nlohmann::json report;
-            report["streamInfo"] = streamInfo.toJson();
-            report["frameStatistics"] = frameStats.toJson();
-            
-            nlohmann::json gopsJson = nlohmann::json::array();
-            for (const auto& gop : gops) {
-                gopsJson.push_back(gop.toJson());
-            }
-            report["gops"] = gopsJson;
-            
-            nlohmann::json framesJson = nlohmann::json::array();
-            for (const auto& frame : frames) {
-                framesJson.push_back(frame.toJson());
-            }
-            report["frames"] = framesJson;
-            
-            std::ofstream outFile(outputPath);
-            outFile << report.dump(2);
-            outFile.close();
-            
-            std::cout << "Analysis report saved to: " << outputPath << std::endl;
-        } else if (format == "csv") {
-            std::ofstream outFile(outputPath);
-            outFile << "pts,dts,type,size,qp,isKeyFrame,timestamp\n";
-            for (const auto& frame : frames) {
-                outFile << frame.toCsv() << "\n";
+        std::cout << "Bitrate Analysis:\n"
+                  << "  Average Bitrate: " << std::fixed << std::setprecision(2)
+                  << (bitrateStats.averageBitrate / 1000.0) << " kbps\n"
+                  << "  Max Bitrate: " << (bitrateStats.maxBitrate / 1000.0) << " kbps\n"
+                  << "  Min Bitrate: " << (bitrateStats.minBitrate / 1000.0) << " kbps\n"
+                  << std::endl;
+        
+        // Finish the report with the summary fields
+        if (reportWriter) {
+            if (format == "json") {
+                nlohmann::json gopsJson = nlohmann::json::array();
+                for (const auto& gop : gops) {
+                    gopsJson.push_back(gop.toJson());
+                }
+                reportWriter->finish({
+                    {"frameStatistics", frameStats.toJson()},
+                    {"bitrateStatistics", bitrateStats.toJson()},
+                    {"gops", gopsJson}
+                });
+                std::cout << "Analysis report saved to: " << outputPath << std::endl;
+            } else {
+                reportWriter->finish();
+                std::cout << "Frame data saved to: " << outputPath << std::endl;
             }
-            outFile.close();
-            
-            std::cout << "Frame data saved to: " << outputPath << std::endl;
+        } else if (binaryWriter) {
+            binaryWriter->setGOPs(gops);
+            binaryWriter->setBitrateStatistics(bitrateStats);
+            binaryWriter->finish({
+                {"frameStatistics", frameStats.toJson()},
+                {"source", sourcePath}
+            });
+            std::cout << "Binary analysis report saved to: " << outputPath << std::endl;
         }
         
         std::cout << "\nAnalysis complete!" << std::endl;
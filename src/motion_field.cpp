@@ -0,0 +1,352 @@
+#include "video_analyzer/motion_field.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/motion_vector.h>
+}
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// SSE2 is part of x86-64; NEON's vector square root needs AArch64
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define MOTION_FIELD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MOTION_FIELD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace video_analyzer {
+
+namespace {
+
+// Vectors per batch in MotionAccumulator::fromField (scratch stays on the stack)
+constexpr size_t kAccumulateBatch = 1024;
+
+// tan(22.5 deg) ~= 408 / 985; both fit the 16-bit multiplier inputs
+constexpr int32_t kTanNum = 408;
+constexpr int32_t kTanDen = 985;
+
+inline int16_t clampComponent(int32_t v) {
+    return static_cast<int16_t>(std::clamp(v, -32767, 32767));
+}
+
+inline float magnitudeScalar(int16_t dx, int16_t dy) {
+    int32_t squared = static_cast<int32_t>(dx) * dx + static_cast<int32_t>(dy) * dy;
+    return std::sqrt(static_cast<float>(squared));
+}
+
+inline uint8_t octantScalar(int16_t dx, int16_t dy) {
+    int32_t ax = dx < 0 ? -dx : dx;
+    int32_t ay = dy < 0 ? -dy : dy;
+    bool xNeg = dx < 0;
+    bool yNeg = dy < 0;
+    
+    if (ax * kTanNum - ay * kTanDen >= 0) {
+        return static_cast<uint8_t>(xNeg ? MotionOctant::W : MotionOctant::E);
+    }
+    if (ay * kTanNum - ax * kTanDen >= 0) {
+        return static_cast<uint8_t>(yNeg ? MotionOctant::S : MotionOctant::N);
+    }
+    // Diagonal: NE, NW, SW, SE = 1 + 2 * quadrant
+    return static_cast<uint8_t>(1 + (yNeg ? 4 : 0) + (xNeg != yNeg ? 2 : 0));
+}
+
+} // namespace
+
+size_t MotionField::memoryUsage() const {
+    return (x.capacity() + y.capacity() + dx.capacity() + dy.capacity()) * sizeof(int16_t) +
+           (width.capacity() + height.capacity()) * sizeof(uint8_t);
+}
+
+MotionAccumulator MotionAccumulator::fromField(const MotionField& field) {
+    MotionAccumulator acc;
+    size_t count = field.size();
+    if (count == 0) {
+        return acc;
+    }
+    
+    float magnitudes[kAccumulateBatch];
+    uint8_t octants[kAccumulateBatch];
+    float minMag = std::numeric_limits<float>::max();
+    float maxMag = 0.0f;
+    
+    for (size_t begin = 0; begin < count; begin += kAccumulateBatch) {
+        size_t n = std::min(kAccumulateBatch, count - begin);
+        motionMagnitudes(field.dx.data() + begin, field.dy.data() + begin, n, magnitudes);
+        motionOctants(field.dx.data() + begin, field.dy.data() + begin, n, octants);
+        
+        for (size_t i = 0; i < n; ++i) {
+            float magnitude = magnitudes[i];
+            acc.sumMagnitude += magnitude;
+            minMag = std::min(minMag, magnitude);
+            maxMag = std::max(maxMag, magnitude);
+            acc.staticCount += magnitude < kStaticThreshold;
+            acc.highMotionCount += magnitude > kHighMotionThreshold;
+            if (magnitude > kStaticThreshold) {
+                acc.octants[octants[i]]++;
+            }
+        }
+    }
+    
+    acc.count = count;
+    acc.minMagnitude = minMag;
+    acc.maxMagnitude = maxMag;
+    return acc;
+}
+
+MotionAccumulator MotionAccumulator::fromVectors(const std::vector<MotionVector>& vectors) {
+    MotionAccumulator acc;
+    if (vectors.empty()) {
+        return acc;
+    }
+    
+    acc.count = vectors.size();
+    acc.minMagnitude = vectors[0].magnitude;
+    acc.maxMagnitude = vectors[0].magnitude;
+    
+    for (const auto& vec : vectors) {
+        acc.sumMagnitude += vec.magnitude;
+        acc.minMagnitude = std::min(acc.minMagnitude, vec.magnitude);
+        acc.maxMagnitude = std::max(acc.maxMagnitude, vec.magnitude);
+        acc.staticCount += vec.magnitude < kStaticThreshold;
+        acc.highMotionCount += vec.magnitude > kHighMotionThreshold;
+        
+        if (vec.magnitude > kStaticThreshold) {
+            // Octants are 45 degrees wide and centered on the axes
+            double degrees = vec.direction * 180.0 / M_PI;
+            if (degrees < 0) degrees += 360.0;
+            int octant = static_cast<int>((degrees + 22.5) / 45.0) % kMotionOctantCount;
+            acc.octants[octant]++;
+        }
+    }
+    
+    return acc;
+}
+
+void MotionAccumulator::merge(const MotionAccumulator& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    
+    count += other.count;
+    sumMagnitude += other.sumMagnitude;
+    minMagnitude = std::min(minMagnitude, other.minMagnitude);
+    maxMagnitude = std::max(maxMagnitude, other.maxMagnitude);
+    staticCount += other.staticCount;
+    highMotionCount += other.highMotionCount;
+    for (int i = 0; i < kMotionOctantCount; ++i) {
+        octants[i] += other.octants[i];
+    }
+}
+
+double MotionAccumulator::averageMagnitude() const {
+    return count > 0 ? sumMagnitude / count : 0.0;
+}
+
+MotionStatistics MotionAccumulator::toStatistics() const {
+    MotionStatistics stats;
+    stats.averageMagnitude = averageMagnitude();
+    stats.maxMagnitude = maxMagnitude;
+    stats.minMagnitude = minMagnitude;
+    stats.staticRegions = static_cast<int>(staticCount);
+    stats.highMotionRegions = static_cast<int>(highMotionCount);
+    
+    // Direction bins: 8 directions (only reported when there are vectors)
+    if (count > 0) {
+        for (int i = 0; i < kMotionOctantCount; ++i) {
+            stats.directionDistribution[motionOctantName(static_cast<MotionOctant>(i))] =
+                static_cast<int>(octants[i]);
+        }
+    }
+    
+    return stats;
+}
+
+const char* motionOctantName(MotionOctant octant) {
+    static const char* const kNames[kMotionOctantCount] = {
+        "E", "NE", "N", "NW", "W", "SW", "S", "SE"
+    };
+    return kNames[static_cast<int>(octant) & (kMotionOctantCount - 1)];
+}
+
+void motionMagnitudes(const int16_t* dx, const int16_t* dy, size_t count, float* magnitudes) {
+    size_t i = 0;
+#if MOTION_FIELD_SSE2
+    // Interleaved (dx, dy) pairs: PMADDWD yields dx * dx + dy * dy per lane
+    for (; i + 8 <= count; i += 8) {
+        __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dx + i));
+        __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dy + i));
+        __m128i lo = _mm_unpacklo_epi16(vx, vy);
+        __m128i hi = _mm_unpackhi_epi16(vx, vy);
+        __m128 squaredLo = _mm_cvtepi32_ps(_mm_madd_epi16(lo, lo));
+        __m128 squaredHi = _mm_cvtepi32_ps(_mm_madd_epi16(hi, hi));
+        _mm_storeu_ps(magnitudes + i, _mm_sqrt_ps(squaredLo));
+        _mm_storeu_ps(magnitudes + i + 4, _mm_sqrt_ps(squaredHi));
+    }
+#elif MOTION_FIELD_NEON
+    for (; i + 4 <= count; i += 4) {
+        int16x4_t vx = vld1_s16(dx + i);
+        int16x4_t vy = vld1_s16(dy + i);
+        int32x4_t squared = vmlal_s16(vmull_s16(vx, vx), vy, vy);
+        vst1q_f32(magnitudes + i, vsqrtq_f32(vcvtq_f32_s32(squared)));
+    }
+#endif
+    for (; i < count; ++i) {
+        magnitudes[i] = magnitudeScalar(dx[i], dy[i]);
+    }
+}
+
+void motionOctants(const int16_t* dx, const int16_t* dy, size_t count, uint8_t* octants) {
+    size_t i = 0;
+#if MOTION_FIELD_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    // Multipliers for (|dx|, |dy|) pairs: |dx| * 408 - |dy| * 985 >= 0 is
+    // horizontal, |dy| * 408 - |dx| * 985 >= 0 vertical
+    const __m128i horizontalWeights = _mm_setr_epi16(kTanNum, -kTanDen, kTanNum, -kTanDen,
+                                                     kTanNum, -kTanDen, kTanNum, -kTanDen);
+    const __m128i verticalWeights = _mm_setr_epi16(-kTanDen, kTanNum, -kTanDen, kTanNum,
+                                                   -kTanDen, kTanNum, -kTanDen, kTanNum);
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128i four = _mm_set1_epi32(4);
+    const __m128i one = _mm_set1_epi32(1);
+    
+    auto classify = [&](__m128i pairs, __m128i xNeg, __m128i yNeg) {
+        __m128i horizontal = _mm_cmpgt_epi32(_mm_madd_epi16(pairs, horizontalWeights),
+                                             _mm_set1_epi32(-1));
+        __m128i vertical = _mm_cmpgt_epi32(_mm_madd_epi16(pairs, verticalWeights),
+                                           _mm_set1_epi32(-1));
+        __m128i horizontalCode = _mm_and_si128(xNeg, four);
+        __m128i verticalCode = _mm_add_epi32(two, _mm_and_si128(yNeg, four));
+        __m128i diagonalCode = _mm_add_epi32(one, _mm_add_epi32(
+            _mm_and_si128(yNeg, four), _mm_and_si128(_mm_xor_si128(xNeg, yNeg), two)));
+        __m128i code = _mm_or_si128(_mm_and_si128(vertical, verticalCode),
+                                    _mm_andnot_si128(vertical, diagonalCode));
+        return _mm_or_si128(_mm_and_si128(horizontal, horizontalCode),
+                            _mm_andnot_si128(horizontal, code));
+    };
+    
+    for (; i + 8 <= count; i += 8) {
+        __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dx + i));
+        __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dy + i));
+        __m128i ax = _mm_max_epi16(vx, _mm_sub_epi16(zero, vx));
+        __m128i ay = _mm_max_epi16(vy, _mm_sub_epi16(zero, vy));
+        __m128i xNeg = _mm_cmplt_epi16(vx, zero);
+        __m128i yNeg = _mm_cmplt_epi16(vy, zero);
+        
+        __m128i codeLo = classify(_mm_unpacklo_epi16(ax, ay),
+                                  _mm_unpacklo_epi16(xNeg, xNeg), _mm_unpacklo_epi16(yNeg, yNeg));
+        __m128i codeHi = classify(_mm_unpackhi_epi16(ax, ay),
+                                  _mm_unpackhi_epi16(xNeg, xNeg), _mm_unpackhi_epi16(yNeg, yNeg));
+        __m128i codes = _mm_packs_epi32(codeLo, codeHi);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(octants + i), _mm_packus_epi16(codes, codes));
+    }
+#elif MOTION_FIELD_NEON
+    const int32x4_t zero = vdupq_n_s32(0);
+    auto classify = [&](int16x4_t ax, int16x4_t ay, uint32x4_t xNeg, uint32x4_t yNeg) {
+        uint32x4_t horizontal = vcgeq_s32(vmlsl_n_s16(vmull_n_s16(ax, kTanNum), ay, kTanDen), zero);
+        uint32x4_t vertical = vcgeq_s32(vmlsl_n_s16(vmull_n_s16(ay, kTanNum), ax, kTanDen), zero);
+        uint32x4_t four = vdupq_n_u32(4);
+        uint32x4_t horizontalCode = vandq_u32(xNeg, four);
+        uint32x4_t verticalCode = vaddq_u32(vdupq_n_u32(2), vandq_u32(yNeg, four));
+        uint32x4_t diagonalCode = vaddq_u32(vdupq_n_u32(1), vaddq_u32(
+            vandq_u32(yNeg, four), vandq_u32(veorq_u32(xNeg, yNeg), vdupq_n_u32(2))));
+        return vbslq_u32(horizontal, horizontalCode, vbslq_u32(vertical, verticalCode, diagonalCode));
+    };
+    
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t vx = vld1q_s16(dx + i);
+        int16x8_t vy = vld1q_s16(dy + i);
+        int16x8_t ax = vabsq_s16(vx);
+        int16x8_t ay = vabsq_s16(vy);
+        uint16x8_t xNeg = vcltq_s16(vx, vdupq_n_s16(0));
+        uint16x8_t yNeg = vcltq_s16(vy, vdupq_n_s16(0));
+        
+        // Sign-extending the 16-bit masks keeps them all ones
+        int16x8_t xMask = vreinterpretq_s16_u16(xNeg);
+        int16x8_t yMask = vreinterpretq_s16_u16(yNeg);
+        uint32x4_t codeLo = classify(vget_low_s16(ax), vget_low_s16(ay),
+                                     vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(xMask))),
+                                     vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(yMask))));
+        uint32x4_t codeHi = classify(vget_high_s16(ax), vget_high_s16(ay),
+                                     vreinterpretq_u32_s32(vmovl_s16(vget_high_s16(xMask))),
+                                     vreinterpretq_u32_s32(vmovl_s16(vget_high_s16(yMask))));
+        uint16x8_t codes = vcombine_u16(vmovn_u32(codeLo), vmovn_u32(codeHi));
+        vst1_u8(octants + i, vmovn_u16(codes));
+    }
+#endif
+    for (; i < count; ++i) {
+        octants[i] = octantScalar(dx[i], dy[i]);
+    }
+}
+
+MotionField extractMotionField(const AVFrame* frame) {
+    MotionField field;
+    if (!frame) {
+        return field;
+    }
+    field.pts = frame->pts;
+    
+    const AVFrameSideData* sd = av_frame_get_side_data(frame, AV_FRAME_DATA_MOTION_VECTORS);
+    if (!sd) {
+        // No motion vectors available (e.g., I-frames don't have motion vectors)
+        return field;
+    }
+    
+    const AVMotionVector* mvs = reinterpret_cast<const AVMotionVector*>(sd->data);
+    size_t count = sd->size / sizeof(AVMotionVector);
+    if (count == 0) {
+        return field;
+    }
+    
+    field.motionScale = std::max<int>(1, mvs[0].motion_scale);
+    field.x.resize(count);
+    field.y.resize(count);
+    field.dx.resize(count);
+    field.dy.resize(count);
+    field.width.resize(count);
+    field.height.resize(count);
+    
+    for (size_t i = 0; i < count; ++i) {
+        const AVMotionVector& mv = mvs[i];
+        field.x[i] = mv.dst_x;
+        field.y[i] = mv.dst_y;
+        field.dx[i] = clampComponent(mv.motion_x);
+        field.dy[i] = clampComponent(mv.motion_y);
+        field.width[i] = mv.w;
+        field.height[i] = mv.h;
+    }
+    
+    return field;
+}
+
+MotionVectorData toMotionVectorData(const MotionField& field) {
+    MotionVectorData mvData;
+    mvData.pts = field.pts;
+    
+    std::vector<float> magnitudes(field.size());
+    motionMagnitudes(field.dx.data(), field.dy.data(), field.size(), magnitudes.data());
+    
+    mvData.vectors.resize(field.size());
+    for (size_t i = 0; i < field.size(); ++i) {
+        MotionVector& vec = mvData.vectors[i];
+        vec.dstX = field.x[i];
+        vec.dstY = field.y[i];
+        vec.srcX = field.x[i] + field.dx[i] / field.motionScale;
+        vec.srcY = field.y[i] + field.dy[i] / field.motionScale;
+        vec.motionX = field.dx[i];
+        vec.motionY = field.dy[i];
+        vec.magnitude = magnitudes[i];
+        vec.direction = std::atan2(static_cast<float>(field.dy[i]), static_cast<float>(field.dx[i]));
+    }
+    
+    return mvData;
+}
+
+} // namespace video_analyzer
@@ -0,0 +1,203 @@
+#include "video_analyzer/motion_heatmap.h"
+#include "video_analyzer/thread_pool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace video_analyzer {
+
+namespace {
+
+// Vectors per magnitude batch in accumulate() (scratch stays on the stack)
+constexpr size_t kMagnitudeBatch = 1024;
+
+// Fields per partial grid in a batch; smaller batches cost more in
+// synchronization than accumulating saves
+constexpr size_t kFramesPerPartial = 16;
+
+} // namespace
+
+MotionHeatmap MotionHeatmap::forFrame(int width, int height, int blockSize) {
+    MotionHeatmap heatmap;
+    heatmap.blockSize = std::max(1, blockSize);
+    heatmap.columns = std::max(0, (width + heatmap.blockSize - 1) / heatmap.blockSize);
+    heatmap.rows = std::max(0, (height + heatmap.blockSize - 1) / heatmap.blockSize);
+    size_t cells = static_cast<size_t>(heatmap.columns) * heatmap.rows;
+    heatmap.weightedSum.assign(cells, 0.0);
+    heatmap.coverage.assign(cells, 0);
+    return heatmap;
+}
+
+void MotionHeatmap::accumulate(const MotionField& field) {
+    frameCount++;
+    if (field.empty() || columns == 0 || rows == 0) {
+        return;
+    }
+    
+    const float toPixels = 1.0f / static_cast<float>(std::max(1, field.motionScale));
+    const int gridWidth = columns * blockSize;
+    const int gridHeight = rows * blockSize;
+    float magnitudes[kMagnitudeBatch];
+    
+    for (size_t start = 0; start < field.size(); start += kMagnitudeBatch) {
+        size_t batch = std::min(kMagnitudeBatch, field.size() - start);
+        motionMagnitudes(field.dx.data() + start, field.dy.data() + start, batch, magnitudes);
+        
+        for (size_t i = 0; i < batch; ++i) {
+            size_t v = start + i;
+            
+            // Partition rectangle, clipped to the grid (vectors may point outside the frame)
+            int x0 = std::max(0, field.x[v] - field.width[v] / 2);
+            int y0 = std::max(0, field.y[v] - field.height[v] / 2);
+            int x1 = std::min(gridWidth, field.x[v] - field.width[v] / 2 + field.width[v]);
+            int y1 = std::min(gridHeight, field.y[v] - field.height[v] / 2 + field.height[v]);
+            if (x0 >= x1 || y0 >= y1) {
+                continue;
+            }
+            
+            double magnitude = magnitudes[i] * toPixels;
+            for (int row = y0 / blockSize; row * blockSize < y1; ++row) {
+                int overlapY = std::min(y1, (row + 1) * blockSize) - std::max(y0, row * blockSize);
+                for (int column = x0 / blockSize; column * blockSize < x1; ++column) {
+                    int overlapX = std::min(x1, (column + 1) * blockSize) -
+                                   std::max(x0, column * blockSize);
+                    size_t cell = static_cast<size_t>(row) * columns + column;
+                    uint32_t area = static_cast<uint32_t>(overlapX * overlapY);
+                    weightedSum[cell] += magnitude * area;
+                    coverage[cell] += area;
+                }
+            }
+        }
+    }
+}
+
+void MotionHeatmap::merge(const MotionHeatmap& other) {
+    if (other.blockSize != blockSize || other.columns != columns || other.rows != rows) {
+        throw std::runtime_error("Cannot merge motion heatmaps of different grids");
+    }
+    
+    frameCount += other.frameCount;
+    for (size_t i = 0; i < weightedSum.size(); ++i) {
+        weightedSum[i] += other.weightedSum[i];
+        coverage[i] += other.coverage[i];
+    }
+}
+
+float MotionHeatmap::mean(int column, int row) const {
+    size_t cell = static_cast<size_t>(row) * columns + column;
+    return coverage[cell] > 0 ? static_cast<float>(weightedSum[cell] / coverage[cell]) : 0.0f;
+}
+
+std::vector<float> MotionHeatmap::means() const {
+    std::vector<float> result(weightedSum.size());
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = coverage[i] > 0 ? static_cast<float>(weightedSum[i] / coverage[i]) : 0.0f;
+    }
+    return result;
+}
+
+float MotionHeatmap::maxMean() const {
+    float result = 0.0f;
+    for (size_t i = 0; i < weightedSum.size(); ++i) {
+        if (coverage[i] > 0) {
+            result = std::max(result, static_cast<float>(weightedSum[i] / coverage[i]));
+        }
+    }
+    return result;
+}
+
+nlohmann::json MotionHeatmap::toJson() const {
+    nlohmann::json j;
+    j["blockSize"] = blockSize;
+    j["columns"] = columns;
+    j["rows"] = rows;
+    j["frameCount"] = frameCount;
+    j["startPts"] = startPts;
+    j["endPts"] = endPts;
+    j["maxMean"] = maxMean();
+    j["means"] = means();
+    return j;
+}
+
+MotionHeatmapSink::MotionHeatmapSink(ThreadPool* pool, int blockSize)
+    : pool_(pool), blockSize_(blockSize) {
+}
+
+void MotionHeatmapSink::begin(const StreamInfo& info) {
+    emptyGrid_ = MotionHeatmap::forFrame(info.width, info.height, blockSize_);
+    hasCurrentGop_ = false;
+    batch_.clear();
+    heatmaps_.clear();
+    
+    size_t workers = pool_ ? pool_->getThreadCount() : 0;
+    partials_.assign(workers >= 2 ? workers : 0, emptyGrid_);
+}
+
+void MotionHeatmapSink::consume(const FrameInfo& frame, const VideoDecoder& decoder) {
+    addFrame(frame, decoder.getMotionField());
+}
+
+void MotionHeatmapSink::addFrame(const FrameInfo& frame, std::optional<MotionField> field) {
+    if (!hasCurrentGop_ || (frame.type == FrameType::I_FRAME && frame.isKeyFrame)) {
+        if (hasCurrentGop_) {
+            closeGOP();
+        }
+        current_ = emptyGrid_;
+        current_.startPts = frame.pts;
+        hasCurrentGop_ = true;
+    }
+    current_.endPts = frame.pts;
+    
+    if (!field.has_value()) {
+        return;
+    }
+    if (partials_.empty()) {
+        current_.accumulate(*field);
+        return;
+    }
+    
+    batch_.push_back(std::move(*field));
+    if (batch_.size() >= partials_.size() * kFramesPerPartial) {
+        flushBatch();
+    }
+}
+
+void MotionHeatmapSink::end() {
+    if (hasCurrentGop_) {
+        closeGOP();
+    }
+    batch_.shrink_to_fit();
+}
+
+std::vector<MotionHeatmap> MotionHeatmapSink::takeHeatmaps() {
+    return std::move(heatmaps_);
+}
+
+void MotionHeatmapSink::flushBatch() {
+    if (batch_.empty()) {
+        return;
+    }
+    
+    // One contiguous run of fields per partial grid
+    size_t count = batch_.size();
+    size_t partials = std::min(partials_.size(), count);
+    pool_->parallelFor(0, partials, [&](size_t p) {
+        size_t first = count * p / partials;
+        size_t last = count * (p + 1) / partials;
+        for (size_t i = first; i < last; ++i) {
+            partials_[p].accumulate(batch_[i]);
+        }
+    }, 1);
+    batch_.clear();
+}
+
+void MotionHeatmapSink::closeGOP() {
+    flushBatch();
+    for (auto& grid : partials_) {
+        current_.merge(grid);
+        grid = emptyGrid_;
+    }
+    heatmaps_.push_back(std::move(current_));
+    hasCurrentGop_ = false;
+}
+
+} // namespace video_analyzer
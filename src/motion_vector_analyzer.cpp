@@ -1,55 +1,129 @@
 #include "video_analyzer/motion_vector_analyzer.h"
+#include "video_analyzer/thread_pool.h"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
 
 namespace video_analyzer {
 
+namespace {
+
+// Fewer frames are summarized serially
+constexpr size_t kMinParallelFrames = 64;
+
+MotionAccumulator mergeAll(const std::vector<MotionAccumulator>& frames) {
+    MotionAccumulator total;
+    for (const auto& frame : frames) {
+        total.merge(frame);
+    }
+    return total;
+}
+
+// Merge per-frame accumulators into per-GOP statistics in one sweep: frames
+// are visited in PTS order and the cursor only moves forward while GOPs
+// come in order (out-of-order or overlapping GOPs fall back to a search)
+std::vector<MotionStatistics> mergeByGOP(const std::vector<int64_t>& pts,
+                                         const std::vector<MotionAccumulator>& frames,
+                                         const std::vector<GOPInfo>& gops) {
+    std::vector<size_t> order(pts.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (!std::is_sorted(pts.begin(), pts.end())) {
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return pts[a] < pts[b]; });
+    }
+    std::vector<int64_t> sortedPts(pts.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        sortedPts[i] = pts[order[i]];
+    }
+    
+    std::vector<MotionStatistics> result;
+    result.reserve(gops.size());
+    size_t cursor = 0;
+    for (const auto& gop : gops) {
+        if (cursor > 0 && sortedPts[cursor - 1] >= gop.startPts) {
+            cursor = std::lower_bound(sortedPts.begin(), sortedPts.begin() + cursor, gop.startPts) -
+                     sortedPts.begin();
+        }
+        while (cursor < sortedPts.size() && sortedPts[cursor] < gop.startPts) {
+            cursor++;
+        }
+        
+        MotionAccumulator acc;
+        while (cursor < sortedPts.size() && sortedPts[cursor] <= gop.endPts) {
+            acc.merge(frames[order[cursor]]);
+            cursor++;
+        }
+        result.push_back(acc.toStatistics());
+    }
+    
+    return result;
+}
+
+} // namespace
+
 MotionVectorAnalyzer::MotionVectorAnalyzer(VideoDecoder& decoder)
     : decoder_(decoder) {
 }
 
 std::vector<MotionVectorData> MotionVectorAnalyzer::extractMotionVectors() {
-    std::vector<MotionVectorData> result;
-    
     // Reset decoder to start
     decoder_.reset();
     
-    // Read all frames and extract motion vectors
-    while (auto frameInfo = decoder_.readNextFrame()) {
-        // Get motion vectors for this frame
-        auto mvData = decoder_.getMotionVectors();
-        if (mvData.has_value()) {
-            result.push_back(mvData.value());
-        }
-    }
+    AnalysisPipeline pipeline(decoder_);
+    pipeline.addSink(*this);
+    pipeline.run();
     
-    return result;
+    return getMotionVectorData();
+}
+
+void MotionVectorAnalyzer::begin(const StreamInfo& /*info*/) {
+    fields_.clear();
+}
+
+void MotionVectorAnalyzer::consume(const FrameInfo& /*frame*/, const VideoDecoder& decoder) {
+    // Get motion vectors for this frame
+    auto field = decoder.getMotionField();
+    if (field.has_value()) {
+        fields_.push_back(std::move(field.value()));
+    }
+}
+
+std::vector<MotionVectorData> MotionVectorAnalyzer::getMotionVectorData() const {
+    std::vector<MotionVectorData> mvData;
+    mvData.reserve(fields_.size());
+    for (const auto& field : fields_) {
+        mvData.push_back(toMotionVectorData(field));
+    }
+    return mvData;
+}
+
+std::vector<MotionAccumulator> MotionVectorAnalyzer::accumulateByFrame(
+    const std::vector<MotionField>& fields) const {
+    
+    std::vector<MotionAccumulator> accumulators(fields.size());
+    parallelForIfLarge(pool_, 0, fields.size(), kMinParallelFrames, [&](size_t i) {
+        accumulators[i] = MotionAccumulator::fromField(fields[i]);
+    });
+    return accumulators;
 }
 
 MotionStatistics MotionVectorAnalyzer::computeStatistics(
     const std::vector<MotionVectorData>& mvData) {
     
-    // Collect all motion vectors from all frames
-    std::vector<MotionVector> allVectors;
-    for (const auto& frameData : mvData) {
-        allVectors.insert(allVectors.end(), 
-                         frameData.vectors.begin(), 
-                         frameData.vectors.end());
-    }
-    
-    return computeStatisticsForVectors(allVectors);
+    std::vector<MotionAccumulator> frames(mvData.size());
+    parallelForIfLarge(pool_, 0, mvData.size(), kMinParallelFrames, [&](size_t i) {
+        frames[i] = MotionAccumulator::fromVectors(mvData[i].vectors);
+    });
+    return mergeAll(frames).toStatistics();
 }
 
 std::vector<MotionStatistics> MotionVectorAnalyzer::aggregateByFrame(
     const std::vector<MotionVectorData>& mvData) {
     
-    std::vector<MotionStatistics> result;
-    
-    for (const auto& frameData : mvData) {
-        result.push_back(computeStatisticsForVectors(frameData.vectors));
-    }
-    
+    std::vector<MotionStatistics> result(mvData.size());
+    parallelForIfLarge(pool_, 0, mvData.size(), kMinParallelFrames, [&](size_t i) {
+        result[i] = MotionAccumulator::fromVectors(mvData[i].vectors).toStatistics();
+    });
     return result;
 }
 
@@ -57,111 +131,41 @@ std::vector<MotionStatistics> MotionVectorAnalyzer::aggregateByGOP(
     const std::vector<MotionVectorData>& mvData,
     const std::vector<GOPInfo>& gops) {
     
-    std::vector<MotionStatistics> result;
-    
-    for (const auto& gop : gops) {
-        // Collect all motion vectors within this GOP
-        std::vector<MotionVector> gopVectors;
-        
-        for (const auto& frameData : mvData) {
-            // Check if this frame is within the GOP
-            if (frameData.pts >= gop.startPts && frameData.pts <= gop.endPts) {
-                gopVectors.insert(gopVectors.end(),
-                                 frameData.vectors.begin(),
-                                 frameData.vectors.end());
-            }
-        }
-        
-        result.push_back(computeStatisticsForVectors(gopVectors));
-    }
-    
-    return result;
-}
-
-bool MotionVectorAnalyzer::isStaticRegion(const MotionVector& mv, double threshold) const {
-    return mv.magnitude < threshold;
+    std::vector<MotionAccumulator> frames(mvData.size());
+    std::vector<int64_t> pts(mvData.size());
+    parallelForIfLarge(pool_, 0, mvData.size(), kMinParallelFrames, [&](size_t i) {
+        frames[i] = MotionAccumulator::fromVectors(mvData[i].vectors);
+        pts[i] = mvData[i].pts;
+    });
+    return mergeByGOP(pts, frames, gops);
 }
 
-bool MotionVectorAnalyzer::isHighMotionRegion(const MotionVector& mv, double threshold) const {
-    return mv.magnitude > threshold;
+MotionStatistics MotionVectorAnalyzer::computeStatistics(const std::vector<MotionField>& fields) {
+    return mergeAll(accumulateByFrame(fields)).toStatistics();
 }
 
-MotionStatistics MotionVectorAnalyzer::computeStatisticsForVectors(
-    const std::vector<MotionVector>& vectors) {
-    
-    MotionStatistics stats;
+std::vector<MotionStatistics> MotionVectorAnalyzer::aggregateByFrame(
+    const std::vector<MotionField>& fields) {
     
-    if (vectors.empty()) {
-        stats.averageMagnitude = 0.0;
-        stats.maxMagnitude = 0.0;
-        stats.minMagnitude = 0.0;
-        stats.staticRegions = 0;
-        stats.highMotionRegions = 0;
-        return stats;
+    std::vector<MotionAccumulator> frames = accumulateByFrame(fields);
+    std::vector<MotionStatistics> result;
+    result.reserve(frames.size());
+    for (const auto& frame : frames) {
+        result.push_back(frame.toStatistics());
     }
+    return result;
+}
+
+std::vector<MotionStatistics> MotionVectorAnalyzer::aggregateByGOP(
+    const std::vector<MotionField>& fields,
+    const std::vector<GOPInfo>& gops) {
     
-    // Calculate magnitude statistics
-    double sumMagnitude = 0.0;
-    double maxMag = vectors[0].magnitude;
-    double minMag = vectors[0].magnitude;
-    
-    int staticCount = 0;
-    int highMotionCount = 0;
-    
-    // Direction bins: 8 directions (N, NE, E, SE, S, SW, W, NW)
-    std::map<std::string, int> directionDist = {
-        {"N", 0}, {"NE", 0}, {"E", 0}, {"SE", 0},
-        {"S", 0}, {"SW", 0}, {"W", 0}, {"NW", 0}
-    };
-    
-    for (const auto& vec : vectors) {
-        sumMagnitude += vec.magnitude;
-        maxMag = std::max(maxMag, static_cast<double>(vec.magnitude));
-        minMag = std::min(minMag, static_cast<double>(vec.magnitude));
-        
-        // Count static and high motion regions
-        if (isStaticRegion(vec)) {
-            staticCount++;
-        }
-        if (isHighMotionRegion(vec)) {
-            highMotionCount++;
-        }
-        
-        // Classify direction (only for non-static vectors)
-        if (vec.magnitude > 1.0) {
-            // Convert direction from radians to degrees
-            double degrees = vec.direction * 180.0 / M_PI;
-            if (degrees < 0) degrees += 360.0;
-            
-            // Classify into 8 directions
-            if (degrees >= 337.5 || degrees < 22.5) {
-                directionDist["E"]++;
-            } else if (degrees >= 22.5 && degrees < 67.5) {
-                directionDist["NE"]++;
-            } else if (degrees >= 67.5 && degrees < 112.5) {
-                directionDist["N"]++;
-            } else if (degrees >= 112.5 && degrees < 157.5) {
-                directionDist["NW"]++;
-            } else if (degrees >= 157.5 && degrees < 202.5) {
-                directionDist["W"]++;
-            } else if (degrees >= 202.5 && degrees < 247.5) {
-                directionDist["SW"]++;
-            } else if (degrees >= 247.5 && degrees < 292.5) {
-                directionDist["S"]++;
-            } else {
-                directionDist["SE"]++;
-            }
-        }
+    std::vector<int64_t> pts;
+    pts.reserve(fields.size());
+    for (const auto& field : fields) {
+        pts.push_back(field.pts);
     }
-    
-    stats.averageMagnitude = sumMagnitude / vectors.size();
-    stats.maxMagnitude = maxMag;
-    stats.minMagnitude = minMag;
-    stats.staticRegions = staticCount;
-    stats.highMotionRegions = highMotionCount;
-    stats.directionDistribution = directionDist;
-    
-    return stats;
+    return mergeByGOP(pts, accumulateByFrame(fields), gops);
 }
 
 } // namespace video_analyzer
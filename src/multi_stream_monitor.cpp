@@ -0,0 +1,489 @@
+#include "video_analyzer/multi_stream_monitor.h"
+#include "video_analyzer/anomaly_detector.h"
+#include "video_analyzer/snapshot_ring.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
+namespace fs = std::filesystem;
+
+namespace video_analyzer {
+
+namespace {
+
+// Packets read from one stream before the demux thread moves to the next
+constexpr int kMaxPacketsPerTurn = 16;
+
+// Packets decoded by one worker task before the stream yields the worker
+constexpr int kMaxPacketsPerTask = 32;
+
+// Backoff of a demux thread when a full pass over its streams read nothing
+constexpr std::chrono::microseconds kMinIdleWait(200);
+constexpr std::chrono::microseconds kMaxIdleWait(5000);
+
+} // namespace
+
+nlohmann::json MonitoredStreamStatus::toJson() const {
+    return nlohmann::json{
+        {"id", id},
+        {"url", url},
+        {"active", active},
+        {"packetsRead", packetsRead},
+        {"packetsDropped", packetsDropped},
+        {"framesAnalyzed", framesAnalyzed},
+        {"anomaliesDetected", anomaliesDetected},
+        {"lastTimestamp", lastTimestamp},
+        {"failed", failed},
+        {"error", error}
+    };
+}
+
+struct MultiStreamMonitor::Stream {
+    Stream(int id, const std::string& url, size_t windowFrames)
+        : id(id), url(url), decoder(url, 1, true), window(windowFrames) {}
+    
+    const int id;
+    const std::string url;
+    StreamDecoder decoder;
+    bool demuxEnded = false;  // Owned by the stream's demux thread
+    std::atomic<bool> removed{false};
+    
+    // Packets awaiting decode and scheduling state
+    std::mutex mutex;
+    std::deque<PacketPtr> pending;
+    bool scheduled = false;        // A worker task is queued or running
+    bool endRequested = false;     // Demuxing ended; flush after the pending packets
+    bool waitForKeyframe = false;  // Packets were dropped; skip to the next keyframe
+    bool completed = false;        // Flushed and fully analyzed
+    bool failed = false;           // Processing threw; no longer decoded
+    std::string error;             // What processing threw
+    
+    // Analysis state, used by one worker at a time
+    AnomalyDetector detector;
+    std::vector<DecodedFrame> decoded;
+    std::vector<Anomaly> detected;
+    std::ofstream exportFile;
+    SnapshotRing<FrameInfo> window;
+    
+    // Recent anomalies
+    std::mutex anomalyMutex;
+    std::deque<Anomaly> anomalies;
+    
+    std::atomic<uint64_t> packetsRead{0};
+    std::atomic<uint64_t> packetsDropped{0};
+    std::atomic<uint64_t> framesAnalyzed{0};
+    std::atomic<uint64_t> anomaliesDetected{0};
+    std::atomic<double> lastTimestamp{0.0};
+};
+
+MultiStreamMonitor::MultiStreamMonitor(const MonitorOptions& options)
+    : options_(options),
+      workers_(std::make_unique<ThreadPool>(options.workerThreads)) {
+    options_.demuxThreads = std::max<size_t>(options_.demuxThreads, 1);
+    options_.maxQueuedPackets = std::max<size_t>(options_.maxQueuedPackets, 1);
+}
+
+MultiStreamMonitor::~MultiStreamMonitor() {
+    stop();
+}
+
+int MultiStreamMonitor::addStream(const std::string& url) {
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(streamsMutex_);
+        id = nextStreamId_++;
+    }
+    
+    // Opening blocks on the network, so it happens outside the lock
+    auto stream = std::make_shared<Stream>(id, url, options_.windowFrames);
+    
+    if (!options_.exportDirectory.empty()) {
+        fs::create_directories(options_.exportDirectory);
+        stream->exportFile.open(fs::path(options_.exportDirectory) / ("stream_" + std::to_string(id) + ".jsonl"));
+    }
+    
+    std::lock_guard<std::mutex> lock(streamsMutex_);
+    streams_.push_back(stream);
+    return id;
+}
+
+bool MultiStreamMonitor::removeStream(int streamId) {
+    std::shared_ptr<Stream> stream;
+    {
+        std::lock_guard<std::mutex> lock(streamsMutex_);
+        auto it = std::find_if(streams_.begin(), streams_.end(), [streamId](const auto& candidate) {
+            return candidate->id == streamId;
+        });
+        if (it == streams_.end()) {
+            return false;
+        }
+        stream = *it;
+        streams_.erase(it);
+    }
+    
+    // Pending work notices the flag and exits; the last reference closes the stream
+    stream->removed = true;
+    stream->decoder.stop();
+    
+    notifyCompletion();
+    return true;
+}
+
+void MultiStreamMonitor::start() {
+    if (running_) {
+        return;
+    }
+    
+    running_ = true;
+    for (size_t i = 0; i < options_.demuxThreads; ++i) {
+        demuxThreads_.emplace_back(&MultiStreamMonitor::demuxLoop, this, i);
+    }
+}
+
+void MultiStreamMonitor::stop() {
+    if (!running_) {
+        return;
+    }
+    
+    running_ = false;
+    for (auto& thread : demuxThreads_) {
+        thread.join();
+    }
+    demuxThreads_.clear();
+    
+    // Queued tasks see running_ == false and return immediately
+    workers_->waitAll();
+    notifyCompletion();
+}
+
+bool MultiStreamMonitor::waitForCompletion(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(completionMutex_);
+    return completionCondition_.wait_for(lock, timeout, [this] {
+        for (const auto& stream : snapshotStreams()) {
+            std::lock_guard<std::mutex> streamLock(stream->mutex);
+            if (!stream->completed) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+size_t MultiStreamMonitor::getStreamCount() const {
+    std::lock_guard<std::mutex> lock(streamsMutex_);
+    return streams_.size();
+}
+
+std::vector<MonitoredStreamStatus> MultiStreamMonitor::getStatus() const {
+    std::vector<MonitoredStreamStatus> statuses;
+    for (const auto& stream : snapshotStreams()) {
+        MonitoredStreamStatus status;
+        status.id = stream->id;
+        status.url = stream->url;
+        status.active = stream->decoder.isStreamActive();
+        status.packetsRead = stream->packetsRead;
+        status.packetsDropped = stream->packetsDropped;
+        status.framesAnalyzed = stream->framesAnalyzed;
+        status.anomaliesDetected = stream->anomaliesDetected;
+        status.lastTimestamp = stream->lastTimestamp;
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            status.failed = stream->failed;
+            status.error = stream->error;
+        }
+        statuses.push_back(status);
+    }
+    return statuses;
+}
+
+FrameStatistics MultiStreamMonitor::getFrameStats(int streamId, double windowSize) const {
+    auto stream = findStream(streamId);
+    if (!stream) {
+        return FrameStatistics{};
+    }
+    
+    std::vector<FrameInfo> frames = stream->window.snapshot();
+    if (!frames.empty()) {
+        // Drop frames older than the window
+        double startTime = frames.back().timestamp - windowSize;
+        auto first = std::find_if(frames.begin(), frames.end(), [startTime](const FrameInfo& frame) {
+            return frame.timestamp >= startTime;
+        });
+        frames.erase(frames.begin(), first);
+    }
+    return FrameStatistics::compute(frames);
+}
+
+std::vector<Anomaly> MultiStreamMonitor::getAnomalies(int streamId) const {
+    auto stream = findStream(streamId);
+    if (!stream) {
+        return {};
+    }
+    
+    std::lock_guard<std::mutex> lock(stream->anomalyMutex);
+    return std::vector<Anomaly>(stream->anomalies.begin(), stream->anomalies.end());
+}
+
+void MultiStreamMonitor::setFrameCallback(FrameCallback callback) {
+    frameCallback_ = callback;
+}
+
+void MultiStreamMonitor::setAnomalyCallback(AnomalyCallback callback) {
+    anomalyCallback_ = callback;
+}
+
+size_t MultiStreamMonitor::getThreadCount() const {
+    return workers_->getThreadCount() + options_.demuxThreads;
+}
+
+std::shared_ptr<MultiStreamMonitor::Stream> MultiStreamMonitor::findStream(int streamId) const {
+    std::lock_guard<std::mutex> lock(streamsMutex_);
+    for (const auto& stream : streams_) {
+        if (stream->id == streamId) {
+            return stream;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::shared_ptr<MultiStreamMonitor::Stream>> MultiStreamMonitor::snapshotStreams() const {
+    std::lock_guard<std::mutex> lock(streamsMutex_);
+    return streams_;
+}
+
+void MultiStreamMonitor::demuxLoop(size_t index) {
+    std::chrono::microseconds idleWait = kMinIdleWait;
+    PacketPtr packet;
+    
+    while (running_) {
+        bool progressed = false;
+        
+        // Re-read the list every pass to pick up added and removed streams
+        for (const auto& stream : snapshotStreams()) {
+            if (static_cast<size_t>(stream->id) % options_.demuxThreads != index || stream->demuxEnded) {
+                continue;
+            }
+            
+            // Bounded turn so one busy stream cannot starve the others
+            for (int i = 0; i < kMaxPacketsPerTurn && running_; ++i) {
+                PacketReadResult result = stream->decoder.readPacket(packet);
+                if (result == PacketReadResult::WOULD_BLOCK) {
+                    break;
+                }
+                progressed = true;
+                
+                if (result == PacketReadResult::ENDED) {
+                    stream->demuxEnded = true;
+                    requestEnd(stream);
+                    break;
+                }
+                if (result == PacketReadResult::VIDEO_PACKET) {
+                    stream->packetsRead++;
+                    enqueue(stream, std::move(packet));
+                    packet = PacketPtr();
+                }
+            }
+        }
+        
+        // No stream had data: back off instead of spinning on EAGAIN
+        if (progressed) {
+            idleWait = kMinIdleWait;
+        } else {
+            std::this_thread::sleep_for(idleWait);
+            idleWait = std::min(idleWait * 2, kMaxIdleWait);
+        }
+    }
+}
+
+void MultiStreamMonitor::enqueue(const std::shared_ptr<Stream>& stream, PacketPtr packet) {
+    bool keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        if (stream->failed) {
+            return;
+        }
+        
+        // Decoding fell behind: drop rather than wait, then resume at a
+        // keyframe so the decoder never sees a broken reference chain
+        if (stream->pending.size() >= options_.maxQueuedPackets) {
+            stream->packetsDropped++;
+            stream->waitForKeyframe = true;
+            return;
+        }
+        if (stream->waitForKeyframe && !keyframe) {
+            stream->packetsDropped++;
+            return;
+        }
+        stream->waitForKeyframe = false;
+        stream->pending.push_back(std::move(packet));
+        
+        if (stream->scheduled) {
+            return;
+        }
+        stream->scheduled = true;
+    }
+    schedule(stream);
+}
+
+void MultiStreamMonitor::requestEnd(const std::shared_ptr<Stream>& stream) {
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->endRequested = true;
+        
+        if (stream->scheduled || stream->failed) {
+            return;
+        }
+        stream->scheduled = true;
+    }
+    schedule(stream);
+}
+
+void MultiStreamMonitor::schedule(const std::shared_ptr<Stream>& stream) {
+    workers_->execute([this, stream] { process(stream); });
+}
+
+void MultiStreamMonitor::process(const std::shared_ptr<Stream>& stream) {
+    // Tasks run without a latch, so nothing else would see an exception;
+    // a stream that throws is marked failed and never scheduled again
+    try {
+        if (processPackets(stream)) {
+            schedule(stream);
+        }
+    } catch (const std::exception& e) {
+        markFailed(*stream, e.what());
+    } catch (...) {
+        markFailed(*stream, "Unknown error");
+    }
+}
+
+bool MultiStreamMonitor::processPackets(const std::shared_ptr<Stream>& stream) {
+    for (int processed = 0;; ++processed) {
+        std::optional<PacketPtr> packet;
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            if (!running_ || stream->removed) {
+                // Discarded packets break the reference chain
+                if (!stream->pending.empty()) {
+                    stream->pending.clear();
+                    stream->waitForKeyframe = true;
+                }
+                stream->scheduled = false;
+                return false;
+            }
+            
+            if (processed == kMaxPacketsPerTask && (!stream->pending.empty() || stream->endRequested)) {
+                break;  // Yield the worker, still scheduled
+            }
+            
+            if (!stream->pending.empty()) {
+                packet = std::move(stream->pending.front());
+                stream->pending.pop_front();
+            } else if (!stream->endRequested || stream->completed) {
+                stream->scheduled = false;
+                return false;
+            }
+        }
+        
+        stream->decoded.clear();
+        if (packet) {
+            stream->decoder.decodePacket(*packet, stream->decoded);
+        } else {
+            stream->decoder.flush(stream->decoded);
+        }
+        
+        for (const auto& frame : stream->decoded) {
+            analyze(*stream, frame.info);
+        }
+        
+        if (!packet) {
+            markCompleted(*stream);
+        }
+    }
+    
+    return true;
+}
+
+void MultiStreamMonitor::analyze(Stream& stream, const FrameInfo& frame) {
+    stream.window.push(frame);
+    stream.framesAnalyzed++;
+    stream.lastTimestamp = frame.timestamp;
+    
+    stream.detected.clear();
+    if (size_t count = stream.detector.inspect(frame, stream.detected)) {
+        stream.anomaliesDetected += count;
+        {
+            std::lock_guard<std::mutex> lock(stream.anomalyMutex);
+            for (const auto& anomaly : stream.detected) {
+                stream.anomalies.push_back(anomaly);
+                if (stream.anomalies.size() > options_.maxAnomalies) {
+                    stream.anomalies.pop_front();
+                }
+            }
+        }
+        
+        if (anomalyCallback_) {
+            for (const auto& anomaly : stream.detected) {
+                anomalyCallback_(stream.id, anomaly);
+            }
+        }
+    }
+    
+    if (frameCallback_) {
+        frameCallback_(stream.id, frame);
+    }
+    
+    // Export to JSON Lines, flushed once per GOP to keep syscalls per
+    // stream low
+    if (stream.exportFile.is_open()) {
+        stream.exportFile << frame.toJson().dump() << "\n";
+        if (frame.isKeyFrame) {
+            stream.exportFile.flush();
+        }
+    }
+}
+
+void MultiStreamMonitor::markCompleted(Stream& stream) {
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        stream.completed = true;
+    }
+    if (stream.exportFile.is_open()) {
+        stream.exportFile.flush();
+    }
+    notifyCompletion();
+}
+
+void MultiStreamMonitor::markFailed(Stream& stream, const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        stream.scheduled = false;
+        stream.failed = true;
+        stream.error = error;
+        stream.pending.clear();
+        stream.completed = true;  // Nothing more will be analyzed
+    }
+    
+    // The demux thread sees the stream end and stops reading it
+    stream.decoder.stop();
+    if (stream.exportFile.is_open()) {
+        stream.exportFile.flush();
+    }
+    notifyCompletion();
+}
+
+void MultiStreamMonitor::notifyCompletion() {
+    // Taking the lock orders this notification after any waiter's check
+    {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+    }
+    completionCondition_.notify_all();
+}
+
+} // namespace video_analyzer
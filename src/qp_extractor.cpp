@@ -0,0 +1,144 @@
+#include "video_analyzer/qp_extractor.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/video_enc_params.h>
+}
+
+#include <algorithm>
+#include <limits>
+
+namespace video_analyzer {
+
+namespace {
+
+// Elements reduced with 32-bit sums before flushing to the 64-bit total.
+// Block deltas are bounded by the codec QP range (|delta| <= 255), so
+// 4096 * 255 stays far below INT32_MAX.
+constexpr size_t kReduceChunk = 4096;
+
+inline int32_t reduceChunk(const int32_t* values, size_t count, int32_t& lo, int32_t& hi) {
+    int32_t sum = 0;
+    int32_t chunkLo = lo;
+    int32_t chunkHi = hi;
+    
+    for (size_t i = 0; i < count; ++i) {
+        int32_t v = values[i];
+        sum += v;
+        chunkLo = v < chunkLo ? v : chunkLo;
+        chunkHi = v > chunkHi ? v : chunkHi;
+    }
+    
+    lo = chunkLo;
+    hi = chunkHi;
+    return sum;
+}
+
+AVVideoEncParams* getEncParams(const AVFrame* frame) {
+    if (!frame) {
+        return nullptr;
+    }
+    
+    AVFrameSideData* sd = av_frame_get_side_data(frame, AV_FRAME_DATA_VIDEO_ENC_PARAMS);
+    if (!sd || sd->size < sizeof(AVVideoEncParams)) {
+        return nullptr;
+    }
+    
+    return reinterpret_cast<AVVideoEncParams*>(sd->data);
+}
+
+} // namespace
+
+QPStatistics reduceBlockQP(const int32_t* deltas, size_t count, int baseQP) {
+    QPStatistics stats;
+    stats.blockCount = static_cast<int>(count);
+    
+    if (count == 0) {
+        stats.average = baseQP;
+        stats.min = baseQP;
+        stats.max = baseQP;
+        return stats;
+    }
+    
+    int64_t total = 0;
+    int32_t lo = std::numeric_limits<int32_t>::max();
+    int32_t hi = std::numeric_limits<int32_t>::min();
+    
+    // Full chunks have a constant trip count, which lets the compiler
+    // vectorize them even with its cheapest cost model (-O2)
+    size_t fullChunks = count / kReduceChunk;
+    for (size_t c = 0; c < fullChunks; ++c) {
+        total += reduceChunk(deltas + c * kReduceChunk, kReduceChunk, lo, hi);
+    }
+    total += reduceChunk(deltas + fullChunks * kReduceChunk, count % kReduceChunk, lo, hi);
+    
+    double mean = static_cast<double>(total) / static_cast<double>(count);
+    stats.average = baseQP + static_cast<int>(mean >= 0 ? mean + 0.5 : mean - 0.5);
+    stats.min = baseQP + lo;
+    stats.max = baseQP + hi;
+    return stats;
+}
+
+std::optional<QPStatistics> extractQPStatistics(const AVFrame* frame) {
+    AVVideoEncParams* params = getEncParams(frame);
+    if (!params) {
+        return std::nullopt;
+    }
+    
+    // Gather block deltas into a contiguous buffer for the reduction kernel
+    thread_local std::vector<int32_t> deltas;
+    deltas.resize(params->nb_blocks);
+    for (unsigned int i = 0; i < params->nb_blocks; ++i) {
+        deltas[i] = av_video_enc_params_block(params, i)->delta_qp;
+    }
+    
+    return reduceBlockQP(deltas.data(), deltas.size(), params->qp);
+}
+
+std::optional<QPMap> extractQPMap(const AVFrame* frame) {
+    AVVideoEncParams* params = getEncParams(frame);
+    if (!params || params->nb_blocks == 0 || frame->width <= 0 || frame->height <= 0) {
+        return std::nullopt;
+    }
+    
+    // Cell size is the smallest block size in the frame
+    int cellWidth = std::numeric_limits<int>::max();
+    int cellHeight = std::numeric_limits<int>::max();
+    for (unsigned int i = 0; i < params->nb_blocks; ++i) {
+        const AVVideoBlockParams* block = av_video_enc_params_block(params, i);
+        if (block->w > 0) cellWidth = std::min(cellWidth, block->w);
+        if (block->h > 0) cellHeight = std::min(cellHeight, block->h);
+    }
+    if (cellWidth == std::numeric_limits<int>::max() ||
+        cellHeight == std::numeric_limits<int>::max()) {
+        return std::nullopt;
+    }
+    
+    QPMap map;
+    map.cellWidth = cellWidth;
+    map.cellHeight = cellHeight;
+    map.columns = (frame->width + cellWidth - 1) / cellWidth;
+    map.rows = (frame->height + cellHeight - 1) / cellHeight;
+    map.values.assign(static_cast<size_t>(map.columns) * map.rows,
+                      static_cast<int16_t>(params->qp));
+    
+    for (unsigned int i = 0; i < params->nb_blocks; ++i) {
+        const AVVideoBlockParams* block = av_video_enc_params_block(params, i);
+        int16_t qp = static_cast<int16_t>(params->qp + block->delta_qp);
+        
+        int col0 = std::max(0, block->src_x / cellWidth);
+        int row0 = std::max(0, block->src_y / cellHeight);
+        int col1 = std::min(map.columns, (block->src_x + block->w + cellWidth - 1) / cellWidth);
+        int row1 = std::min(map.rows, (block->src_y + block->h + cellHeight - 1) / cellHeight);
+        
+        for (int row = row0; row < row1; ++row) {
+            std::fill(map.values.begin() + static_cast<size_t>(row) * map.columns + col0,
+                      map.values.begin() + static_cast<size_t>(row) * map.columns + col1,
+                      qp);
+        }
+    }
+    
+    return map;
+}
+
+} // namespace video_analyzer
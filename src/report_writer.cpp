@@ -0,0 +1,245 @@
+#include "video_analyzer/report_writer.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace video_analyzer {
+
+namespace {
+
+// Output buffer size and the largest single record appended at once
+constexpr size_t kBufferSize = 64 * 1024;
+constexpr size_t kMaxRecordSize = 512;
+
+// Re-indent a nested JSON dump so it lines up under a top-level key
+std::string indentNested(const nlohmann::json& value) {
+    std::string text = value.dump(2);
+    std::string result;
+    result.reserve(text.size() + text.size() / 8);
+    for (char c : text) {
+        result.push_back(c);
+        if (c == '\n') {
+            result.append("  ");
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+ReportWriter::ReportWriter(const std::string& path, ReportFormat format)
+    : file_(path, std::ios::out | std::ios::trunc | std::ios::binary),
+      path_(path),
+      format_(format),
+      buffer_(kBufferSize) {
+    if (!file_) {
+        throw std::runtime_error("Failed to open report file: " + path);
+    }
+}
+
+ReportWriter::~ReportWriter() {
+    if (!finished_) {
+        try {
+            finish();
+        } catch (...) {
+            // Destructors must not throw; the report is left truncated
+        }
+    }
+}
+
+void ReportWriter::begin(const StreamInfo& info) {
+    if (begun_) {
+        return;
+    }
+    begun_ = true;
+    
+    if (format_ == ReportFormat::CSV) {
+        append("pts,dts,type,size,qp,isKeyFrame,timestamp\n");
+    } else {
+        append("{\n  \"streamInfo\": ");
+        append(indentNested(info.toJson()));
+        append(",\n  \"frames\": [");
+    }
+}
+
+void ReportWriter::consume(const FrameInfo& frame, const VideoDecoder& /*decoder*/) {
+    writeFrame(frame);
+}
+
+void ReportWriter::end() {
+    if (format_ == ReportFormat::JSON && begun_ && !framesClosed_) {
+        append(framesWritten_ > 0 ? "\n  ]" : "]");
+        framesClosed_ = true;
+    }
+}
+
+void ReportWriter::writeFrame(const FrameInfo& frame) {
+    if (!begun_) {
+        begun_ = true;
+        append(format_ == ReportFormat::CSV
+               ? "pts,dts,type,size,qp,isKeyFrame,timestamp\n"
+               : "{\n  \"frames\": [");
+    }
+    
+    ensureCapacity(kMaxRecordSize);
+    if (format_ == ReportFormat::CSV) {
+        appendFrameCsv(frame);
+    } else {
+        if (framesWritten_ > 0) {
+            append(",\n    ", 6);
+        } else {
+            append("\n    ", 5);
+        }
+        appendFrameJson(frame);
+    }
+    framesWritten_++;
+}
+
+void ReportWriter::finish(const nlohmann::json& summary) {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    
+    if (format_ == ReportFormat::JSON) {
+        if (!begun_) {
+            begun_ = true;
+            append("{\n  \"frames\": [");
+        }
+        end();
+        
+        for (const auto& item : summary.items()) {
+            append(",\n  \"");
+            append(item.key());
+            append("\": ");
+            append(indentNested(item.value()));
+        }
+        append("\n}\n");
+    }
+    
+    flush();
+    file_.close();
+    if (file_.fail()) {
+        throw std::runtime_error("Failed to write report file: " + path_);
+    }
+}
+
+void ReportWriter::ensureCapacity(size_t bytes) {
+    if (buffer_.size() - used_ < bytes) {
+        flush();
+    }
+}
+
+void ReportWriter::flush() {
+    if (used_ > 0) {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+        used_ = 0;
+    }
+}
+
+void ReportWriter::append(const char* text, size_t length) {
+    if (length > buffer_.size() - used_) {
+        flush();
+        if (length > buffer_.size()) {
+            // Oversized block (e.g. a large summary): write through
+            file_.write(text, static_cast<std::streamsize>(length));
+            return;
+        }
+    }
+    std::memcpy(buffer_.data() + used_, text, length);
+    used_ += length;
+}
+
+void ReportWriter::append(const char* text) {
+    append(text, std::strlen(text));
+}
+
+void ReportWriter::append(const std::string& text) {
+    append(text.data(), text.size());
+}
+
+void ReportWriter::appendInt(int64_t value) {
+    auto result = std::to_chars(buffer_.data() + used_, buffer_.data() + buffer_.size(), value);
+    used_ = static_cast<size_t>(result.ptr - buffer_.data());
+}
+
+void ReportWriter::appendDouble(double value) {
+    // JSON has no NaN/Inf; nlohmann::json writes them as null
+    if (!std::isfinite(value)) {
+        append("null", 4);
+        return;
+    }
+    
+    // Shortest round-trip representation, like nlohmann::json
+    auto result = std::to_chars(buffer_.data() + used_, buffer_.data() + buffer_.size(), value);
+    char* begin = buffer_.data() + used_;
+    used_ = static_cast<size_t>(result.ptr - buffer_.data());
+    
+    // Keep the value a JSON floating point number (e.g. "2" -> "2.0")
+    if (std::memchr(begin, '.', result.ptr - begin) == nullptr &&
+        std::memchr(begin, 'e', result.ptr - begin) == nullptr) {
+        append(".0", 2);
+    }
+}
+
+void ReportWriter::appendFixed(double value, int precision) {
+    auto result = std::to_chars(buffer_.data() + used_, buffer_.data() + buffer_.size(),
+                                value, std::chars_format::fixed, precision);
+    used_ = static_cast<size_t>(result.ptr - buffer_.data());
+}
+
+void ReportWriter::appendFrameJson(const FrameInfo& frame) {
+    append("{\"pts\":", 7);
+    appendInt(frame.pts);
+    append(",\"dts\":", 7);
+    appendInt(frame.dts);
+    append(",\"type\":\"", 9);
+    append(frameTypeName(frame.type));
+    append("\",\"size\":", 9);
+    appendInt(frame.size);
+    append(",\"qp\":", 6);
+    appendInt(frame.qp);
+    append(",\"qpMin\":", 9);
+    appendInt(frame.qpMin);
+    append(",\"qpMax\":", 9);
+    appendInt(frame.qpMax);
+    if (frame.isKeyFrame) {
+        append(",\"isKeyFrame\":true", 18);
+    } else {
+        append(",\"isKeyFrame\":false", 19);
+    }
+    append(",\"timestamp\":", 13);
+    appendDouble(frame.timestamp);
+    if (frame.isDuplicate) {
+        append(",\"isDuplicate\":true", 19);
+    } else {
+        append(",\"isDuplicate\":false", 20);
+    }
+    append(",\"duplicateGroupId\":", 20);
+    appendInt(frame.duplicateGroupId);
+    append(",\"pos\":", 7);
+    appendInt(frame.pos);
+    append("}", 1);
+}
+
+void ReportWriter::appendFrameCsv(const FrameInfo& frame) {
+    appendInt(frame.pts);
+    append(",", 1);
+    appendInt(frame.dts);
+    append(",", 1);
+    append(frameTypeName(frame.type));
+    append(",", 1);
+    appendInt(frame.size);
+    append(",", 1);
+    appendInt(frame.qp);
+    if (frame.isKeyFrame) {
+        append(",true,", 6);
+    } else {
+        append(",false,", 7);
+    }
+    appendFixed(frame.timestamp, 6);
+    append("\n", 1);
+}
+
+} // namespace video_analyzer
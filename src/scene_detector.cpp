@@ -1,6 +1,7 @@
 #include "video_analyzer/scene_detector.h"
 #include "video_analyzer/ffmpeg_error.h"
 #include "video_analyzer/ffmpeg_context.h"
+#include "video_analyzer/luma_kernels.h"
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -15,6 +16,32 @@ extern "C" {
 
 namespace video_analyzer {
 
+namespace {
+
+// Mean absolute difference of the thumbnails is scaled so that a change of
+// about a quarter of the luma range saturates the pixel term
+constexpr double kSadScale = 4.0;
+
+double thumbnailSadDifference(const LumaThumbnail& a, const LumaThumbnail& b) {
+    if (a.empty() || a.width != b.width || a.height != b.height) {
+        return 0.0;
+    }
+    
+    uint64_t sad = sumAbsoluteDifferences(a.pixels.data(), b.pixels.data(), a.pixels.size());
+    double meanDiff = static_cast<double>(sad) / (a.pixels.size() * 255.0);
+    return std::min(1.0, meanDiff * kSadScale);
+}
+
+double thumbnailMean(const LumaThumbnail& thumbnail) {
+    uint64_t sum = 0;
+    for (uint8_t v : thumbnail.pixels) {
+        sum += v;
+    }
+    return static_cast<double>(sum) / thumbnail.pixels.size();
+}
+
+} // namespace
+
 // SceneInfo implementation
 nlohmann::json SceneInfo::toJson() const {
     return nlohmann::json{
@@ -36,8 +63,71 @@ struct SceneDetector::Impl {
     double threshold;
     std::vector<SceneInfo> scenes;
     
+    // Streaming state
+    int frameIndex = 0;
+    int prevSize = 0;
+    SceneInfo currentScene{};
+    double currentSceneSize = 0.0;
+    
+    // Luma of the previous and current frame (empty without pixel data)
+    LumaThumbnail prevThumbnail;
+    LumaThumbnail thumbnail;
+    uint32_t prevHistogram[kLumaHistogramBins] = {};
+    uint32_t histogram[kLumaHistogramBins] = {};
+    double currentSceneLuma = 0.0;
+    int currentSceneLumaFrames = 0;
+    
     explicit Impl(VideoDecoder& dec, double thresh)
         : decoder(dec), threshold(thresh) {}
+    
+    void startScene(const FrameInfo& frame) {
+        currentScene = SceneInfo{};
+        currentScene.sceneIndex = static_cast<int>(scenes.size());
+        currentScene.startFrameNumber = frameIndex;
+        currentScene.startPts = frame.pts;
+        currentScene.startTimestamp = frame.timestamp;
+        currentSceneSize = 0.0;
+        currentSceneLuma = 0.0;
+        currentSceneLumaFrames = 0;
+    }
+    
+    void closeScene() {
+        if (currentSceneLumaFrames > 0) {
+            currentScene.averageBrightness = currentSceneLuma / currentSceneLumaFrames;
+        } else {
+            // Without pixel data brightness is approximated by average frame size
+            currentScene.averageBrightness = currentSceneSize / currentScene.frameCount;
+        }
+        scenes.push_back(currentScene);
+    }
+    
+    // Combined pixel and histogram difference to the previous frame, or a
+    // negative value if either frame has no luma
+    double lumaDifference() const {
+        if (thumbnail.empty() || prevThumbnail.empty() ||
+            thumbnail.width != prevThumbnail.width || thumbnail.height != prevThumbnail.height) {
+            return -1.0;
+        }
+        
+        double pixelDiff = thumbnailSadDifference(thumbnail, prevThumbnail);
+        double histogramDiff = chiSquareDistance(histogram, prevHistogram, kLumaHistogramBins);
+        return 0.5 * (pixelDiff + histogramDiff);
+    }
+    
+    // Size change heuristic for frames without pixel data (HEADER_SCAN)
+    bool isSizeBoundary(const FrameInfo& frame) const {
+        double sizeDiff = 0.0;
+        if (prevSize > 0) {
+            sizeDiff = std::abs(static_cast<double>(frame.size - prevSize)) / 
+                      static_cast<double>(prevSize);
+        }
+        
+        if (frame.isKeyFrame && sizeDiff > threshold) {
+            return true;
+        }
+        // Very large size change even without keyframe
+        return sizeDiff > threshold * 2.0;
+    }
 };
 
 SceneDetector::SceneDetector(VideoDecoder& decoder, double threshold)
@@ -51,113 +141,71 @@ SceneDetector::SceneDetector(SceneDetector&&) noexcept = default;
 SceneDetector& SceneDetector::operator=(SceneDetector&&) noexcept = default;
 
 std::vector<SceneInfo> SceneDetector::analyze() {
-    pImpl_->scenes.clear();
     pImpl_->decoder.reset();
     
-    std::vector<FrameInfo> frames;
-    std::vector<FramePtr> frameBuffers;
+    AnalysisPipeline pipeline(pImpl_->decoder);
+    pipeline.addSink(*this);
+    pipeline.run();
     
-    // Read all frames and store frame info
-    while (auto frameInfo = pImpl_->decoder.readNextFrame()) {
-        frames.push_back(*frameInfo);
-    }
+    return pImpl_->scenes;
+}
+
+void SceneDetector::begin(const StreamInfo& /*info*/) {
+    pImpl_->scenes.clear();
+    pImpl_->frameIndex = 0;
+    pImpl_->prevSize = 0;
+    pImpl_->prevThumbnail = LumaThumbnail{};
+    pImpl_->thumbnail = LumaThumbnail{};
+}
+
+void SceneDetector::consume(const FrameInfo& frame, const VideoDecoder& decoder) {
+    // Scene changes are detected on the decoded luma plane: an 8x8 block
+    // thumbnail is compared to the previous frame's by mean absolute
+    // difference and by luma histogram. Without pixel data (HEADER_SCAN)
+    // frame size changes and keyframes are used instead.
+    auto& impl = *pImpl_;
+    std::swap(impl.prevThumbnail, impl.thumbnail);
+    std::copy(std::begin(impl.histogram), std::end(impl.histogram), std::begin(impl.prevHistogram));
     
-    if (frames.empty()) {
-        return pImpl_->scenes;
+    if (downscaleLuma(decoder.getLastDecodedFrame(), impl.thumbnail)) {
+        lumaHistogram(impl.thumbnail.pixels.data(), impl.thumbnail.pixels.size(), impl.histogram);
     }
     
-    // Reset decoder to read frames again for pixel analysis
-    pImpl_->decoder.reset();
-    
-    // Allocate frame buffers for comparison
-    FramePtr prevFrame;
-    FramePtr currFrame;
-    
-    // Track scene boundaries
-    std::vector<int> sceneBoundaries;
-    sceneBoundaries.push_back(0); // First frame is always a scene boundary
-    
-    int frameIndex = 0;
-    double prevBrightness = 0.0;
-    double totalBrightness = 0.0;
-    int brightnessCount = 0;
-    
-    // Read frames and detect scene changes
-    while (auto frameInfo = pImpl_->decoder.readNextFrame()) {
-        // For scene detection, we need actual frame data
-        // Since VideoDecoder doesn't expose AVFrame directly, we'll use a simplified approach
-        // based on frame size changes and keyframe detection
-        
-        // A scene change is likely when:
-        // 1. Frame is a keyframe (I-frame)
-        // 2. Frame size changes significantly
-        // 3. Frame type pattern changes
+    if (impl.frameIndex == 0) {
+        impl.startScene(frame);
+    } else {
+        double lumaDiff = impl.lumaDifference();
+        bool isSceneBoundary = lumaDiff >= 0.0 ? lumaDiff > impl.threshold
+                                               : impl.isSizeBoundary(frame);
         
-        if (frameIndex > 0) {
-            const auto& prevFrameInfo = frames[frameIndex - 1];
-            const auto& currFrameInfo = frames[frameIndex];
-            
-            // Calculate size difference ratio
-            double sizeDiff = 0.0;
-            if (prevFrameInfo.size > 0) {
-                sizeDiff = std::abs(static_cast<double>(currFrameInfo.size - prevFrameInfo.size)) / 
-                          static_cast<double>(prevFrameInfo.size);
-            }
-            
-            // Detect scene boundary based on:
-            // 1. Keyframe with significant size change
-            // 2. Size difference exceeds threshold
-            bool isSceneBoundary = false;
-            
-            if (currFrameInfo.isKeyFrame && sizeDiff > pImpl_->threshold) {
-                isSceneBoundary = true;
-            } else if (sizeDiff > pImpl_->threshold * 2.0) {
-                // Very large size change even without keyframe
-                isSceneBoundary = true;
-            }
-            
-            if (isSceneBoundary) {
-                sceneBoundaries.push_back(frameIndex);
-            }
+        if (isSceneBoundary) {
+            impl.closeScene();
+            impl.startScene(frame);
         }
-        
-        frameIndex++;
     }
     
-    // Add final boundary
-    if (sceneBoundaries.back() != static_cast<int>(frames.size()) - 1) {
-        sceneBoundaries.push_back(frames.size());
+    auto& scene = impl.currentScene;
+    scene.endFrameNumber = impl.frameIndex;
+    scene.endPts = frame.pts;
+    scene.endTimestamp = frame.timestamp;
+    scene.frameCount++;
+    impl.currentSceneSize += frame.size;
+    if (!impl.thumbnail.empty()) {
+        impl.currentSceneLuma += thumbnailMean(impl.thumbnail);
+        impl.currentSceneLumaFrames++;
     }
     
-    // Create SceneInfo objects
-    for (size_t i = 0; i < sceneBoundaries.size() - 1; i++) {
-        int startIdx = sceneBoundaries[i];
-        int endIdx = sceneBoundaries[i + 1] - 1;
-        
-        if (endIdx >= static_cast<int>(frames.size())) {
-            endIdx = frames.size() - 1;
-        }
-        
-        SceneInfo scene;
-        scene.sceneIndex = i;
-        scene.startFrameNumber = startIdx;
-        scene.endFrameNumber = endIdx;
-        scene.startPts = frames[startIdx].pts;
-        scene.endPts = frames[endIdx].pts;
-        scene.startTimestamp = frames[startIdx].timestamp;
-        scene.endTimestamp = frames[endIdx].timestamp;
-        scene.frameCount = endIdx - startIdx + 1;
-        
-        // Calculate average brightness (approximated by average frame size)
-        double totalSize = 0.0;
-        for (int j = startIdx; j <= endIdx; j++) {
-            totalSize += frames[j].size;
-        }
-        scene.averageBrightness = totalSize / scene.frameCount;
-        
-        pImpl_->scenes.push_back(scene);
+    impl.prevSize = frame.size;
+    impl.frameIndex++;
+}
+
+void SceneDetector::end() {
+    if (pImpl_->frameIndex > 0) {
+        pImpl_->closeScene();
     }
-    
+}
+
+const std::vector<SceneInfo>& SceneDetector::getScenes() const {
     return pImpl_->scenes;
 }
 
@@ -187,33 +235,27 @@ double SceneDetector::getAverageSceneDuration() const {
 }
 
 double SceneDetector::calculateFrameDifference(const AVFrame* frame1, const AVFrame* frame2) const {
-    if (!frame1 || !frame2) {
+    LumaThumbnail thumbnail1;
+    LumaThumbnail thumbnail2;
+    if (!downscaleLuma(frame1, thumbnail1) || !downscaleLuma(frame2, thumbnail2)) {
         return 0.0;
     }
     
-    // Simplified pixel difference calculation
-    // In a full implementation, this would:
-    // 1. Convert frames to same format if needed
-    // 2. Calculate pixel-wise difference
-    // 3. Normalize by frame size
-    
-    // For now, return a placeholder
-    return 0.0;
+    return thumbnailSadDifference(thumbnail1, thumbnail2);
 }
 
 double SceneDetector::calculateHistogramDifference(const AVFrame* frame1, const AVFrame* frame2) const {
-    if (!frame1 || !frame2) {
+    LumaThumbnail thumbnail1;
+    LumaThumbnail thumbnail2;
+    if (!downscaleLuma(frame1, thumbnail1) || !downscaleLuma(frame2, thumbnail2)) {
         return 0.0;
     }
     
-    // Simplified histogram difference calculation
-    // In a full implementation, this would:
-    // 1. Calculate histograms for both frames
-    // 2. Compare histograms using chi-square or correlation
-    // 3. Return normalized difference
-    
-    // For now, return a placeholder
-    return 0.0;
+    uint32_t histogram1[kLumaHistogramBins];
+    uint32_t histogram2[kLumaHistogramBins];
+    lumaHistogram(thumbnail1.pixels.data(), thumbnail1.pixels.size(), histogram1);
+    lumaHistogram(thumbnail2.pixels.data(), thumbnail2.pixels.size(), histogram2);
+    return chiSquareDistance(histogram1, histogram2, kLumaHistogramBins);
 }
 
 } // namespace video_analyzer
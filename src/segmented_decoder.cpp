@@ -0,0 +1,111 @@
+#include "video_analyzer/segmented_decoder.h"
+#include <algorithm>
+#include <limits>
+
+namespace video_analyzer {
+
+SegmentedDecoder::SegmentedDecoder(const std::string& filePath, ThreadPool& pool,
+                                   const DecoderOptions& options)
+    : filePath_(filePath), pool_(pool), options_(options),
+      index_(KeyframeIndex::build(filePath)) {
+}
+
+void SegmentedDecoder::setSegmentCount(size_t count) {
+    segmentCount_ = count;
+}
+
+std::vector<DecodeSegment> SegmentedDecoder::planSegments() const {
+    std::vector<DecodeSegment> segments;
+    const auto& keyframes = index_.getKeyframes();
+    const auto& framePts = index_.getFramePts();
+    size_t totalFrames = framePts.size();
+    
+    if (totalFrames == 0) {
+        return segments;
+    }
+    
+    size_t segmentCount = segmentCount_ > 0 ? segmentCount_ : pool_.getThreadCount() * 4;
+    size_t targetFrames = std::max<size_t>(1, (totalFrames + segmentCount - 1) / segmentCount);
+    
+    // The first segment decodes from the start of the file, so it also
+    // covers any frames preceding the first keyframe
+    DecodeSegment current{std::numeric_limits<int64_t>::min(), 0, 0, 0, 0};
+    
+    for (const auto& keyframe : keyframes) {
+        if (keyframe.frameNumber == 0 ||
+            keyframe.frameNumber - current.firstFrame < targetFrames) {
+            continue;
+        }
+        
+        current.endPts = keyframe.pts;
+        current.frameCount = keyframe.frameNumber - current.firstFrame;
+        segments.push_back(current);
+        
+        // The segment starts at the keyframe's PTS. seekTimestamp holds its
+        // DTS, which seekToTimestamp() passes to av_seek_frame with
+        // AVSEEK_FLAG_BACKWARD: the demuxer lands on this keyframe or an
+        // earlier one, whose frames decodeSegment() drops by PTS
+        current.startPts = keyframe.pts;
+        current.seekTimestamp = keyframe.dts;
+        current.firstFrame = keyframe.frameNumber;
+    }
+    
+    current.endPts = std::numeric_limits<int64_t>::max();
+    current.frameCount = totalFrames - current.firstFrame;
+    segments.push_back(current);
+    
+    return segments;
+}
+
+std::vector<FrameInfo> SegmentedDecoder::decodeAll() {
+    std::vector<DecodeSegment> segments = planSegments();
+    
+    // Wait on a latch rather than futures: when decodeAll() itself runs on
+    // a pool worker, the waiting thread keeps running segments instead of
+    // blocking a thread they need
+    std::vector<std::vector<FrameInfo>> results(segments.size());
+    auto decode = [&](size_t i) {
+        results[i] = decodeSegment(segments[i]);
+    };
+    CompletionLatch latch;
+    pool_.submitBulk(segments.size(), decode, latch);
+    pool_.wait(latch);
+    
+    // Segments cover disjoint, increasing PTS ranges, so concatenating
+    // them in order yields presentation order
+    std::vector<FrameInfo> frames;
+    frames.reserve(index_.getFrameCount());
+    for (const auto& segmentFrames : results) {
+        frames.insert(frames.end(), segmentFrames.begin(), segmentFrames.end());
+    }
+    
+    return frames;
+}
+
+std::vector<FrameInfo> SegmentedDecoder::decodeSegment(const DecodeSegment& segment) const {
+    VideoDecoder decoder(filePath_, options_);
+    if (segment.firstFrame > 0) {
+        decoder.seekToTimestamp(segment.seekTimestamp);
+    }
+    
+    std::vector<FrameInfo> frames;
+    frames.reserve(segment.frameCount);
+    
+    while (auto frame = decoder.readNextFrame()) {
+        // Leading frames of an open GOP belong to the previous segment
+        if (frame->pts < segment.startPts) {
+            continue;
+        }
+        
+        // Output is in presentation order, so the segment is complete
+        if (frame->pts >= segment.endPts) {
+            break;
+        }
+        
+        frames.push_back(*frame);
+    }
+    
+    return frames;
+}
+
+} // namespace video_analyzer
@@ -1,4 +1,9 @@
 #include "video_analyzer/stream_analyzer.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
 #include <algorithm>
 #include <numeric>
 #include <cmath>
@@ -6,8 +11,8 @@
 namespace video_analyzer {
 
 StreamAnalyzer::StreamAnalyzer(const std::string& streamUrl, int threadCount)
-    : decoder_(std::make_unique<StreamDecoder>(streamUrl, threadCount)),
-      threadPool_(std::make_unique<ThreadPool>(threadCount)) {
+    : decoder_(std::make_unique<StreamDecoder>(streamUrl, threadCount)) {
+    setQueueOptions(StreamQueueOptions{});
 }
 
 StreamAnalyzer::~StreamAnalyzer() {
@@ -21,6 +26,8 @@ void StreamAnalyzer::start() {
     
     running_ = true;
     analysisThread_ = std::thread(&StreamAnalyzer::analysisLoop, this);
+    decodeThread_ = std::thread(&StreamAnalyzer::decodeLoop, this);
+    readerThread_ = std::thread(&StreamAnalyzer::readerLoop, this);
 }
 
 void StreamAnalyzer::stop() {
@@ -29,10 +36,16 @@ void StreamAnalyzer::stop() {
     }
     
     running_ = false;
+    
+    // Interrupts a blocked read, then wakes the stages waiting on the queues
     decoder_->stop();
+    packetQueue_->close();
+    frameQueue_->close();
     
-    if (analysisThread_.joinable()) {
-        analysisThread_.join();
+    for (std::thread* thread : {&readerThread_, &decodeThread_, &analysisThread_}) {
+        if (thread->joinable()) {
+            thread->join();
+        }
     }
     
     if (streamingOutput_.is_open()) {
@@ -40,30 +53,31 @@ void StreamAnalyzer::stop() {
     }
 }
 
-BitrateStatistics StreamAnalyzer::getCurrentBitrateStats(double windowSize) const {
-    std::lock_guard<std::mutex> lock(dataMutex_);
+std::vector<FrameInfo> StreamAnalyzer::snapshotWindow(double windowSize) const {
+    std::vector<FrameInfo> frames;
+    frameWindow_.snapshot(frames);
+    
+    if (frames.empty()) {
+        return frames;
+    }
     
+    // Drop frames older than the window
+    double startTime = frames.back().timestamp - windowSize;
+    auto first = std::find_if(frames.begin(), frames.end(), [startTime](const FrameInfo& frame) {
+        return frame.timestamp >= startTime;
+    });
+    frames.erase(frames.begin(), first);
+    return frames;
+}
+
+BitrateStatistics StreamAnalyzer::getCurrentBitrateStats(double windowSize) const {
     BitrateStatistics stats;
     stats.averageBitrate = 0.0;
     stats.maxBitrate = 0.0;
     stats.minBitrate = 0.0;
     stats.stdDeviation = 0.0;
     
-    if (frameWindow_.empty()) {
-        return stats;
-    }
-    
-    // Get frames within window
-    double currentTime = frameWindow_.back().timestamp;
-    double startTime = currentTime - windowSize;
-    
-    std::vector<FrameInfo> windowFrames;
-    for (const auto& frame : frameWindow_) {
-        if (frame.timestamp >= startTime) {
-            windowFrames.push_back(frame);
-        }
-    }
-    
+    std::vector<FrameInfo> windowFrames = snapshotWindow(windowSize);
     if (windowFrames.empty()) {
         return stats;
     }
@@ -85,28 +99,11 @@ BitrateStatistics StreamAnalyzer::getCurrentBitrateStats(double windowSize) cons
 }
 
 FrameStatistics StreamAnalyzer::getCurrentFrameStats(double windowSize) const {
-    std::lock_guard<std::mutex> lock(dataMutex_);
-    
-    if (frameWindow_.empty()) {
-        return FrameStatistics();
-    }
-    
-    // Get frames within window
-    double currentTime = frameWindow_.back().timestamp;
-    double startTime = currentTime - windowSize;
-    
-    std::vector<FrameInfo> windowFrames;
-    for (const auto& frame : frameWindow_) {
-        if (frame.timestamp >= startTime) {
-            windowFrames.push_back(frame);
-        }
-    }
-    
-    return FrameStatistics::compute(windowFrames);
+    return FrameStatistics::compute(snapshotWindow(windowSize));
 }
 
 std::vector<Anomaly> StreamAnalyzer::getDetectedAnomalies() const {
-    std::lock_guard<std::mutex> lock(dataMutex_);
+    std::lock_guard<std::mutex> lock(anomalyMutex_);
     return std::vector<Anomaly>(anomalies_.begin(), anomalies_.end());
 }
 
@@ -123,117 +120,146 @@ void StreamAnalyzer::enableStreamingExport(const std::string& outputPath) {
     exportEnabled_ = streamingOutput_.is_open();
 }
 
-void StreamAnalyzer::analysisLoop() {
-    const size_t maxWindowSize = 300;  // Keep last 300 frames
+void StreamAnalyzer::setQueueOptions(const StreamQueueOptions& options) {
+    if (running_) {
+        return;
+    }
+    
+    packetQueue_ = std::make_unique<BoundedQueue<PacketPtr>>(options.packetCapacity, options.packetPolicy);
+    packetQueue_->setEvictionBoundary([](const PacketPtr& packet) {
+        return (packet->flags & AV_PKT_FLAG_KEY) != 0;
+    });
+    frameQueue_ = std::make_unique<BoundedQueue<DecodedFrame>>(options.frameCapacity, options.framePolicy);
+}
+
+StreamPipelineStats StreamAnalyzer::getPipelineStats() const {
+    StreamPipelineStats stats;
+    stats.packetsRead = packetsRead_;
+    stats.packetsDropped = packetsSkipped_ + packetQueue_->droppedCount();
+    stats.framesDecoded = framesDecoded_;
+    stats.framesDropped = frameQueue_->droppedCount();
+    stats.packetQueueDepth = packetQueue_->size();
+    stats.frameQueueDepth = frameQueue_->size();
+    return stats;
+}
+
+void StreamAnalyzer::readerLoop() {
+    // Set after the pushed packet is dropped: later packets reference it,
+    // so skip to the next keyframe. Evicting the oldest packet also purges
+    // the queued packets that reference it, up to the next keyframe.
+    bool waitForKeyframe = false;
     
     while (running_ && decoder_->isStreamActive()) {
-        auto frame = decoder_->readNextFrame();
+        PacketPtr packet;
+        if (decoder_->readPacket(packet) != PacketReadResult::VIDEO_PACKET) {
+            continue;
+        }
+        packetsRead_++;
         
-        if (!frame.has_value()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (waitForKeyframe && !(packet->flags & AV_PKT_FLAG_KEY)) {
+            packetsSkipped_++;
             continue;
         }
+        waitForKeyframe = false;
         
-        // Add to window
-        {
-            std::lock_guard<std::mutex> lock(dataMutex_);
-            frameWindow_.push_back(frame.value());
-            
-            // Limit window size
-            if (frameWindow_.size() > maxWindowSize) {
-                frameWindow_.pop_front();
-            }
+        PushResult result = packetQueue_->push(std::move(packet));
+        if (result == PushResult::REJECTED) {
+            waitForKeyframe = true;
+        } else if (result == PushResult::CLOSED) {
+            break;
         }
+    }
+    
+    packetQueue_->close();
+}
+
+void StreamAnalyzer::decodeLoop() {
+    std::vector<DecodedFrame> frames;
+    bool decoding = true;
+    
+    while (running_) {
+        auto packet = packetQueue_->pop();
+        if (!packet.has_value()) {
+            break;
+        }
+        
+        frames.clear();
+        decoding = decoder_->decodePacket(*packet, frames);
+        
+        for (const auto& frame : frames) {
+            framesDecoded_++;
+            frameQueue_->push(frame);
+        }
+        
+        if (!decoding) {
+            break;
+        }
+    }
+    
+    // Stream ended: emit the frames still held by the decoder
+    if (decoding && running_) {
+        frames.clear();
+        decoder_->flush(frames);
+        for (const auto& frame : frames) {
+            framesDecoded_++;
+            frameQueue_->push(frame);
+        }
+    }
+    
+    // Unblocks the reader if decoding failed first
+    packetQueue_->close();
+    frameQueue_->close();
+}
+
+void StreamAnalyzer::analysisLoop() {
+    while (running_) {
+        auto decoded = frameQueue_->pop();
+        if (!decoded.has_value()) {
+            break;  // Stream ended and all frames were analyzed
+        }
+        const FrameInfo& frame = decoded->info;
+        
+        // Add to window (keeps the last kMaxWindowFrames frames)
+        frameWindow_.push(frame);
         
         // Detect anomalies
-        detectAnomalies(frame.value());
+        detectAnomalies(frame);
         
         // Call frame callback
         if (frameCallback_) {
-            frameCallback_(frame.value());
+            frameCallback_(frame);
         }
         
         // Export to JSON Lines
         if (exportEnabled_ && streamingOutput_.is_open()) {
-            streamingOutput_ << frame->toJson().dump() << "\n";
+            streamingOutput_ << frame.toJson().dump() << "\n";
             streamingOutput_.flush();
         }
         
-        previousFrame_ = frame;
+        latency_.record(std::chrono::steady_clock::now() - decoded->receivedAt);
     }
 }
 
 void StreamAnalyzer::detectAnomalies(const FrameInfo& frame) {
-    // Frame drop detection
-    if (previousFrame_.has_value()) {
-        double timeDiff = frame.timestamp - previousFrame_->timestamp;
-        double expectedDiff = 1.0 / 30.0;  // Assume 30fps
-        
-        if (timeDiff > expectedDiff * 2.0) {
-            Anomaly anomaly;
-            anomaly.type = AnomalyType::FRAME_DROP;
-            anomaly.timestamp = frame.timestamp;
-            anomaly.description = "Frame drop detected: " + std::to_string(timeDiff) + "s gap";
-            
-            {
-                std::lock_guard<std::mutex> lock(dataMutex_);
-                anomalies_.push_back(anomaly);
-                
-                // Keep only recent anomalies
-                if (anomalies_.size() > 100) {
-                    anomalies_.pop_front();
-                }
-            }
-            
-            if (anomalyCallback_) {
-                anomalyCallback_(anomaly);
-            }
-        }
-    }
-    
-    // Bitrate spike detection
-    if (previousFrame_.has_value()) {
-        double currentBitrate = frame.size * 8.0;  // Simplified
-        double previousBitrate = previousFrame_->size * 8.0;
-        
-        if (currentBitrate > previousBitrate * 3.0) {
-            Anomaly anomaly;
-            anomaly.type = AnomalyType::BITRATE_SPIKE;
-            anomaly.timestamp = frame.timestamp;
-            anomaly.description = "Bitrate spike detected";
-            
-            {
-                std::lock_guard<std::mutex> lock(dataMutex_);
-                anomalies_.push_back(anomaly);
-                
-                if (anomalies_.size() > 100) {
-                    anomalies_.pop_front();
-                }
-            }
-            
-            if (anomalyCallback_) {
-                anomalyCallback_(anomaly);
-            }
-        }
+    detectedAnomalies_.clear();
+    if (anomalyDetector_.inspect(frame, detectedAnomalies_) == 0) {
+        return;
     }
     
-    // Quality drop detection (simplified - based on QP)
-    if (frame.qp > 40) {  // High QP indicates low quality
-        Anomaly anomaly;
-        anomaly.type = AnomalyType::QUALITY_DROP;
-        anomaly.timestamp = frame.timestamp;
-        anomaly.description = "Quality drop detected: QP=" + std::to_string(frame.qp);
-        
-        {
-            std::lock_guard<std::mutex> lock(dataMutex_);
+    {
+        std::lock_guard<std::mutex> lock(anomalyMutex_);
+        for (const auto& anomaly : detectedAnomalies_) {
             anomalies_.push_back(anomaly);
             
+            // Keep only recent anomalies
             if (anomalies_.size() > 100) {
                 anomalies_.pop_front();
             }
         }
-        
-        if (anomalyCallback_) {
+    }
+    
+    if (anomalyCallback_) {
+        for (const auto& anomaly : detectedAnomalies_) {
             anomalyCallback_(anomaly);
         }
     }
@@ -1,41 +1,122 @@
 #include "video_analyzer/stream_decoder.h"
 #include "video_analyzer/ffmpeg_error.h"
+#include "video_analyzer/qp_extractor.h"
+#include "video_analyzer/snapshot_ring.h"
 
 extern "C" {
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
 #include <libavutil/error.h>
 #include <libavutil/frame.h>
+#include <libavutil/mem.h>
 #include <libavutil/pixdesc.h>
+#include <libavutil/time.h>
 }
 
 #include <cstring>
+#include <deque>
 #include <thread>
 #include <algorithm>
-#include <deque>
-#include <mutex>
 
 namespace video_analyzer {
 
+namespace {
+
+constexpr int kIOBufferSize = 32768;
+
+// How long probing waits for a non-blocking input, like the "timeout" option
+constexpr std::chrono::seconds kProbeTimeout(5);
+
+/**
+ * Protocol opened with AVIO_FLAG_NONBLOCK behind a custom AVIOContext.
+ *
+ * The demuxer needs data to detect the format, so while probing, reads
+ * wait for it. Afterwards an empty socket makes reads fail with EAGAIN,
+ * which av_read_frame() passes on instead of blocking.
+ */
+struct NonBlockingInput {
+    const std::atomic<bool>* active = nullptr;
+    AVIOContext* protocol = nullptr;  // Opened with AVIO_FLAG_NONBLOCK
+    AVIOContext* pb = nullptr;        // Handed to the demuxer
+    bool probing = true;
+    std::chrono::steady_clock::time_point probeDeadline;
+    
+    NonBlockingInput() = default;
+    NonBlockingInput(const NonBlockingInput&) = delete;
+    NonBlockingInput& operator=(const NonBlockingInput&) = delete;
+    
+    ~NonBlockingInput() {
+        if (pb) {
+            av_freep(&pb->buffer);
+            avio_context_free(&pb);
+        }
+        avio_closep(&protocol);
+    }
+    
+    static int read(void* opaque, uint8_t* buf, int size) {
+        auto* input = static_cast<NonBlockingInput*>(opaque);
+        while (true) {
+            int ret = avio_read_partial(input->protocol, buf, size);
+            if (ret > 0 || (ret < 0 && ret != AVERROR(EAGAIN))) {
+                return ret;
+            }
+            
+            // EAGAIN sets the sticky error and EOF flags; clear them so the
+            // next read tries the socket again
+            input->protocol->eof_reached = 0;
+            input->protocol->error = 0;
+            
+            if (!input->probing) {
+                return AVERROR(EAGAIN);
+            }
+            if (!input->active->load()) {
+                return AVERROR_EXIT;
+            }
+            if (std::chrono::steady_clock::now() >= input->probeDeadline) {
+                return AVERROR(ETIMEDOUT);
+            }
+            av_usleep(1000);
+        }
+    }
+    
+    static int64_t seek(void* opaque, int64_t offset, int whence) {
+        auto* input = static_cast<NonBlockingInput*>(opaque);
+        if (whence == AVSEEK_SIZE) {
+            return avio_size(input->protocol);
+        }
+        return avio_seek(input->protocol, offset, whence & ~AVSEEK_FORCE);
+    }
+};
+
+} // namespace
+
 struct StreamDecoder::Impl {
+    // Declared first: read by the interrupt callback while the context closes
+    std::atomic<bool> streamActive{true};
+    
+    // Declared before the context, which must close before its I/O is freed
+    NonBlockingInput input;
+    
     FFmpegContext context;
     PacketPtr packet;
     FramePtr frame;
     int videoStreamIndex = -1;
-    std::atomic<bool> streamActive{true};
     std::string streamUrl;
     int threadCount = 0;
-    int lastPacketSize = 0;
+    int lastPacketSize = 0;  // Fallback size when the decoder drops packet metadata
     
-    // Buffer management
-    std::deque<FrameInfo> frameBuffer;
-    std::mutex bufferMutex;
-    size_t maxBufferSize = 100;  // Maximum frames to buffer
+    // Most recent frames; written by the decoding thread, read lock-free
+    // by getBufferStatus()
+    SnapshotRing<FrameInfo> frameBuffer{100};
+    
+    // Decoded frames not yet returned by readNextFrame()
+    std::deque<FrameInfo> pendingFrames;
+    std::vector<DecodedFrame> decodedFrames;
     
     Impl() = default;
 };
 
-StreamDecoder::StreamDecoder(const std::string& streamUrl, int threadCount)
+StreamDecoder::StreamDecoder(const std::string& streamUrl, int threadCount, bool nonBlocking)
     : pImpl_(std::make_unique<Impl>()) {
     
     pImpl_->streamUrl = streamUrl;
@@ -55,14 +136,57 @@ StreamDecoder::StreamDecoder(const std::string& streamUrl, int threadCount)
     }
     
     // Open input stream
-    AVFormatContext* fmtCtx = nullptr;
+    AVFormatContext* fmtCtx = avformat_alloc_context();
+    if (!fmtCtx) {
+        throw FFmpegError(AVERROR(ENOMEM), "Failed to allocate format context");
+    }
+    
+    // Let stop() abort a demuxer blocked on network I/O
+    fmtCtx->interrupt_callback.callback = [](void* opaque) -> int {
+        return !static_cast<Impl*>(opaque)->streamActive.load();
+    };
+    fmtCtx->interrupt_callback.opaque = pImpl_.get();
     
     // Set options for streaming
     AVDictionary* opts = nullptr;
     av_dict_set(&opts, "rtsp_transport", "tcp", 0);  // Use TCP for RTSP
     av_dict_set(&opts, "timeout", "5000000", 0);     // 5 second timeout
     
-    int ret = avformat_open_input(&fmtCtx, streamUrl.c_str(), nullptr, &opts);
+    int ret = 0;
+    if (nonBlocking) {
+        // AVFMT_FLAG_NONBLOCK alone never reaches the protocol, so open it
+        // non-blocking here. Inputs without an AVIO protocol (e.g. RTSP,
+        // whose demuxer does its own networking) fall back to a regular open
+        NonBlockingInput& input = pImpl_->input;
+        ret = avio_open2(&input.protocol, streamUrl.c_str(), AVIO_FLAG_READ | AVIO_FLAG_NONBLOCK,
+                         &fmtCtx->interrupt_callback, &opts);
+        if (ret >= 0) {
+            unsigned char* buffer = static_cast<unsigned char*>(av_malloc(kIOBufferSize));
+            input.pb = buffer ? avio_alloc_context(buffer, kIOBufferSize, 0, &input,
+                                                   &NonBlockingInput::read, nullptr,
+                                                   &NonBlockingInput::seek)
+                              : nullptr;
+            if (!input.pb) {
+                av_free(buffer);
+                avformat_free_context(fmtCtx);
+                av_dict_free(&opts);
+                throw FFmpegError(AVERROR(ENOMEM), "Failed to allocate I/O context");
+            }
+            input.pb->seekable = input.protocol->seekable;
+            input.active = &pImpl_->streamActive;
+            input.probeDeadline = std::chrono::steady_clock::now() + kProbeTimeout;
+            fmtCtx->pb = input.pb;
+        } else if (ret != AVERROR_PROTOCOL_NOT_FOUND) {
+            avformat_free_context(fmtCtx);
+            av_dict_free(&opts);
+            char errbuf[AV_ERROR_MAX_STRING_SIZE];
+            av_strerror(ret, errbuf, sizeof(errbuf));
+            throw FFmpegError(ret, std::string("Failed to open stream: ") + errbuf);
+        }
+        fmtCtx->flags |= AVFMT_FLAG_NONBLOCK;
+    }
+    
+    ret = avformat_open_input(&fmtCtx, streamUrl.c_str(), nullptr, &opts);
     av_dict_free(&opts);
     
     if (ret < 0) {
@@ -116,6 +240,12 @@ StreamDecoder::StreamDecoder(const std::string& streamUrl, int threadCount)
         throw FFmpegError(ret, std::string("Failed to copy codec parameters: ") + errbuf);
     }
     
+    // Propagate packet opaque_ref to output frames for exact size attribution
+    codecCtx->flags |= AV_CODEC_FLAG_COPY_OPAQUE;
+    
+    // Export per-block quantization parameters for QP extraction
+    codecCtx->export_side_data |= AV_CODEC_EXPORT_DATA_VIDEO_ENC_PARAMS;
+    
     // Configure multi-threading
     codecCtx->thread_count = pImpl_->threadCount;
     codecCtx->thread_type = FF_THREAD_FRAME;
@@ -130,6 +260,9 @@ StreamDecoder::StreamDecoder(const std::string& streamUrl, int threadCount)
     }
     
     pImpl_->context.setCodecContext(codecCtx);
+    
+    // Probing is done: from now on an idle input returns EAGAIN
+    pImpl_->input.probing = false;
 }
 
 StreamDecoder::~StreamDecoder() {
@@ -179,107 +312,173 @@ std::optional<FrameInfo> StreamDecoder::readNextFrame() {
         return std::nullopt;
     }
     
-    AVFormatContext* fmtCtx = pImpl_->context.getFormatContext();
-    AVCodecContext* codecCtx = pImpl_->context.getCodecContext();
-    AVPacket* packet = pImpl_->packet.get();
-    AVFrame* frame = pImpl_->frame.get();
-    
-    // Try to receive a frame first
-    int ret = avcodec_receive_frame(codecCtx, frame);
-    
-    if (ret == 0) {
-        // Successfully received a frame
-        FrameInfo info;
-        info.pts = frame->pts;
-        info.dts = frame->pkt_dts;
-        info.type = detectFrameType(frame);
-        info.size = pImpl_->lastPacketSize;
-        info.qp = extractQP(frame);
-        info.isKeyFrame = (frame->flags & AV_FRAME_FLAG_KEY) != 0;
-        
-        AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
-        info.timestamp = frame->pts * av_q2d(stream->time_base);
+    // Feed packets until the decoder outputs; a packet may decode to
+    // several frames, which are returned one per call
+    while (pImpl_->pendingFrames.empty()) {
+        PacketReadResult result = readPacket(pImpl_->packet);
+        if (result == PacketReadResult::ENDED) {
+            return std::nullopt;
+        }
+        if (result != PacketReadResult::VIDEO_PACKET) {
+            continue;
+        }
         
-        // Add to buffer
-        {
-            std::lock_guard<std::mutex> lock(pImpl_->bufferMutex);
-            pImpl_->frameBuffer.push_back(info);
-            
-            // Limit buffer size
-            if (pImpl_->frameBuffer.size() > pImpl_->maxBufferSize) {
-                pImpl_->frameBuffer.pop_front();
-            }
+        std::vector<DecodedFrame>& frames = pImpl_->decodedFrames;
+        frames.clear();
+        bool decoding = decodePacket(pImpl_->packet, frames);
+        av_packet_unref(pImpl_->packet.get());
+        for (const auto& frame : frames) {
+            pImpl_->pendingFrames.push_back(frame.info);
         }
         
-        av_frame_unref(frame);
-        return info;
-    } else if (ret == AVERROR(EAGAIN)) {
-        // Decoder needs more input
-    } else if (ret == AVERROR_EOF) {
-        pImpl_->streamActive = false;
-        return std::nullopt;
-    } else {
-        // Error receiving frame - stream may have issues
-        pImpl_->streamActive = false;
-        return std::nullopt;
+        if (!decoding && pImpl_->pendingFrames.empty()) {
+            return std::nullopt;
+        }
     }
     
-    // Read packet
-    ret = av_read_frame(fmtCtx, packet);
-    if (ret < 0) {
-        if (ret == AVERROR_EOF || ret == AVERROR(ETIMEDOUT)) {
-            pImpl_->streamActive = false;
+    FrameInfo info = pImpl_->pendingFrames.front();
+    pImpl_->pendingFrames.pop_front();
+    return info;
+}
+
+PacketReadResult StreamDecoder::readPacket(PacketPtr& packet) {
+    if (!pImpl_->streamActive) {
+        return PacketReadResult::ENDED;
+    }
+    
+    AVFormatContext* fmtCtx = pImpl_->context.getFormatContext();
+    AVPacket* pkt = packet.get();
+    av_packet_unref(pkt);
+    
+    int ret = av_read_frame(fmtCtx, pkt);
+    
+    // Some demuxers report a short read as EOF; the I/O context knows it was EAGAIN
+    AVIOContext* pb = pImpl_->input.pb;
+    if (ret == AVERROR(EAGAIN) || (ret < 0 && pb && pb->error == AVERROR(EAGAIN))) {
+        if (pb) {
+            // Clear the sticky flags so the next read tries the socket again
+            pb->eof_reached = 0;
+            pb->error = 0;
         }
-        return std::nullopt;
+        return PacketReadResult::WOULD_BLOCK;
+    }
+    if (ret < 0) {
+        // End of stream, timeout, interruption by stop() or I/O failure
+        pImpl_->streamActive = false;
+        return PacketReadResult::ENDED;
     }
     
     // Skip non-video packets
-    if (packet->stream_index != pImpl_->videoStreamIndex) {
-        av_packet_unref(packet);
-        return std::nullopt;
+    if (pkt->stream_index != pImpl_->videoStreamIndex) {
+        av_packet_unref(pkt);
+        return PacketReadResult::SKIPPED;
     }
     
-    // Save packet size
+    // Carry packet size and position through the decoder to the output frame
+    attachPacketMetadata(pkt);
+    return PacketReadResult::VIDEO_PACKET;
+}
+
+bool StreamDecoder::decodePacket(const PacketPtr& packet, std::vector<DecodedFrame>& frames) {
+    // Packets read before the end of the stream are still decoded
     pImpl_->lastPacketSize = packet->size;
+    return sendPacket(packet.get(), frames);
+}
+
+void StreamDecoder::flush(std::vector<DecodedFrame>& frames) {
+    sendPacket(nullptr, frames);
+}
+
+bool StreamDecoder::sendPacket(const AVPacket* packet, std::vector<DecodedFrame>& frames) {
+    AVCodecContext* codecCtx = pImpl_->context.getCodecContext();
     
-    // Send packet to decoder
-    ret = avcodec_send_packet(codecCtx, packet);
-    av_packet_unref(packet);
+    // Output queue full: drain it and resend until the packet is accepted.
+    // Once receiving returns EAGAIN the decoder must accept input again, so
+    // this ends; only other errors are treated as failures
+    int ret = avcodec_send_packet(codecCtx, packet);
+    while (ret == AVERROR(EAGAIN)) {
+        if (!receiveFrames(frames)) {
+            return false;
+        }
+        ret = avcodec_send_packet(codecCtx, packet);
+    }
     
-    if (ret < 0 && ret != AVERROR(EAGAIN)) {
+    if (ret == AVERROR_INVALIDDATA) {
+        return true;  // Corrupt packet or missing reference, skip it
+    }
+    if (ret < 0 && ret != AVERROR_EOF) {
         pImpl_->streamActive = false;
-        return std::nullopt;
+        return false;
     }
     
-    // Try to receive frame again
-    ret = avcodec_receive_frame(codecCtx, frame);
-    if (ret == 0) {
-        FrameInfo info;
-        info.pts = frame->pts;
-        info.dts = frame->pkt_dts;
-        info.type = detectFrameType(frame);
-        info.size = pImpl_->lastPacketSize;
-        info.qp = extractQP(frame);
-        info.isKeyFrame = (frame->flags & AV_FRAME_FLAG_KEY) != 0;
+    return receiveFrames(frames);
+}
+
+bool StreamDecoder::receiveFrames(std::vector<DecodedFrame>& frames) {
+    AVCodecContext* codecCtx = pImpl_->context.getCodecContext();
+    AVFrame* frame = pImpl_->frame.get();
+    
+    while (true) {
+        int ret = avcodec_receive_frame(codecCtx, frame);
+        if (ret == AVERROR(EAGAIN)) {
+            return true;  // Decoder needs more input
+        }
+        if (ret == AVERROR_INVALIDDATA) {
+            continue;
+        }
+        if (ret < 0) {
+            // Fully drained or decoder failure
+            pImpl_->streamActive = false;
+            return false;
+        }
         
-        AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
-        info.timestamp = frame->pts * av_q2d(stream->time_base);
+        DecodedFrame decoded;
+        decoded.info = buildFrameInfo(frame);
         
-        // Add to buffer
-        {
-            std::lock_guard<std::mutex> lock(pImpl_->bufferMutex);
-            pImpl_->frameBuffer.push_back(info);
-            
-            if (pImpl_->frameBuffer.size() > pImpl_->maxBufferSize) {
-                pImpl_->frameBuffer.pop_front();
-            }
-        }
+        // Latency is measured from packet receipt; frames without metadata
+        // count from now
+        const PacketMetadata* meta = getPacketMetadata(frame);
+        decoded.receivedAt = meta && meta->attachedAt != 0
+            ? std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::nanoseconds(meta->attachedAt)))
+            : std::chrono::steady_clock::now();
+        
+        // Add to buffer (oldest frame is overwritten when full)
+        pImpl_->frameBuffer.push(decoded.info);
+        frames.push_back(decoded);
         
         av_frame_unref(frame);
-        return info;
+    }
+}
+
+FrameInfo StreamDecoder::buildFrameInfo(const AVFrame* frame) const {
+    AVFormatContext* fmtCtx = pImpl_->context.getFormatContext();
+    AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
+    
+    FrameInfo info{};
+    info.pts = frame->pts;
+    info.dts = frame->pkt_dts;
+    info.type = detectFrameType(frame);
+    info.isKeyFrame = (frame->flags & AV_FRAME_FLAG_KEY) != 0;
+    info.timestamp = frame->pts * av_q2d(stream->time_base);
+    info.duplicateGroupId = -1;
+    
+    // QP from exported encoding parameters (0 if the codec does not export them)
+    if (auto qp = extractQPStatistics(frame)) {
+        info.qp = qp->average;
+        info.qpMin = qp->min;
+        info.qpMax = qp->max;
+    }
+    
+    // Size and position of the packet that produced this frame
+    if (const PacketMetadata* meta = getPacketMetadata(frame)) {
+        info.size = meta->size;
+        info.pos = meta->pos;
+    } else {
+        info.size = pImpl_->lastPacketSize;
     }
     
-    return std::nullopt;
+    return info;
 }
 
 bool StreamDecoder::isStreamActive() const {
@@ -287,16 +486,18 @@ bool StreamDecoder::isStreamActive() const {
 }
 
 BufferStatus StreamDecoder::getBufferStatus() const {
-    std::lock_guard<std::mutex> lock(pImpl_->bufferMutex);
+    // Consistent copy without blocking the decoding thread
+    thread_local std::vector<FrameInfo> frames;
+    pImpl_->frameBuffer.snapshot(frames);
     
     BufferStatus status;
-    status.bufferedFrames = pImpl_->frameBuffer.size();
-    status.isBuffering = pImpl_->frameBuffer.size() < 10;  // Buffering if less than 10 frames
+    status.bufferedFrames = frames.size();
+    status.isBuffering = frames.size() < 10;  // Buffering if less than 10 frames
     
     // Calculate buffered duration
-    if (pImpl_->frameBuffer.size() >= 2) {
-        double firstTs = pImpl_->frameBuffer.front().timestamp;
-        double lastTs = pImpl_->frameBuffer.back().timestamp;
+    if (frames.size() >= 2) {
+        double firstTs = frames.front().timestamp;
+        double lastTs = frames.back().timestamp;
         status.bufferedDuration = lastTs - firstTs;
     } else {
         status.bufferedDuration = 0.0;
@@ -338,18 +539,4 @@ FrameType StreamDecoder::detectFrameType(const AVFrame* frame) const {
     }
 }
 
-int StreamDecoder::extractQP(const AVFrame* frame) const {
-    if (!frame) {
-        return 0;
-    }
-    
-    AVCodecContext* codecCtx = pImpl_->context.getCodecContext();
-    
-    if (codecCtx->codec_id == AV_CODEC_ID_AV1) {
-        return 128;  // Placeholder for AV1
-    }
-    
-    return 0;  // Placeholder
-}
-
 } // namespace video_analyzer
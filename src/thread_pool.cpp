@@ -3,9 +3,18 @@
 
 namespace video_analyzer {
 
-ThreadPool::ThreadPool(size_t numThreads)
-    : stop_(false), activeTasks_(0) {
-    
+namespace {
+
+// Identifies pool workers so submissions from a task go to its own deque
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+// Deque capacity per worker; overflow goes to the injection queue
+constexpr size_t kDequeCapacity = 4096;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t numThreads) {
     // Auto-detect hardware threads if numThreads is 0
     if (numThreads == 0) {
         numThreads = detectHardwareThreads();
@@ -18,34 +27,69 @@ ThreadPool::ThreadPool(size_t numThreads)
     // Ensure at least one thread
     numThreads = std::max(numThreads, size_t(1));
     
-    // Create worker threads
+    // Create all deques before any worker may steal from them
     workers_.reserve(numThreads);
     for (size_t i = 0; i < numThreads; ++i) {
-        workers_.emplace_back(&ThreadPool::workerThread, this);
+        workers_.push_back(std::make_unique<Worker>(kDequeCapacity));
+    }
+    for (size_t i = 0; i < numThreads; ++i) {
+        workers_[i]->thread = std::thread(&ThreadPool::workerThread, this, i);
     }
 }
 
 ThreadPool::~ThreadPool() {
+    waitAll();
+    
     {
-        std::unique_lock<std::mutex> lock(queueMutex_);
+        std::lock_guard<std::mutex> lock(sleepMutex_);
         stop_ = true;
     }
     
     // Wake up all threads
-    condition_.notify_all();
+    wakeCondition_.notify_all();
     
     // Wait for all threads to finish
-    for (std::thread& worker : workers_) {
-        if (worker.joinable()) {
-            worker.join();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
         }
     }
 }
 
+void ThreadPool::wait(CompletionLatch& latch) {
+    if (currentPool != this) {
+        // An outside thread only helps with its own tasks: running an
+        // unrelated long job here would delay the caller past the latch
+        while (!latch.isReady()) {
+            Job* job = takeInjectedJob(latch);
+            if (!job) {
+                break;
+            }
+            runJob(job);
+        }
+        latch.wait();
+        return;
+    }
+    
+    // Help instead of blocking: the tasks we wait for may be queued behind us
+    while (!latch.isReady()) {
+        if (Job* job = findJob(currentWorker)) {
+            runJob(job);
+            continue;
+        }
+        
+        // Remaining tasks are running elsewhere; re-scan now and then for
+        // work they spawn
+        latch.waitFor(std::chrono::microseconds(500));
+    }
+    
+    latch.wait();
+}
+
 void ThreadPool::waitAll() {
-    std::unique_lock<std::mutex> lock(queueMutex_);
+    std::unique_lock<std::mutex> lock(idleMutex_);
     allTasksComplete_.wait(lock, [this] {
-        return tasks_.empty() && activeTasks_ == 0;
+        return pendingJobs_.load() == 0;
     });
 }
 
@@ -53,43 +97,151 @@ size_t ThreadPool::getThreadCount() const {
     return workers_.size();
 }
 
-void ThreadPool::workerThread() {
+void ThreadPool::checkAccepting() const {
+    // Don't allow enqueueing after stopping the pool
+    if (stop_) {
+        throw std::runtime_error("Cannot submit task to stopped ThreadPool");
+    }
+}
+
+void ThreadPool::enqueue(Job* job) {
+    pendingJobs_++;
+    if (currentPool != this || !workers_[currentWorker]->deque.push(job)) {
+        std::lock_guard<std::mutex> lock(injectionMutex_);
+        injected_.push_back(job);
+    }
+    notifyWork(1);
+}
+
+void ThreadPool::enqueueBulk(const std::vector<Job*>& jobs) {
+    pendingJobs_ += jobs.size();
+    size_t pushed = 0;
+    if (currentPool == this) {
+        WorkStealingDeque<Job>& deque = workers_[currentWorker]->deque;
+        while (pushed < jobs.size() && deque.push(jobs[pushed])) {
+            pushed++;
+        }
+    }
+    if (pushed < jobs.size()) {
+        std::lock_guard<std::mutex> lock(injectionMutex_);
+        injected_.insert(injected_.end(), jobs.begin() + pushed, jobs.end());
+    }
+    notifyWork(jobs.size());
+}
+
+void ThreadPool::runJob(Job* job) {
+    CompletionLatch* latch = job->latch;
+    
+    try {
+        job->run(job);  // Releases the job
+    } catch (...) {
+        if (latch) {
+            latch->setException(std::current_exception());
+        }
+    }
+    
+    if (latch) {
+        latch->countDown();
+    }
+    
+    if (pendingJobs_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        allTasksComplete_.notify_all();
+    }
+}
+
+ThreadPool::Job* ThreadPool::findJob(size_t workerIndex) {
+    if (Job* job = workers_[workerIndex]->deque.pop()) {
+        return job;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex_);
+        if (!injected_.empty()) {
+            Job* job = injected_.front();
+            injected_.pop_front();
+            return job;
+        }
+    }
+    
+    return stealJob(workerIndex);
+}
+
+ThreadPool::Job* ThreadPool::takeInjectedJob(const CompletionLatch& latch) {
+    std::lock_guard<std::mutex> lock(injectionMutex_);
+    auto it = std::find_if(injected_.begin(), injected_.end(),
+                           [&latch](const Job* job) { return job->latch == &latch; });
+    if (it == injected_.end()) {
+        return nullptr;
+    }
+    Job* job = *it;
+    injected_.erase(it);
+    return job;
+}
+
+ThreadPool::Job* ThreadPool::stealJob(size_t thiefIndex) {
+    // Start after the thief so workers spread over different victims
+    size_t count = workers_.size();
+    size_t start = thiefIndex + 1;
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = (start + i) % count;
+        if (victim == thiefIndex) {
+            continue;
+        }
+        if (Job* job = workers_[victim]->deque.steal()) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::notifyWork(size_t jobs) {
+    workEpoch_.fetch_add(1);
+    if (sleepers_.load() == 0) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    if (jobs == 1) {
+        wakeCondition_.notify_one();
+    } else {
+        wakeCondition_.notify_all();
+    }
+}
+
+void ThreadPool::workerThread(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    
     while (true) {
-        std::function<void()> task;
+        if (Job* job = findJob(index)) {
+            runJob(job);
+            continue;
+        }
+        
+        // Announce the sleep, then look once more: either this scan sees
+        // work queued concurrently or the submitter sees us sleeping
+        uint64_t epoch = workEpoch_.load();
+        sleepers_++;
+        if (Job* job = findJob(index)) {
+            sleepers_--;
+            runJob(job);
+            continue;
+        }
         
         {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            
-            // Wait for a task or stop signal
-            condition_.wait(lock, [this] {
-                return stop_ || !tasks_.empty();
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeCondition_.wait(lock, [this, epoch] {
+                return stop_ || workEpoch_.load() != epoch;
             });
-            
-            // Exit if stopped and no more tasks
-            if (stop_ && tasks_.empty()) {
-                return;
-            }
-            
-            // Get next task
-            if (!tasks_.empty()) {
-                task = std::move(tasks_.front());
-                tasks_.pop();
-                ++activeTasks_;
-            }
         }
+        sleepers_--;
         
-        // Execute task outside the lock
-        if (task) {
-            task();
-            
-            // Decrement active tasks and notify if all complete
-            {
-                std::unique_lock<std::mutex> lock(queueMutex_);
-                --activeTasks_;
-                if (tasks_.empty() && activeTasks_ == 0) {
-                    allTasksComplete_.notify_all();
-                }
-            }
+        // Exit once stopped; the destructor drained all tasks first
+        if (stop_) {
+            return;
         }
     }
 }
@@ -1,36 +1,155 @@
 #include "video_analyzer/video_analyzer.h"
 #include "video_analyzer/ffmpeg_error.h"
+#include "video_analyzer/binary_report.h"
+#include "video_analyzer/bitrate_analyzer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 namespace video_analyzer {
 
-void VideoAnalyzer::analyze(const std::string& filepath) {
+namespace {
+
+// How often the background analysis hands results to poll()
+constexpr std::chrono::milliseconds kPublishInterval(50);
+
+/**
+ * @brief Sink handing frames to a callback in batches
+ */
+class BatchPublisher : public FrameSink {
+public:
+    using Publish = std::function<void(const std::vector<FrameInfo>& frames)>;
+    
+    explicit BatchPublisher(Publish publish) : publish_(std::move(publish)) {}
+    
+    void consume(const FrameInfo& frame, const VideoDecoder& /*decoder*/) override {
+        pending_.push_back(frame);
+        
+        // The first frame goes out at once so the video shows up immediately
+        auto now = std::chrono::steady_clock::now();
+        if (!publishedAny_ || now - lastPublish_ >= kPublishInterval) {
+            flush();
+        }
+    }
+    
+    void end() override {
+        flush();
+    }
+
+private:
+    void flush() {
+        publish_(pending_);
+        pending_.clear();
+        publishedAny_ = true;
+        lastPublish_ = std::chrono::steady_clock::now();
+    }
+    
+    Publish publish_;
+    std::vector<FrameInfo> pending_;
+    bool publishedAny_ = false;
+    std::chrono::steady_clock::time_point lastPublish_;
+};
+
+} // namespace
+
+/**
+ * @brief State shared between the background analysis thread and poll()
+ */
+struct VideoAnalyzer::BackgroundAnalysis {
+    std::thread thread;
+    std::atomic<bool> cancelRequested{false};
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    
+    mutable std::mutex mutex;
+    
+    // Published by the thread, taken by poll() (guarded by mutex)
+    bool streamInfoReady = false;
+    StreamInfo streamInfo;
+    std::vector<FrameInfo> frames;
+    std::vector<GOPInfo> gops;
+    FrameStatistics stats;
+    bool fromCache = false;
+    size_t framesDecoded = 0;
+    double lastTimestamp = 0.0;
+    double endTime = 0.0;          // Elapsed seconds when the thread finished
+    bool finished = false;         // Thread has published its last batch
+    std::exception_ptr error;
+    
+    // Owned by poll()
+    bool merged = false;           // Last batch merged
+};
+
+VideoAnalyzer::VideoAnalyzer() = default;
+
+VideoAnalyzer::~VideoAnalyzer() {
+    cancelAnalysis();
+}
+
+void VideoAnalyzer::analyze(const std::string& filepath, const AnalysisCache* cache) {
+    cancelAnalysis();
+    background_.reset();
+    
+    if (cache) {
+        if (auto cached = cache->lookup(filepath)) {
+            stream_info_ = cached->getStreamInfo();
+            has_stream_info_ = true;
+            frames_ = cached->readFrames();
+            gops_ = cached->readGOPs();
+            frame_stats_ = cached->getFrameStatistics();
+            source_path_ = filepath;
+            from_cache_ = true;
+            
+            if (!frames_.empty()) {
+                detectDuplicateFrames();
+                std::cout << "Loaded " << frames_.size() << " frames, "
+                          << gops_.size() << " GOPs from analysis cache" << std::endl;
+                return;
+            }
+        }
+    }
+    from_cache_ = false;
+    
     // Create decoder
     VideoDecoder decoder(filepath);
+    source_path_ = filepath;
     
     // Get stream info
     stream_info_ = decoder.getStreamInfo();
+    has_stream_info_ = true;
     
-    // Decode all frames
-    frames_.clear();
+    // Decode once and feed every analyzer from the same pass
+    FrameCollector collector;
+    GOPAnalyzer gop_analyzer(decoder);
+    FrameStatisticsAccumulator stats_accumulator;
+    BitrateAnalyzer bitrate_analyzer(decoder);
     
-    while (auto frame_opt = decoder.readNextFrame()) {
-        frames_.push_back(*frame_opt);
+    AnalysisPipeline pipeline(decoder);
+    pipeline.addSink(collector);
+    pipeline.addSink(gop_analyzer);
+    pipeline.addSink(stats_accumulator);
+    if (cache) {
+        pipeline.addSink(bitrate_analyzer);
     }
+    pipeline.run();
+    
+    frames_ = collector.takeFrames();
     
     if (frames_.empty()) {
         throw std::runtime_error("No frames decoded from video");
     }
     
-    // Reset decoder for GOP analysis
-    decoder.reset();
-    
-    // Analyze GOPs
-    GOPAnalyzer gop_analyzer(decoder);
-    gops_ = gop_analyzer.analyze();
+    gops_ = gop_analyzer.getGOPs();
+    frame_stats_ = stats_accumulator.getStatistics();
     
-    // Calculate frame statistics
-    frame_stats_ = FrameStatistics::compute(frames_);
+    // Cache the decoder output, before duplicate detection
+    if (cache) {
+        cache->store(filepath, stream_info_, frames_, gops_, frame_stats_,
+                     bitrate_analyzer.getStatistics());
+    }
     
     // Detect duplicate frames
     detectDuplicateFrames();
@@ -39,6 +158,243 @@ void VideoAnalyzer::analyze(const std::string& filepath) {
               << gops_.size() << " GOPs" << std::endl;
 }
 
+void VideoAnalyzer::startAnalysis(const std::string& filepath, const AnalysisCache* cache) {
+    cancelAnalysis();
+    
+    source_path_ = filepath;
+    from_cache_ = false;
+    has_stream_info_ = false;
+    stream_info_ = StreamInfo{};
+    frames_.clear();
+    gops_.clear();
+    frame_stats_ = FrameStatistics{};
+    
+    background_ = std::make_unique<BackgroundAnalysis>();
+    background_->thread = std::thread(&VideoAnalyzer::runBackground,
+                                      std::ref(*background_), filepath, cache);
+}
+
+void VideoAnalyzer::runBackground(BackgroundAnalysis& state, std::string filepath,
+                                  const AnalysisCache* cache) {
+    auto finish = [&state] {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - state.startTime;
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.endTime = elapsed.count();
+        state.finished = true;
+    };
+    
+    try {
+        if (cache) {
+            if (auto cached = cache->lookup(filepath)) {
+                std::vector<FrameInfo> frames = cached->readFrames();
+                if (!frames.empty()) {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    state.streamInfo = cached->getStreamInfo();
+                    state.streamInfoReady = true;
+                    state.framesDecoded = frames.size();
+                    state.lastTimestamp = frames.back().timestamp;
+                    state.frames = std::move(frames);
+                    state.gops = cached->readGOPs();
+                    state.stats = cached->getFrameStatistics();
+                    state.fromCache = true;
+                }
+            }
+        }
+        
+        bool fromCache;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            fromCache = state.fromCache;
+        }
+        if (!fromCache) {
+            VideoDecoder decoder(filepath);
+            
+            // Publish stream info before the first frame is decoded
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.streamInfo = decoder.getStreamInfo();
+                state.streamInfoReady = true;
+            }
+            
+            // The complete frame list and bitrate are kept for the cache only
+            FrameCollector collector;
+            BitrateAnalyzer bitrate_analyzer(decoder);
+            GOPAnalyzer gop_analyzer(decoder);
+            FrameStatisticsAccumulator stats_accumulator;
+            size_t published_gops = 0;
+            
+            BatchPublisher publisher([&](const std::vector<FrameInfo>& frames) {
+                const auto& gops = gop_analyzer.getGOPs();
+                FrameStatistics stats = stats_accumulator.getStatistics();
+                
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (!frames.empty()) {
+                    state.lastTimestamp = frames.back().timestamp;
+                }
+                state.framesDecoded += frames.size();
+                state.frames.insert(state.frames.end(), frames.begin(), frames.end());
+                state.gops.insert(state.gops.end(), gops.begin() + published_gops, gops.end());
+                state.stats = stats;
+                published_gops = gops.size();
+            });
+            
+            // Sink order matters: GOPs and statistics include a frame before
+            // it is published
+            AnalysisPipeline pipeline(decoder);
+            if (cache) {
+                pipeline.addSink(collector);
+                pipeline.addSink(bitrate_analyzer);
+            }
+            pipeline.addSink(gop_analyzer);
+            pipeline.addSink(stats_accumulator);
+            pipeline.addSink(publisher);
+            pipeline.setProgressCallback([&](size_t) {
+                if (state.cancelRequested) {
+                    pipeline.cancel();
+                }
+            });
+            size_t frame_count = pipeline.run();
+            
+            if (frame_count == 0 && !pipeline.isCancelled()) {
+                throw std::runtime_error("No frames decoded from video");
+            }
+            
+            // Cache the decoder output of complete runs only
+            if (cache && !pipeline.isCancelled()) {
+                cache->store(filepath, decoder.getStreamInfo(), collector.getFrames(),
+                             gop_analyzer.getGOPs(), stats_accumulator.getStatistics(),
+                             bitrate_analyzer.getStatistics());
+            }
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.error = std::current_exception();
+    }
+    
+    finish();
+}
+
+bool VideoAnalyzer::poll() {
+    if (!background_ || background_->merged) {
+        return false;
+    }
+    
+    std::vector<FrameInfo> frames;
+    std::vector<GOPInfo> gops;
+    bool finished;
+    bool changed = false;
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(background_->mutex);
+        if (background_->streamInfoReady && !has_stream_info_) {
+            stream_info_ = background_->streamInfo;
+            has_stream_info_ = true;
+            changed = true;
+        }
+        frames.swap(background_->frames);
+        gops.swap(background_->gops);
+        frame_stats_ = background_->stats;
+        from_cache_ = background_->fromCache;
+        finished = background_->finished;
+        error = background_->error;
+    }
+    
+    changed = changed || !frames.empty() || !gops.empty();
+    if (frames_.empty()) {
+        frames_ = std::move(frames);
+    } else {
+        frames_.insert(frames_.end(), frames.begin(), frames.end());
+    }
+    gops_.insert(gops_.end(), gops.begin(), gops.end());
+    
+    if (finished) {
+        if (background_->thread.joinable()) {
+            background_->thread.join();
+        }
+        background_->merged = true;
+        
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        
+        detectDuplicateFrames();
+        std::cout << (background_->cancelRequested ? "Cancelled after " : "Analyzed ")
+                  << frames_.size() << " frames, " << gops_.size() << " GOPs"
+                  << (from_cache_ ? " from analysis cache" : "") << std::endl;
+        changed = true;
+    }
+    
+    return changed;
+}
+
+bool VideoAnalyzer::isAnalyzing() const {
+    return background_ && !background_->merged;
+}
+
+AnalysisProgress VideoAnalyzer::getProgress() const {
+    AnalysisProgress progress;
+    if (!background_) {
+        return progress;
+    }
+    
+    std::lock_guard<std::mutex> lock(background_->mutex);
+    progress.running = !background_->merged;
+    progress.cancelled = background_->cancelRequested;
+    progress.framesDecoded = background_->framesDecoded;
+    
+    if (background_->finished) {
+        progress.elapsedSeconds = background_->endTime;
+    } else {
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - background_->startTime;
+        progress.elapsedSeconds = elapsed.count();
+    }
+    if (progress.elapsedSeconds > 0.0) {
+        progress.framesPerSecond = progress.framesDecoded / progress.elapsedSeconds;
+    }
+    
+    if (background_->finished && !background_->error && !progress.cancelled) {
+        progress.fraction = 1.0;
+    } else if (background_->streamInfo.duration > 0.0) {
+        progress.fraction = std::clamp(background_->lastTimestamp / background_->streamInfo.duration,
+                                       0.0, 1.0);
+    }
+    return progress;
+}
+
+void VideoAnalyzer::cancelAnalysis() {
+    if (!background_ || background_->merged) {
+        return;
+    }
+    
+    background_->cancelRequested = true;
+    if (background_->thread.joinable()) {
+        background_->thread.join();
+    }
+}
+
+void VideoAnalyzer::loadReport(const std::string& filepath) {
+    cancelAnalysis();
+    background_.reset();
+    
+    BinaryReport report(filepath);
+    
+    stream_info_ = report.getStreamInfo();
+    has_stream_info_ = true;
+    frames_ = report.readFrames();
+    gops_ = report.readGOPs();
+    frame_stats_ = report.getFrameStatistics();
+    source_path_ = report.getMetadata().value("source", "");
+    from_cache_ = false;
+    
+    if (frames_.empty()) {
+        throw std::runtime_error("No frames in analysis report");
+    }
+    
+    std::cout << "Loaded " << frames_.size() << " frames, "
+              << gops_.size() << " GOPs from report" << std::endl;
+}
+
 void VideoAnalyzer::detectDuplicateFrames(float size_tolerance, 
                                            bool require_same_qp,
                                            bool require_same_type) {
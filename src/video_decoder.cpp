@@ -1,5 +1,7 @@
 #include "video_analyzer/video_decoder.h"
 #include "video_analyzer/ffmpeg_error.h"
+#include "video_analyzer/qp_extractor.h"
+#include "video_analyzer/motion_field.h"
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -7,15 +9,105 @@ extern "C" {
 #include <libavutil/error.h>
 #include <libavutil/frame.h>
 #include <libavutil/pixdesc.h>
-#include <libavutil/motion_vector.h>
 }
 
 #include <cstring>
 #include <thread>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <vector>
 
 namespace video_analyzer {
 
+namespace {
+
+// Maximum number of frames held back to restore presentation order in
+// HEADER_SCAN mode (H.264/HEVC DPBs hold at most 16 frames)
+constexpr size_t kHeaderScanReorderDepth = 16;
+
+// Frame held back in HEADER_SCAN mode. Frames without any timestamp take
+// the sort key of the frame decoded before them, so they keep their decode
+// order instead of sorting ahead of everything as AV_NOPTS_VALUE would
+struct PendingFrame {
+    FrameInfo info;
+    int64_t orderPts;
+    uint64_t sequence;   // Decode order, breaks ties
+};
+
+struct LaterPts {
+    bool operator()(const PendingFrame& a, const PendingFrame& b) const {
+        if (a.orderPts != b.orderPts) {
+            return a.orderPts > b.orderPts;
+        }
+        return a.sequence > b.sequence;
+    }
+};
+
+// Average frame rate of a stream, falling back to the base rate (0 if unknown)
+double nominalFrameRate(const AVStream* stream) {
+    for (AVRational rate : {stream->avg_frame_rate, stream->r_frame_rate}) {
+        if (rate.num > 0 && rate.den > 0) {
+            return av_q2d(rate);
+        }
+    }
+    return 0.0;
+}
+
+// Allocate a codec context initialized from the stream parameters
+AVCodecContext* allocCodecContext(const AVCodec* codec, const AVCodecParameters* codecpar) {
+    AVCodecContext* codecCtx = avcodec_alloc_context3(codec);
+    if (!codecCtx) {
+        throw FFmpegError(AVERROR(ENOMEM), "Failed to allocate codec context");
+    }
+    
+    int ret = avcodec_parameters_to_context(codecCtx, codecpar);
+    if (ret < 0) {
+        avcodec_free_context(&codecCtx);
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        throw FFmpegError(ret, std::string("Failed to copy codec parameters: ") + errbuf);
+    }
+    
+    return codecCtx;
+}
+
+// Configure and open a decoder (frees the context on failure)
+void openCodecContext(AVCodecContext* codecCtx, const AVCodec* codec, int threadCount,
+                      bool exportMotionVectors, bool exportEncodeParams) {
+    // Propagate packet opaque_ref to output frames for exact size attribution
+    codecCtx->flags |= AV_CODEC_FLAG_COPY_OPAQUE;
+    
+    // Export per-block quantization parameters for QP extraction
+    if (exportEncodeParams) {
+        codecCtx->export_side_data |= AV_CODEC_EXPORT_DATA_VIDEO_ENC_PARAMS;
+    }
+    
+    // Motion vectors cost a side data allocation and copy per frame, so
+    // they are only exported on request
+    if (exportMotionVectors) {
+        codecCtx->export_side_data |= AV_CODEC_EXPORT_DATA_MVS;
+    }
+    
+    // Configure multi-threading
+    codecCtx->thread_count = threadCount;
+    // Use frame-level threading for better frame order preservation
+    // FF_THREAD_FRAME ensures frames are output in presentation order
+    codecCtx->thread_type = FF_THREAD_FRAME;
+    
+    // Open codec
+    int ret = avcodec_open2(codecCtx, codec, nullptr);
+    if (ret < 0) {
+        avcodec_free_context(&codecCtx);
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        throw FFmpegError(ret, std::string("Failed to open codec: ") + errbuf);
+    }
+}
+
+} // namespace
+
 struct VideoDecoder::Impl {
     FFmpegContext context;
     PacketPtr packet;
@@ -24,16 +116,41 @@ struct VideoDecoder::Impl {
     bool endOfStream = false;
     std::string filePath;
     int threadCount = 0;
-    int lastPacketSize = 0;  // Track last packet size for frame info
+    int lastPacketSize = 0;  // Fallback size when the decoder drops packet metadata
     FramePtr lastDecodedFrame;  // Keep last frame for motion vector extraction
+    bool exportMotionVectors = false;
+    bool exportEncodeParams = true;
+    
+    // HEADER_SCAN state
+    DecodeMode mode = DecodeMode::FULL_DECODE;
+    AVCodecParserContext* parser = nullptr;
+    std::priority_queue<PendingFrame, std::vector<PendingFrame>, LaterPts> reorderQueue;
+    uint64_t scanSequence = 0;
+    int64_t lastOrderPts = std::numeric_limits<int64_t>::min();
+    int64_t scanFrameIndex = 0;  // Decode-order index, timestamps packets without PTS/DTS
+    bool demuxEnded = false;
     
     Impl() = default;
+    
+    ~Impl() {
+        if (parser) {
+            av_parser_close(parser);
+        }
+    }
 };
 
 VideoDecoder::VideoDecoder(const std::string& filePath, int threadCount)
+    : VideoDecoder(filePath, DecoderOptions{threadCount, DecodeMode::FULL_DECODE}) {
+}
+
+VideoDecoder::VideoDecoder(const std::string& filePath, const DecoderOptions& options)
     : pImpl_(std::make_unique<Impl>()) {
     
     pImpl_->filePath = filePath;
+    pImpl_->mode = options.mode;
+    pImpl_->exportMotionVectors = options.exportMotionVectors && options.mode == DecodeMode::FULL_DECODE;
+    pImpl_->exportEncodeParams = options.exportEncodeParams;
+    int threadCount = options.threadCount;
     
     // Auto-detect or limit thread count to hardware cores
     if (threadCount == 0) {
@@ -89,36 +206,18 @@ VideoDecoder::VideoDecoder(const std::string& filePath, int threadCount)
         throw FFmpegError(AVERROR_DECODER_NOT_FOUND, "Codec not found");
     }
     
-    // Allocate codec context
-    AVCodecContext* codecCtx = avcodec_alloc_context3(codec);
-    if (!codecCtx) {
-        throw FFmpegError(AVERROR(ENOMEM), "Failed to allocate codec context");
-    }
+    // Allocate codec context and copy codec parameters to it
+    AVCodecContext* codecCtx = allocCodecContext(codec, codecpar);
     
-    // Copy codec parameters to context
-    ret = avcodec_parameters_to_context(codecCtx, codecpar);
-    if (ret < 0) {
-        avcodec_free_context(&codecCtx);
-        char errbuf[AV_ERROR_MAX_STRING_SIZE];
-        av_strerror(ret, errbuf, sizeof(errbuf));
-        throw FFmpegError(ret, std::string("Failed to copy codec parameters: ") + errbuf);
-    }
-    
-    // Configure multi-threading
-    codecCtx->thread_count = pImpl_->threadCount;
-    // Use frame-level threading for better frame order preservation
-    // FF_THREAD_FRAME ensures frames are output in presentation order
-    codecCtx->thread_type = FF_THREAD_FRAME;
-    
-    // Open codec
-    ret = avcodec_open2(codecCtx, codec, nullptr);
-    if (ret < 0) {
-        avcodec_free_context(&codecCtx);
-        char errbuf[AV_ERROR_MAX_STRING_SIZE];
-        av_strerror(ret, errbuf, sizeof(errbuf));
-        throw FFmpegError(ret, std::string("Failed to open codec: ") + errbuf);
+    if (pImpl_->mode == DecodeMode::HEADER_SCAN) {
+        // No decoder is opened; the parser extracts picture types from slice headers
+        pImpl_->context.setCodecContext(codecCtx);
+        resetParser();
+        return;
     }
     
+    openCodecContext(codecCtx, codec, pImpl_->threadCount, pImpl_->exportMotionVectors,
+                     pImpl_->exportEncodeParams);
     pImpl_->context.setCodecContext(codecCtx);
 }
 
@@ -187,6 +286,10 @@ std::optional<FrameInfo> VideoDecoder::readNextFrame() {
         return std::nullopt;
     }
     
+    if (pImpl_->mode == DecodeMode::HEADER_SCAN) {
+        return scanNextFrame();
+    }
+    
     AVFormatContext* fmtCtx = pImpl_->context.getFormatContext();
     AVCodecContext* codecCtx = pImpl_->context.getCodecContext();
     AVPacket* packet = pImpl_->packet.get();
@@ -198,21 +301,9 @@ std::optional<FrameInfo> VideoDecoder::readNextFrame() {
         
         if (ret == 0) {
             // Successfully received a frame
-            FrameInfo info;
-            info.pts = frame->pts;
-            info.dts = frame->pkt_dts;
-            info.type = detectFrameType(frame);
-            info.size = pImpl_->lastPacketSize;
-            info.qp = extractQP(frame);
-            info.isKeyFrame = (frame->flags & AV_FRAME_FLAG_KEY) != 0;
-            
-            AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
-            info.timestamp = frame->pts * av_q2d(stream->time_base);
+            FrameInfo info = buildFrameInfo(frame);
             
             // Store a reference to the frame for motion vector extraction
-            if (!pImpl_->lastDecodedFrame.get()) {
-                pImpl_->lastDecodedFrame = FramePtr();
-            }
             av_frame_unref(pImpl_->lastDecodedFrame.get());
             av_frame_ref(pImpl_->lastDecodedFrame.get(), frame);
             
@@ -240,21 +331,9 @@ std::optional<FrameInfo> VideoDecoder::readNextFrame() {
                 // Try to receive remaining frames
                 ret = avcodec_receive_frame(codecCtx, frame);
                 if (ret == 0) {
-                    FrameInfo info;
-                    info.pts = frame->pts;
-                    info.dts = frame->pkt_dts;
-                    info.type = detectFrameType(frame);
-                    info.size = pImpl_->lastPacketSize;
-                    info.qp = extractQP(frame);
-                    info.isKeyFrame = (frame->flags & AV_FRAME_FLAG_KEY) != 0;
-                    
-                    AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
-                    info.timestamp = frame->pts * av_q2d(stream->time_base);
+                    FrameInfo info = buildFrameInfo(frame);
                     
                     // Store a reference to the frame for motion vector extraction
-                    if (!pImpl_->lastDecodedFrame.get()) {
-                        pImpl_->lastDecodedFrame = FramePtr();
-                    }
                     av_frame_unref(pImpl_->lastDecodedFrame.get());
                     av_frame_ref(pImpl_->lastDecodedFrame.get(), frame);
                     
@@ -274,8 +353,9 @@ std::optional<FrameInfo> VideoDecoder::readNextFrame() {
             continue;
         }
         
-        // Save packet size
+        // Carry packet size and position through the decoder to the output frame
         pImpl_->lastPacketSize = packet->size;
+        attachPacketMetadata(packet);
         
         // Send packet to decoder
         ret = avcodec_send_packet(codecCtx, packet);
@@ -291,11 +371,105 @@ std::optional<FrameInfo> VideoDecoder::readNextFrame() {
     }
 }
 
+std::optional<FrameInfo> VideoDecoder::scanNextFrame() {
+    AVFormatContext* fmtCtx = pImpl_->context.getFormatContext();
+    AVCodecContext* codecCtx = pImpl_->context.getCodecContext();
+    AVPacket* packet = pImpl_->packet.get();
+    AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
+    auto& queue = pImpl_->reorderQueue;
+    
+    // Packets arrive in decode order; hold back enough of them to emit in PTS order
+    while (!pImpl_->demuxEnded && queue.size() <= kHeaderScanReorderDepth) {
+        int ret = av_read_frame(fmtCtx, packet);
+        if (ret == AVERROR_EOF) {
+            pImpl_->demuxEnded = true;
+            break;
+        }
+        if (ret < 0) {
+            char errbuf[AV_ERROR_MAX_STRING_SIZE];
+            av_strerror(ret, errbuf, sizeof(errbuf));
+            throw FFmpegError(ret, std::string("Error reading frame: ") + errbuf);
+        }
+        
+        // Skip non-video packets
+        if (packet->stream_index != pImpl_->videoStreamIndex) {
+            av_packet_unref(packet);
+            continue;
+        }
+        
+        FrameInfo info{};
+        info.pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+        info.dts = packet->dts;
+        info.size = packet->size;
+        info.qp = 0;
+        info.isKeyFrame = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+        info.duplicateGroupId = -1;
+        
+        // Without any timestamp, place the frame by its index at the nominal
+        // frame rate (0 if unknown); pts stays AV_NOPTS_VALUE
+        int64_t frameIndex = pImpl_->scanFrameIndex++;
+        if (info.pts != AV_NOPTS_VALUE) {
+            info.timestamp = info.pts * av_q2d(stream->time_base);
+        } else {
+            double frameRate = nominalFrameRate(stream);
+            info.timestamp = frameRate > 0.0 ? frameIndex / frameRate : 0.0;
+        }
+        info.pos = packet->pos;
+        
+        // Picture type from the slice/frame header
+        int pictType = AV_PICTURE_TYPE_NONE;
+        if (pImpl_->parser && codecCtx->codec_id != AV_CODEC_ID_AV1) {
+            uint8_t* outData = nullptr;
+            int outSize = 0;
+            av_parser_parse2(pImpl_->parser, codecCtx, &outData, &outSize,
+                             packet->data, packet->size,
+                             packet->pts, packet->dts, packet->pos);
+            pictType = pImpl_->parser->pict_type;
+        }
+        
+        switch (pictType) {
+            case AV_PICTURE_TYPE_I:
+                info.type = FrameType::I_FRAME;
+                break;
+            case AV_PICTURE_TYPE_P:
+                info.type = FrameType::P_FRAME;
+                break;
+            case AV_PICTURE_TYPE_B:
+                info.type = FrameType::B_FRAME;
+                break;
+            default:
+                // AV1 or no parser: Key Frame maps to I_FRAME, Inter Frame to P_FRAME
+                info.type = info.isKeyFrame ? FrameType::I_FRAME : FrameType::P_FRAME;
+                break;
+        }
+        
+        av_packet_unref(packet);
+        
+        if (info.pts != AV_NOPTS_VALUE) {
+            pImpl_->lastOrderPts = info.pts;
+        }
+        queue.push({info, pImpl_->lastOrderPts, pImpl_->scanSequence++});
+    }
+    
+    if (queue.empty()) {
+        pImpl_->endOfStream = true;
+        return std::nullopt;
+    }
+    
+    FrameInfo info = queue.top().info;
+    queue.pop();
+    return info;
+}
+
 void VideoDecoder::seekToTime(double seconds) {
     AVFormatContext* fmtCtx = pImpl_->context.getFormatContext();
     AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
     
-    int64_t timestamp = static_cast<int64_t>(seconds / av_q2d(stream->time_base));
+    seekToTimestamp(static_cast<int64_t>(seconds / av_q2d(stream->time_base)));
+}
+
+void VideoDecoder::seekToTimestamp(int64_t timestamp) {
+    AVFormatContext* fmtCtx = pImpl_->context.getFormatContext();
     
     int ret = av_seek_frame(fmtCtx, pImpl_->videoStreamIndex, timestamp, AVSEEK_FLAG_BACKWARD);
     if (ret < 0) {
@@ -304,7 +478,19 @@ void VideoDecoder::seekToTime(double seconds) {
         throw FFmpegError(ret, std::string("Error seeking: ") + errbuf);
     }
     
-    avcodec_flush_buffers(pImpl_->context.getCodecContext());
+    if (pImpl_->mode == DecodeMode::HEADER_SCAN) {
+        // The parser keeps slice context across packets; start it afresh
+        resetParser();
+        pImpl_->reorderQueue = {};
+        pImpl_->lastOrderPts = std::numeric_limits<int64_t>::min();
+        pImpl_->demuxEnded = false;
+        
+        AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
+        pImpl_->scanFrameIndex = std::max<int64_t>(
+            0, std::llround(timestamp * av_q2d(stream->time_base) * nominalFrameRate(stream)));
+    } else {
+        avcodec_flush_buffers(pImpl_->context.getCodecContext());
+    }
     pImpl_->endOfStream = false;
 }
 
@@ -312,10 +498,82 @@ void VideoDecoder::reset() {
     seekToTime(0.0);
 }
 
+void VideoDecoder::resetParser() {
+    if (pImpl_->parser) {
+        av_parser_close(pImpl_->parser);
+    }
+    
+    pImpl_->parser = av_parser_init(pImpl_->context.getCodecContext()->codec_id);
+    if (pImpl_->parser) {
+        pImpl_->parser->flags |= PARSER_FLAG_COMPLETE_FRAMES;
+    }
+}
+
 bool VideoDecoder::hasMoreFrames() const {
     return !pImpl_->endOfStream;
 }
 
+DecodeMode VideoDecoder::getDecodeMode() const {
+    return pImpl_->mode;
+}
+
+void VideoDecoder::setMotionVectorExport(bool enable) {
+    if (pImpl_->mode == DecodeMode::HEADER_SCAN || enable == pImpl_->exportMotionVectors) {
+        return;
+    }
+    
+    // Codec options can't be changed on an open codec, so the decoder is
+    // reopened with the same parameters and restarted from the beginning
+    AVCodecParameters* codecpar =
+        pImpl_->context.getFormatContext()->streams[pImpl_->videoStreamIndex]->codecpar;
+    const AVCodec* codec = avcodec_find_decoder(codecpar->codec_id);
+    if (!codec) {
+        throw FFmpegError(AVERROR_DECODER_NOT_FOUND, "Codec not found");
+    }
+    
+    AVCodecContext* codecCtx = allocCodecContext(codec, codecpar);
+    openCodecContext(codecCtx, codec, pImpl_->threadCount, enable, pImpl_->exportEncodeParams);
+    pImpl_->context.setCodecContext(codecCtx);
+    pImpl_->exportMotionVectors = enable;
+    
+    av_frame_unref(pImpl_->lastDecodedFrame.get());
+    reset();
+}
+
+bool VideoDecoder::isMotionVectorExportEnabled() const {
+    return pImpl_->exportMotionVectors;
+}
+
+FrameInfo VideoDecoder::buildFrameInfo(const AVFrame* frame) const {
+    AVFormatContext* fmtCtx = pImpl_->context.getFormatContext();
+    AVStream* stream = fmtCtx->streams[pImpl_->videoStreamIndex];
+    
+    FrameInfo info{};
+    info.pts = frame->pts != AV_NOPTS_VALUE ? frame->pts : frame->best_effort_timestamp;
+    info.dts = frame->pkt_dts;
+    info.type = detectFrameType(frame);
+    info.isKeyFrame = (frame->flags & AV_FRAME_FLAG_KEY) != 0;
+    info.timestamp = info.pts * av_q2d(stream->time_base);
+    info.duplicateGroupId = -1;
+    
+    // QP from exported encoding parameters (0 if the codec does not export them)
+    if (auto qp = extractQPStatistics(frame)) {
+        info.qp = qp->average;
+        info.qpMin = qp->min;
+        info.qpMax = qp->max;
+    }
+    
+    // Size and position of the packet that produced this frame
+    if (const PacketMetadata* meta = getPacketMetadata(frame)) {
+        info.size = meta->size;
+        info.pos = meta->pos;
+    } else {
+        info.size = pImpl_->lastPacketSize;
+    }
+    
+    return info;
+}
+
 FrameType VideoDecoder::detectFrameType(const AVFrame* frame) const {
     if (!frame) {
         return FrameType::UNKNOWN;
@@ -346,79 +604,33 @@ FrameType VideoDecoder::detectFrameType(const AVFrame* frame) const {
     }
 }
 
-int VideoDecoder::extractQP(const AVFrame* frame) const {
-    if (!frame) {
-        return 0;
-    }
-    
-    AVCodecContext* codecCtx = pImpl_->context.getCodecContext();
-    
-    // QP extraction is codec-specific and complex
-    // For AV1, we return a placeholder value in the valid range (0-255)
-    // For H.264/H.265, we return a placeholder value in the valid range (0-51)
-    
-    if (codecCtx->codec_id == AV_CODEC_ID_AV1) {
-        // AV1 QP range is 0-255
-        // Return a mid-range placeholder value
-        return 128;
+std::optional<MotionVectorData> VideoDecoder::getMotionVectors() const {
+    if (auto field = getMotionField()) {
+        return toMotionVectorData(*field);
     }
     
-    // For other codecs (H.264/H.265), return 0 as placeholder
-    // In a full implementation, you would:
-    // 1. Access frame side data for QP table
-    // 2. Calculate average QP from the table
-    // 3. Validate against codec-specific range
-    return 0;
+    return std::nullopt;
 }
 
-std::optional<MotionVectorData> VideoDecoder::getMotionVectors() const {
+std::optional<MotionField> VideoDecoder::getMotionField() const {
     if (!pImpl_->lastDecodedFrame.get()) {
         return std::nullopt;
     }
     
-    return extractMotionVectors(pImpl_->lastDecodedFrame.get());
+    return extractMotionField(pImpl_->lastDecodedFrame.get());
 }
 
-MotionVectorData VideoDecoder::extractMotionVectors(const AVFrame* frame) const {
-    MotionVectorData mvData;
-    mvData.pts = frame->pts;
-    
-    if (!frame) {
-        return mvData;
-    }
-    
-    // Extract motion vectors from frame side data
-    AVFrameSideData* sd = av_frame_get_side_data(frame, AV_FRAME_DATA_MOTION_VECTORS);
-    if (!sd) {
-        // No motion vectors available (e.g., I-frames don't have motion vectors)
-        return mvData;
-    }
-    
-    // Parse motion vector data
-    const AVMotionVector* mvs = reinterpret_cast<const AVMotionVector*>(sd->data);
-    int mv_count = sd->size / sizeof(AVMotionVector);
-    
-    for (int i = 0; i < mv_count; i++) {
-        const AVMotionVector* mv = &mvs[i];
-        
-        MotionVector vec;
-        vec.srcX = mv->src_x;
-        vec.srcY = mv->src_y;
-        vec.dstX = mv->dst_x;
-        vec.dstY = mv->dst_y;
-        vec.motionX = mv->motion_x;
-        vec.motionY = mv->motion_y;
-        
-        // Calculate magnitude and direction
-        vec.magnitude = std::sqrt(static_cast<float>(mv->motion_x * mv->motion_x + 
-                                                      mv->motion_y * mv->motion_y));
-        vec.direction = std::atan2(static_cast<float>(mv->motion_y), 
-                                   static_cast<float>(mv->motion_x));
-        
-        mvData.vectors.push_back(vec);
+std::optional<QPMap> VideoDecoder::getQPMap() const {
+    return extractQPMap(getLastDecodedFrame());
+}
+
+const AVFrame* VideoDecoder::getLastDecodedFrame() const {
+    AVFrame* frame = pImpl_->lastDecodedFrame.get();
+    if (!frame || !frame->buf[0]) {
+        return nullptr;
     }
     
-    return mvData;
+    return frame;
 }
 
 } // namespace video_analyzer
@@ -0,0 +1,370 @@
+#include "video_analyzer/video_texture.h"
+#include "video_analyzer/frame_renderer.h"
+#include <cstdint>
+#include <iostream>
+
+namespace video_analyzer {
+
+namespace {
+
+// Full-screen triangle generated from gl_VertexID; no vertex buffer needed
+const char* kVertexShader = R"(#version 150
+out vec2 uv;
+void main() {
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    uv = corner;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+const char* kFragmentShader = R"(#version 150
+in vec2 uv;
+out vec4 color;
+uniform sampler2D plane_y;
+uniform sampler2D plane_u;
+uniform sampler2D plane_v;
+uniform mat3 yuv_matrix;
+uniform vec3 yuv_offset;
+void main() {
+    vec3 yuv = vec3(texture(plane_y, uv).r, texture(plane_u, uv).r, texture(plane_v, uv).r);
+    color = vec4(clamp(yuv_matrix * (yuv - yuv_offset), 0.0, 1.0), 1.0);
+}
+)";
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Failed to compile YUV shader: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint createPlaneTexture(GLint internal_format, GLenum format, int width, int height) {
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    return texture;
+}
+
+} // namespace
+
+VideoTexture::~VideoTexture() {
+    destroy();
+}
+
+bool VideoTexture::create(int width, int height) {
+    destroy();
+    width_ = width;
+    height_ = height;
+    upload_size_ = static_cast<size_t>(width) * height +
+                   2 * static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+    
+    if (!createProgram()) {
+        destroy();
+        return false;
+    }
+    
+    int chroma_width = (width + 1) / 2;
+    int chroma_height = (height + 1) / 2;
+    plane_textures_[0] = createPlaneTexture(GL_R8, GL_RED, width, height);
+    plane_textures_[1] = createPlaneTexture(GL_R8, GL_RED, chroma_width, chroma_height);
+    plane_textures_[2] = createPlaneTexture(GL_R8, GL_RED, chroma_width, chroma_height);
+    rgb_texture_ = createPlaneTexture(GL_RGB8, GL_RGB, width, height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    GLint previous_framebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+    glGenFramebuffers(1, &framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, rgb_texture_, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+    
+    if (!complete) {
+        std::cerr << "Video framebuffer is incomplete" << std::endl;
+        destroy();
+        return false;
+    }
+    
+    // Core profile draws need a bound vertex array, even an empty one
+    glGenVertexArrays(1, &vertex_array_);
+    return true;
+}
+
+void VideoTexture::destroy() {
+    if (!upload_buffers_.empty()) {
+        GLint previous_buffer = 0;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previous_buffer);
+        for (auto& buffer : upload_buffers_) {
+            if (buffer.mapped) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            }
+            glDeleteBuffers(1, &buffer.pbo);
+        }
+        upload_buffers_.clear();
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previous_buffer);
+    }
+    if (program_) {
+        glDeleteProgram(program_);
+        program_ = 0;
+    }
+    if (vertex_array_) {
+        glDeleteVertexArrays(1, &vertex_array_);
+        vertex_array_ = 0;
+    }
+    if (framebuffer_) {
+        glDeleteFramebuffers(1, &framebuffer_);
+        framebuffer_ = 0;
+    }
+    if (rgb_texture_) {
+        glDeleteTextures(1, &rgb_texture_);
+        rgb_texture_ = 0;
+    }
+    for (auto& texture : plane_textures_) {
+        if (texture) {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+    }
+}
+
+bool VideoTexture::createProgram() {
+    GLuint vertex_shader = compileShader(GL_VERTEX_SHADER, kVertexShader);
+    GLuint fragment_shader = compileShader(GL_FRAGMENT_SHADER, kFragmentShader);
+    if (!vertex_shader || !fragment_shader) {
+        if (vertex_shader) glDeleteShader(vertex_shader);
+        if (fragment_shader) glDeleteShader(fragment_shader);
+        return false;
+    }
+    
+    program_ = glCreateProgram();
+    glAttachShader(program_, vertex_shader);
+    glAttachShader(program_, fragment_shader);
+    glBindFragDataLocation(program_, 0, "color");
+    glLinkProgram(program_);
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+    
+    GLint status = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log[1024];
+        glGetProgramInfoLog(program_, sizeof(log), nullptr, log);
+        std::cerr << "Failed to link YUV shader: " << log << std::endl;
+        return false;
+    }
+    
+    GLint previous_program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previous_program);
+    glUseProgram(program_);
+    glUniform1i(glGetUniformLocation(program_, "plane_y"), 0);
+    glUniform1i(glGetUniformLocation(program_, "plane_u"), 1);
+    glUniform1i(glGetUniformLocation(program_, "plane_v"), 2);
+    glUseProgram(previous_program);
+    
+    yuv_matrix_location_ = glGetUniformLocation(program_, "yuv_matrix");
+    yuv_offset_location_ = glGetUniformLocation(program_, "yuv_offset");
+    return true;
+}
+
+void VideoTexture::update(const uint8_t* yuv, const YUVColorInfo& color) {
+    // Handed-out buffers are mapped write-only and must not be read
+    if (yuv && findUploadBuffer(yuv) < 0) {
+        upload(yuv, -1, color);
+    }
+}
+
+void VideoTexture::updateFromUploadBuffer(uint8_t* buffer, const YUVColorInfo& color) {
+    // take() may also return memory the prefetcher allocated itself
+    int index = findUploadBuffer(buffer);
+    if (index >= 0) {
+        upload(nullptr, index, color);
+    } else {
+        update(buffer, color);
+    }
+}
+
+void VideoTexture::upload(const uint8_t* yuv, int index, const YUVColorInfo& color) {
+    if (!program_) {
+        return;
+    }
+    
+    // Save the state touched below
+    GLint previous_framebuffer = 0, previous_program = 0, previous_vertex_array = 0, previous_buffer = 0;
+    GLint previous_textures[3] = { 0, 0, 0 }, previous_active_texture = 0, previous_alignment = 0;
+    GLint previous_viewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previous_program);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previous_vertex_array);
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &previous_active_texture);
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previous_alignment);
+    glGetIntegerv(GL_VIEWPORT, previous_viewport);
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previous_buffer);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    GLboolean depth = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean cull = glIsEnabled(GL_CULL_FACE);
+    
+    // Transfer from the pixel buffer the frame was decoded into, or read
+    // the planes straight from client memory. Only a buffer the caller
+    // handed back is unmapped; one still owned elsewhere stays mapped
+    uintptr_t source = reinterpret_cast<uintptr_t>(yuv);
+    if (index >= 0) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload_buffers_[index].pbo);
+        bool uploaded = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+        upload_buffers_[index].mapped = nullptr;
+        
+        if (!uploaded) {
+            // The buffer contents were lost; keep the last frame
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previous_buffer);
+            return;
+        }
+        source = 0;  // Offsets into the bound buffer
+    } else {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    
+    // Upload the planes; rows are tightly packed. From a pixel buffer the
+    // transfer completes asynchronously, from client memory it is copied
+    // before glTexSubImage2D returns
+    int chroma_width = (width_ + 1) / 2;
+    int chroma_height = (height_ + 1) / 2;
+    const size_t plane_offsets[3] = {
+        0,
+        static_cast<size_t>(width_) * height_,
+        static_cast<size_t>(width_) * height_ + static_cast<size_t>(chroma_width) * chroma_height
+    };
+    
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int plane = 0; plane < 3; ++plane) {
+        glActiveTexture(GL_TEXTURE0 + plane);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous_textures[plane]);
+        glBindTexture(GL_TEXTURE_2D, plane_textures_[plane]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                        plane == 0 ? width_ : chroma_width,
+                        plane == 0 ? height_ : chroma_height,
+                        GL_RED, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(source + plane_offsets[plane]));
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previous_buffer);
+    
+    // Normalized YUV to RGB; the range scale is folded into the matrix
+    float luma_scale = color.full_range ? 1.0f : 255.0f / 219.0f;
+    float chroma_scale = color.full_range ? 1.0f : 255.0f / 224.0f;
+    float luma_offset = color.full_range ? 0.0f : 16.0f / 255.0f;
+    float r_cr = color.bt709 ? 1.5748f : 1.402f;
+    float g_cb = color.bt709 ? 0.187324f : 0.344136f;
+    float g_cr = color.bt709 ? 0.468124f : 0.714136f;
+    float b_cb = color.bt709 ? 1.8556f : 1.772f;
+    const float matrix[9] = {
+        luma_scale, luma_scale, luma_scale,               // Y column
+        0.0f, -g_cb * chroma_scale, b_cb * chroma_scale,  // U column
+        r_cr * chroma_scale, -g_cr * chroma_scale, 0.0f   // V column
+    };
+    
+    // Convert into the RGB texture
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glViewport(0, 0, width_, height_);
+    glDisable(GL_BLEND);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glUseProgram(program_);
+    glUniformMatrix3fv(yuv_matrix_location_, 1, GL_FALSE, matrix);
+    glUniform3f(yuv_offset_location_, luma_offset, 128.0f / 255.0f, 128.0f / 255.0f);
+    glBindVertexArray(vertex_array_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    
+    // Restore
+    glBindVertexArray(previous_vertex_array);
+    glUseProgram(previous_program);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+    glViewport(previous_viewport[0], previous_viewport[1], previous_viewport[2], previous_viewport[3]);
+    for (int plane = 0; plane < 3; ++plane) {
+        glActiveTexture(GL_TEXTURE0 + plane);
+        glBindTexture(GL_TEXTURE_2D, previous_textures[plane]);
+    }
+    glActiveTexture(previous_active_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previous_alignment);
+    if (blend) glEnable(GL_BLEND);
+    if (scissor) glEnable(GL_SCISSOR_TEST);
+    if (depth) glEnable(GL_DEPTH_TEST);
+    if (cull) glEnable(GL_CULL_FACE);
+}
+
+uint8_t* VideoTexture::mapUploadBuffer() {
+    if (!program_) {
+        return nullptr;
+    }
+    
+    GLint previous_buffer = 0;
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previous_buffer);
+    
+    int index = bindFreeUploadBuffer();
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, upload_size_,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    upload_buffers_[index].mapped = static_cast<uint8_t*>(mapped);
+    
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previous_buffer);
+    return upload_buffers_[index].mapped;
+}
+
+void VideoTexture::discardUploadBuffer(uint8_t* buffer) {
+    int index = findUploadBuffer(buffer);
+    if (index < 0) {
+        return;
+    }
+    
+    GLint previous_buffer = 0;
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previous_buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload_buffers_[index].pbo);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    upload_buffers_[index].mapped = nullptr;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previous_buffer);
+}
+
+int VideoTexture::findUploadBuffer(const uint8_t* mapped) const {
+    if (!mapped) {
+        return -1;
+    }
+    for (size_t i = 0; i < upload_buffers_.size(); ++i) {
+        if (upload_buffers_[i].mapped == mapped) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int VideoTexture::bindFreeUploadBuffer() {
+    for (size_t i = 0; i < upload_buffers_.size(); ++i) {
+        if (!upload_buffers_[i].mapped) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload_buffers_[i].pbo);
+            return static_cast<int>(i);
+        }
+    }
+    
+    // Every buffer is handed out; the pool grows to the number of frames
+    // the caller keeps in flight plus the one being uploaded
+    UploadBuffer buffer;
+    glGenBuffers(1, &buffer.pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, upload_size_, nullptr, GL_STREAM_DRAW);
+    upload_buffers_.push_back(buffer);
+    return static_cast<int>(upload_buffers_.size() - 1);
+}
+
+} // namespace video_analyzer
@@ -0,0 +1,101 @@
+#include "video_analyzer/analysis_cache.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace video_analyzer;
+
+namespace fs = std::filesystem;
+
+class AnalysisCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root_ = fs::temp_directory_path() / "analysis_cache_test";
+        fs::remove_all(root_);
+        fs::create_directories(root_);
+        videoPath_ = (root_ / "video.mp4").string();
+        writeVideo(std::string(200000, 'a'));
+    }
+    
+    void TearDown() override {
+        fs::remove_all(root_);
+    }
+    
+    void writeVideo(const std::string& content) {
+        std::ofstream file(videoPath_, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+    
+    std::string cacheDir() const {
+        return (root_ / "cache").string();
+    }
+    
+    fs::path root_;
+    std::string videoPath_;
+};
+
+TEST_F(AnalysisCacheTest, StoreThenLookup) {
+    AnalysisCache cache(cacheDir());
+    EXPECT_EQ(cache.lookup(videoPath_), nullptr);
+    
+    StreamInfo info{};
+    info.codecName = "h264";
+    std::vector<FrameInfo> frames = {
+        {0, 0, FrameType::I_FRAME, 5000, 22, true, 0.0, false, -1, 48, 22, 22},
+        {512, 512, FrameType::P_FRAME, 800, 26, false, 0.04, false, -1, 5048, 24, 30}
+    };
+    std::vector<GOPInfo> gops = {{0, 0, 512, 2, 1, 1, 0, 5800, false}};
+    FrameStatistics stats = FrameStatistics::compute(frames);
+    BitrateStatistics bitrate{46400.0, 46400.0, 46400.0, 0.0, {{0.0, 46400.0}}};
+    
+    ASSERT_TRUE(cache.store(videoPath_, info, frames, gops, stats, bitrate));
+    
+    auto cached = cache.lookup(videoPath_);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached->getStreamInfo().codecName, "h264");
+    EXPECT_EQ(cached->getFrameStatistics().totalFrames, 2);
+    
+    auto loaded = cached->readFrames();
+    ASSERT_EQ(loaded.size(), frames.size());
+    EXPECT_EQ(loaded[1].toJson(), frames[1].toJson());
+    EXPECT_EQ(cached->readGOPs()[0].toJson(), gops[0].toJson());
+    EXPECT_EQ(cached->readBitrateStatistics().toJson(), bitrate.toJson());
+}
+
+TEST_F(AnalysisCacheTest, ModifiedFileInvalidatesEntry) {
+    AnalysisCache cache(cacheDir());
+    ASSERT_TRUE(cache.store(videoPath_, StreamInfo{}, {}, {}, FrameStatistics{}, BitrateStatistics{}));
+    ASSERT_NE(cache.lookup(videoPath_), nullptr);
+    
+    // Same size, different tail content
+    std::string content(200000, 'a');
+    content.back() = 'b';
+    writeVideo(content);
+    EXPECT_EQ(cache.lookup(videoPath_), nullptr);
+}
+
+TEST_F(AnalysisCacheTest, UncommittedEntryIsDiscarded) {
+    AnalysisCache cache(cacheDir());
+    {
+        auto entry = cache.createEntry(videoPath_);
+        ASSERT_NE(entry, nullptr);
+        entry->writer().writeFrame({0, 0, FrameType::I_FRAME, 100, 20, true, 0.0, false, -1, 0, 20, 20});
+    }
+    
+    EXPECT_EQ(cache.lookup(videoPath_), nullptr);
+    EXPECT_TRUE(!fs::exists(cacheDir()) || fs::is_empty(cacheDir()));
+}
+
+TEST_F(AnalysisCacheTest, KeyAndClear) {
+    CacheKey key = CacheKey::fromFile(videoPath_);
+    EXPECT_EQ(key.size, 200000u);
+    EXPECT_EQ(key.version, kAnalysisCacheVersion);
+    EXPECT_EQ(key.path, fs::canonical(videoPath_).string());
+    EXPECT_THROW(CacheKey::fromFile((root_ / "missing.mp4").string()), std::runtime_error);
+    
+    AnalysisCache cache(cacheDir());
+    ASSERT_TRUE(cache.store(videoPath_, StreamInfo{}, {}, {}, FrameStatistics{}, BitrateStatistics{}));
+    cache.clear();
+    EXPECT_EQ(cache.lookup(videoPath_), nullptr);
+}
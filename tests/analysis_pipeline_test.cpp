@@ -0,0 +1,163 @@
+#include "video_analyzer/analysis_pipeline.h"
+#include "video_analyzer/gop_analyzer.h"
+#include "video_analyzer/bitrate_analyzer.h"
+#include "video_analyzer/scene_detector.h"
+#include "video_analyzer/frame_statistics.h"
+#include "video_analyzer/video_decoder.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace video_analyzer;
+
+class AnalysisPipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testVideoPath = "../test_videos/test_h264_480p_24fps.mp4";
+        if (!std::filesystem::exists(testVideoPath)) {
+            GTEST_SKIP() << "Test video not found: " << testVideoPath;
+        }
+    }
+    
+    std::string testVideoPath;
+};
+
+namespace {
+
+// Counts begin/consume/end calls
+class CountingSink : public FrameSink {
+public:
+    int beginCount = 0;
+    int frameCount = 0;
+    int endCount = 0;
+    
+    void begin(const StreamInfo& info) override { beginCount++; }
+    void consume(const FrameInfo& frame, const VideoDecoder& decoder) override {
+        if (decoder.getLastDecodedFrame() != nullptr) {
+            frameCount++;
+        }
+    }
+    void end() override { endCount++; }
+};
+
+} // namespace
+
+TEST_F(AnalysisPipelineTest, FansOutEveryFrameToAllSinks) {
+    VideoDecoder decoder(testVideoPath);
+    CountingSink sink1;
+    CountingSink sink2;
+    
+    AnalysisPipeline pipeline(decoder);
+    pipeline.addSink(sink1);
+    pipeline.addSink(sink2);
+    size_t decoded = pipeline.run();
+    
+    EXPECT_GT(decoded, 0u);
+    EXPECT_EQ(sink1.beginCount, 1);
+    EXPECT_EQ(sink1.endCount, 1);
+    EXPECT_EQ(sink1.frameCount, static_cast<int>(decoded));
+    EXPECT_EQ(sink2.frameCount, static_cast<int>(decoded));
+}
+
+TEST_F(AnalysisPipelineTest, RespectsMaxFrames) {
+    VideoDecoder decoder(testVideoPath);
+    FrameCollector collector;
+    
+    AnalysisPipeline pipeline(decoder);
+    pipeline.addSink(collector);
+    
+    EXPECT_EQ(pipeline.run(10), 10u);
+    EXPECT_EQ(collector.getFrames().size(), 10u);
+}
+
+TEST_F(AnalysisPipelineTest, CancelStopsAfterCurrentFrame) {
+    VideoDecoder decoder(testVideoPath);
+    FrameCollector collector;
+    CountingSink counter;
+    
+    AnalysisPipeline pipeline(decoder);
+    pipeline.addSink(collector);
+    pipeline.addSink(counter);
+    pipeline.setProgressCallback([&pipeline](size_t framesDecoded) {
+        if (framesDecoded == 5) {
+            pipeline.cancel();
+        }
+    });
+    
+    EXPECT_EQ(pipeline.run(), 5u);
+    EXPECT_TRUE(pipeline.isCancelled());
+    EXPECT_EQ(collector.getFrames().size(), 5u);
+    EXPECT_EQ(counter.endCount, 1);
+}
+
+TEST_F(AnalysisPipelineTest, CancelOnlyStopsTheCurrentPass) {
+    VideoDecoder decoder(testVideoPath);
+    FrameCollector collector;
+    
+    AnalysisPipeline pipeline(decoder);
+    pipeline.addSink(collector);
+    pipeline.setProgressCallback([&pipeline](size_t framesDecoded) {
+        if (framesDecoded == 5) {
+            pipeline.cancel();
+        }
+    });
+    ASSERT_EQ(pipeline.run(), 5u);
+    std::vector<FrameInfo> frames = collector.takeFrames();
+    
+    // A later pass is not cut short by the earlier cancel()
+    pipeline.setProgressCallback(nullptr);
+    EXPECT_EQ(pipeline.replay(frames), 5u);
+    EXPECT_FALSE(pipeline.isCancelled());
+    EXPECT_EQ(collector.getFrames().size(), 5u);
+    
+    EXPECT_EQ(pipeline.run(20), 20u);
+    EXPECT_FALSE(pipeline.isCancelled());
+}
+
+TEST_F(AnalysisPipelineTest, SinglePassMatchesStandaloneAnalyzers) {
+    // Standalone analyzers (each decodes on its own)
+    VideoDecoder decoder1(testVideoPath);
+    GOPAnalyzer gopStandalone(decoder1);
+    auto expectedGops = gopStandalone.analyze();
+    
+    BitrateAnalyzer bitrateStandalone(decoder1);
+    auto expectedBitrate = bitrateStandalone.analyze();
+    
+    SceneDetector sceneStandalone(decoder1, 0.3);
+    auto expectedScenes = sceneStandalone.analyze();
+    
+    // Shared single pass
+    VideoDecoder decoder2(testVideoPath);
+    FrameCollector collector;
+    FrameStatisticsAccumulator statsAccumulator;
+    GOPAnalyzer gopAnalyzer(decoder2);
+    BitrateAnalyzer bitrateAnalyzer(decoder2);
+    SceneDetector sceneDetector(decoder2, 0.3);
+    
+    AnalysisPipeline pipeline(decoder2);
+    pipeline.addSink(collector);
+    pipeline.addSink(statsAccumulator);
+    pipeline.addSink(gopAnalyzer);
+    pipeline.addSink(bitrateAnalyzer);
+    pipeline.addSink(sceneDetector);
+    pipeline.run();
+    
+    const auto& gops = gopAnalyzer.getGOPs();
+    ASSERT_EQ(gops.size(), expectedGops.size());
+    for (size_t i = 0; i < gops.size(); ++i) {
+        EXPECT_EQ(gops[i].startPts, expectedGops[i].startPts);
+        EXPECT_EQ(gops[i].endPts, expectedGops[i].endPts);
+        EXPECT_EQ(gops[i].frameCount, expectedGops[i].frameCount);
+        EXPECT_EQ(gops[i].totalSize, expectedGops[i].totalSize);
+    }
+    
+    const auto& bitrate = bitrateAnalyzer.getStatistics();
+    EXPECT_DOUBLE_EQ(bitrate.averageBitrate, expectedBitrate.averageBitrate);
+    EXPECT_EQ(bitrate.timeSeriesData.size(), expectedBitrate.timeSeriesData.size());
+    
+    EXPECT_EQ(sceneDetector.getScenes().size(), expectedScenes.size());
+    
+    auto stats = statsAccumulator.getStatistics();
+    auto expectedStats = FrameStatistics::compute(collector.getFrames());
+    EXPECT_EQ(stats.totalFrames, expectedStats.totalFrames);
+    EXPECT_DOUBLE_EQ(stats.averageFrameSize, expectedStats.averageFrameSize);
+}
@@ -0,0 +1,59 @@
+#include "video_analyzer/anomaly_detector.h"
+#include <gtest/gtest.h>
+
+using namespace video_analyzer;
+
+namespace {
+
+FrameInfo makeFrame(double timestamp, int size, int qp = 26) {
+    FrameInfo frame{};
+    frame.timestamp = timestamp;
+    frame.size = size;
+    frame.qp = qp;
+    frame.type = FrameType::P_FRAME;
+    frame.duplicateGroupId = -1;
+    return frame;
+}
+
+} // namespace
+
+TEST(AnomalyDetectorTest, SteadyStreamHasNoAnomalies) {
+    AnomalyDetector detector;
+    std::vector<Anomaly> anomalies;
+    
+    for (int i = 0; i < 60; ++i) {
+        detector.inspect(makeFrame(i / 30.0, 1000), anomalies);
+    }
+    EXPECT_TRUE(anomalies.empty());
+}
+
+TEST(AnomalyDetectorTest, DetectsFrameDropAndBitrateSpike) {
+    AnomalyDetector detector;
+    std::vector<Anomaly> anomalies;
+    
+    EXPECT_EQ(detector.inspect(makeFrame(0.0, 1000), anomalies), 0u);
+    EXPECT_EQ(detector.inspect(makeFrame(0.5, 5000), anomalies), 2u);
+    
+    ASSERT_EQ(anomalies.size(), 2u);
+    EXPECT_EQ(anomalies[0].type, AnomalyType::FRAME_DROP);
+    EXPECT_EQ(anomalies[1].type, AnomalyType::BITRATE_SPIKE);
+    EXPECT_DOUBLE_EQ(anomalies[1].timestamp, 0.5);
+}
+
+TEST(AnomalyDetectorTest, DetectsQualityDropWithoutHistory) {
+    AnomalyDetector detector;
+    std::vector<Anomaly> anomalies;
+    
+    EXPECT_EQ(detector.inspect(makeFrame(0.0, 1000, 45), anomalies), 1u);
+    EXPECT_EQ(anomalies[0].type, AnomalyType::QUALITY_DROP);
+}
+
+TEST(AnomalyDetectorTest, ResetForgetsPreviousFrame) {
+    AnomalyDetector detector;
+    std::vector<Anomaly> anomalies;
+    
+    detector.inspect(makeFrame(0.0, 100), anomalies);
+    detector.reset();
+    detector.inspect(makeFrame(10.0, 10000), anomalies);
+    EXPECT_TRUE(anomalies.empty());
+}
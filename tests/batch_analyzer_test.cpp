@@ -0,0 +1,105 @@
+#include "video_analyzer/batch_analyzer.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using namespace video_analyzer;
+
+class BatchAnalyzerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        outputDir = fs::temp_directory_path() / "video_analyzer_batch_test";
+        fs::remove_all(outputDir);
+        fs::create_directories(outputDir);
+    }
+    
+    void TearDown() override {
+        fs::remove_all(outputDir);
+    }
+    
+    fs::path outputDir;
+};
+
+TEST_F(BatchAnalyzerTest, CollectInputsFromListFile) {
+    fs::path listFile = outputDir / "inputs.txt";
+    {
+        std::ofstream list(listFile);
+        list << "# nightly assets\n"
+             << "a.mp4\n"
+             << "\n"
+             << "  dir/b.mkv  \n";
+    }
+    
+    auto files = BatchAnalyzer::collectInputs(listFile.string());
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(files[0], "a.mp4");
+    EXPECT_EQ(files[1], "dir/b.mkv");
+}
+
+TEST_F(BatchAnalyzerTest, CollectInputsFromDirectory) {
+    fs::create_directories(outputDir / "sub");
+    std::ofstream(outputDir / "b.mp4").put('x');
+    std::ofstream(outputDir / "sub" / "a.MKV").put('x');
+    std::ofstream(outputDir / "notes.txt").put('x');
+    
+    auto files = BatchAnalyzer::collectInputs(outputDir.string());
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(fs::path(files[0]).filename(), "b.mp4");
+    EXPECT_EQ(fs::path(files[1]).filename(), "a.MKV");
+}
+
+TEST_F(BatchAnalyzerTest, MissingListFileThrows) {
+    EXPECT_THROW(BatchAnalyzer::collectInputs((outputDir / "missing.txt").string()),
+                 std::runtime_error);
+}
+
+TEST_F(BatchAnalyzerTest, BalancesDecoderThreads) {
+    BatchOptions options;
+    options.jobs = 1;
+    BatchAnalyzer analyzer(options);
+    
+    EXPECT_EQ(analyzer.getJobCount(), 1u);
+    EXPECT_GE(analyzer.getDecoderThreadsPerFile(), 1);
+    
+    options.decoderOptions.threadCount = 2;
+    BatchAnalyzer fixedThreads(options);
+    EXPECT_EQ(fixedThreads.getDecoderThreadsPerFile(), 2);
+}
+
+TEST_F(BatchAnalyzerTest, AnalyzesFilesAndWritesSummary) {
+    std::string videoPath = "../test_videos/test_h264_480p_24fps.mp4";
+    if (!fs::exists(videoPath)) {
+        GTEST_SKIP() << "Test video not found: " << videoPath;
+    }
+    
+    BatchOptions options;
+    options.jobs = 2;
+    options.outputDir = outputDir.string();
+    BatchAnalyzer analyzer(options);
+    
+    size_t callbacks = 0;
+    analyzer.setProgressCallback([&](const BatchFileResult&, size_t, size_t total) {
+        callbacks++;
+        EXPECT_EQ(total, 3u);
+    });
+    
+    // Same file twice (report names must not collide) plus a missing file
+    auto summary = analyzer.run({videoPath, videoPath, "nonexistent_file.mp4"});
+    
+    EXPECT_EQ(callbacks, 3u);
+    EXPECT_EQ(summary.succeeded, 2u);
+    EXPECT_EQ(summary.failed, 1u);
+    EXPECT_GT(summary.totalFrames, 0);
+    EXPECT_GT(summary.filesPerHour, 0.0);
+    
+    ASSERT_TRUE(summary.files[0].success);
+    ASSERT_TRUE(summary.files[1].success);
+    EXPECT_NE(summary.files[0].reportPath, summary.files[1].reportPath);
+    EXPECT_TRUE(fs::exists(summary.files[0].reportPath));
+    EXPECT_TRUE(fs::exists(summary.files[1].reportPath));
+    EXPECT_FALSE(summary.files[2].success);
+    EXPECT_FALSE(summary.files[2].error.empty());
+    
+    EXPECT_TRUE(fs::exists(outputDir / "batch_summary.json"));
+}
@@ -0,0 +1,186 @@
+#include "video_analyzer/binary_report.h"
+#include "report_test_frames.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace video_analyzer;
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+} // namespace
+
+TEST(BinaryReportTest, RoundTripFramesAndGOPs) {
+    std::string path = tempPath("binary_report_test.vsa");
+    auto frames = test::makeReportFrames();
+    std::vector<GOPInfo> gops = {{0, 0, 3003, 3, 1, 1, 1, 53221, false}};
+    
+    StreamInfo info{};
+    info.codecName = "h264";
+    info.width = 1920;
+    info.height = 1080;
+    info.frameRate = 29.97;
+    
+    FrameStatistics stats = FrameStatistics::compute(frames);
+    
+    {
+        BinaryReportWriter writer(path);
+        writer.begin(info);
+        for (const auto& frame : frames) {
+            writer.writeFrame(frame);
+        }
+        writer.setGOPs(gops);
+        writer.finish({{"frameStatistics", stats.toJson()}, {"source", "input.mp4"}});
+        EXPECT_EQ(writer.getFramesWritten(), frames.size());
+    }
+    
+    ASSERT_TRUE(BinaryReport::isBinaryReport(path));
+    BinaryReport report(path);
+    
+    EXPECT_EQ(report.getFrameCount(), frames.size());
+    EXPECT_EQ(report.getStreamInfo().toJson(), info.toJson());
+    EXPECT_EQ(report.getFrameStatistics().toJson(), stats.toJson());
+    EXPECT_EQ(report.getMetadata()["source"], "input.mp4");
+    
+    auto loaded = report.readFrames();
+    ASSERT_EQ(loaded.size(), frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        EXPECT_EQ(loaded[i].toJson(), frames[i].toJson()) << "frame " << i;
+    }
+    
+    auto loadedGops = report.readGOPs();
+    ASSERT_EQ(loadedGops.size(), 1u);
+    EXPECT_EQ(loadedGops[0].toJson(), gops[0].toJson());
+    
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryReportTest, ColumnsAreAlignedAndTyped) {
+    std::string path = tempPath("binary_report_columns.vsa");
+    auto frames = test::makeReportFrames();
+    
+    BitrateStatistics bitrate{};
+    bitrate.averageBitrate = 2.0e6;
+    bitrate.maxBitrate = 2.5e6;
+    bitrate.minBitrate = 1.5e6;
+    bitrate.timeSeriesData = {{0.0, 1.5e6}, {1.0, 2.5e6}};
+    
+    // Vectors of lengths 5 and 0 in the B-frame, none in the P-frame
+    MotionField moving;
+    moving.pts = 3003;
+    moving.x = {8, 24};
+    moving.y = {8, 8};
+    moving.dx = {3, 0};
+    moving.dy = {-4, 0};
+    moving.width = {16, 16};
+    moving.height = {16, 16};
+    MotionField still;
+    still.pts = 1501;
+    
+    {
+        BinaryReportWriter writer(path);
+        for (const auto& frame : frames) {
+            writer.writeFrame(frame);
+        }
+        writer.setBitrateStatistics(bitrate);
+        writer.setMotionVectorData({moving, still});
+        writer.finish();
+    }
+    
+    BinaryReport report(path);
+    
+    auto pts = report.column<int64_t>("frames.pts");
+    ASSERT_EQ(pts.size, frames.size());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pts.data) % kBinaryReportAlignment, 0u);
+    EXPECT_EQ(pts[1], 3003);
+    
+    auto flags = report.column<uint8_t>("frames.flags");
+    EXPECT_EQ(flags[0], kFrameFlagKeyFrame);
+    EXPECT_EQ(flags[2], kFrameFlagDuplicate);
+    
+    auto bitrates = report.column<double>("bitrate.bitrate");
+    ASSERT_EQ(bitrates.size, 2u);
+    EXPECT_DOUBLE_EQ(bitrates[1], 2.5e6);
+    EXPECT_DOUBLE_EQ(report.getMetadata()["bitrateStatistics"]["averageBitrate"].get<double>(), 2.0e6);
+    EXPECT_EQ(report.readBitrateStatistics().toJson(), bitrate.toJson());
+    
+    auto motionPts = report.column<int64_t>("motion.pts");
+    auto vectorCount = report.column<int32_t>("motion.vectorCount");
+    auto averageMagnitude = report.column<float>("motion.averageMagnitude");
+    auto maxMagnitude = report.column<float>("motion.maxMagnitude");
+    ASSERT_EQ(motionPts.size, 2u);
+    ASSERT_EQ(vectorCount.size, 2u);
+    EXPECT_EQ(motionPts[0], 3003);
+    EXPECT_EQ(vectorCount[0], 2);
+    EXPECT_FLOAT_EQ(averageMagnitude[0], 2.5f);
+    EXPECT_FLOAT_EQ(maxMagnitude[0], 5.0f);
+    EXPECT_EQ(motionPts[1], 1501);
+    EXPECT_EQ(vectorCount[1], 0);
+    EXPECT_FLOAT_EQ(maxMagnitude[1], 0.0f);
+    
+    // Wrong element type and unknown columns are rejected
+    EXPECT_THROW(report.column<double>("frames.pts"), std::runtime_error);
+    EXPECT_THROW(report.column<int64_t>("frames.missing"), std::runtime_error);
+    EXPECT_TRUE(report.column<int32_t>("gops.gopIndex").empty());
+    
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryReportTest, RejectsNonReportFiles) {
+    std::string path = tempPath("binary_report_invalid.vsa");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "{\"frames\": []}";
+    }
+    
+    EXPECT_FALSE(BinaryReport::isBinaryReport(path));
+    EXPECT_THROW(BinaryReport report(path), std::runtime_error);
+    EXPECT_THROW(BinaryReport report(tempPath("binary_report_missing.vsa")), std::runtime_error);
+    
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryReportTest, RejectsWrappingSectionBounds) {
+    std::string path = tempPath("binary_report_wrapping.vsa");
+    {
+        BinaryReportWriter writer(path);
+        for (const auto& frame : test::makeReportFrames()) {
+            writer.writeFrame(frame);
+        }
+        writer.finish();
+    }
+    
+    auto patch = [&](std::streamoff position, uint64_t value) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(position);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto readU64 = [&](std::streamoff position) {
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(position);
+        uint64_t value = 0;
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    };
+    
+    // Header: magic[8], version, columnCount, directoryOffset, metadataOffset, metadataSize
+    const std::streamoff directoryOffset = static_cast<std::streamoff>(readU64(16));
+    const uint64_t metadataOffset = readU64(24);
+    
+    // offset + count * size wraps to offset for multi-byte columns
+    patch(directoryOffset + 56, uint64_t(1) << 63);
+    EXPECT_THROW(BinaryReport report(path), std::runtime_error);
+    patch(directoryOffset + 56, 3);
+    EXPECT_NO_THROW(BinaryReport report(path));
+    
+    // metadataOffset + metadataSize wraps around to a small value
+    patch(32, ~uint64_t(0) - metadataOffset + 2);
+    EXPECT_THROW(BinaryReport report(path), std::runtime_error);
+    
+    std::filesystem::remove(path);
+}
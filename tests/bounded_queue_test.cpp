@@ -0,0 +1,163 @@
+#include "video_analyzer/bounded_queue.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace video_analyzer;
+
+TEST(BoundedQueueTest, DropNewestRejectsWhenFull) {
+    BoundedQueue<int> queue(2, OverflowPolicy::DROP_NEWEST);
+    EXPECT_EQ(queue.push(1), PushResult::PUSHED);
+    EXPECT_EQ(queue.push(2), PushResult::PUSHED);
+    EXPECT_EQ(queue.push(3), PushResult::REJECTED);
+    
+    EXPECT_EQ(queue.size(), 2u);
+    EXPECT_EQ(queue.droppedCount(), 1u);
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.pop(), 2);
+}
+
+TEST(BoundedQueueTest, DropOldestEvictsWhenFull) {
+    BoundedQueue<int> queue(2, OverflowPolicy::DROP_OLDEST);
+    queue.push(1);
+    queue.push(2);
+    EXPECT_EQ(queue.push(3), PushResult::EVICTED_OLDEST);
+    
+    EXPECT_EQ(queue.droppedCount(), 1u);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+}
+
+TEST(BoundedQueueTest, CloseDrainsThenEnds) {
+    BoundedQueue<std::unique_ptr<int>> queue(4, OverflowPolicy::BLOCK);
+    queue.push(std::make_unique<int>(5));
+    queue.close();
+    
+    EXPECT_TRUE(queue.isClosed());
+    EXPECT_EQ(queue.push(std::make_unique<int>(6)), PushResult::CLOSED);
+    
+    auto item = queue.pop();
+    ASSERT_TRUE(item.has_value());
+    EXPECT_EQ(**item, 5);
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(BoundedQueueTest, PopForTimesOut) {
+    BoundedQueue<int> queue(1, OverflowPolicy::BLOCK);
+    EXPECT_FALSE(queue.popFor(std::chrono::milliseconds(5)).has_value());
+}
+
+TEST(BoundedQueueTest, CloseWakesBlockedConsumer) {
+    BoundedQueue<int> queue(1, OverflowPolicy::BLOCK);
+    std::thread consumer([&queue] {
+        EXPECT_FALSE(queue.pop().has_value());
+    });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.close();
+    consumer.join();
+}
+
+TEST(BoundedQueueTest, BlockAppliesBackpressure) {
+    constexpr int kItems = 1000;
+    BoundedQueue<int> queue(8, OverflowPolicy::BLOCK);
+    
+    std::thread producer([&queue] {
+        for (int i = 0; i < kItems; ++i) {
+            EXPECT_EQ(queue.push(i), PushResult::PUSHED);
+            EXPECT_LE(queue.size(), 8u);
+        }
+        queue.close();
+    });
+    
+    std::vector<int> received;
+    while (auto item = queue.pop()) {
+        received.push_back(*item);
+    }
+    producer.join();
+    
+    ASSERT_EQ(received.size(), static_cast<size_t>(kItems));
+    for (int i = 0; i < kItems; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+    EXPECT_EQ(queue.droppedCount(), 0u);
+}
+
+TEST(BoundedQueueTest, DropOldestEvictsDependentRuns) {
+    struct Packet {
+        int index;
+        bool key;
+    };
+    
+    // Keyframe every 4 packets; the consumer takes one packet per 3 pushed
+    constexpr int kPackets = 60;
+    constexpr int kGop = 4;
+    BoundedQueue<Packet> queue(3, OverflowPolicy::DROP_OLDEST);
+    queue.setEvictionBoundary([](const Packet& packet) { return packet.key; });
+    
+    std::vector<Packet> decoded;
+    int previous = -1;  // Last decoded packet, the reference of the next one
+    auto decodeOne = [&] {
+        auto packet = queue.popFor(std::chrono::milliseconds(0));
+        if (!packet) {
+            return;
+        }
+        // Every packet after an eviction starts from a keyframe or follows
+        // its reference directly
+        EXPECT_TRUE(packet->key || packet->index == previous + 1) << "packet " << packet->index;
+        previous = packet->index;
+        decoded.push_back(*packet);
+    };
+    
+    // Same reaction to push results as StreamAnalyzer's reader
+    bool waitForKeyframe = false;
+    bool evicted = false;
+    for (int i = 0; i < kPackets; ++i) {
+        Packet packet{i, i % kGop == 0};
+        if (waitForKeyframe && !packet.key) {
+            continue;
+        }
+        waitForKeyframe = false;
+        
+        PushResult result = queue.push(packet);
+        EXPECT_FALSE(packet.key && result == PushResult::REJECTED) << "keyframe " << i;
+        evicted = evicted || result != PushResult::PUSHED;
+        waitForKeyframe = result == PushResult::REJECTED;
+        
+        if (i % 3 == 2) {
+            decodeOne();
+        }
+    }
+    queue.close();
+    while (queue.size() > 0) {
+        decodeOne();
+    }
+    
+    EXPECT_TRUE(evicted);
+    EXPECT_GT(queue.droppedCount(), 0u);
+    ASSERT_FALSE(decoded.empty());
+    EXPECT_TRUE(decoded.front().key);
+}
+
+TEST(BoundedQueueTest, EvictionKeepsQueuedKeyframe) {
+    BoundedQueue<int> queue(3, OverflowPolicy::DROP_OLDEST);
+    queue.setEvictionBoundary([](int item) { return item % 10 == 0; });
+    queue.push(0);
+    queue.push(1);
+    queue.push(10);
+    
+    // Evicting 0 also drops its dependent 1; 10 and the pushed 11 remain
+    EXPECT_EQ(queue.push(11), PushResult::EVICTED_OLDEST);
+    EXPECT_EQ(queue.droppedCount(), 2u);
+    EXPECT_EQ(queue.pop(), 10);
+    EXPECT_EQ(queue.pop(), 11);
+    
+    // A dependent pushed after an evicted run with no keyframe left is rejected
+    queue.push(20);
+    queue.push(21);
+    queue.push(22);
+    EXPECT_EQ(queue.push(23), PushResult::REJECTED);
+    EXPECT_EQ(queue.size(), 0u);
+}
@@ -9,6 +9,8 @@ TEST(FrameTypeTest, ToStringConversion) {
     EXPECT_EQ(frameTypeToString(FrameType::P_FRAME), "P");
     EXPECT_EQ(frameTypeToString(FrameType::B_FRAME), "B");
     EXPECT_EQ(frameTypeToString(FrameType::UNKNOWN), "UNKNOWN");
+    EXPECT_STREQ(frameTypeName(FrameType::B_FRAME), "B");
+    EXPECT_STREQ(frameTypeName(FrameType::UNKNOWN), "UNKNOWN");
 }
 
 TEST(FrameTypeTest, FromStringConversion) {
@@ -5,6 +5,8 @@
 extern "C" {
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+#include <libavutil/frame.h>
 }
 
 using namespace video_analyzer;
@@ -135,3 +137,28 @@ TEST(FramePtrTest, MoveAssignment) {
     EXPECT_EQ(frame2.get(), ptr);
     EXPECT_EQ(frame1.get(), nullptr);
 }
+
+// Test packet metadata propagation helpers
+TEST(PacketMetadataTest, AttachAndRetrieve) {
+    PacketPtr packet;
+    packet->size = 1234;
+    packet->pos = 5678;
+    
+    attachPacketMetadata(packet.get());
+    ASSERT_NE(packet->opaque_ref, nullptr);
+    
+    // Simulate the decoder moving opaque_ref to the output frame
+    FramePtr frame;
+    frame->opaque_ref = av_buffer_ref(packet->opaque_ref);
+    
+    const PacketMetadata* meta = getPacketMetadata(frame.get());
+    ASSERT_NE(meta, nullptr);
+    EXPECT_EQ(meta->size, 1234);
+    EXPECT_EQ(meta->pos, 5678);
+}
+
+TEST(PacketMetadataTest, FrameWithoutMetadata) {
+    FramePtr frame;
+    EXPECT_EQ(getPacketMetadata(frame.get()), nullptr);
+    EXPECT_EQ(getPacketMetadata(nullptr), nullptr);
+}
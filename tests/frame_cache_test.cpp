@@ -0,0 +1,95 @@
+#include "video_analyzer/frame_cache.h"
+#include <gtest/gtest.h>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+using namespace video_analyzer;
+
+namespace {
+
+// Allocate a gray frame of the given size
+FramePtr makeFrame(int width, int height) {
+    FramePtr frame;
+    frame->format = AV_PIX_FMT_GRAY8;
+    frame->width = width;
+    frame->height = height;
+    EXPECT_GE(av_frame_get_buffer(frame.get(), 0), 0);
+    return frame;
+}
+
+} // namespace
+
+TEST(FrameCacheTest, StoresReferencesByFrameNumber) {
+    FrameCache cache;
+    FramePtr frame = makeFrame(64, 64);
+    frame->pts = 42;
+
+    ASSERT_TRUE(cache.put(7, frame.get()));
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.contains(7));
+    EXPECT_GE(cache.getMemoryUsage(), 64u * 64u);
+
+    AVFrame* cached = cache.get(7);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_NE(cached, frame.get());
+    EXPECT_EQ(cached->pts, 42);
+    EXPECT_EQ(cached->data[0], frame->data[0]);  // Shared buffer, no copy
+
+    EXPECT_EQ(cache.get(8), nullptr);
+    EXPECT_EQ(cache.getHitCount(), 1u);
+    EXPECT_EQ(cache.getMissCount(), 1u);
+}
+
+TEST(FrameCacheTest, EvictsLeastRecentlyUsedOverBudget) {
+    FramePtr frame = makeFrame(64, 64);
+    size_t frameBytes = FrameCache::frameBytes(frame.get());
+    ASSERT_GT(frameBytes, 0u);
+
+    FrameCache cache(frameBytes * 3);
+    cache.put(0, frame.get());
+    cache.put(1, frame.get());
+    cache.put(2, frame.get());
+
+    // Touch 0 so that 1 is the least recently used
+    EXPECT_NE(cache.get(0), nullptr);
+    cache.put(3, frame.get());
+
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_LE(cache.getMemoryUsage(), cache.getBudget());
+}
+
+TEST(FrameCacheTest, ReplacingAFrameKeepsAccountingExact) {
+    FramePtr small = makeFrame(16, 16);
+    FramePtr large = makeFrame(128, 128);
+
+    FrameCache cache;
+    cache.put(5, small.get());
+    cache.put(5, large.get());
+
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.getMemoryUsage(), FrameCache::frameBytes(large.get()));
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.getMemoryUsage(), 0u);
+}
+
+TEST(FrameCacheTest, KeepsNewestFrameWhenBudgetIsTooSmall) {
+    FramePtr frame = makeFrame(64, 64);
+
+    FrameCache cache(1);
+    cache.put(0, frame.get());
+    cache.put(1, frame.get());
+
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.contains(1));
+
+    cache.setBudget(0);
+    EXPECT_TRUE(cache.contains(1));
+}
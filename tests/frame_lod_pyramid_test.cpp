@@ -0,0 +1,173 @@
+#include "video_analyzer/frame_lod_pyramid.h"
+#include "video_analyzer/thread_pool.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+using namespace video_analyzer;
+
+namespace {
+
+std::vector<FrameInfo> makeFrames(size_t count) {
+    std::vector<FrameInfo> frames(count);
+    for (size_t i = 0; i < count; ++i) {
+        FrameInfo& frame = frames[i];
+        frame.pts = static_cast<int64_t>(i);
+        frame.dts = frame.pts;
+        frame.type = i % 30 == 0 ? FrameType::I_FRAME
+                   : i % 3 == 0 ? FrameType::P_FRAME : FrameType::B_FRAME;
+        frame.size = static_cast<int>((i * 7919) % 50000) + 100;
+        frame.qp = static_cast<int>((i * 31) % 52);
+        frame.isKeyFrame = frame.type == FrameType::I_FRAME;
+        frame.timestamp = i / 30.0;
+        frame.isDuplicate = false;
+        frame.duplicateGroupId = -1;
+    }
+    return frames;
+}
+
+FrameLodBucket bruteForce(const std::vector<FrameInfo>& frames, size_t begin, size_t end) {
+    FrameLodBucket result;
+    for (size_t i = begin; i < end; ++i) {
+        result.merge(FrameLodBucket::fromFrame(frames[i]));
+    }
+    return result;
+}
+
+void expectEqual(const FrameLodBucket& actual, const FrameLodBucket& expected) {
+    EXPECT_EQ(actual.count, expected.count);
+    EXPECT_EQ(actual.minSize, expected.minSize);
+    EXPECT_EQ(actual.maxSize, expected.maxSize);
+    EXPECT_EQ(actual.sumSize, expected.sumSize);
+    EXPECT_EQ(actual.minQP, expected.minQP);
+    EXPECT_EQ(actual.maxQP, expected.maxQP);
+    EXPECT_EQ(actual.sumQP, expected.sumQP);
+    EXPECT_EQ(actual.iFrames, expected.iFrames);
+    EXPECT_EQ(actual.pFrames, expected.pFrames);
+    EXPECT_EQ(actual.bFrames, expected.bFrames);
+    EXPECT_EQ(actual.hasKeyFrame, expected.hasKeyFrame);
+}
+
+} // namespace
+
+TEST(FrameLodPyramidTest, EmptyPyramid) {
+    FrameLodPyramid pyramid;
+    EXPECT_TRUE(pyramid.empty());
+    EXPECT_EQ(pyramid.levelCount(), 0u);
+    EXPECT_EQ(pyramid.aggregate(0, 10).count, 0u);
+    EXPECT_TRUE(pyramid.query(0, 10, 100).empty());
+}
+
+TEST(FrameLodPyramidTest, AggregateMatchesBruteForce) {
+    auto frames = makeFrames(1000);
+    FrameLodPyramid pyramid;
+    pyramid.update(frames);
+    
+    EXPECT_EQ(pyramid.size(), 1000u);
+    EXPECT_EQ(pyramid.levelCount(), 11u);  // 1000, 500, ..., 2, 1
+    
+    const size_t ranges[][2] = {{0, 1000}, {0, 1}, {999, 1000}, {1, 999},
+                                {17, 531}, {256, 512}, {300, 301}, {123, 124}};
+    for (const auto& range : ranges) {
+        expectEqual(pyramid.aggregate(range[0], range[1]),
+                    bruteForce(frames, range[0], range[1]));
+    }
+    
+    // Out-of-range ends are clamped
+    expectEqual(pyramid.aggregate(900, 5000), bruteForce(frames, 900, 1000));
+}
+
+TEST(FrameLodPyramidTest, QueryReturnsOneBucketPerColumn) {
+    auto frames = makeFrames(10007);
+    FrameLodPyramid pyramid;
+    pyramid.update(frames);
+    
+    auto columns = pyramid.query(100, 10007, 640);
+    ASSERT_EQ(columns.size(), 640u);
+    
+    uint32_t total = 0;
+    for (size_t c = 0; c < columns.size(); ++c) {
+        size_t first = 100 + c * 9907 / 640;
+        size_t last = 100 + (c + 1) * 9907 / 640;
+        expectEqual(columns[c], bruteForce(frames, first, last));
+        total += columns[c].count;
+    }
+    EXPECT_EQ(total, 9907u);
+    
+    // Fewer frames than columns: one column per frame
+    auto zoomed = pyramid.query(50, 60, 640);
+    ASSERT_EQ(zoomed.size(), 10u);
+    for (size_t i = 0; i < zoomed.size(); ++i) {
+        EXPECT_EQ(zoomed[i].count, 1u);
+        EXPECT_EQ(zoomed[i].maxSize, frames[50 + i].size);
+    }
+}
+
+TEST(FrameLodPyramidTest, IncrementalUpdateMatchesFullBuild) {
+    auto frames = makeFrames(5000);
+    
+    FrameLodPyramid full;
+    full.update(frames);
+    
+    FrameLodPyramid incremental;
+    std::vector<FrameInfo> partial;
+    for (size_t step : {1, 2, 3, 64, 1000, 1, 3929}) {
+        size_t target = std::min(frames.size(), partial.size() + step);
+        partial.insert(partial.end(), frames.begin() + partial.size(), frames.begin() + target);
+        incremental.update(partial);
+        expectEqual(incremental.aggregate(0, partial.size()), bruteForce(frames, 0, partial.size()));
+    }
+    ASSERT_EQ(incremental.size(), frames.size());
+    EXPECT_EQ(incremental.levelCount(), full.levelCount());
+    
+    for (size_t begin = 0; begin < frames.size(); begin += 487) {
+        expectEqual(incremental.aggregate(begin, begin + 1301), full.aggregate(begin, begin + 1301));
+    }
+}
+
+TEST(FrameLodPyramidTest, ShorterSequenceRebuilds) {
+    auto frames = makeFrames(300);
+    FrameLodPyramid pyramid;
+    pyramid.update(frames);
+    
+    frames.resize(100);
+    frames[10].size = 999999;
+    pyramid.update(frames);
+    
+    EXPECT_EQ(pyramid.size(), 100u);
+    EXPECT_EQ(pyramid.aggregate(0, 100).maxSize, 999999);
+    
+    pyramid.clear();
+    EXPECT_TRUE(pyramid.empty());
+}
+
+TEST(FrameLodPyramidTest, ParallelBuildMatchesSerial) {
+    auto frames = makeFrames(200000);
+    
+    FrameLodPyramid serial;
+    serial.update(frames);
+    
+    ThreadPool pool(4);
+    FrameLodPyramid parallel;
+    parallel.update(frames, &pool);
+    
+    expectEqual(parallel.aggregate(0, frames.size()), serial.aggregate(0, frames.size()));
+    auto a = serial.query(0, frames.size(), 1920);
+    auto b = parallel.query(0, frames.size(), 1920);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        expectEqual(b[i], a[i]);
+    }
+}
+
+TEST(FrameLodPyramidTest, DominantTypeKeepsIFrames) {
+    FrameLodBucket bucket;
+    EXPECT_EQ(bucket.dominantType(), FrameType::UNKNOWN);
+    
+    bucket.bFrames = 10;
+    bucket.pFrames = 3;
+    EXPECT_EQ(bucket.dominantType(), FrameType::B_FRAME);
+    
+    bucket.iFrames = 1;
+    EXPECT_EQ(bucket.dominantType(), FrameType::I_FRAME);
+}
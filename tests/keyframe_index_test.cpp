@@ -0,0 +1,76 @@
+#include "video_analyzer/keyframe_index.h"
+#include "video_analyzer/video_decoder.h"
+#include "video_analyzer/ffmpeg_error.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+
+using namespace video_analyzer;
+
+class KeyframeIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testVideoPath = "../test_videos/test_h264_480p_24fps.mp4";
+        if (!std::filesystem::exists(testVideoPath)) {
+            GTEST_SKIP() << "Test video not found: " << testVideoPath;
+        }
+    }
+    
+    std::string testVideoPath;
+};
+
+TEST_F(KeyframeIndexTest, MatchesDecodedFrames) {
+    KeyframeIndex index = KeyframeIndex::build(testVideoPath);
+    
+    VideoDecoder decoder(testVideoPath);
+    std::vector<FrameInfo> frames;
+    while (auto frame = decoder.readNextFrame()) {
+        frames.push_back(*frame);
+    }
+    
+    ASSERT_EQ(index.getFrameCount(), frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        EXPECT_EQ(index.getFramePts()[i], frames[i].pts);
+        EXPECT_EQ(index.findFrameNumber(frames[i].pts), i);
+    }
+    
+    // Every keyframe maps to a decoded keyframe
+    ASSERT_FALSE(index.getKeyframes().empty());
+    EXPECT_EQ(index.getKeyframes().front().frameNumber, 0u);
+    for (const auto& keyframe : index.getKeyframes()) {
+        ASSERT_LT(keyframe.frameNumber, frames.size());
+        EXPECT_TRUE(frames[keyframe.frameNumber].isKeyFrame);
+    }
+}
+
+TEST_F(KeyframeIndexTest, FindKeyframeForFrame) {
+    KeyframeIndex index = KeyframeIndex::build(testVideoPath);
+    const auto& keyframes = index.getKeyframes();
+    ASSERT_FALSE(keyframes.empty());
+    
+    for (size_t n = 0; n < index.getFrameCount(); ++n) {
+        const KeyframeEntry* keyframe = index.findKeyframeForFrame(n);
+        ASSERT_NE(keyframe, nullptr);
+        EXPECT_LE(keyframe->frameNumber, n);
+        
+        // No later keyframe precedes the frame
+        const KeyframeEntry* next = keyframe + 1;
+        if (next != keyframes.data() + keyframes.size()) {
+            EXPECT_GT(next->frameNumber, n);
+        }
+    }
+    
+    EXPECT_FALSE(index.findFrameNumber(-12345).has_value());
+}
+
+TEST_F(KeyframeIndexTest, CancelledBuildThrows) {
+    std::atomic<bool> cancel{true};
+    EXPECT_THROW(KeyframeIndex::build(testVideoPath, &cancel), FFmpegError);
+    
+    cancel = false;
+    EXPECT_GT(KeyframeIndex::build(testVideoPath, &cancel).getFrameCount(), 0u);
+}
+
+TEST(KeyframeIndexErrorTest, InvalidFile) {
+    EXPECT_THROW(KeyframeIndex::build("nonexistent_file.mp4"), FFmpegError);
+}
@@ -0,0 +1,53 @@
+#include "video_analyzer/latency_histogram.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace video_analyzer;
+using namespace std::chrono;
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 0.0);
+    EXPECT_DOUBLE_EQ(histogram.percentile(99.0), 0.0);
+}
+
+TEST(LatencyHistogramTest, PowerOfTwoBuckets) {
+    LatencyHistogram histogram;
+    histogram.record(nanoseconds(500));    // < 1 us
+    histogram.record(microseconds(1));     // [1, 2)
+    histogram.record(microseconds(3));     // [2, 4)
+    histogram.record(microseconds(1000));  // [512, 1024)
+    histogram.record(nanoseconds(-5));     // Clamped to 0
+    
+    EXPECT_EQ(histogram.count(), 5u);
+    EXPECT_EQ(histogram.bucketCount(0), 2u);
+    EXPECT_EQ(histogram.bucketCount(1), 1u);
+    EXPECT_EQ(histogram.bucketCount(2), 1u);
+    EXPECT_EQ(histogram.bucketCount(10), 1u);
+    EXPECT_DOUBLE_EQ(LatencyHistogram::bucketUpperBound(10), 1024.0);
+    EXPECT_DOUBLE_EQ(histogram.max(), 1000.0);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 90; ++i) {
+        histogram.record(microseconds(100));  // [64, 128)
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(milliseconds(5));    // [4096, 8192)
+    }
+    
+    EXPECT_DOUBLE_EQ(histogram.percentile(50.0), 128.0);
+    EXPECT_DOUBLE_EQ(histogram.percentile(90.0), 128.0);
+    EXPECT_DOUBLE_EQ(histogram.percentile(99.0), 5000.0);  // Capped at max
+    EXPECT_NEAR(histogram.mean(), 590.0, 1e-9);
+    
+    auto json = histogram.toJson();
+    EXPECT_EQ(json["count"].get<uint64_t>(), 100u);
+    EXPECT_EQ(json["buckets"].size(), 2u);
+    
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.bucketCount(7), 0u);
+}
@@ -0,0 +1,152 @@
+#include "video_analyzer/luma_kernels.h"
+#include "video_analyzer/ffmpeg_context.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <random>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+using namespace video_analyzer;
+
+namespace {
+
+std::vector<uint8_t> randomBytes(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> bytes(count);
+    for (auto& b : bytes) {
+        b = static_cast<uint8_t>(dist(rng));
+    }
+    return bytes;
+}
+
+// Straightforward block average used as reference for the SIMD kernels
+std::vector<uint8_t> referenceDownscale(const uint8_t* plane, int linesize, int width, int height) {
+    const int block = LumaThumbnail::kBlockSize;
+    std::vector<uint8_t> out;
+    for (int by = 0; by < height / block; ++by) {
+        for (int bx = 0; bx < width / block; ++bx) {
+            unsigned sum = 0;
+            for (int y = 0; y < block; ++y) {
+                for (int x = 0; x < block; ++x) {
+                    sum += plane[(by * block + y) * linesize + bx * block + x];
+                }
+            }
+            out.push_back(static_cast<uint8_t>((sum + 32) / 64));
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(LumaKernelsTest, ReportsKernelName) {
+    std::string name = lumaKernelName();
+    EXPECT_TRUE(name == "avx2" || name == "sse2" || name == "neon" || name == "scalar") << name;
+}
+
+TEST(LumaKernelsTest, DownscaleMatchesReference) {
+    // Odd sizes exercise the vector tails and dropped partial blocks
+    const int sizes[][2] = {{8, 8}, {24, 16}, {100, 37}, {259, 67}, {640, 360}};
+    for (const auto& size : sizes) {
+        int width = size[0];
+        int height = size[1];
+        int linesize = width + 13;
+        auto plane = randomBytes(static_cast<size_t>(linesize) * height, width * 31 + height);
+        
+        LumaThumbnail thumbnail;
+        downscaleLuma(plane.data(), linesize, width, height, thumbnail);
+        
+        EXPECT_EQ(thumbnail.width, width / 8);
+        EXPECT_EQ(thumbnail.height, height / 8);
+        EXPECT_EQ(thumbnail.pixels, referenceDownscale(plane.data(), linesize, width, height))
+            << width << "x" << height;
+    }
+}
+
+TEST(LumaKernelsTest, DownscaleFrame) {
+    FramePtr frame;
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = 64;
+    frame->height = 48;
+    ASSERT_GE(av_frame_get_buffer(frame.get(), 0), 0);
+    for (int y = 0; y < frame->height; ++y) {
+        for (int x = 0; x < frame->width; ++x) {
+            frame->data[0][y * frame->linesize[0] + x] = static_cast<uint8_t>(x < 32 ? 16 : 235);
+        }
+    }
+    
+    LumaThumbnail thumbnail;
+    ASSERT_TRUE(downscaleLuma(frame.get(), thumbnail));
+    ASSERT_EQ(thumbnail.width, 8);
+    ASSERT_EQ(thumbnail.height, 6);
+    EXPECT_EQ(thumbnail.pixels[0], 16);
+    EXPECT_EQ(thumbnail.pixels[7], 235);
+    
+    // Formats without an 8-bit luma plane are rejected
+    frame->format = AV_PIX_FMT_RGB24;
+    EXPECT_FALSE(downscaleLuma(frame.get(), thumbnail));
+    EXPECT_TRUE(thumbnail.empty());
+    EXPECT_FALSE(downscaleLuma(nullptr, thumbnail));
+}
+
+TEST(LumaKernelsTest, SumAbsoluteDifferencesMatchesReference) {
+    for (size_t count : {0u, 1u, 15u, 16u, 33u, 1000u, 70001u}) {
+        auto a = randomBytes(count, 1);
+        auto b = randomBytes(count, 2);
+        
+        uint64_t expected = 0;
+        for (size_t i = 0; i < count; ++i) {
+            expected += std::abs(a[i] - b[i]);
+        }
+        EXPECT_EQ(sumAbsoluteDifferences(a.data(), b.data(), count), expected) << count;
+    }
+    
+    // Maximal differences must not overflow the vector accumulators
+    std::vector<uint8_t> black(100000, 0);
+    std::vector<uint8_t> white(100000, 255);
+    EXPECT_EQ(sumAbsoluteDifferences(black.data(), white.data(), black.size()), 100000u * 255u);
+}
+
+TEST(LumaKernelsTest, HistogramCountsEveryValue) {
+    auto pixels = randomBytes(1027, 3);
+    uint32_t bins[kLumaHistogramBins];
+    lumaHistogram(pixels.data(), pixels.size(), bins);
+    
+    uint32_t expected[kLumaHistogramBins] = {};
+    for (uint8_t v : pixels) {
+        expected[v / 4]++;
+    }
+    for (int i = 0; i < kLumaHistogramBins; ++i) {
+        EXPECT_EQ(bins[i], expected[i]) << i;
+    }
+}
+
+TEST(LumaKernelsTest, ChiSquareDistanceBounds) {
+    uint32_t a[kLumaHistogramBins] = {};
+    uint32_t b[kLumaHistogramBins] = {};
+    uint32_t empty[kLumaHistogramBins] = {};
+    a[0] = 100;
+    b[63] = 50;
+    
+    EXPECT_DOUBLE_EQ(chiSquareDistance(a, a, kLumaHistogramBins), 0.0);
+    EXPECT_DOUBLE_EQ(chiSquareDistance(a, b, kLumaHistogramBins), 1.0);
+    EXPECT_DOUBLE_EQ(chiSquareDistance(empty, empty, kLumaHistogramBins), 0.0);
+    EXPECT_DOUBLE_EQ(chiSquareDistance(a, empty, kLumaHistogramBins), 1.0);
+    
+    // Scale invariant: same distribution with twice the mass
+    uint32_t c[kLumaHistogramBins] = {};
+    uint32_t d[kLumaHistogramBins] = {};
+    c[10] = 30;
+    c[20] = 10;
+    d[10] = 60;
+    d[20] = 20;
+    EXPECT_NEAR(chiSquareDistance(c, d, kLumaHistogramBins), 0.0, 1e-12);
+    
+    b[0] = 50;
+    double partial = chiSquareDistance(a, b, kLumaHistogramBins);
+    EXPECT_GT(partial, 0.0);
+    EXPECT_LT(partial, 1.0);
+}
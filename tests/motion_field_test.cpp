@@ -0,0 +1,195 @@
+#include "video_analyzer/motion_field.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+using namespace video_analyzer;
+
+namespace {
+
+// Random components in [-range, range]; counts are not multiples of the
+// vector width so the scalar tails are exercised too
+void randomField(size_t count, int range, unsigned seed, std::vector<int16_t>& dx,
+                 std::vector<int16_t>& dy) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(-range, range);
+    dx.resize(count);
+    dy.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        dx[i] = static_cast<int16_t>(dist(rng));
+        dy[i] = static_cast<int16_t>(dist(rng));
+    }
+}
+
+// Octant from the angle, as the atan2-based classification did
+MotionOctant referenceOctant(int dx, int dy) {
+    double degrees = std::atan2(static_cast<double>(dy), static_cast<double>(dx)) * 180.0 / M_PI;
+    if (degrees < 0) degrees += 360.0;
+    return static_cast<MotionOctant>(static_cast<int>((degrees + 22.5) / 45.0) % kMotionOctantCount);
+}
+
+} // namespace
+
+TEST(MotionFieldTest, MagnitudesMatchScalar) {
+    std::vector<int16_t> dx, dy;
+    randomField(1003, 32767, 1, dx, dy);
+    dx.push_back(32767);
+    dy.push_back(-32767);
+    
+    std::vector<float> magnitudes(dx.size());
+    motionMagnitudes(dx.data(), dy.data(), dx.size(), magnitudes.data());
+    
+    for (size_t i = 0; i < dx.size(); ++i) {
+        float expected = std::sqrt(static_cast<float>(dx[i] * dx[i] + dy[i] * dy[i]));
+        EXPECT_EQ(magnitudes[i], expected) << dx[i] << "," << dy[i];
+    }
+}
+
+TEST(MotionFieldTest, OctantsMatchAngles) {
+    // Below 2378 no component ratio lies between 408/985 and tan(22.5), so
+    // the integer test agrees exactly with the angle
+    std::vector<int16_t> dx, dy;
+    randomField(5001, 2000, 2, dx, dy);
+    
+    std::vector<uint8_t> octants(dx.size());
+    motionOctants(dx.data(), dy.data(), dx.size(), octants.data());
+    
+    for (size_t i = 0; i < dx.size(); ++i) {
+        if (dx[i] == 0 && dy[i] == 0) {
+            EXPECT_EQ(octants[i], static_cast<uint8_t>(MotionOctant::E));
+            continue;
+        }
+        EXPECT_EQ(octants[i], static_cast<uint8_t>(referenceOctant(dx[i], dy[i])))
+            << dx[i] << "," << dy[i];
+    }
+}
+
+TEST(MotionFieldTest, OctantsOfAxesAndDiagonals) {
+    const int16_t dx[] = {0, 5, 5, 0, -5, -5, -5, 0, 5, -32767, 32767};
+    const int16_t dy[] = {0, 0, 5, 5, 5, 0, -5, -5, -5, 32767, -1};
+    const MotionOctant expected[] = {
+        MotionOctant::E, MotionOctant::E, MotionOctant::NE, MotionOctant::N, MotionOctant::NW,
+        MotionOctant::W, MotionOctant::SW, MotionOctant::S, MotionOctant::SE, MotionOctant::NW,
+        MotionOctant::E
+    };
+    const size_t count = sizeof(dx) / sizeof(dx[0]);
+    
+    uint8_t octants[count];
+    motionOctants(dx, dy, count, octants);
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(octants[i], static_cast<uint8_t>(expected[i])) << i;
+    }
+    EXPECT_STREQ(motionOctantName(MotionOctant::NW), "NW");
+}
+
+TEST(MotionFieldTest, ConvertsToMotionVectors) {
+    MotionField field;
+    field.pts = 42;
+    field.motionScale = 4;
+    field.x = {8, 24};
+    field.y = {8, 8};
+    field.dx = {-8, 3};
+    field.dy = {4, 0};
+    field.width = {16, 8};
+    field.height = {16, 8};
+    EXPECT_EQ(field.memoryUsage(), 2u * (4 * sizeof(int16_t) + 2));
+    
+    MotionVectorData mvData = toMotionVectorData(field);
+    EXPECT_EQ(mvData.pts, 42);
+    ASSERT_EQ(mvData.vectors.size(), 2u);
+    
+    const MotionVector& vec = mvData.vectors[0];
+    EXPECT_EQ(vec.dstX, 8);
+    EXPECT_EQ(vec.dstY, 8);
+    EXPECT_EQ(vec.srcX, 6);   // dst + motion / scale
+    EXPECT_EQ(vec.srcY, 9);
+    EXPECT_EQ(vec.motionX, -8);
+    EXPECT_EQ(vec.motionY, 4);
+    EXPECT_FLOAT_EQ(vec.magnitude, std::sqrt(80.0f));
+    EXPECT_FLOAT_EQ(vec.direction, std::atan2(4.0f, -8.0f));
+    
+    EXPECT_EQ(mvData.vectors[1].srcX, 24);  // Sub-pixel motion truncates
+}
+
+TEST(MotionFieldTest, ExtractFromNullFrame) {
+    MotionField field = extractMotionField(nullptr);
+    EXPECT_TRUE(field.empty());
+}
+
+TEST(MotionFieldTest, AccumulatorMergeMatchesWholeField) {
+    std::vector<int16_t> dx, dy;
+    randomField(3001, 64, 3, dx, dy);
+    
+    MotionField whole;
+    whole.dx = dx;
+    whole.dy = dy;
+    MotionField first;
+    MotionField second;
+    first.dx.assign(dx.begin(), dx.begin() + 1000);
+    first.dy.assign(dy.begin(), dy.begin() + 1000);
+    second.dx.assign(dx.begin() + 1000, dx.end());
+    second.dy.assign(dy.begin() + 1000, dy.end());
+    
+    MotionAccumulator expected = MotionAccumulator::fromField(whole);
+    MotionAccumulator merged = MotionAccumulator::fromField(first);
+    merged.merge(MotionAccumulator());
+    merged.merge(MotionAccumulator::fromField(second));
+    
+    EXPECT_EQ(merged.count, expected.count);
+    EXPECT_NEAR(merged.sumMagnitude, expected.sumMagnitude, 1e-6 * expected.sumMagnitude);
+    EXPECT_EQ(merged.minMagnitude, expected.minMagnitude);
+    EXPECT_EQ(merged.maxMagnitude, expected.maxMagnitude);
+    EXPECT_EQ(merged.staticCount, expected.staticCount);
+    EXPECT_EQ(merged.highMotionCount, expected.highMotionCount);
+    for (int i = 0; i < kMotionOctantCount; ++i) {
+        EXPECT_EQ(merged.octants[i], expected.octants[i]) << i;
+    }
+    
+    // Merging into an empty accumulator copies
+    MotionAccumulator empty;
+    empty.merge(expected);
+    EXPECT_EQ(empty.count, expected.count);
+    EXPECT_EQ(empty.minMagnitude, expected.minMagnitude);
+}
+
+TEST(MotionFieldTest, AccumulatorMatchesVectorRecords) {
+    MotionField field;
+    std::vector<int16_t> dx, dy;
+    randomField(777, 40, 4, dx, dy);
+    field.dx = dx;
+    field.dy = dy;
+    field.x.assign(dx.size(), 8);
+    field.y.assign(dx.size(), 8);
+    field.width.assign(dx.size(), 16);
+    field.height.assign(dx.size(), 16);
+    
+    MotionAccumulator fromField = MotionAccumulator::fromField(field);
+    MotionAccumulator fromVectors = MotionAccumulator::fromVectors(toMotionVectorData(field).vectors);
+    EXPECT_EQ(fromField.count, fromVectors.count);
+    EXPECT_NEAR(fromField.sumMagnitude, fromVectors.sumMagnitude, 1e-3);
+    EXPECT_EQ(fromField.staticCount, fromVectors.staticCount);
+    EXPECT_EQ(fromField.highMotionCount, fromVectors.highMotionCount);
+    for (int i = 0; i < kMotionOctantCount; ++i) {
+        EXPECT_EQ(fromField.octants[i], fromVectors.octants[i]) << i;
+    }
+}
+
+TEST(MotionFieldTest, AccumulatorToStatistics) {
+    MotionField field;
+    field.dx = {0, 3, 0, -20};
+    field.dy = {0, 4, 12, 0};
+    
+    MotionStatistics stats = MotionAccumulator::fromField(field).toStatistics();
+    EXPECT_DOUBLE_EQ(stats.averageMagnitude, (0.0 + 5.0 + 12.0 + 20.0) / 4.0);
+    EXPECT_DOUBLE_EQ(stats.maxMagnitude, 20.0);
+    EXPECT_DOUBLE_EQ(stats.minMagnitude, 0.0);
+    EXPECT_EQ(stats.staticRegions, 1);
+    EXPECT_EQ(stats.highMotionRegions, 2);
+    EXPECT_EQ(stats.directionDistribution.at("NE"), 1);
+    EXPECT_EQ(stats.directionDistribution.at("N"), 1);
+    EXPECT_EQ(stats.directionDistribution.at("W"), 1);
+    
+    MotionStatistics none = MotionAccumulator().toStatistics();
+    EXPECT_DOUBLE_EQ(none.averageMagnitude, 0.0);
+    EXPECT_TRUE(none.directionDistribution.empty());
+}
@@ -0,0 +1,184 @@
+#include "video_analyzer/motion_heatmap.h"
+#include "video_analyzer/thread_pool.h"
+#include <gtest/gtest.h>
+#include <optional>
+#include <random>
+#include <stdexcept>
+
+using namespace video_analyzer;
+
+namespace {
+
+// Frame of 16x16 macroblocks with random quarter-pel motion
+MotionField randomField(int width, int height, int64_t pts, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(-64, 64);
+    MotionField field;
+    field.pts = pts;
+    field.motionScale = 4;
+    for (int y = 8; y < height; y += 16) {
+        for (int x = 8; x < width; x += 16) {
+            field.x.push_back(static_cast<int16_t>(x));
+            field.y.push_back(static_cast<int16_t>(y));
+            field.dx.push_back(static_cast<int16_t>(dist(rng)));
+            field.dy.push_back(static_cast<int16_t>(dist(rng)));
+            field.width.push_back(16);
+            field.height.push_back(16);
+        }
+    }
+    return field;
+}
+
+void addVector(MotionField& field, int x, int y, int dx, int dy, int width, int height) {
+    field.x.push_back(static_cast<int16_t>(x));
+    field.y.push_back(static_cast<int16_t>(y));
+    field.dx.push_back(static_cast<int16_t>(dx));
+    field.dy.push_back(static_cast<int16_t>(dy));
+    field.width.push_back(static_cast<uint8_t>(width));
+    field.height.push_back(static_cast<uint8_t>(height));
+}
+
+FrameInfo frameAt(int64_t pts, bool keyframe) {
+    FrameInfo frame{};
+    frame.pts = pts;
+    frame.type = keyframe ? FrameType::I_FRAME : FrameType::P_FRAME;
+    frame.isKeyFrame = keyframe;
+    return frame;
+}
+
+StreamInfo streamOf(int width, int height) {
+    StreamInfo info{};
+    info.width = width;
+    info.height = height;
+    return info;
+}
+
+// Feed frames 0..count-1 with a keyframe every gopLength frames; keyframes
+// carry no vectors
+std::vector<MotionHeatmap> runSink(MotionHeatmapSink& sink, int count, int gopLength) {
+    sink.begin(streamOf(320, 240));
+    for (int i = 0; i < count; ++i) {
+        bool keyframe = i % gopLength == 0;
+        std::optional<MotionField> field;
+        if (!keyframe) {
+            field = randomField(320, 240, i, i + 1);
+        }
+        sink.addFrame(frameAt(i, keyframe), std::move(field));
+    }
+    sink.end();
+    return sink.takeHeatmaps();
+}
+
+} // namespace
+
+TEST(MotionHeatmapTest, GridCoversFrame) {
+    MotionHeatmap heatmap = MotionHeatmap::forFrame(1920, 1080);
+    EXPECT_EQ(heatmap.columns, 120);
+    EXPECT_EQ(heatmap.rows, 68);  // Partial bottom row
+    EXPECT_EQ(heatmap.means().size(), 120u * 68u);
+    EXPECT_TRUE(heatmap.empty());
+    EXPECT_EQ(heatmap.maxMean(), 0.0f);
+}
+
+TEST(MotionHeatmapTest, WeightsByCoveredArea) {
+    MotionHeatmap heatmap = MotionHeatmap::forFrame(64, 32);
+    
+    MotionField field;
+    field.motionScale = 1;
+    addVector(field, 8, 8, 3, 4, 16, 16);     // Cell (0, 0), magnitude 5
+    addVector(field, 20, 4, 0, 10, 8, 8);     // Quarter of cell (1, 0), magnitude 10
+    addVector(field, 24, 12, 0, 2, 16, 8);    // Half of cell (1, 0), magnitude 2
+    addVector(field, 48, 16, 6, 8, 32, 32);   // Cells (2..3, 0..1), magnitude 10
+    addVector(field, 200, 200, 9, 9, 16, 16); // Outside the frame
+    heatmap.accumulate(field);
+    
+    EXPECT_EQ(heatmap.frameCount, 1);
+    EXPECT_FLOAT_EQ(heatmap.mean(0, 0), 5.0f);
+    EXPECT_FLOAT_EQ(heatmap.mean(1, 0), (10.0f * 64 + 2.0f * 128) / 192);
+    EXPECT_FLOAT_EQ(heatmap.mean(2, 1), 10.0f);
+    EXPECT_FLOAT_EQ(heatmap.mean(3, 0), 10.0f);
+    EXPECT_EQ(heatmap.mean(0, 1), 0.0f);
+    EXPECT_FLOAT_EQ(heatmap.maxMean(), 10.0f);
+    
+    // Quarter-pel units are converted to pixels
+    MotionHeatmap scaled = MotionHeatmap::forFrame(64, 32);
+    field.motionScale = 4;
+    scaled.accumulate(field);
+    EXPECT_FLOAT_EQ(scaled.mean(0, 0), 1.25f);
+}
+
+TEST(MotionHeatmapTest, MergeRequiresSameGrid) {
+    MotionHeatmap a = MotionHeatmap::forFrame(64, 64);
+    MotionHeatmap b = MotionHeatmap::forFrame(64, 64);
+    a.accumulate(randomField(64, 64, 0, 1));
+    b.accumulate(randomField(64, 64, 1, 2));
+    a.merge(b);
+    EXPECT_EQ(a.frameCount, 2);
+    
+    MotionHeatmap other = MotionHeatmap::forFrame(128, 64);
+    EXPECT_THROW(a.merge(other), std::runtime_error);
+}
+
+TEST(MotionHeatmapTest, SinkBuildsOneHeatmapPerGOP) {
+    MotionHeatmapSink sink;
+    auto heatmaps = runSink(sink, 25, 10);
+    
+    ASSERT_EQ(heatmaps.size(), 3u);
+    EXPECT_EQ(heatmaps[0].startPts, 0);
+    EXPECT_EQ(heatmaps[0].endPts, 9);
+    EXPECT_EQ(heatmaps[2].startPts, 20);
+    EXPECT_EQ(heatmaps[2].endPts, 24);
+    EXPECT_EQ(heatmaps[0].frameCount, 9);  // The keyframe has no vectors
+    EXPECT_EQ(heatmaps[2].frameCount, 4);
+    EXPECT_EQ(heatmaps[0].columns, 20);
+    
+    // Same as accumulating the GOP's fields directly
+    MotionHeatmap expected = MotionHeatmap::forFrame(320, 240);
+    for (int i = 11; i < 20; ++i) {
+        expected.accumulate(randomField(320, 240, i, i + 1));
+    }
+    EXPECT_EQ(heatmaps[1].coverage, expected.coverage);
+    EXPECT_EQ(heatmaps[1].weightedSum, expected.weightedSum);
+}
+
+TEST(MotionHeatmapTest, SinkParallelMatchesSerial) {
+    MotionHeatmapSink serialSink;
+    auto serial = runSink(serialSink, 403, 150);
+    
+    ThreadPool pool(4);
+    MotionHeatmapSink parallelSink(&pool);
+    auto parallel = runSink(parallelSink, 403, 150);
+    
+    ASSERT_EQ(serial.size(), 3u);
+    ASSERT_EQ(parallel.size(), serial.size());
+    for (size_t g = 0; g < serial.size(); ++g) {
+        EXPECT_EQ(parallel[g].frameCount, serial[g].frameCount);
+        EXPECT_EQ(parallel[g].startPts, serial[g].startPts);
+        EXPECT_EQ(parallel[g].endPts, serial[g].endPts);
+        EXPECT_EQ(parallel[g].coverage, serial[g].coverage);
+        for (size_t i = 0; i < serial[g].weightedSum.size(); ++i) {
+            EXPECT_NEAR(parallel[g].weightedSum[i], serial[g].weightedSum[i],
+                        1e-9 * serial[g].weightedSum[i]);
+        }
+    }
+    
+    // A new run starts over
+    EXPECT_EQ(runSink(parallelSink, 5, 10).size(), 1u);
+}
+
+TEST(MotionHeatmapTest, JsonSerialization) {
+    MotionHeatmap heatmap = MotionHeatmap::forFrame(32, 16);
+    MotionField field;
+    addVector(field, 8, 8, 0, 7, 16, 16);
+    heatmap.accumulate(field);
+    
+    auto j = heatmap.toJson();
+    EXPECT_EQ(j["blockSize"], 16);
+    EXPECT_EQ(j["columns"], 2);
+    EXPECT_EQ(j["rows"], 1);
+    EXPECT_EQ(j["frameCount"], 1);
+    EXPECT_EQ(j["startPts"], 0);
+    ASSERT_EQ(j["means"].size(), 2u);
+    EXPECT_FLOAT_EQ(j["means"][0].get<float>(), 7.0f);
+    EXPECT_FLOAT_EQ(j["means"][1].get<float>(), 0.0f);
+}
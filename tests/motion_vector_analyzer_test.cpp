@@ -1,6 +1,7 @@
 #include "video_analyzer/motion_vector_analyzer.h"
 #include "video_analyzer/video_decoder.h"
 #include "video_analyzer/gop_analyzer.h"
+#include "video_analyzer/thread_pool.h"
 #include <gtest/gtest.h>
 #include <filesystem>
 
@@ -39,6 +40,33 @@ TEST_F(MotionVectorAnalyzerTest, ExtractMotionVectors) {
     }
 }
 
+// Test that registering the analyzer in a pipeline turns on motion vector export
+TEST_F(MotionVectorAnalyzerTest, PipelineEnablesMotionVectorExport) {
+    VideoDecoder decoder(testVideoPath);
+    ASSERT_FALSE(decoder.isMotionVectorExportEnabled());
+    
+    // Sinks that don't read motion vectors leave export off
+    FrameCollector collector;
+    AnalysisPipeline gopPipeline(decoder);
+    gopPipeline.addSink(collector);
+    gopPipeline.run(10);
+    EXPECT_FALSE(decoder.isMotionVectorExportEnabled());
+    
+    MotionVectorAnalyzer analyzer(decoder);
+    AnalysisPipeline pipeline(decoder);
+    pipeline.addSink(analyzer);
+    size_t frameCount = pipeline.run();
+    
+    EXPECT_TRUE(decoder.isMotionVectorExportEnabled());
+    EXPECT_EQ(analyzer.getMotionVectorData().size(), frameCount);
+    
+    size_t vectorCount = 0;
+    for (const auto& frameData : analyzer.getMotionVectorData()) {
+        vectorCount += frameData.vectors.size();
+    }
+    EXPECT_GT(vectorCount, 0u);
+}
+
 // Test statistics computation
 TEST_F(MotionVectorAnalyzerTest, ComputeStatistics) {
     VideoDecoder decoder(testVideoPath);
@@ -116,6 +144,42 @@ TEST_F(MotionVectorAnalyzerTest, AggregateByGOP) {
     }
 }
 
+// Fields and per-vector records, serial or pooled, give the same GOP statistics
+TEST_F(MotionVectorAnalyzerTest, AggregateByGOPMatchesAcrossInputs) {
+    VideoDecoder decoder(testVideoPath);
+    MotionVectorAnalyzer mvAnalyzer(decoder);
+    
+    decoder.reset();
+    GOPAnalyzer gopAnalyzer(decoder);
+    auto gops = gopAnalyzer.analyze();
+    
+    decoder.reset();
+    mvAnalyzer.extractMotionVectors();
+    const auto& fields = mvAnalyzer.getMotionFields();
+    auto mvData = mvAnalyzer.getMotionVectorData();
+    
+    if (fields.empty() || gops.empty()) {
+        GTEST_SKIP() << "No motion vector or GOP data available";
+    }
+    
+    auto serial = mvAnalyzer.aggregateByGOP(fields, gops);
+    ThreadPool pool(4);
+    mvAnalyzer.setThreadPool(&pool);
+    auto pooled = mvAnalyzer.aggregateByGOP(fields, gops);
+    auto fromRecords = mvAnalyzer.aggregateByGOP(mvData, gops);
+    
+    ASSERT_EQ(serial.size(), gops.size());
+    ASSERT_EQ(pooled.size(), gops.size());
+    ASSERT_EQ(fromRecords.size(), gops.size());
+    for (size_t i = 0; i < gops.size(); ++i) {
+        EXPECT_DOUBLE_EQ(pooled[i].averageMagnitude, serial[i].averageMagnitude);
+        EXPECT_EQ(pooled[i].directionDistribution, serial[i].directionDistribution);
+        EXPECT_NEAR(fromRecords[i].averageMagnitude, serial[i].averageMagnitude, 1e-3);
+        EXPECT_EQ(fromRecords[i].staticRegions, serial[i].staticRegions);
+        EXPECT_EQ(fromRecords[i].highMotionRegions, serial[i].highMotionRegions);
+    }
+}
+
 // Test region classification
 TEST_F(MotionVectorAnalyzerTest, RegionClassification) {
     VideoDecoder decoder(testVideoPath);
@@ -0,0 +1,291 @@
+#include "video_analyzer/multi_stream_monitor.h"
+#include "video_analyzer/ffmpeg_error.h"
+#include <gtest/gtest.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace video_analyzer;
+
+// Local files and UDP loopback feeds stand in for live feeds
+
+namespace {
+
+// Remuxes a file to MPEG-TS over UDP, looping, until stopped; afterwards
+// the receiving end stays open but idle
+class UdpSender {
+public:
+    UdpSender(const std::string& path, const std::string& url)
+        : thread_([this, path, url] { run(path, url); }) {}
+    
+    ~UdpSender() {
+        stop();
+    }
+    
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    
+    bool failed() const {
+        return failed_;
+    }
+    
+private:
+    void run(const std::string& path, const std::string& url) {
+        AVFormatContext* input = nullptr;
+        AVFormatContext* output = nullptr;
+        AVPacket* packet = av_packet_alloc();
+        
+        int videoStream = -1;
+        if (avformat_open_input(&input, path.c_str(), nullptr, nullptr) < 0 ||
+            avformat_find_stream_info(input, nullptr) < 0 ||
+            (videoStream = av_find_best_stream(input, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0)) < 0 ||
+            avformat_alloc_output_context2(&output, nullptr, "mpegts", url.c_str()) < 0) {
+            failed_ = true;
+        }
+        
+        if (!failed_) {
+            AVStream* stream = avformat_new_stream(output, nullptr);
+            avcodec_parameters_copy(stream->codecpar, input->streams[videoStream]->codecpar);
+            stream->codecpar->codec_tag = 0;
+            stream->time_base = input->streams[videoStream]->time_base;
+            failed_ = avio_open(&output->pb, url.c_str(), AVIO_FLAG_WRITE) < 0 ||
+                      avformat_write_header(output, nullptr) < 0;
+        }
+        
+        // Loop the file with increasing timestamps until stopped
+        int64_t offset = 0;
+        int64_t lastDts = 0;
+        while (!failed_ && running_) {
+            int ret = av_read_frame(input, packet);
+            if (ret == AVERROR_EOF) {
+                offset = lastDts + 1;
+                av_seek_frame(input, videoStream, 0, AVSEEK_FLAG_BACKWARD);
+                continue;
+            }
+            if (ret < 0) {
+                failed_ = true;
+                break;
+            }
+            if (packet->stream_index == videoStream) {
+                av_packet_rescale_ts(packet, input->streams[videoStream]->time_base, output->streams[0]->time_base);
+                packet->pts = packet->pts == AV_NOPTS_VALUE ? AV_NOPTS_VALUE : packet->pts + offset;
+                packet->dts = packet->dts == AV_NOPTS_VALUE ? AV_NOPTS_VALUE : packet->dts + offset;
+                if (packet->dts != AV_NOPTS_VALUE) {
+                    lastDts = packet->dts;
+                }
+                packet->stream_index = 0;
+                packet->pos = -1;
+                av_interleaved_write_frame(output, packet);
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            av_packet_unref(packet);
+        }
+        
+        av_packet_free(&packet);
+        if (output) {
+            avio_closep(&output->pb);
+            avformat_free_context(output);
+        }
+        avformat_close_input(&input);
+    }
+    
+    std::atomic<bool> running_{true};
+    std::atomic<bool> failed_{false};
+    std::thread thread_;
+};
+
+} // namespace
+
+class MultiStreamMonitorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testVideoPath = "test_videos/test_h264_720p_60fps.mp4";
+        
+        if (!std::filesystem::exists(testVideoPath)) {
+            GTEST_SKIP() << "Test video not found: " << testVideoPath;
+        }
+    }
+    
+    std::string testVideoPath;
+};
+
+TEST_F(MultiStreamMonitorTest, ThreadCountIndependentOfStreams) {
+    MonitorOptions options;
+    options.workerThreads = 2;
+    options.demuxThreads = 1;
+    MultiStreamMonitor monitor(options);
+    
+    size_t threadsBefore = monitor.getThreadCount();
+    for (int i = 0; i < 8; ++i) {
+        monitor.addStream(testVideoPath);
+    }
+    
+    EXPECT_EQ(monitor.getStreamCount(), 8u);
+    EXPECT_EQ(monitor.getThreadCount(), threadsBefore);
+}
+
+TEST_F(MultiStreamMonitorTest, AnalyzesAllStreams) {
+    MonitorOptions options;
+    options.workerThreads = 2;
+    options.maxQueuedPackets = 100000;  // Finite inputs: analyze every frame
+    MultiStreamMonitor monitor(options);
+    
+    std::atomic<uint64_t> callbackFrames{0};
+    monitor.setFrameCallback([&callbackFrames](int, const FrameInfo&) {
+        callbackFrames++;
+    });
+    
+    int first = monitor.addStream(testVideoPath);
+    int second = monitor.addStream(testVideoPath);
+    monitor.start();
+    ASSERT_TRUE(monitor.waitForCompletion(std::chrono::seconds(60)));
+    
+    auto status = monitor.getStatus();
+    ASSERT_EQ(status.size(), 2u);
+    EXPECT_EQ(status[0].id, first);
+    EXPECT_EQ(status[1].id, second);
+    for (const auto& stream : status) {
+        EXPECT_FALSE(stream.active);
+        EXPECT_GT(stream.framesAnalyzed, 0u);
+        EXPECT_EQ(stream.packetsDropped, 0u);
+    }
+    
+    // Identical inputs produce identical results
+    EXPECT_EQ(status[0].framesAnalyzed, status[1].framesAnalyzed);
+    EXPECT_EQ(callbackFrames, status[0].framesAnalyzed * 2);
+    EXPECT_GT(monitor.getFrameStats(first).totalFrames, 0);
+    
+    monitor.stop();
+}
+
+TEST_F(MultiStreamMonitorTest, ExportsPerStreamJsonLines) {
+    std::filesystem::path exportDir = std::filesystem::temp_directory_path() / "multi_stream_monitor_test";
+    std::filesystem::remove_all(exportDir);
+    
+    MonitorOptions options;
+    options.workerThreads = 1;
+    options.maxQueuedPackets = 100000;
+    options.exportDirectory = exportDir.string();
+    
+    uint64_t framesAnalyzed = 0;
+    {
+        MultiStreamMonitor monitor(options);
+        int id = monitor.addStream(testVideoPath);
+        monitor.start();
+        ASSERT_TRUE(monitor.waitForCompletion(std::chrono::seconds(60)));
+        framesAnalyzed = monitor.getStatus()[0].framesAnalyzed;
+        EXPECT_EQ(id, 0);
+    }
+    
+    std::ifstream exported(exportDir / "stream_0.jsonl");
+    ASSERT_TRUE(exported.is_open());
+    uint64_t lines = 0;
+    for (std::string line; std::getline(exported, line);) {
+        lines++;
+    }
+    EXPECT_EQ(lines, framesAnalyzed);
+    
+    std::filesystem::remove_all(exportDir);
+}
+
+TEST_F(MultiStreamMonitorTest, RemoveStream) {
+    MultiStreamMonitor monitor;
+    int id = monitor.addStream(testVideoPath);
+    monitor.start();
+    
+    EXPECT_TRUE(monitor.removeStream(id));
+    EXPECT_FALSE(monitor.removeStream(id));
+    EXPECT_EQ(monitor.getStreamCount(), 0u);
+    EXPECT_TRUE(monitor.getAnomalies(id).empty());
+    EXPECT_TRUE(monitor.waitForCompletion(std::chrono::milliseconds(10)));
+}
+
+TEST_F(MultiStreamMonitorTest, CallbackExceptionFailsStream) {
+    MonitorOptions options;
+    options.workerThreads = 2;
+    options.maxQueuedPackets = 100000;
+    MultiStreamMonitor monitor(options);
+    
+    monitor.setFrameCallback([](int, const FrameInfo&) {
+        throw std::runtime_error("callback failed");
+    });
+    
+    monitor.addStream(testVideoPath);
+    monitor.start();
+    
+    // The failed stream counts as completed instead of hanging unscheduled
+    ASSERT_TRUE(monitor.waitForCompletion(std::chrono::seconds(60)));
+    
+    auto status = monitor.getStatus();
+    ASSERT_EQ(status.size(), 1u);
+    EXPECT_TRUE(status[0].failed);
+    EXPECT_EQ(status[0].error, "callback failed");
+    EXPECT_EQ(status[0].framesAnalyzed, 1u);
+    EXPECT_EQ(status[0].toJson()["error"], "callback failed");
+    
+    monitor.stop();
+}
+
+TEST_F(MultiStreamMonitorTest, IdleUdpStreamDoesNotStallOthers) {
+    int port = 20000 + static_cast<int>(getpid() % 20000);
+    std::string url = "udp://127.0.0.1:" + std::to_string(port);
+    
+    MonitorOptions options;
+    options.workerThreads = 2;
+    options.demuxThreads = 1;  // Both streams share one demux thread
+    options.maxQueuedPackets = 100000;
+    MultiStreamMonitor monitor(options);
+    
+    // Opening probes while the feed sends; afterwards it goes silent
+    int idle = -1;
+    {
+        UdpSender sender(testVideoPath, url);
+        try {
+            idle = monitor.addStream(url);
+        } catch (const FFmpegError& e) {
+            GTEST_SKIP() << "UDP loopback not available: " << e.what();
+        }
+        ASSERT_FALSE(sender.failed());
+    }
+    int file = monitor.addStream(testVideoPath);
+    monitor.start();
+    
+    // The file is read to the end although the idle feed never delivers
+    // another packet; a blocking read would hold the demux thread
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (monitor.getStatus()[1].active && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    
+    auto status = monitor.getStatus();
+    ASSERT_EQ(status.size(), 2u);
+    EXPECT_EQ(status[0].id, idle);
+    EXPECT_EQ(status[1].id, file);
+    EXPECT_FALSE(status[1].active);
+    EXPECT_GT(status[1].packetsRead, 0u);
+    
+    // Idle, not ended: a read timeout on a blocking socket would have ended it
+    EXPECT_TRUE(status[0].active);
+    EXPECT_FALSE(status[0].failed);
+    
+    monitor.stop();
+}
+
+TEST(MultiStreamMonitorErrorTest, InvalidStreamUrl) {
+    MultiStreamMonitor monitor;
+    EXPECT_THROW(monitor.addStream("nonexistent_stream_input.mp4"), FFmpegError);
+    EXPECT_EQ(monitor.getStreamCount(), 0u);
+}
@@ -0,0 +1,76 @@
+#include "video_analyzer/qp_extractor.h"
+#include "video_analyzer/video_decoder.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <vector>
+
+using namespace video_analyzer;
+
+TEST(QPExtractorTest, ReduceEmptyUsesFrameQP) {
+    QPStatistics stats = reduceBlockQP(nullptr, 0, 30);
+    EXPECT_EQ(stats.average, 30);
+    EXPECT_EQ(stats.min, 30);
+    EXPECT_EQ(stats.max, 30);
+    EXPECT_EQ(stats.blockCount, 0);
+}
+
+TEST(QPExtractorTest, ReduceBlockDeltas) {
+    std::vector<int32_t> deltas = {-4, 0, 2, 6};
+    QPStatistics stats = reduceBlockQP(deltas.data(), deltas.size(), 26);
+    
+    EXPECT_EQ(stats.min, 22);
+    EXPECT_EQ(stats.max, 32);
+    EXPECT_EQ(stats.average, 27);  // 26 + round(4 / 4)
+    EXPECT_EQ(stats.blockCount, 4);
+}
+
+TEST(QPExtractorTest, ReduceAcrossChunks) {
+    // More elements than one reduction chunk, including extremes
+    std::vector<int32_t> deltas(100000, 1);
+    deltas[12345] = -20;
+    deltas[99999] = 25;
+    
+    QPStatistics stats = reduceBlockQP(deltas.data(), deltas.size(), 20);
+    EXPECT_EQ(stats.min, 0);
+    EXPECT_EQ(stats.max, 45);
+    EXPECT_EQ(stats.average, 21);
+}
+
+TEST(QPExtractorTest, NullFrame) {
+    EXPECT_FALSE(extractQPStatistics(nullptr).has_value());
+    EXPECT_FALSE(extractQPMap(nullptr).has_value());
+}
+
+TEST(QPExtractorTest, H264FrameQP) {
+    std::string videoPath = "../test_videos/test_h264_480p_24fps.mp4";
+    if (!std::filesystem::exists(videoPath)) {
+        GTEST_SKIP() << "Test video not found: " << videoPath;
+    }
+    
+    VideoDecoder decoder(videoPath);
+    int frameCount = 0;
+    bool sawNonZeroQP = false;
+    
+    while (auto frame = decoder.readNextFrame()) {
+        EXPECT_GE(frame->qpMin, 0);
+        EXPECT_LE(frame->qpMax, 51);
+        EXPECT_LE(frame->qpMin, frame->qp);
+        EXPECT_LE(frame->qp, frame->qpMax);
+        sawNonZeroQP = sawNonZeroQP || frame->qp > 0;
+        
+        if (frameCount == 0) {
+            // One QP value per 16x16 macroblock
+            auto map = decoder.getQPMap();
+            ASSERT_TRUE(map.has_value());
+            EXPECT_EQ(map->cellWidth, 16);
+            EXPECT_EQ(map->cellHeight, 16);
+            EXPECT_EQ(map->columns, 40);
+            EXPECT_EQ(map->rows, 30);
+            EXPECT_EQ(map->values.size(), 40u * 30u);
+        }
+        
+        if (++frameCount >= 30) break;
+    }
+    
+    EXPECT_TRUE(sawNonZeroQP);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "video_analyzer/data_models.h"
+#include <vector>
+
+namespace video_analyzer {
+namespace test {
+
+// Frames covering negative DTS, B-frame reordering, missing position and
+// duplicate groups; shared by the report writer and binary report tests
+inline std::vector<FrameInfo> makeReportFrames() {
+    std::vector<FrameInfo> frames;
+    frames.push_back({0, -1001, FrameType::I_FRAME, 48213, 24, true, 0.0, false, -1, 48, 20, 30});
+    frames.push_back({3003, 0, FrameType::B_FRAME, 912, 31, false, 1.0 / 30.0, false, -1, 48261, 28, 35});
+    frames.push_back({1501, 1001, FrameType::P_FRAME, 4096, 27, false, 2.0, true, 3, -1, 27, 27});
+    return frames;
+}
+
+} // namespace test
+} // namespace video_analyzer
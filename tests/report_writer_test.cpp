@@ -0,0 +1,120 @@
+#include "video_analyzer/report_writer.h"
+#include "report_test_frames.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace video_analyzer;
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+} // namespace
+
+TEST(ReportWriterTest, JsonMatchesFrameInfoToJson) {
+    std::string path = tempPath("report_writer_test.json");
+    auto frames = test::makeReportFrames();
+    
+    StreamInfo info{};
+    info.codecName = "h264";
+    info.width = 1920;
+    info.height = 1080;
+    
+    {
+        ReportWriter writer(path, ReportFormat::JSON);
+        writer.begin(info);
+        for (const auto& frame : frames) {
+            writer.writeFrame(frame);
+        }
+        writer.end();
+        writer.finish({{"gops", nlohmann::json::array({{{"startFrame", 0}}})}});
+        EXPECT_EQ(writer.getFramesWritten(), frames.size());
+    }
+    
+    nlohmann::json report = nlohmann::json::parse(readFile(path));
+    EXPECT_EQ(report["streamInfo"], info.toJson());
+    EXPECT_EQ(report["gops"][0]["startFrame"], 0);
+    ASSERT_EQ(report["frames"].size(), frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        EXPECT_EQ(report["frames"][i], frames[i].toJson()) << "frame " << i;
+    }
+    
+    std::filesystem::remove(path);
+}
+
+TEST(ReportWriterTest, JsonEmptyReportIsValid) {
+    std::string path = tempPath("report_writer_empty.json");
+    {
+        ReportWriter writer(path, ReportFormat::JSON);
+        writer.begin(StreamInfo{});
+        // Destructor finishes the report
+    }
+    
+    nlohmann::json report = nlohmann::json::parse(readFile(path));
+    EXPECT_TRUE(report["frames"].is_array());
+    EXPECT_TRUE(report["frames"].empty());
+    
+    std::filesystem::remove(path);
+}
+
+TEST(ReportWriterTest, CsvMatchesFrameInfoToCsv) {
+    std::string path = tempPath("report_writer_test.csv");
+    auto frames = test::makeReportFrames();
+    
+    {
+        ReportWriter writer(path, ReportFormat::CSV);
+        writer.begin(StreamInfo{});
+        for (const auto& frame : frames) {
+            writer.writeFrame(frame);
+        }
+        writer.finish();
+    }
+    
+    std::string expected = "pts,dts,type,size,qp,isKeyFrame,timestamp\n";
+    for (const auto& frame : frames) {
+        expected += frame.toCsv() + "\n";
+    }
+    EXPECT_EQ(readFile(path), expected);
+    
+    std::filesystem::remove(path);
+}
+
+TEST(ReportWriterTest, LargeReportSpansBufferFlushes) {
+    std::string path = tempPath("report_writer_large.json");
+    FrameInfo frame{0, 0, FrameType::P_FRAME, 1000, 26, false, 0.0, false, -1, 0, 26, 26};
+    const size_t frameCount = 20000;
+    
+    {
+        ReportWriter writer(path, ReportFormat::JSON);
+        writer.begin(StreamInfo{});
+        for (size_t i = 0; i < frameCount; ++i) {
+            frame.pts = static_cast<int64_t>(i) * 512;
+            frame.timestamp = static_cast<double>(i) / 60.0;
+            writer.writeFrame(frame);
+        }
+        writer.finish();
+    }
+    
+    nlohmann::json report = nlohmann::json::parse(readFile(path));
+    ASSERT_EQ(report["frames"].size(), frameCount);
+    EXPECT_EQ(report["frames"][frameCount - 1]["pts"], static_cast<int64_t>(frameCount - 1) * 512);
+    EXPECT_DOUBLE_EQ(report["frames"][12345]["timestamp"].get<double>(), 12345.0 / 60.0);
+    
+    std::filesystem::remove(path);
+}
+
+TEST(ReportWriterTest, OpenFailureThrows) {
+    EXPECT_THROW(ReportWriter("/nonexistent_dir/report.json", ReportFormat::JSON), std::runtime_error);
+}
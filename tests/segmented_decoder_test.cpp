@@ -0,0 +1,70 @@
+#include "video_analyzer/segmented_decoder.h"
+#include "video_analyzer/video_decoder.h"
+#include "video_analyzer/thread_pool.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+using namespace video_analyzer;
+
+class SegmentedDecoderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testVideoPath = "../test_videos/test_h264_720p_60fps.mp4";
+        if (!std::filesystem::exists(testVideoPath)) {
+            GTEST_SKIP() << "Test video not found: " << testVideoPath;
+        }
+    }
+    
+    std::string testVideoPath;
+};
+
+TEST_F(SegmentedDecoderTest, SegmentsCoverAllFrames) {
+    ThreadPool pool(4);
+    SegmentedDecoder decoder(testVideoPath, pool);
+    decoder.setSegmentCount(4);
+    
+    auto segments = decoder.planSegments();
+    ASSERT_FALSE(segments.empty());
+    
+    size_t expectedFirst = 0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        EXPECT_EQ(segments[i].firstFrame, expectedFirst);
+        EXPECT_GT(segments[i].frameCount, 0u);
+        if (i > 0) {
+            EXPECT_EQ(segments[i].startPts, segments[i - 1].endPts);
+        }
+        expectedFirst += segments[i].frameCount;
+    }
+    EXPECT_EQ(expectedFirst, decoder.getKeyframeIndex().getFrameCount());
+}
+
+TEST_F(SegmentedDecoderTest, MatchesSequentialDecode) {
+    VideoDecoder sequential(testVideoPath);
+    std::vector<FrameInfo> expected;
+    while (auto frame = sequential.readNextFrame()) {
+        expected.push_back(*frame);
+    }
+    
+    ThreadPool pool(4);
+    SegmentedDecoder decoder(testVideoPath, pool);
+    decoder.setSegmentCount(8);
+    auto frames = decoder.decodeAll();
+    
+    ASSERT_EQ(frames.size(), expected.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        EXPECT_EQ(frames[i].pts, expected[i].pts) << "Frame " << i;
+        EXPECT_EQ(frames[i].type, expected[i].type) << "Frame " << i;
+        EXPECT_EQ(frames[i].size, expected[i].size) << "Frame " << i;
+        EXPECT_EQ(frames[i].isKeyFrame, expected[i].isKeyFrame) << "Frame " << i;
+    }
+}
+
+TEST_F(SegmentedDecoderTest, SingleSegment) {
+    ThreadPool pool(2);
+    SegmentedDecoder decoder(testVideoPath, pool);
+    decoder.setSegmentCount(1);
+    
+    auto segments = decoder.planSegments();
+    ASSERT_EQ(segments.size(), 1u);
+    EXPECT_EQ(decoder.decodeAll().size(), decoder.getKeyframeIndex().getFrameCount());
+}
@@ -0,0 +1,91 @@
+#include "video_analyzer/snapshot_ring.h"
+#include "video_analyzer/data_models.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace video_analyzer;
+
+TEST(SnapshotRingTest, KeepsMostRecentValues) {
+    SnapshotRing<int> ring(4);
+    EXPECT_EQ(ring.size(), 0u);
+    EXPECT_TRUE(ring.snapshot().empty());
+    
+    for (int i = 1; i <= 6; ++i) {
+        ring.push(i);
+    }
+    
+    EXPECT_EQ(ring.size(), 4u);
+    EXPECT_EQ(ring.totalPushed(), 6u);
+    EXPECT_EQ(ring.snapshot(), (std::vector<int>{3, 4, 5, 6}));
+    
+    std::vector<int> newest;
+    EXPECT_EQ(ring.snapshot(newest, 2), 2u);
+    EXPECT_EQ(newest, (std::vector<int>{5, 6}));
+    
+    ring.clear();
+    EXPECT_EQ(ring.size(), 0u);
+    ring.push(7);
+    EXPECT_EQ(ring.snapshot(), (std::vector<int>{7}));
+}
+
+TEST(SnapshotRingTest, StoresFrameInfo) {
+    SnapshotRing<FrameInfo> ring(2);
+    ring.push({100, 90, FrameType::I_FRAME, 4000, 24, true, 1.0, false, -1, 0, 24, 24});
+    ring.push({200, 190, FrameType::P_FRAME, 900, 28, false, 2.0, false, -1, 4000, 26, 30});
+    
+    auto frames = ring.snapshot();
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0].pts, 100);
+    EXPECT_EQ(frames[1].type, FrameType::P_FRAME);
+    EXPECT_EQ(frames[1].qpMax, 30);
+}
+
+// Readers running concurrently with the writer must always see a
+// contiguous, fully written run of values
+TEST(SnapshotRingTest, ConcurrentSnapshotsAreConsistent) {
+    struct Sample {
+        uint64_t value;
+        uint64_t check;
+    };
+    
+    SnapshotRing<Sample> ring(64);
+    std::atomic<bool> done{false};
+    const uint64_t total = 200000;
+    
+    std::thread writer([&] {
+        for (uint64_t i = 1; i <= total; ++i) {
+            ring.push({i, ~i});
+        }
+        done = true;
+    });
+    
+    std::vector<std::thread> readers;
+    std::atomic<int> failures{0};
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            std::vector<Sample> samples;
+            while (!done) {
+                ring.snapshot(samples);
+                for (size_t i = 0; i < samples.size(); ++i) {
+                    if (samples[i].check != ~samples[i].value ||
+                        (i > 0 && samples[i].value != samples[i - 1].value + 1)) {
+                        failures++;
+                        break;
+                    }
+                }
+            }
+        });
+    }
+    
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    
+    EXPECT_EQ(failures.load(), 0);
+    auto last = ring.snapshot();
+    ASSERT_EQ(last.size(), 64u);
+    EXPECT_EQ(last.back().value, total);
+}
@@ -298,3 +298,159 @@ TEST_F(ThreadPoolTest, AllTasksExecute) {
         EXPECT_TRUE(e);
     }
 }
+
+// Test: execute() with a CompletionLatch instead of futures
+TEST_F(ThreadPoolTest, ExecuteWithLatch) {
+    ThreadPool pool(4);
+    
+    std::atomic<int> counter{0};
+    CompletionLatch latch(100);
+    for (int i = 0; i < 100; ++i) {
+        pool.execute([&counter]() { counter++; }, &latch);
+    }
+    
+    pool.wait(latch);
+    EXPECT_TRUE(latch.isReady());
+    EXPECT_EQ(counter, 100);
+}
+
+// Test: submitBulk() runs every index once
+TEST_F(ThreadPoolTest, SubmitBulk) {
+    ThreadPool pool(4);
+    
+    std::vector<std::atomic<int>> hits(1000);
+    auto body = [&hits](size_t i) { hits[i]++; };
+    
+    CompletionLatch latch;
+    pool.submitBulk(hits.size(), body, latch);
+    latch.wait();
+    
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit, 1);
+    }
+}
+
+// Test: parallelFor() covers the range exactly once
+TEST_F(ThreadPoolTest, ParallelForCoversRange) {
+    ThreadPool pool(4);
+    
+    std::vector<int> values(10007, 0);
+    pool.parallelFor(0, values.size(), [&values](size_t i) {
+        values[i] = static_cast<int>(i) * 2;
+    });
+    
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(values[i], static_cast<int>(i) * 2);
+    }
+    
+    // Explicit grain size and an empty range
+    std::atomic<size_t> sum{0};
+    pool.parallelFor(10, 20, [&sum](size_t i) { sum += i; }, 3);
+    EXPECT_EQ(sum, 145u);
+    pool.parallelFor(5, 5, [](size_t) { FAIL(); });
+}
+
+// Test: nested parallelFor inside pool tasks does not deadlock
+TEST_F(ThreadPoolTest, NestedParallelFor) {
+    ThreadPool pool(2);
+    
+    std::atomic<int> counter{0};
+    pool.parallelFor(0, 8, [&pool, &counter](size_t) {
+        pool.parallelFor(0, 100, [&counter](size_t) { counter++; }, 10);
+    }, 1);
+    
+    EXPECT_EQ(counter, 800);
+}
+
+// Test: parallelFor() rethrows the exception of a failed iteration
+TEST_F(ThreadPoolTest, ParallelForExceptionPropagation) {
+    ThreadPool pool(4);
+    
+    EXPECT_THROW(pool.parallelFor(0, 100, [](size_t i) {
+        if (i == 42) {
+            throw std::runtime_error("iteration failed");
+        }
+    }, 1), std::runtime_error);
+    
+    // The pool stays usable
+    std::atomic<int> counter{0};
+    pool.parallelFor(0, 10, [&counter](size_t) { counter++; }, 1);
+    EXPECT_EQ(counter, 10);
+}
+
+// Test: tasks submitted from tasks are stolen by other workers
+TEST_F(ThreadPoolTest, TasksSpawnedByTasks) {
+    ThreadPool pool(4);
+    
+    std::atomic<int> counter{0};
+    CompletionLatch latch(1);
+    pool.execute([&pool, &counter, &latch]() {
+        latch.add(500);
+        for (int i = 0; i < 500; ++i) {
+            pool.execute([&counter]() { counter++; }, &latch);
+        }
+    }, &latch);
+    
+    latch.wait();
+    pool.waitAll();
+    EXPECT_EQ(counter, 500);
+}
+
+// Test: wait() outside the pool runs only the latch's own tasks
+TEST_F(ThreadPoolTest, ExternalWaitDoesNotRunUnrelatedTasks) {
+    ThreadPool pool(1);
+    
+    // Occupy the worker so queued tasks stay queued
+    std::atomic<bool> release{false};
+    std::atomic<bool> blocking{false};
+    pool.execute([&release, &blocking]() {
+        blocking = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!blocking) {
+        std::this_thread::yield();
+    }
+    
+    std::thread::id unrelatedThread;
+    pool.execute([&unrelatedThread]() { unrelatedThread = std::this_thread::get_id(); });
+    
+    std::atomic<int> counter{0};
+    CompletionLatch latch(10);
+    for (int i = 0; i < 10; ++i) {
+        pool.execute([&counter]() { counter++; }, &latch);
+    }
+    
+    // The only worker is blocked, so the caller runs its tasks itself
+    pool.wait(latch);
+    EXPECT_EQ(counter, 10);
+    EXPECT_EQ(unrelatedThread, std::thread::id());
+    
+    release = true;
+    pool.waitAll();
+    EXPECT_NE(unrelatedThread, std::thread::id());
+    EXPECT_NE(unrelatedThread, std::this_thread::get_id());
+}
+
+// Test: parallelForIfLarge() runs small ranges serially on the caller
+TEST_F(ThreadPoolTest, ParallelForIfLargeThreshold) {
+    ThreadPool pool(4);
+    
+    std::vector<std::thread::id> threads(16);
+    parallelForIfLarge(&pool, 0, threads.size(), 64, [&threads](size_t i) {
+        threads[i] = std::this_thread::get_id();
+    });
+    for (const auto& id : threads) {
+        EXPECT_EQ(id, std::this_thread::get_id());
+    }
+    
+    // Without a pool every range is serial; large ranges cover every index
+    std::vector<int> values(1000, 0);
+    parallelForIfLarge(nullptr, 0, values.size(), 1, [&values](size_t i) { values[i]++; });
+    parallelForIfLarge(&pool, 0, values.size(), 64, [&values](size_t i) { values[i]++; });
+    for (int value : values) {
+        EXPECT_EQ(value, 2);
+    }
+    parallelForIfLarge(&pool, 5, 5, 0, [](size_t) { FAIL(); });
+}
@@ -1,6 +1,94 @@
-// Placeholder for video analyzer tests
+#include "video_analyzer/video_analyzer.h"
 #include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace video_analyzer;
 
 TEST(VideoAnalyzerTest, Placeholder) {
     EXPECT_TRUE(true);
 }
+
+namespace {
+
+// Poll until the background analysis has been merged
+void pollUntilDone(VideoAnalyzer& analyzer) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (analyzer.isAnalyzing() && std::chrono::steady_clock::now() < deadline) {
+        analyzer.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+} // namespace
+
+TEST(VideoAnalyzerTest, BackgroundAnalysisReportsOpenFailure) {
+    VideoAnalyzer analyzer;
+    EXPECT_FALSE(analyzer.isAnalyzing());
+    
+    analyzer.startAnalysis("/nonexistent/video.mp4");
+    EXPECT_TRUE(analyzer.isAnalyzing());
+    
+    bool threw = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (analyzer.isAnalyzing() && std::chrono::steady_clock::now() < deadline) {
+        try {
+            analyzer.poll();
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    
+    EXPECT_TRUE(threw);
+    EXPECT_FALSE(analyzer.isAnalyzing());
+    EXPECT_FALSE(analyzer.hasStreamInfo());
+    EXPECT_TRUE(analyzer.getFrames().empty());
+}
+
+TEST(VideoAnalyzerTest, BackgroundAnalysisMatchesSynchronous) {
+    std::string path = "../test_videos/test_h264_480p_24fps.mp4";
+    if (!std::filesystem::exists(path)) {
+        GTEST_SKIP() << "Test video not found: " << path;
+    }
+    
+    VideoAnalyzer sync;
+    sync.analyze(path);
+    
+    VideoAnalyzer async;
+    async.startAnalysis(path);
+    pollUntilDone(async);
+    
+    ASSERT_FALSE(async.isAnalyzing());
+    EXPECT_TRUE(async.hasStreamInfo());
+    ASSERT_EQ(async.getFrames().size(), sync.getFrames().size());
+    ASSERT_EQ(async.getGOPs().size(), sync.getGOPs().size());
+    for (size_t i = 0; i < sync.getFrames().size(); ++i) {
+        EXPECT_EQ(async.getFrames()[i].pts, sync.getFrames()[i].pts);
+        EXPECT_EQ(async.getFrames()[i].isDuplicate, sync.getFrames()[i].isDuplicate);
+    }
+    EXPECT_EQ(async.getFrameStatistics().totalFrames, sync.getFrameStatistics().totalFrames);
+    
+    AnalysisProgress progress = async.getProgress();
+    EXPECT_FALSE(progress.running);
+    EXPECT_FALSE(progress.cancelled);
+    EXPECT_DOUBLE_EQ(progress.fraction, 1.0);
+    EXPECT_EQ(progress.framesDecoded, sync.getFrames().size());
+}
+
+TEST(VideoAnalyzerTest, CancelKeepsPartialResults) {
+    std::string path = "../test_videos/test_h264_480p_24fps.mp4";
+    if (!std::filesystem::exists(path)) {
+        GTEST_SKIP() << "Test video not found: " << path;
+    }
+    
+    VideoAnalyzer analyzer;
+    analyzer.startAnalysis(path);
+    analyzer.cancelAnalysis();
+    pollUntilDone(analyzer);
+    
+    EXPECT_FALSE(analyzer.isAnalyzing());
+    EXPECT_TRUE(analyzer.getProgress().cancelled);
+    EXPECT_EQ(analyzer.getFrames().size(), analyzer.getProgress().framesDecoded);
+}
@@ -2,6 +2,8 @@
 #include "video_analyzer/ffmpeg_error.h"
 #include <gtest/gtest.h>
 #include <thread>
+#include <vector>
+#include <map>
 
 using namespace video_analyzer;
 
@@ -339,3 +341,134 @@ TEST(VideoDecoderTest, NonAV1_NoTileInfo) {
     auto json = info.toJson();
     EXPECT_FALSE(json.contains("av1TileInfo"));
 }
+
+// Test that header scan reports the same frames as a full decode
+TEST(VideoDecoderTest, HeaderScanMatchesFullDecode) {
+    VideoDecoder fullDecoder("../test_videos/test_h264_480p_24fps.mp4");
+    
+    DecoderOptions options;
+    options.mode = DecodeMode::HEADER_SCAN;
+    VideoDecoder scanDecoder("../test_videos/test_h264_480p_24fps.mp4", options);
+    EXPECT_EQ(scanDecoder.getDecodeMode(), DecodeMode::HEADER_SCAN);
+    
+    std::vector<FrameInfo> fullFrames;
+    while (auto frame = fullDecoder.readNextFrame()) {
+        fullFrames.push_back(*frame);
+    }
+    
+    std::vector<FrameInfo> scanFrames;
+    while (auto frame = scanDecoder.readNextFrame()) {
+        scanFrames.push_back(*frame);
+    }
+    
+    ASSERT_EQ(scanFrames.size(), fullFrames.size());
+    for (size_t i = 0; i < scanFrames.size(); ++i) {
+        EXPECT_EQ(scanFrames[i].pts, fullFrames[i].pts) << "Frame " << i;
+        EXPECT_EQ(scanFrames[i].type, fullFrames[i].type) << "Frame " << i;
+        EXPECT_EQ(scanFrames[i].isKeyFrame, fullFrames[i].isKeyFrame) << "Frame " << i;
+        EXPECT_GT(scanFrames[i].size, 0);
+    }
+    
+    // No pixels are decoded in header scan mode
+    EXPECT_EQ(scanDecoder.getLastDecodedFrame(), nullptr);
+}
+
+// Test that header scan can be reset and rescanned
+TEST(VideoDecoderTest, HeaderScanReset) {
+    DecoderOptions options;
+    options.mode = DecodeMode::HEADER_SCAN;
+    VideoDecoder decoder("../test_videos/test_h264_480p_24fps.mp4", options);
+    
+    int firstPass = 0;
+    while (decoder.readNextFrame()) {
+        firstPass++;
+    }
+    EXPECT_FALSE(decoder.hasMoreFrames());
+    
+    decoder.reset();
+    int secondPass = 0;
+    while (decoder.readNextFrame()) {
+        secondPass++;
+    }
+    
+    EXPECT_GT(firstPass, 0);
+    EXPECT_EQ(firstPass, secondPass);
+}
+
+// Test that a reset mid-stream classifies frames like a fresh scan
+TEST(VideoDecoderTest, HeaderScanResetMidStream) {
+    DecoderOptions options;
+    options.mode = DecodeMode::HEADER_SCAN;
+    VideoDecoder freshDecoder("../test_videos/test_h264_480p_24fps.mp4", options);
+    VideoDecoder decoder("../test_videos/test_h264_480p_24fps.mp4", options);
+    
+    // Leave the parser in the middle of a GOP
+    for (int i = 0; i < 10 && decoder.readNextFrame(); ++i) {
+    }
+    decoder.reset();
+    
+    while (auto expected = freshDecoder.readNextFrame()) {
+        auto frame = decoder.readNextFrame();
+        ASSERT_TRUE(frame.has_value());
+        EXPECT_EQ(frame->pts, expected->pts);
+        EXPECT_EQ(frame->type, expected->type);
+        EXPECT_DOUBLE_EQ(frame->timestamp, expected->timestamp);
+        EXPECT_GE(frame->timestamp, 0.0);
+    }
+    EXPECT_FALSE(decoder.readNextFrame().has_value());
+}
+
+// Test that frame sizes are attributed to the right frame under frame threading
+TEST(VideoDecoderTest, MultiThreadedPacketSizeAttribution) {
+    // Header scan reads sizes straight from the packets
+    DecoderOptions options;
+    options.mode = DecodeMode::HEADER_SCAN;
+    VideoDecoder scanDecoder("test_videos/test_h264_720p_60fps.mp4", options);
+    
+    std::map<int64_t, std::pair<int, int64_t>> packetsByPts;
+    while (auto frame = scanDecoder.readNextFrame()) {
+        packetsByPts[frame->pts] = {frame->size, frame->pos};
+    }
+    
+    VideoDecoder decoder("test_videos/test_h264_720p_60fps.mp4", 4);
+    int frameCount = 0;
+    while (auto frame = decoder.readNextFrame()) {
+        auto it = packetsByPts.find(frame->pts);
+        ASSERT_NE(it, packetsByPts.end()) << "Unknown PTS " << frame->pts;
+        EXPECT_EQ(frame->size, it->second.first) << "Frame " << frameCount;
+        EXPECT_EQ(frame->pos, it->second.second) << "Frame " << frameCount;
+        frameCount++;
+    }
+    
+    EXPECT_EQ(frameCount, static_cast<int>(packetsByPts.size()));
+}
+
+// Test that motion vectors are only exported when requested
+TEST(VideoDecoderTest, MotionVectorExportIsOptIn) {
+    auto countVectors = [](VideoDecoder& decoder) {
+        size_t count = 0;
+        while (decoder.readNextFrame()) {
+            if (auto mvData = decoder.getMotionVectors()) {
+                count += mvData->vectors.size();
+            }
+        }
+        return count;
+    };
+    
+    VideoDecoder plainDecoder("test_videos/test_h264_720p_60fps.mp4");
+    EXPECT_FALSE(plainDecoder.isMotionVectorExportEnabled());
+    EXPECT_EQ(countVectors(plainDecoder), 0u);
+    
+    DecoderOptions options;
+    options.exportMotionVectors = true;
+    VideoDecoder mvDecoder("test_videos/test_h264_720p_60fps.mp4", options);
+    EXPECT_TRUE(mvDecoder.isMotionVectorExportEnabled());
+    size_t exported = countVectors(mvDecoder);
+    EXPECT_GT(exported, 0u);
+    
+    // Enabling later reopens the codec and restarts from the beginning
+    plainDecoder.setMotionVectorExport(true);
+    EXPECT_TRUE(plainDecoder.isMotionVectorExportEnabled());
+    EXPECT_TRUE(plainDecoder.hasMoreFrames());
+    EXPECT_EQ(countVectors(plainDecoder), exported);
+}
@@ -0,0 +1,83 @@
+#include "video_analyzer/work_stealing_deque.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace video_analyzer;
+
+TEST(WorkStealingDequeTest, OwnerPopsLifoThievesStealFifo) {
+    WorkStealingDeque<int> deque(8);
+    int values[4] = {0, 1, 2, 3};
+    for (int& value : values) {
+        EXPECT_TRUE(deque.push(&value));
+    }
+    EXPECT_EQ(deque.size(), 4u);
+    
+    EXPECT_EQ(deque.pop(), &values[3]);
+    EXPECT_EQ(deque.steal(), &values[0]);
+    EXPECT_EQ(deque.steal(), &values[1]);
+    EXPECT_EQ(deque.pop(), &values[2]);
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDequeTest, PushFailsWhenFull) {
+    WorkStealingDeque<int> deque(3);
+    EXPECT_EQ(deque.capacity(), 4u);
+    
+    int value = 0;
+    for (size_t i = 0; i < deque.capacity(); ++i) {
+        EXPECT_TRUE(deque.push(&value));
+    }
+    EXPECT_FALSE(deque.push(&value));
+    
+    // Space freed by a steal is reused
+    EXPECT_NE(deque.steal(), nullptr);
+    EXPECT_TRUE(deque.push(&value));
+}
+
+TEST(WorkStealingDequeTest, ConcurrentStealsTakeEachItemOnce) {
+    constexpr int kItems = 20000;
+    WorkStealingDeque<int> deque(kItems);
+    std::vector<int> items(kItems);
+    std::vector<std::atomic<int>> taken(kItems);
+    
+    std::atomic<bool> done{false};
+    auto take = [&](int* item) {
+        taken[item - items.data()]++;
+    };
+    
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&]() {
+            while (!done || !deque.empty()) {
+                if (int* item = deque.steal()) {
+                    take(item);
+                }
+            }
+        });
+    }
+    
+    // Owner interleaves pushes and pops while thieves steal
+    for (int i = 0; i < kItems; ++i) {
+        ASSERT_TRUE(deque.push(&items[i]));
+        if (i % 3 == 0) {
+            if (int* item = deque.pop()) {
+                take(item);
+            }
+        }
+    }
+    while (int* item = deque.pop()) {
+        take(item);
+    }
+    done = true;
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+    
+    for (const auto& count : taken) {
+        ASSERT_EQ(count, 1);
+    }
+}
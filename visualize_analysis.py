@@ -5,13 +5,82 @@ Video Stream Analyzer - Visualization Tool
 """
 
 import json
+import struct
 import sys
 import matplotlib.pyplot as plt
 import matplotlib.patches as mpatches
 from pathlib import Path
 
+VSA_MAGIC = b'VSAREP01'
+
+def is_binary_analysis(path):
+    """检查是否为二进制列式报告 (.vsa)"""
+    with open(path, 'rb') as f:
+        return f.read(len(VSA_MAGIC)) == VSA_MAGIC
+
+def load_binary_columns(vsa_file):
+    """映射二进制列式报告，返回 (metadata, {列名: numpy 数组})
+
+    列直接以 numpy.memmap 视图返回，不做任何解析。
+    """
+    import numpy as np
+    
+    raw = np.memmap(vsa_file, dtype=np.uint8, mode='r')
+    magic, version, column_count, directory_offset, metadata_offset, metadata_size = \
+        struct.unpack_from('<8sIIQQQ', raw[:64].tobytes())
+    if magic != VSA_MAGIC:
+        raise ValueError(f'Not a binary analysis report: {vsa_file}')
+    if version != 1:
+        raise ValueError(f'Unsupported binary report version: {version}')
+    
+    columns = {}
+    for i in range(column_count):
+        entry_offset = directory_offset + i * 64
+        name, dtype, offset, count = struct.unpack(
+            '<40s8sQQ', raw[entry_offset:entry_offset + 64].tobytes())
+        name = name.rstrip(b'\0').decode()
+        dtype = dtype.rstrip(b'\0').decode()
+        columns[name] = np.frombuffer(raw, dtype=dtype, count=count, offset=offset)
+    
+    metadata = json.loads(raw[metadata_offset:metadata_offset + metadata_size].tobytes())
+    return metadata, columns
+
+def load_binary_analysis(vsa_file):
+    """加载二进制列式报告并转换为与 JSON 报告相同的结构"""
+    metadata, columns = load_binary_columns(vsa_file)
+    frame_types = metadata.get('frameTypes', ['I', 'P', 'B', 'UNKNOWN'])
+    
+    data = {'streamInfo': metadata.get('streamInfo', {})}
+    if 'frameStatistics' in metadata:
+        data['frameStats'] = metadata['frameStatistics']
+    
+    data['frames'] = [
+        {'timestamp': t, 'size': s, 'type': frame_types[k] if k < len(frame_types) else 'UNKNOWN'}
+        for t, s, k in zip(columns['frames.timestamp'].tolist(),
+                           columns['frames.size'].tolist(),
+                           columns['frames.type'].tolist())
+    ]
+    
+    gop_keys = ['gopIndex', 'startPts', 'endPts', 'frameCount', 'iFrameCount',
+                'pFrameCount', 'bFrameCount', 'totalSize', 'isOpenGOP']
+    gop_columns = [columns[f'gops.{key}'].tolist() for key in gop_keys]
+    data['gops'] = [dict(zip(gop_keys, values)) for values in zip(*gop_columns)]
+    
+    if 'bitrateStatistics' in metadata:
+        bitrate_stats = dict(metadata['bitrateStatistics'])
+        bitrate_stats['timeSeriesData'] = [
+            {'timestamp': t, 'bitrate': b}
+            for t, b in zip(columns['bitrate.timestamp'].tolist(),
+                            columns['bitrate.bitrate'].tolist())
+        ]
+        data['bitrateStats'] = bitrate_stats
+    
+    return data
+
 def load_analysis(json_file):
-    """加载分析结果"""
+    """加载分析结果 (JSON 或二进制 .vsa)"""
+    if is_binary_analysis(json_file):
+        return load_binary_analysis(json_file)
     with open(json_file, 'r') as f:
         return json.load(f)
 
@@ -207,7 +276,7 @@ def visualize(json_file):
 
 def main():
     if len(sys.argv) < 2:
-        print("Usage: python visualize_analysis.py <analysis.json>")
+        print("Usage: python visualize_analysis.py <analysis.json|analysis.vsa>")
         print("\nExample:")
         print("  ./video_analyzer_cli input.mp4 --output analysis.json")
         print("  python visualize_analysis.py analysis.json")